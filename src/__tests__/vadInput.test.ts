@@ -0,0 +1,101 @@
+/**
+ * @jest-environment node
+ */
+import fs from 'fs';
+import path from 'path';
+
+// The VAD only runs against the built addon; skipped where it is not built
+const addonPath = [
+  path.join(process.cwd(), 'build/Release/audio_capture.node'),
+  path.join(process.cwd(), 'build/audio_capture.node'),
+].find((candidate) => fs.existsSync(candidate));
+
+const describeAddon = addonPath ? describe : describe.skip;
+
+const SAMPLE_RATE = 48000;
+const FRAME_MS = 20;
+const FRAMES = 25;
+
+// Same rounding as the native float conversion: clamp, scale by 32768
+function toInt16(samples: Float32Array): Int16Array {
+  const pcm16 = new Int16Array(samples.length);
+  for (let i = 0; i < samples.length; i++) {
+    const clamped = Math.min(Math.max(samples[i], -1), 1);
+    pcm16[i] = Math.min(Math.round(clamped * 32768), 32767);
+  }
+  return pcm16;
+}
+
+function silence(): Float32Array {
+  return new Float32Array((SAMPLE_RATE * FRAME_MS * FRAMES) / 1000);
+}
+
+// A speech-band tone
+function tone(): Float32Array {
+  const samples = silence();
+  for (let i = 0; i < samples.length; i++) {
+    samples[i] = 0.5 * Math.sin((2 * Math.PI * 440 * i) / SAMPLE_RATE);
+  }
+  return samples;
+}
+
+describeAddon('VAD input types', () => {
+  // eslint-disable-next-line global-require, import/no-dynamic-require
+  const addon = addonPath ? require(addonPath) : null;
+  let capture: any;
+
+  beforeEach(() => {
+    capture = new addon.AudioCapture();
+    expect(capture.createVAD(SAMPLE_RATE, 2)).toBe(true);
+  });
+
+  const batch = (audio: Float32Array | Int16Array | Buffer) => {
+    capture.resetVAD();
+    return Array.from(capture.processVADBatch(audio, FRAME_MS) as Uint8Array);
+  };
+
+  it.each([
+    ['silence', silence],
+    ['tone', tone],
+  ])(
+    'processVADBatch decides %s the same as Float32Array and Int16Array',
+    (_name, make) => {
+      const float32 = make();
+      const pcm16 = toInt16(float32);
+
+      const fromFloat = batch(float32);
+      expect(fromFloat).toHaveLength(FRAMES);
+      expect(fromFloat).toEqual(batch(pcm16));
+      expect(fromFloat).toEqual(batch(Buffer.from(pcm16.buffer)));
+    },
+  );
+
+  it.each([
+    ['silence', silence],
+    ['tone', tone],
+  ])(
+    'processVADFrames decides %s the same as Float32Array and Int16Array',
+    (_name, make) => {
+      expect(capture.createVADEngine()).toBe(true);
+      const stream = capture.openVADStream(SAMPLE_RATE, 2);
+      expect(stream).toBeGreaterThanOrEqual(0);
+
+      // Every frame on the one stream, processed in order
+      const streams = new Uint32Array(FRAMES).fill(stream);
+      const frames = (audio: Float32Array | Int16Array | Buffer) => {
+        capture.resetVADStream(stream);
+        return Array.from(
+          capture.processVADFrames(streams, audio, FRAME_MS) as Int8Array,
+        );
+      };
+
+      const float32 = make();
+      const pcm16 = toInt16(float32);
+
+      const fromFloat = frames(float32);
+      expect(fromFloat).toHaveLength(FRAMES);
+      expect(fromFloat).toEqual(frames(pcm16));
+      expect(fromFloat).toEqual(frames(Buffer.from(pcm16.buffer)));
+    },
+  );
+});
@@ -313,36 +313,28 @@ export default class AudioPipeline extends EventEmitter {
       let speech = false;
       if (this.audioCapture && this.audioCapture.isVADInitialized()) {
         try {
-          // Convert 48kHz float32 to int16 for WebRTC VAD
-          const pcm48Data = floatToPcm16(float32Data);
+          // One native call per chunk: float32 goes straight in and partial
+          // frames carry over to the next chunk
+          const decisions = this.audioCapture.processVADBatch(
+            float32Data,
+            this.VAD_FRAME_MS,
+          );
+          if (!decisions) {
+            throw new Error('processVADBatch failed');
+          }
 
-          let framesProcessed = 0;
           let speechFrames = 0;
 
           // Debug: Log input size
           if (this.stats.audioChunksProcessed % 50 === 0) {
             console.log(
-              `🔍 [VAD Debug] Input: ${pcm48Data.length} samples, ${Math.floor(pcm48Data.length / this.VAD_SAMPLES_PER_FRAME)} complete frames`,
+              `🔍 [VAD Debug] Input: ${float32Data.length} samples, ${decisions.length} complete frames`,
             );
           }
 
-          for (
-            let offset = 0;
-            offset + this.VAD_SAMPLES_PER_FRAME <= pcm48Data.length;
-            offset += this.VAD_SAMPLES_PER_FRAME
-          ) {
-            // Create buffer with exact byte offset and length for 960 samples (1920 bytes)
-            const frameBuffer = Buffer.from(
-              pcm48Data.buffer,
-              pcm48Data.byteOffset + offset * 2, // offset in bytes (2 bytes per sample)
-              this.VAD_SAMPLES_PER_FRAME * 2, // 960 samples * 2 bytes = 1920 bytes
-            );
-
-            const frameHasSpeech = this.audioCapture.processVAD(frameBuffer);
-            framesProcessed += 1;
-
-            // Accumulate speech across all frames instead of short-circuiting.
-            if (frameHasSpeech) {
+          // Accumulate speech across all frames instead of short-circuiting.
+          for (let i = 0; i < decisions.length; i++) {
+            if (decisions[i]) {
               speech = true;
               speechFrames += 1;
             }
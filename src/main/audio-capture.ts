@@ -11,33 +11,298 @@ export interface AudioFormat {
   isFloat?: boolean;
   isNonInterleaved?: boolean;
   formatFlags?: number;
+  streamSampleRate?: number; // Rate of the native mono float32 stream
+}
+
+export interface CaptureOptions {
+  sampleRate?: number; // 48000 (default), 24000, 16000, 12000 or 8000; asked of the OS first
+  channels?: number; // 1 or 2; backends that can downmix natively deliver this many
+  frameDurationMs?: number; // OS buffer duration where the backend supports it
 }
 
 export interface AudioSample {
   data: Buffer;
-  timestamp: number;
+  timestamp: number; // Monotonic microseconds (native capture clock)
   frameCount: number;
   format: AudioFormat;
+  silent: boolean; // Digital silence; data is zeros
 }
 
 export interface AudioChunk {
   data: Buffer; // PCM16 data
-  timestamp: number;
+  timestamp: number; // Monotonic microseconds
   sampleRate: number;
   channels: number;
 }
 
 export interface Float32AudioChunk {
   data: number[]; // Float32 data
-  timestamp: number;
+  timestamp: number; // Monotonic microseconds
   sampleRate: number;
   channels: number;
 }
 
+export interface Float32BatchOptions {
+  batchMs?: number; // Target batch duration (default 20ms)
+  maxQueuedBatches?: number; // Batches kept before the oldest is dropped (default 8)
+  sampleRate?: number; // Native resampling target, must divide 48000 (default 48000)
+  encoding?: SampleEncoding; // Batch payload type (default 'float32')
+  speechGated?: boolean; // Deliver only VAD speech segments; needs enableStreamingVAD() first
+  preRollMs?: number; // Audio before each onset delivered with it, keep above the VAD holdMs (default 500)
+  silenceRuns?: boolean; // Deliver whole batches of digital silence as one null batch with its frame count
+  adaptiveBatching?: boolean; // Grow batches while the event loop lags, shrink them when idle; batchMs is the start
+  minBatchMs?: number; // Adaptive lower bound (default 10ms)
+  maxBatchMs?: number; // Adaptive upper bound, at most 1000 (default 200ms); the queue holds maxQueuedBatches of these
+}
+
+// 'pcm16' delivers a Buffer of little-endian PCM16, 'base64' the same bytes
+// as a base64 string ready for provider payloads
+export type SampleEncoding = 'float32' | 'pcm16' | 'base64';
+
+// Float32Array, Buffer or string according to Float32BatchOptions.encoding;
+// null for a silence run (Float32BatchOptions.silenceRuns)
+export type AudioBatch = Float32Array | Buffer | string | null;
+
+export interface Float32BatchInfo {
+  sampleRate: number;
+  frames: number; // Samples the batch covers, including a silence run's
+  silent: boolean; // Silence run: no samples, frames of digital silence
+  droppedSamples: number; // Samples dropped since the previous batch
+  totalDroppedSamples: number;
+  vad?: VADDecisions; // Present while the streaming VAD stage is enabled
+  features?: SpectralFeatures; // Present while the spectral feature stage is enabled
+  segmentStart?: boolean; // Speech-gated only: first batch of a segment (begins with its pre-roll)
+  segmentEnd?: boolean; // Speech-gated only: last, possibly short, batch of a segment
+}
+
+export interface OpusEncoderOptions {
+  bitrate?: number; // Bits per second, 6000-510000 (default 24000)
+  frameMs?: number; // 10, 20, 40 or 60 (default 20)
+  sampleRate?: number; // 8000, 12000, 16000, 24000 or 48000 (default)
+  complexity?: number; // 0-10 (default 5)
+  application?: 'voip' | 'audio'; // Opus tuning (default 'voip')
+  maxQueuedPackets?: number; // Packets kept before the oldest is dropped (default 50)
+}
+
+export interface OpusPacket {
+  data: Buffer; // One Opus frame
+  timestamp: number; // Monotonic microseconds of the capture packet that completed it
+  position: number; // Stream sample index of the frame's first sample
+}
+
+export interface OpusPacketInfo {
+  sampleRate: number;
+  frameMs: number;
+  droppedPackets: number; // Packets dropped since the previous delivery
+  totalDroppedPackets: number;
+}
+
+export interface RecordingOptions {
+  path: string; // First file; rotated files get -0001, -0002... before the extension
+  format?: 'wav' | 'raw' | 'opus'; // Container (default 'wav'); 'opus' writes Ogg Opus
+  encoding?: 'pcm16' | 'float32'; // wav/raw sample format (default 'pcm16')
+  rotateBytes?: number; // Start a new file past this size (default never)
+  rotateSeconds?: number; // Start a new file after this much audio (default never)
+  syncIntervalMs?: number; // fdatasync cadence; 0 only at rotation and stop (default 1000)
+  writeBytes?: number; // Bytes per write(), whole 4096-byte blocks (default 262144)
+  queueMs?: number; // Audio queued for the I/O thread, 100-60000 (default 2000)
+  bitrate?: number; // Opus only (default 24000)
+  frameMs?: number; // Opus only (default 20)
+}
+
+export interface RecordingStats {
+  recording: boolean;
+  files: string[];
+  samples: number; // Samples at the capture rate written so far
+  droppedSamples: number; // Lost because the disk fell behind the queue
+  bytesWritten: number;
+  writes: number;
+  syncs: number;
+  error?: string; // First I/O error; later audio is discarded
+}
+
+// Per-frame flag bits in VADDecisions.frames
+export enum VADFrameFlags {
+  Voiced = 1 << 0, // Raw WebRTC VAD decision
+  Speaking = 1 << 1, // State after hold/release hysteresis
+  SpeechStart = 1 << 2,
+  SpeechEnd = 1 << 3,
+}
+
+export interface StreamingVADOptions {
+  mode?: number; // WebRTC VAD aggressiveness 0-3 (default 2)
+  frameMs?: number; // 10, 20 or 30 (default 20)
+  holdMs?: number; // Continuous voice needed to start speaking (default 200)
+  releaseMs?: number; // Continuous silence needed to stop speaking (default 2000)
+  sampleRate?: number; // 8000, 16000 or 48000 (default); lower rates decimate natively
+}
+
+export interface VADDecisions {
+  frames: Uint8Array; // One VADFrameFlags byte per frame, oldest first
+  frameMs: number;
+  sampleRate: number; // Rate the VAD ran at
+  speaking: boolean;
+  speechStarted: boolean;
+  speechEnded: boolean;
+}
+
+export interface SpectralFeaturesOptions {
+  frameMs?: number; // 10, 20 or 30 (default 20)
+  sampleRate?: number; // 8000, 16000 (default) or 48000; must divide the capture rate
+}
+
+// Offsets into each frame of SpectralFeatures.values
+export enum SpectralFeature {
+  EnergyDb = 0, // Frame power in dBFS, -100 for digital silence
+  Band0Db = 1, // WebRTC VAD filterbank band energies (offset dB): 80-250,
+  Band1Db = 2, //   250-500, 500-1000, 1000-2000, 2000-3000 and 3000-4000 Hz
+  Band2Db = 3,
+  Band3Db = 4,
+  Band4Db = 5,
+  Band5Db = 6,
+  Flatness = 7, // 0 tonal (music) .. 1 noise-like (keyboard, fans)
+  CentroidHz = 8,
+  ZeroCrossingRate = 9, // Sign changes per sample
+  SpeechBandRatio = 10, // Share of the power in 300-3400 Hz
+}
+
+export interface SpectralFeatures {
+  frames: number;
+  stride: number; // Values per frame (SpectralFeature offsets)
+  values: Float32Array; // frames * stride values, oldest frame first
+  frameMs: number;
+  sampleRate: number; // Rate the analysis ran at
+}
+
+export interface VADEngineOptions {
+  streams?: number; // Stream states in the pool, 1-4096 (default 64)
+  threads?: number; // Worker threads besides the caller, 0-16 (default: cores - 1, at most 3)
+}
+
+export interface NoiseGateOptions {
+  attackMs?: number; // Time constant of a rising level (default 10)
+  releaseMs?: number; // Time constant of a falling level (default 150)
+  holdMs?: number; // Gate stays open after the level drops (default 300)
+}
+
+export interface AudioLevel {
+  rms: number; // Last packet
+  peak: number; // Last packet, largest |sample|
+  level: number; // Smoothed RMS, what the gate compares
+  gateOpen: boolean;
+  gateThreshold: number;
+}
+
+export interface ProcessingWorkerOptions {
+  enabled?: boolean; // Process packets off the OS capture thread (default true)
+  cpu?: number; // Pin the worker to this CPU; -1 leaves it to the OS (default)
+  priority?: 'normal' | 'high' | 'realtime'; // Worker scheduling (default 'high')
+  queuePackets?: number; // Packets queued before new ones are dropped, 2-4096 (default 64)
+  slotBytes?: number; // Preallocated bytes per queued packet (default 38400)
+}
+
+export interface StageLatencyStats {
+  count: number;
+  meanUs: number;
+  p50Us: number; // Percentiles are histogram bucket bounds (within ~6%)
+  p90Us: number;
+  p99Us: number;
+  maxUs: number;
+}
+
+export interface BufferLimits {
+  maxDurationMs?: number; // Keep at most this much audio per format, oldest trimmed first (0 = no limit)
+  maxBytes?: number; // Byte limit across both formats (default 5MB)
+}
+
+export interface BufferLevel {
+  float32Samples: number;
+  float32DurationMs: number;
+  pcm16Frames: number;
+  pcm16DurationMs: number;
+  bytes: number;
+  usage: number; // bytes / maxBytes
+  ageMs: number; // Age of the oldest buffered float32 sample
+  maxDurationMs: number;
+}
+
+export interface BufferLevelStats {
+  current: number;
+  highWater: number;
+}
+
+export interface AudioCaptureStats {
+  stages: {
+    captureToBuffer: StageLatencyStats; // Backend delivery until buffered
+    bufferToJS: StageLatencyStats; // Buffered audio until JS receives it
+    conversion: StageLatencyStats; // Format conversion and resampling
+    vad: StageLatencyStats; // Streaming VAD stage
+    features: StageLatencyStats; // Spectral feature stage
+    workerQueue: StageLatencyStats; // Capture callback until the worker picks the packet up
+    captureLatency: StageLatencyStats; // Device capture until backend delivery (backends with timestamps)
+  };
+  counters: {
+    packets: number;
+    frames: number;
+    rawCallbackDrops: number;
+    pushSignalFailures: number;
+    workerDrops: number; // Packets dropped on a full worker queue
+    gatedPackets: number; // Packets the noise gate dropped
+    silentPackets: number; // Digital-silence packets carried as a duration only
+    pullOverrunSamples: number;
+    trimmedChunks: number;
+    pullTrimmedSamples: number; // Float32 samples dropped by the buffer limits
+    pushDroppedSamples: number;
+  };
+  buffers: {
+    pullBufferedSamples: BufferLevelStats;
+    pushBufferedSamples: BufferLevelStats;
+    jsQueueDepth: BufferLevelStats;
+    workerQueueDepth: BufferLevelStats;
+  };
+  worker: {
+    enabled: boolean;
+    running: boolean;
+    priority: 'normal' | 'high' | 'realtime';
+    cpu: number;
+    queueDepth: number;
+    queueCapacity: number;
+    threadConfigError?: string; // Why the requested pinning/priority was refused
+  };
+  // One native capture engine serves every AudioCapture instance in the process
+  engine: {
+    consumers: number; // Instances attached to the engine
+    started: number; // Instances currently started
+    sharedPullStream: boolean; // Pull buffer reads the engine's stream without a copy
+    deviceChanges: number; // Device notifications seen; each invalidates the device list
+  };
+  // Device sample clock fitted against the host clock from capture timestamps
+  clock: {
+    locked: boolean;
+    driftPpm: number; // Positive: the device runs fast
+    measuredRate: number; // 0 until locked
+    jitterUs: number;
+  };
+  // Push delivery (startFloat32Push) batch sizing and event-loop lag
+  delivery: {
+    active: boolean;
+    adaptive: boolean; // Float32BatchOptions.adaptiveBatching
+    targetBatchMs: number; // Batch duration the next delivery waits for
+    minBatchMs: number;
+    maxBatchMs: number;
+    wakeupLatencyMs: number; // Smoothed delay from batch ready to the JS callback
+    maxWakeupLatencyMs: number;
+    queuedMs: number; // Audio waiting when the last delivery started
+    deliveries: number;
+    adjustments: number; // Target changes since startFloat32Push
+  };
+}
+
 export class AudioCapture extends EventEmitter {
   private nativeCapture: any;
   private isInitialized: boolean = false;
   private vadInitialized: boolean = false;
+  private vadEngineInitialized: boolean = false;
   
   // ────────────────────────────────────────────
   // Audio chunk storage for playback
@@ -146,7 +411,7 @@ export class AudioCapture extends EventEmitter {
     }
   }
 
-  public async start(): Promise<boolean> {
+  public async start(options?: CaptureOptions): Promise<boolean> {
     console.log(
       `🎵 Starting audio capture - isInitialized: ${this.isInitialized}`,
     );
@@ -163,14 +428,16 @@ export class AudioCapture extends EventEmitter {
       // Test getting available devices and format info before starting
       console.log(
         '📱 Available audio devices:',
-        this.nativeCapture.getAvailableDevices(),
+        await this.nativeCapture.getAvailableDevicesAsync(),
       );
       console.log(
         '📝 Default audio format:',
         JSON.stringify(this.nativeCapture.getFormat()),
       );
 
-      const success = this.nativeCapture.start();
+      // Opens the backend off the main thread (ScreenCaptureKit can take
+      // seconds to resolve permissions)
+      const success: boolean = await this.nativeCapture.startAsync(options);
       console.log(`📊 Native start result: ${success}`);
 
       if (success) {
@@ -272,6 +539,25 @@ export class AudioCapture extends EventEmitter {
     }
   }
 
+  // Resolves from a native cache that device notifications invalidate, so
+  // listing is cheap unless hardware changed
+  public async getAvailableDevicesAsync(): Promise<string[]> {
+    if (!this.isInitialized) {
+      return ['Mock Device'];
+    }
+
+    try {
+      return await this.nativeCapture.getAvailableDevicesAsync();
+    } catch (error) {
+      console.error('Error getting available devices:', error);
+      return [];
+    }
+  }
+
+  // Device ids of the form "file:<path>[?speed=<N|max>&loop=1&packetMs=<ms>
+  // &layout=planar&format=<s16|s32|f32>&rate=<hz>&channels=<n>]" replay a
+  // recording instead of capturing, "mix:<id>|<id>" and "tracks:<id>|<id>"
+  // combine sources (see setSources; switch only while stopped)
   public setDevice(deviceId: string): boolean {
     if (!this.isInitialized) {
       console.log('Mock: Setting device to', deviceId);
@@ -279,13 +565,44 @@ export class AudioCapture extends EventEmitter {
     }
 
     try {
-      return this.nativeCapture.setDevice(deviceId);
+      const selected = this.nativeCapture.setDevice(deviceId);
+      if (!selected) {
+        console.warn('Device not selected:', this.nativeCapture.getLastError());
+      }
+      return selected;
     } catch (error) {
       console.error('Error setting device:', error);
       return false;
     }
   }
 
+  // setDevice() without blocking the main thread on device activation
+  public async setDeviceAsync(deviceId: string): Promise<boolean> {
+    if (!this.isInitialized) {
+      console.log('Mock: Setting device to', deviceId);
+      return true;
+    }
+
+    try {
+      const selected: boolean = await this.nativeCapture.setDeviceAsync(deviceId);
+      if (!selected) {
+        console.warn('Device not selected:', this.nativeCapture.getLastError());
+      }
+      return selected;
+    } catch (error) {
+      console.error('Error setting device:', error);
+      return false;
+    }
+  }
+
+  // Capture several devices at once, time-aligned natively: 'mix' sums them
+  // into the usual mono stream, 'tracks' delivers one interleaved float32
+  // channel per source to the raw audio callback (the pipeline still sees
+  // their average). Source ids are anything setDevice() accepts.
+  public setSources(deviceIds: string[], mode: 'mix' | 'tracks' = 'mix'): boolean {
+    return this.setDevice(`${mode}:${deviceIds.join('|')}`);
+  }
+
   public getVolumeLevel(): number {
     if (!this.isInitialized) {
       // Return random mock volume for demo
@@ -300,6 +617,20 @@ export class AudioCapture extends EventEmitter {
     }
   }
 
+  // Native level meter and gate state, measured on every backend
+  public getLevel(): AudioLevel | null {
+    if (!this.isInitialized) {
+      return null;
+    }
+
+    try {
+      return this.nativeCapture.getLevel();
+    } catch (error) {
+      console.error('Error getting audio level:', error);
+      return null;
+    }
+  }
+
   public getLastError(): string {
     if (!this.isInitialized) {
       return 'Native module not available';
@@ -337,6 +668,50 @@ export class AudioCapture extends EventEmitter {
     }
   }
 
+  // Bound the pull buffer by duration and/or size so slow consumers cannot
+  // grow memory or latency without limit
+  public setBufferLimits(limits: BufferLimits): boolean {
+    if (!this.isInitialized) {
+      return false;
+    }
+
+    try {
+      return this.nativeCapture.setBufferLimits(limits);
+    } catch (error) {
+      console.error('Error setting buffer limits:', error);
+      return false;
+    }
+  }
+
+  // Pull buffer level from native running counters (cheap to poll)
+  public getBufferLevel(): BufferLevel | null {
+    if (!this.isInitialized) {
+      return null;
+    }
+
+    try {
+      return this.nativeCapture.getBufferLevel();
+    } catch (error) {
+      console.error('Error getting buffer level:', error);
+      return null;
+    }
+  }
+
+  // Drop digital silence at the front of the pull buffer without reading it;
+  // returns the samples skipped so the caller's timeline stays correct
+  public skipBufferedSilence(): number {
+    if (!this.isInitialized) {
+      return 0;
+    }
+
+    try {
+      return this.nativeCapture.skipBufferedSilence();
+    } catch (error) {
+      console.error('Error skipping buffered silence:', error);
+      return 0;
+    }
+  }
+
   public getBufferedFloat32Audio(): Float32AudioChunk[] {
     if (!this.isInitialized) {
       return [];
@@ -350,6 +725,281 @@ export class AudioCapture extends EventEmitter {
     }
   }
 
+  // Push mode: native side coalesces 48kHz mono float32 into fixed-duration
+  // batches and emits one 'float32batch' event per batch (encoded per options.encoding)
+  public startFloat32Push(options: Float32BatchOptions = {}): boolean {
+    if (!this.isInitialized) {
+      return false;
+    }
+
+    try {
+      this.nativeCapture.setFloat32Callback(
+        (batch: AudioBatch, info: Float32BatchInfo) => {
+          this.emit('float32batch', batch, info);
+        },
+        options,
+      );
+      return true;
+    } catch (error) {
+      console.error('Error starting float32 push delivery:', error);
+      return false;
+    }
+  }
+
+  public stopFloat32Push(): void {
+    if (!this.isInitialized) {
+      return;
+    }
+
+    try {
+      this.nativeCapture.clearFloat32Callback();
+    } catch (error) {
+      console.error('Error stopping float32 push delivery:', error);
+    }
+  }
+
+  // Float32 -> PCM16 -> base64 in one native pass (or a PCM16 Buffer),
+  // replacing floatToPcm16 plus Buffer.toString('base64') on the JS thread
+  public encodePcm16(samples: Float32Array, encoding: 'pcm16'): Buffer | null;
+  public encodePcm16(samples: Float32Array, encoding?: 'base64'): string | null;
+  public encodePcm16(
+    samples: Float32Array,
+    encoding: 'pcm16' | 'base64' = 'base64',
+  ): Buffer | string | null {
+    if (!this.isInitialized) {
+      return null;
+    }
+
+    try {
+      return this.nativeCapture.encodePcm16(samples, encoding);
+    } catch (error) {
+      console.error('Error encoding PCM16:', error);
+      return null;
+    }
+  }
+
+  // Whether the native module was built with libopus (AUDIOMID_WITH_OPUS)
+  public isOpusAvailable(): boolean {
+    if (!this.isInitialized) {
+      return false;
+    }
+
+    try {
+      return this.nativeCapture.isOpusAvailable();
+    } catch (error) {
+      console.error('Error checking Opus availability:', error);
+      return false;
+    }
+  }
+
+  // Encode captured audio to Opus natively and emit 'opuspackets' with
+  // every packet encoded since the previous event
+  public startOpusEncoding(options: OpusEncoderOptions = {}): boolean {
+    if (!this.isInitialized) {
+      return false;
+    }
+
+    try {
+      this.nativeCapture.setOpusCallback(
+        (packets: OpusPacket[], info: OpusPacketInfo) => {
+          this.emit('opuspackets', packets, info);
+        },
+        options,
+      );
+      return true;
+    } catch (error) {
+      console.error('Error starting Opus encoding:', error);
+      return false;
+    }
+  }
+
+  public stopOpusEncoding(): void {
+    if (!this.isInitialized) {
+      return;
+    }
+
+    try {
+      this.nativeCapture.clearOpusCallback();
+    } catch (error) {
+      console.error('Error stopping Opus encoding:', error);
+    }
+  }
+
+  // Record the captured stream to disk natively; conversion, encoding and
+  // writes run on their own I/O thread, never on the event loop
+  public startRecording(options: RecordingOptions): boolean {
+    if (!this.isInitialized) {
+      return false;
+    }
+
+    try {
+      return this.nativeCapture.startRecording(options);
+    } catch (error) {
+      console.error('Error starting recording:', error);
+      return false;
+    }
+  }
+
+  // Write out the queued audio, close the file and report what was recorded
+  public stopRecording(): RecordingStats | null {
+    if (!this.isInitialized) {
+      return null;
+    }
+
+    try {
+      return this.nativeCapture.stopRecording();
+    } catch (error) {
+      console.error('Error stopping recording:', error);
+      return null;
+    }
+  }
+
+  public getRecordingStats(): RecordingStats | null {
+    if (!this.isInitialized) {
+      return null;
+    }
+
+    try {
+      return this.nativeCapture.getRecordingStats();
+    } catch (error) {
+      console.error('Error getting recording stats:', error);
+      return null;
+    }
+  }
+
+  // Fill a caller-owned Float32Array with buffered audio, returns samples written.
+  // Reusing the same target keeps steady-state polling allocation-free.
+  public readFloat32Audio(target: Float32Array): number {
+    if (!this.isInitialized) {
+      return 0;
+    }
+
+    try {
+      return this.nativeCapture.readFloat32Audio(target);
+    } catch (error) {
+      console.error('Error reading float32 audio:', error);
+      return 0;
+    }
+  }
+
+  // Deliver getBufferedFloat32Audio() results as views over pooled native memory.
+  // Returns false when the runtime disallows external buffers (e.g. Electron's
+  // V8 memory cage), in which case delivery keeps copying.
+  public setZeroCopyDelivery(enabled: boolean): boolean {
+    if (!this.isInitialized) {
+      return false;
+    }
+
+    try {
+      return this.nativeCapture.setZeroCopyDelivery(enabled);
+    } catch (error) {
+      console.error('Error setting zero-copy delivery:', error);
+      return false;
+    }
+  }
+
+  // Rate of audio returned by getBufferedFloat32Audio()/readFloat32Audio().
+  // Lower rates (24000, 16000, 8000) are produced by the native resampler;
+  // audio already buffered at the previous rate is discarded.
+  public setOutputSampleRate(sampleRate: number): boolean {
+    if (!this.isInitialized) {
+      return false;
+    }
+
+    try {
+      return this.nativeCapture.setOutputSampleRate(sampleRate);
+    } catch (error) {
+      console.error('Error setting output sample rate:', error);
+      return false;
+    }
+  }
+
+  // Run WebRTC VAD natively on every captured packet with hold/release
+  // hysteresis. At 8/16kHz the decimated stream is shared with consumers that
+  // asked for the same output rate. Decisions are attached to push batches and available from
+  // getVADDecisions() for polling consumers.
+  public enableStreamingVAD(options: StreamingVADOptions = {}): boolean {
+    if (!this.isInitialized) {
+      return false;
+    }
+
+    try {
+      return this.nativeCapture.enableStreamingVAD(options);
+    } catch (error) {
+      console.error('Error enabling streaming VAD:', error);
+      return false;
+    }
+  }
+
+  public disableStreamingVAD(): void {
+    if (!this.isInitialized) {
+      return;
+    }
+
+    try {
+      this.nativeCapture.disableStreamingVAD();
+    } catch (error) {
+      console.error('Error disabling streaming VAD:', error);
+    }
+  }
+
+  // Frame decisions made since the previous call
+  public getVADDecisions(): VADDecisions | null {
+    if (!this.isInitialized) {
+      return null;
+    }
+
+    try {
+      return this.nativeCapture.getVADDecisions();
+    } catch (error) {
+      console.error('Error getting VAD decisions:', error);
+      return null;
+    }
+  }
+
+  // Per-frame spectral features (filterbank band energies, flatness,
+  // centroid, zero-crossing rate) computed natively next to the VAD, so JS
+  // can tell speech from music or keyboard noise before uploading. Features
+  // are attached to push batches and available from getSpectralFeatures().
+  public enableSpectralFeatures(options: SpectralFeaturesOptions = {}): boolean {
+    if (!this.isInitialized) {
+      return false;
+    }
+
+    try {
+      return this.nativeCapture.enableSpectralFeatures(options);
+    } catch (error) {
+      console.error('Error enabling spectral features:', error);
+      return false;
+    }
+  }
+
+  public disableSpectralFeatures(): void {
+    if (!this.isInitialized) {
+      return;
+    }
+
+    try {
+      this.nativeCapture.disableSpectralFeatures();
+    } catch (error) {
+      console.error('Error disabling spectral features:', error);
+    }
+  }
+
+  // Feature frames analysed since the previous call
+  public getSpectralFeatures(): SpectralFeatures | null {
+    if (!this.isInitialized) {
+      return null;
+    }
+
+    try {
+      return this.nativeCapture.getSpectralFeatures();
+    } catch (error) {
+      console.error('Error getting spectral features:', error);
+      return null;
+    }
+  }
+
   // WebRTC VAD methods
   public createVAD(sampleRate: number = 48000, mode: number = 2): boolean {
     if (!this.isInitialized) {
@@ -385,6 +1035,25 @@ export class AudioCapture extends EventEmitter {
     }
   }
 
+  // Run VAD over an arbitrary-length buffer in frameMs frames, returning one
+  // decision per frame (1 = speech). A trailing partial frame is carried into
+  // the next call. Float32Array input is converted natively.
+  public processVADBatch(
+    audio: Buffer | Int16Array | Float32Array,
+    frameMs: number = 20,
+  ): Uint8Array | null {
+    if (!this.isInitialized || !this.vadInitialized) {
+      return null;
+    }
+
+    try {
+      return this.nativeCapture.processVADBatch(audio, frameMs);
+    } catch (error) {
+      console.error('Error processing VAD batch:', error);
+      return null;
+    }
+  }
+
   public setVADMode(mode: number): boolean {
     if (!this.isInitialized || !this.vadInitialized) {
       return false;
@@ -410,19 +1079,164 @@ export class AudioCapture extends EventEmitter {
     }
   }
 
-  public setNoiseGateThreshold(threshold: number): boolean {
+  // Multi-stream VAD: one pool of WebRTC VAD states shared by many streams
+  // (e.g. relayed calls), processed across worker threads. Recreating the
+  // engine closes every open stream.
+  public createVADEngine(options: VADEngineOptions = {}): boolean {
     if (!this.isInitialized) {
+      console.warn('Cannot create VAD engine: native module not initialized');
       return false;
     }
 
     try {
-      return this.nativeCapture.setNoiseGateThreshold(threshold);
+      this.vadEngineInitialized = this.nativeCapture.createVADEngine(options);
+      return this.vadEngineInitialized;
+    } catch (error) {
+      console.error('Error creating VAD engine:', error);
+      return false;
+    }
+  }
+
+  // Returns the new stream id, or -1 if the pool is full
+  public openVADStream(sampleRate: number = 48000, mode: number = 2): number {
+    if (!this.isInitialized || !this.vadEngineInitialized) {
+      return -1;
+    }
+
+    try {
+      return this.nativeCapture.openVADStream(sampleRate, mode);
+    } catch (error) {
+      console.error('Error opening VAD stream:', error);
+      return -1;
+    }
+  }
+
+  public closeVADStream(stream: number): boolean {
+    if (!this.isInitialized || !this.vadEngineInitialized) {
+      return false;
+    }
+
+    try {
+      return this.nativeCapture.closeVADStream(stream);
+    } catch (error) {
+      console.error('Error closing VAD stream:', error);
+      return false;
+    }
+  }
+
+  public resetVADStream(stream: number): boolean {
+    if (!this.isInitialized || !this.vadEngineInitialized) {
+      return false;
+    }
+
+    try {
+      return this.nativeCapture.resetVADStream(stream);
+    } catch (error) {
+      console.error('Error resetting VAD stream:', error);
+      return false;
+    }
+  }
+
+  // One frameMs frame per entry of streams, back to back in audio (each at
+  // its stream's sample rate). Frames of the same stream are processed in
+  // order; returns one decision per frame (1 = speech, 0 = no speech).
+  public processVADFrames(
+    streams: Uint32Array,
+    audio: Buffer | Int16Array | Float32Array,
+    frameMs: number = 20,
+  ): Int8Array | null {
+    if (!this.isInitialized || !this.vadEngineInitialized) {
+      return null;
+    }
+
+    try {
+      return this.nativeCapture.processVADFrames(streams, audio, frameMs);
+    } catch (error) {
+      console.error('Error processing VAD frames:', error);
+      return null;
+    }
+  }
+
+  // Smoothed RMS below which packets are dropped natively before buffering,
+  // VAD, encoding or delivery; 0 disables the gate (default 0.02)
+  public setNoiseGateThreshold(threshold: number, options?: NoiseGateOptions): boolean {
+    if (!this.isInitialized) {
+      return false;
+    }
+
+    try {
+      return this.nativeCapture.setNoiseGateThreshold(threshold, options);
     } catch (error) {
       console.error('Error setting noise gate threshold:', error);
       return false;
     }
   }
 
+  // Capture buffer duration in ms (latency vs. CPU wakeups); only while stopped
+  public setBufferDuration(milliseconds: number): boolean {
+    if (!this.isInitialized) {
+      return false;
+    }
+
+    try {
+      const applied = this.nativeCapture.setBufferDuration(milliseconds);
+      if (!applied) {
+        console.warn(
+          'Buffer duration not applied:',
+          this.nativeCapture.getLastError(),
+        );
+      }
+      return applied;
+    } catch (error) {
+      console.error('Error setting buffer duration:', error);
+      return false;
+    }
+  }
+
+  // Where packet processing runs: by default a native worker thread does the
+  // conversion, VAD, resampling and encoding so the OS capture callback only
+  // copies bytes. Only while stopped.
+  public setProcessingWorker(options: ProcessingWorkerOptions): boolean {
+    if (!this.isInitialized) {
+      return false;
+    }
+
+    try {
+      this.nativeCapture.setProcessingWorker(options);
+      return true;
+    } catch (error) {
+      console.error('Error configuring processing worker:', error);
+      return false;
+    }
+  }
+
+  // Native pipeline latency, throughput and drop statistics
+  public getStats(): AudioCaptureStats | null {
+    if (!this.isInitialized) {
+      return null;
+    }
+
+    try {
+      return this.nativeCapture.getStats();
+    } catch (error) {
+      console.error('Error getting capture stats:', error);
+      return null;
+    }
+  }
+
+  // Clear latency histograms, counters and high-water marks
+  public resetStats(): void {
+    if (!this.isInitialized) {
+      return;
+    }
+
+    try {
+      this.nativeCapture.resetStats();
+    } catch (error) {
+      console.error('Error resetting capture stats:', error);
+    }
+  }
+
   public isVADInitialized(): boolean {
     return this.vadInitialized;
   }
@@ -527,7 +1341,7 @@ export class AudioCapture extends EventEmitter {
 
       const mockSample: AudioSample = {
         data: mockData,
-        timestamp: Date.now(),
+        timestamp: Math.round(performance.now() * 1000),
         frameCount: sampleCount,
         format: {
           sampleRate: 24000,
@@ -535,6 +1349,7 @@ export class AudioCapture extends EventEmitter {
           bitsPerSample: 16,
           bytesPerFrame: 2,
         },
+        silent: false,
       };
 
       // Store audio chunks for playback if recording
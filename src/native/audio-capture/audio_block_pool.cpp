@@ -0,0 +1,146 @@
+#include "audio_block_pool.h"
+#include <new>
+
+namespace AudioCapture {
+
+namespace {
+
+// 10, 20 and 40 ms of 48 kHz stereo float32 (3840, 7680 and 15360 bytes),
+// rounded up so a packet header fits alongside, then 340 ms of 48 kHz mono
+constexpr size_t CLASS_BYTES[AudioBlockPool::SIZE_CLASSES] = {4096, 8192, 16384,
+                                                             AudioBlockPool::MAX_CLASS_BYTES};
+
+} // namespace
+
+AudioBlock& AudioBlock::operator=(AudioBlock&& other) noexcept {
+    if (this != &other) {
+        Reset();
+        header_ = other.header_;
+        other.header_ = nullptr;
+    }
+    return *this;
+}
+
+void AudioBlock::Reset() {
+    if (header_) {
+        header_->pool->Release(header_);
+        header_ = nullptr;
+    }
+}
+
+void* AudioBlock::Release() {
+    AudioBlockHeader* header = header_;
+    header_ = nullptr;
+    return header;
+}
+
+AudioBlockPool::AudioBlockPool(size_t initialBlocksPerClass)
+    : outstanding_(0)
+    , allocations_(0)
+    , retired_(false) {
+
+    for (size_t c = 0; c < SIZE_CLASSES; ++c) {
+        freeBlocks_[c].reserve(initialBlocksPerClass);
+        for (size_t i = 0; i < initialBlocksPerClass; ++i) {
+            freeBlocks_[c].push_back(Allocate(this, c, CLASS_BYTES[c]));
+        }
+    }
+}
+
+AudioBlockPool::~AudioBlockPool() {
+    for (std::vector<AudioBlockHeader*>& blocks : freeBlocks_) {
+        for (AudioBlockHeader* block : blocks) {
+            Free(block);
+        }
+    }
+}
+
+size_t AudioBlockPool::ClassBytes(size_t sizeClass) {
+    return sizeClass < SIZE_CLASSES ? CLASS_BYTES[sizeClass] : 0;
+}
+
+AudioBlockHeader* AudioBlockPool::Allocate(AudioBlockPool* pool, size_t sizeClass, size_t capacity) {
+    AudioBlockHeader* block = static_cast<AudioBlockHeader*>(::operator new(sizeof(AudioBlockHeader) + capacity));
+    block->pool = pool;
+    block->sizeClass = sizeClass;
+    block->capacity = capacity;
+    return block;
+}
+
+void AudioBlockPool::Free(AudioBlockHeader* block) {
+    ::operator delete(block);
+}
+
+AudioBlock AudioBlockPool::Acquire(size_t bytes) {
+    size_t sizeClass = 0;
+    while (sizeClass < SIZE_CLASSES && bytes > CLASS_BYTES[sizeClass]) {
+        sizeClass++;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        outstanding_++;
+
+        if (sizeClass < SIZE_CLASSES && !freeBlocks_[sizeClass].empty()) {
+            AudioBlockHeader* block = freeBlocks_[sizeClass].back();
+            freeBlocks_[sizeClass].pop_back();
+            return AudioBlock(block);
+        }
+        allocations_++;
+    }
+
+    // Outside the lock; a failed allocation gives the count back
+    try {
+        size_t capacity = sizeClass < SIZE_CLASSES ? CLASS_BYTES[sizeClass] : bytes;
+        return AudioBlock(Allocate(this, sizeClass, capacity));
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        outstanding_--;
+        allocations_--;
+        throw;
+    }
+}
+
+void AudioBlockPool::Release(AudioBlockHeader* block) {
+    bool destroy = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        outstanding_--;
+
+        if (retired_ || block->sizeClass >= SIZE_CLASSES) {
+            Free(block);
+            destroy = retired_ && (outstanding_ == 0);
+        } else {
+            freeBlocks_[block->sizeClass].push_back(block);
+        }
+    }
+
+    if (destroy) {
+        delete this;
+    }
+}
+
+void AudioBlockPool::Retire() {
+    bool destroy = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        retired_ = true;
+        destroy = (outstanding_ == 0);
+    }
+
+    if (destroy) {
+        delete this;
+    }
+}
+
+size_t AudioBlockPool::OutstandingBlocks() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return outstanding_;
+}
+
+uint64_t AudioBlockPool::Allocations() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return allocations_;
+}
+
+} // namespace AudioCapture
\ No newline at end of file
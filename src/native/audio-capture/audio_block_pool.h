@@ -0,0 +1,152 @@
+#pragma once
+
+#include <mutex>
+#include <algorithm>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace AudioCapture {
+
+class AudioBlockPool;
+
+// Bookkeeping in front of every AudioBlockPool block; the payload follows it
+struct alignas(16) AudioBlockHeader {
+    AudioBlockPool* pool;
+    size_t sizeClass;  // AudioBlockPool::SIZE_CLASSES: heap block, freed on release
+    size_t capacity;   // Payload bytes
+};
+
+// Owning handle of one pooled block; returns it to its pool when destroyed
+class AudioBlock {
+public:
+    AudioBlock() = default;
+    ~AudioBlock() { Reset(); }
+
+    AudioBlock(AudioBlock&& other) noexcept : header_(other.header_) { other.header_ = nullptr; }
+    AudioBlock& operator=(AudioBlock&& other) noexcept;
+
+    AudioBlock(const AudioBlock&) = delete;
+    AudioBlock& operator=(const AudioBlock&) = delete;
+
+    uint8_t* Data() const { return header_ ? reinterpret_cast<uint8_t*>(header_ + 1) : nullptr; }
+    size_t Capacity() const { return header_ ? header_->capacity : 0; }
+    explicit operator bool() const { return header_ != nullptr; }
+
+    // Give the block back now
+    void Reset();
+
+    // Pass the block through an opaque pointer (e.g. a thread-safe function's
+    // data) and take ownership back on the other side
+    void* Release();
+    static AudioBlock Adopt(void* block) { return AudioBlock(static_cast<AudioBlockHeader*>(block)); }
+
+private:
+    friend class AudioBlockPool;
+    explicit AudioBlock(AudioBlockHeader* header) : header_(header) {}
+
+    AudioBlockHeader* header_ = nullptr;
+};
+
+// Byte blocks for per-packet copies and pull deliveries, in size classes
+// holding 10, 20 and 40 ms of 48 kHz stereo float32 plus a small header, and
+// one poll's worth of mono audio (MAX_CLASS_BYTES). Larger requests go to the
+// heap. Blocks are reused so steady-state delivery allocates nothing.
+//
+// Thread-safe, so blocks can be taken on the capture thread and returned from
+// JS (e.g. by an external ArrayBuffer's finalizer). The pool can outlive its
+// owner: after Retire() it deletes itself once the last block is returned.
+class AudioBlockPool {
+public:
+    static constexpr size_t SIZE_CLASSES = 4;
+    static constexpr size_t MAX_CLASS_BYTES = 64 * 1024;
+
+    explicit AudioBlockPool(size_t initialBlocksPerClass = 0);
+
+    AudioBlockPool(const AudioBlockPool&) = delete;
+    AudioBlockPool& operator=(const AudioBlockPool&) = delete;
+
+    // Block of at least bytes (allocates only if its class is exhausted)
+    AudioBlock Acquire(size_t bytes);
+
+    // Owner is done with the pool; it is destroyed once all blocks are returned
+    void Retire();
+
+    // Payload bytes of a size class
+    static size_t ClassBytes(size_t sizeClass);
+
+    // Blocks currently held through handles
+    size_t OutstandingBlocks() const;
+
+    // Blocks allocated because no pooled one fitted or was free
+    uint64_t Allocations() const;
+
+private:
+    friend class AudioBlock;
+    ~AudioBlockPool();
+
+    void Release(AudioBlockHeader* block);
+    static AudioBlockHeader* Allocate(AudioBlockPool* pool, size_t sizeClass, size_t capacity);
+    static void Free(AudioBlockHeader* block);
+
+    mutable std::mutex mutex_;
+    std::vector<AudioBlockHeader*> freeBlocks_[SIZE_CLASSES];
+    size_t outstanding_;
+    uint64_t allocations_;
+    bool retired_;
+};
+
+// Samples in a pooled block, with the container calls the buffers' callers
+// already use on vectors. Reading from the front only moves an offset.
+template <typename T>
+class PooledSamples {
+public:
+    // Copy count samples into a block from pool
+    void Assign(AudioBlockPool& pool, const T* samples, size_t count) {
+        Allocate(pool, count);
+        std::copy(samples, samples + count, data());
+    }
+
+    // Room for count samples; their values are unspecified
+    void Allocate(AudioBlockPool& pool, size_t count) {
+        block_ = pool.Acquire(count * sizeof(T));
+        offset_ = 0;
+        size_ = count;
+    }
+
+    // Keep only the first count samples
+    void Truncate(size_t count) { size_ = std::min(size_, count); }
+
+    // Drop count samples from the front
+    void ConsumeFront(size_t count) {
+        count = std::min(count, size_);
+        offset_ += count;
+        size_ -= count;
+    }
+
+    void clear() {
+        block_.Reset();
+        offset_ = 0;
+        size_ = 0;
+    }
+
+    T* data() { return reinterpret_cast<T*>(block_.Data()) + offset_; }
+    const T* data() const { return reinterpret_cast<const T*>(block_.Data()) + offset_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    T* begin() { return data(); }
+    T* end() { return data() + size_; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size_; }
+
+    T& operator[](size_t index) { return data()[index]; }
+    const T& operator[](size_t index) const { return data()[index]; }
+
+private:
+    AudioBlock block_;
+    size_t offset_ = 0;
+    size_t size_ = 0;
+};
+
+} // namespace AudioCapture
\ No newline at end of file
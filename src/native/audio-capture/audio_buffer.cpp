@@ -1,11 +1,69 @@
 #include "audio_buffer.h"
+#include "audio_capture_base.h"
 #include <algorithm>
 
 namespace AudioCapture {
 
-AudioBuffer::AudioBuffer(size_t maxSizeBytes)
-    : maxSizeBytes_(maxSizeBytes)
-    , currentSizeBytes_(0) {
+namespace {
+
+uint64_t FramesToMicros(uint64_t frames, uint32_t sampleRate) {
+    return sampleRate > 0 ? frames * 1000000 / sampleRate : 0;
+}
+
+} // namespace
+
+AudioBuffer::AudioBuffer(size_t maxSizeBytes, size_t float32RingSamples,
+                         std::shared_ptr<BroadcastFloatRing> float32Stream)
+    : blockPool_(new AudioBlockPool())
+    , maxSizeBytes_(maxSizeBytes)
+    , maxDurationMs_(0)
+    , trimmedChunks_(0)
+    , trimmedFloat32Samples_(0)
+    , currentSizeBytes_(0)
+    , pcm16Frames_(0)
+    , pcm16SampleRate_(0)
+    , float32Samples_(0)
+    , float32SampleRate_(0)
+    , float32Channels_(0)
+    , float32RingSamples_(float32RingSamples)
+    , float32RingTimestamp_(0)
+    , float32Stream_(std::move(float32Stream))
+    , useStream_(false) {
+    
+    if (float32Stream_) {
+        streamCursor_ = std::make_unique<BroadcastFloatRing::Cursor>(*float32Stream_);
+        useStream_ = true;
+    } else if (float32RingSamples > 0) {
+        float32Ring_ = std::make_unique<BroadcastFloatRing>(float32RingSamples);
+        float32Cursor_ = std::make_unique<BroadcastFloatRing::Cursor>(*float32Ring_);
+    }
+}
+
+AudioBuffer::~AudioBuffer() {
+    // Chunks still held by callers return their blocks later
+    chunks_.clear();
+    float32Chunks_.clear();
+    blockPool_->Retire();
+}
+
+void AudioBuffer::UseFloat32Stream(bool useStream) {
+    if (useStream && !float32Stream_) return;
+    
+    // Allocated before the switch is published, so the producer never sees it missing
+    if (!useStream && !float32Ring_ && float32RingSamples_ > 0) {
+        float32Ring_ = std::make_unique<BroadcastFloatRing>(float32RingSamples_);
+        float32Cursor_ = std::make_unique<BroadcastFloatRing::Cursor>(*float32Ring_);
+    }
+    
+    useStream_.store(useStream, std::memory_order_release);
+    Clear();
+}
+
+BroadcastFloatRing::Cursor* AudioBuffer::Float32Cursor() const {
+    if (useStream_.load(std::memory_order_acquire)) {
+        return streamCursor_.get();
+    }
+    return float32Cursor_.get();
 }
 
 void AudioBuffer::Push(const std::vector<int16_t>& audioData, uint32_t sampleRate, uint16_t channels) {
@@ -14,35 +72,52 @@ void AudioBuffer::Push(const std::vector<int16_t>& audioData, uint32_t sampleRat
     std::lock_guard<std::mutex> lock(mutex_);
     
     AudioChunk chunk;
-    chunk.data = audioData;
+    chunk.data.Assign(*blockPool_, audioData.data(), audioData.size());
     chunk.timestamp = GetCurrentTimestamp();
     chunk.sampleRate = sampleRate;
     chunk.channels = channels;
     
-    size_t chunkSize = GetChunkSize(chunk);
-    
+    AddPcm16(chunk);
     chunks_.push_back(std::move(chunk));
-    currentSizeBytes_ += chunkSize;
     
     // Remove old chunks if buffer is too large
     TrimToSize();
 }
 
 void AudioBuffer::PushFloat32(const std::vector<float>& audioData, uint32_t sampleRate, uint16_t channels) {
-    if (audioData.empty()) return;
+    PushFloat32(audioData.data(), audioData.size(), sampleRate, channels);
+}
+
+void AudioBuffer::PushFloat32(const float* samples, size_t count, uint32_t sampleRate, uint16_t channels) {
+    if (!samples || count == 0) return;
+    
+    float32SampleRate_.store(sampleRate, std::memory_order_relaxed);
+    float32Channels_.store(channels, std::memory_order_relaxed);
+    
+    if (useStream_.load(std::memory_order_acquire)) {
+        // The stream's producer already wrote these samples
+        float32RingTimestamp_.store(GetCurrentTimestamp(), std::memory_order_relaxed);
+        return;
+    }
+    
+    if (float32Ring_) {
+        // Wait-free path: no lock, no allocation on the capture thread
+        float32Ring_->Push(samples, count);
+        float32RingTimestamp_.store(GetCurrentTimestamp(), std::memory_order_relaxed);
+        return;
+    }
     
     std::lock_guard<std::mutex> lock(mutex_);
     
     Float32AudioChunk chunk;
-    chunk.data = audioData;
+    chunk.data.Assign(*blockPool_, samples, count);
     chunk.timestamp = GetCurrentTimestamp();
     chunk.sampleRate = sampleRate;
     chunk.channels = channels;
     
-    size_t chunkSize = audioData.size() * sizeof(float);
-    
     float32Chunks_.push_back(std::move(chunk));
-    currentSizeBytes_ += chunkSize;
+    currentSizeBytes_ += count * sizeof(float);
+    float32Samples_ += count;
     
     // Remove old chunks if buffer is too large
     TrimToSize();
@@ -56,7 +131,7 @@ bool AudioBuffer::Pop(AudioChunk& chunk) {
     }
     
     chunk = std::move(chunks_.front());
-    currentSizeBytes_ -= GetChunkSize(chunk);
+    RemovePcm16(chunk);
     chunks_.pop_front();
     
     return true;
@@ -71,7 +146,7 @@ std::vector<AudioChunk> AudioBuffer::PopMultiple(size_t maxChunks) {
     size_t count = 0;
     while (!chunks_.empty() && count < maxChunks) {
         AudioChunk chunk = std::move(chunks_.front());
-        currentSizeBytes_ -= GetChunkSize(chunk);
+        RemovePcm16(chunk);
         chunks_.pop_front();
         
         result.push_back(std::move(chunk));
@@ -81,7 +156,92 @@ std::vector<AudioChunk> AudioBuffer::PopMultiple(size_t maxChunks) {
     return result;
 }
 
+void AudioBuffer::PushSilence(size_t count, uint32_t sampleRate, uint16_t channels) {
+    if (count == 0) return;
+    
+    float32SampleRate_.store(sampleRate, std::memory_order_relaxed);
+    float32Channels_.store(channels, std::memory_order_relaxed);
+    
+    if (useStream_.load(std::memory_order_acquire)) {
+        float32RingTimestamp_.store(GetCurrentTimestamp(), std::memory_order_relaxed);
+        return;
+    }
+    
+    if (float32Ring_) {
+        float32Ring_->PushZeros(count);
+        float32RingTimestamp_.store(GetCurrentTimestamp(), std::memory_order_relaxed);
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    float32Samples_ += count;
+    
+    // Extend a trailing silence run rather than adding a chunk per packet
+    if (!float32Chunks_.empty() && float32Chunks_.back().silentSamples > 0 &&
+        float32Chunks_.back().sampleRate == sampleRate && float32Chunks_.back().channels == channels) {
+        float32Chunks_.back().silentSamples += count;
+    } else {
+        Float32AudioChunk chunk;
+        chunk.timestamp = GetCurrentTimestamp();
+        chunk.sampleRate = sampleRate;
+        chunk.channels = channels;
+        chunk.silentSamples = count;
+        float32Chunks_.push_back(std::move(chunk));
+    }
+    
+    TrimToSize();
+}
+
+size_t AudioBuffer::SkipFloat32Silence() {
+    if (BroadcastFloatRing::Cursor* cursor = Float32Cursor()) {
+        TrimRing(*cursor);
+        return cursor->Skip(cursor->SilentAvailable());
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    size_t skipped = 0;
+    while (!float32Chunks_.empty() && float32Chunks_.front().silentSamples > 0) {
+        skipped += float32Chunks_.front().silentSamples;
+        RemoveFloat32(float32Chunks_.front());
+        float32Chunks_.pop_front();
+    }
+    return skipped;
+}
+
 std::vector<Float32AudioChunk> AudioBuffer::PopMultipleFloat32(size_t maxChunks) {
+    if (BroadcastFloatRing::Cursor* cursor = Float32Cursor()) {
+        std::vector<Float32AudioChunk> result;
+        TrimRing(*cursor);
+        size_t available = cursor->Available();
+        if (maxChunks == 0 || available == 0) {
+            return result;
+        }
+        
+        Float32AudioChunk chunk;
+        chunk.sampleRate = float32SampleRate_.load(std::memory_order_relaxed);
+        chunk.channels = float32Channels_.load(std::memory_order_relaxed);
+        
+        // The ring only knows its last write: the first sample is everything
+        // buffered older than that
+        uint64_t lastPush = float32RingTimestamp_.load(std::memory_order_relaxed);
+        uint64_t buffered = FramesToMicros(available / std::max<uint16_t>(chunk.channels, 1), chunk.sampleRate);
+        chunk.timestamp = lastPush > buffered ? lastPush - buffered : 0;
+        
+        size_t silent = cursor->SilentAvailable();
+        if (silent > 0) {
+            chunk.silentSamples = cursor->Skip(silent);
+        } else {
+            chunk.data.Allocate(*blockPool_, available);
+            chunk.data.Truncate(cursor->Pop(chunk.data.data(), available));
+        }
+        
+        if (!chunk.data.empty() || chunk.silentSamples > 0) {
+            result.push_back(std::move(chunk));
+        }
+        return result;
+    }
+    
     std::lock_guard<std::mutex> lock(mutex_);
     
     std::vector<Float32AudioChunk> result;
@@ -89,8 +249,8 @@ std::vector<Float32AudioChunk> AudioBuffer::PopMultipleFloat32(size_t maxChunks)
     
     size_t count = 0;
     while (!float32Chunks_.empty() && count < maxChunks) {
+        RemoveFloat32(float32Chunks_.front());
         Float32AudioChunk chunk = std::move(float32Chunks_.front());
-        currentSizeBytes_ -= chunk.data.size() * sizeof(float);
         float32Chunks_.pop_front();
         
         result.push_back(std::move(chunk));
@@ -100,27 +260,114 @@ std::vector<Float32AudioChunk> AudioBuffer::PopMultipleFloat32(size_t maxChunks)
     return result;
 }
 
+size_t AudioBuffer::PopFloat32(float* dest, size_t maxSamples) {
+    if (!dest || maxSamples == 0) return 0;
+    
+    if (BroadcastFloatRing::Cursor* cursor = Float32Cursor()) {
+        TrimRing(*cursor);
+        return cursor->Pop(dest, maxSamples);
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    size_t copied = 0;
+    while (!float32Chunks_.empty() && copied < maxSamples) {
+        auto& chunk = float32Chunks_.front();
+        if (chunk.silentSamples > 0) {
+            // Silence runs are expanded only as far as they are read
+            size_t count = std::min(chunk.silentSamples, maxSamples - copied);
+            std::fill(dest + copied, dest + copied + count, 0.0f);
+            copied += count;
+            ConsumeFloat32(chunk, count);
+            if (chunk.silentSamples == 0) {
+                float32Chunks_.pop_front();
+            }
+            continue;
+        }
+        
+        size_t count = std::min(chunk.data.size(), maxSamples - copied);
+        std::copy(chunk.data.begin(), chunk.data.begin() + count, dest + copied);
+        copied += count;
+        
+        if (count == chunk.data.size()) {
+            RemoveFloat32(chunk);
+            float32Chunks_.pop_front();
+        } else {
+            // Keep the unread tail for the next call
+            ConsumeFloat32(chunk, count);
+        }
+    }
+    
+    return copied;
+}
+
+size_t AudioBuffer::GetBufferedFloat32Samples() const {
+    if (const BroadcastFloatRing::Cursor* cursor = Float32Cursor()) {
+        // What the next read returns once the ring is trimmed to the limit
+        size_t limit = Float32LimitSamples();
+        size_t available = cursor->Available();
+        return limit > 0 ? std::min(available, limit) : available;
+    }
+    
+    return float32Samples_.load(std::memory_order_relaxed);
+}
+
+uint64_t AudioBuffer::GetFloat32OverrunCount() const {
+    // Both cursors, so the count survives switching between them
+    uint64_t overruns = float32Cursor_ ? float32Cursor_->OverrunCount() : 0;
+    return overruns + (streamCursor_ ? streamCursor_->OverrunCount() : 0);
+}
+
+uint64_t AudioBuffer::GetFloat32BufferedAgeMicros() const {
+    uint64_t now = GetCurrentTimestamp();
+    
+    if (Float32Cursor()) {
+        // The ring only knows its last write; the oldest sample is the buffered
+        // duration older than that
+        uint64_t buffered = GetBufferedFloat32Micros();
+        if (buffered == 0) return 0;
+        
+        uint64_t lastPush = float32RingTimestamp_.load(std::memory_order_relaxed);
+        uint64_t sinceLastPush = now > lastPush ? now - lastPush : 0;
+        return sinceLastPush + buffered;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (float32Chunks_.empty()) return 0;
+    
+    uint64_t oldest = float32Chunks_.front().timestamp;
+    return now > oldest ? now - oldest : 0;
+}
+
 void AudioBuffer::Clear() {
+    if (float32Cursor_) {
+        float32Cursor_->Clear();
+    }
+    if (streamCursor_) {
+        streamCursor_->Clear();
+    }
+    
     std::lock_guard<std::mutex> lock(mutex_);
     chunks_.clear();
     float32Chunks_.clear();
     currentSizeBytes_ = 0;
+    pcm16Frames_ = 0;
+    float32Samples_ = 0;
 }
 
 size_t AudioBuffer::GetSize() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return currentSizeBytes_;
+    size_t ringBytes = Float32Cursor() ? GetBufferedFloat32Samples() * sizeof(float) : 0;
+    return currentSizeBytes_.load(std::memory_order_relaxed) + ringBytes;
 }
 
 bool AudioBuffer::IsEmpty() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return chunks_.empty();
+    return pcm16Frames_.load(std::memory_order_relaxed) == 0 && GetBufferedFloat32Samples() == 0;
 }
 
 float AudioBuffer::GetUsagePercentage() const {
     std::lock_guard<std::mutex> lock(mutex_);
     if (maxSizeBytes_ == 0) return 0.0f;
-    return static_cast<float>(currentSizeBytes_) / static_cast<float>(maxSizeBytes_);
+    return static_cast<float>(GetSize()) / static_cast<float>(maxSizeBytes_);
 }
 
 void AudioBuffer::SetMaxSize(size_t maxSizeBytes) {
@@ -129,40 +376,131 @@ void AudioBuffer::SetMaxSize(size_t maxSizeBytes) {
     TrimToSize();
 }
 
-uint64_t AudioBuffer::GetBufferedDurationMs() const {
+void AudioBuffer::SetMaxDuration(uint32_t milliseconds) {
     std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (chunks_.empty()) return 0;
-    
-    uint64_t totalSamples = 0;
-    uint32_t avgSampleRate = 0;
-    
-    for (const auto& chunk : chunks_) {
-        totalSamples += chunk.data.size() / chunk.channels;
-        avgSampleRate = chunk.sampleRate; // Use last sample rate
-    }
-    
-    if (avgSampleRate == 0) return 0;
-    
-    return (totalSamples * 1000) / avgSampleRate;
+    maxDurationMs_.store(milliseconds, std::memory_order_relaxed);
+    TrimToSize();
+}
+
+uint64_t AudioBuffer::GetBufferedDurationMs() const {
+    return std::max(GetBufferedPcm16Micros(), GetBufferedFloat32Micros()) / 1000;
+}
+
+uint64_t AudioBuffer::GetBufferedPcm16Micros() const {
+    return FramesToMicros(pcm16Frames_.load(std::memory_order_relaxed),
+                          pcm16SampleRate_.load(std::memory_order_relaxed));
+}
+
+uint64_t AudioBuffer::GetBufferedFloat32Micros() const {
+    uint16_t channels = std::max<uint16_t>(float32Channels_.load(std::memory_order_relaxed), 1);
+    return FramesToMicros(GetBufferedFloat32Samples() / channels,
+                          float32SampleRate_.load(std::memory_order_relaxed));
 }
 
 size_t AudioBuffer::GetChunkSize(const AudioChunk& chunk) const {
     return sizeof(AudioChunk) + (chunk.data.size() * sizeof(int16_t));
 }
 
+void AudioBuffer::AddPcm16(const AudioChunk& chunk) {
+    currentSizeBytes_ += GetChunkSize(chunk);
+    pcm16Frames_ += chunk.data.size() / std::max<uint16_t>(chunk.channels, 1);
+    pcm16SampleRate_.store(chunk.sampleRate, std::memory_order_relaxed);
+}
+
+void AudioBuffer::RemovePcm16(const AudioChunk& chunk) {
+    currentSizeBytes_ -= GetChunkSize(chunk);
+    pcm16Frames_ -= chunk.data.size() / std::max<uint16_t>(chunk.channels, 1);
+}
+
+void AudioBuffer::RemoveFloat32(const Float32AudioChunk& chunk) {
+    currentSizeBytes_ -= chunk.data.size() * sizeof(float);
+    float32Samples_ -= chunk.data.size() + chunk.silentSamples;
+}
+
+void AudioBuffer::ConsumeFloat32(Float32AudioChunk& chunk, size_t samples) {
+    // Silence runs hold no bytes and only shorten
+    if (chunk.silentSamples > 0) {
+        samples = std::min(samples, chunk.silentSamples);
+        chunk.silentSamples -= samples;
+    } else {
+        samples = std::min(samples, chunk.data.size());
+        currentSizeBytes_ -= samples * sizeof(float);
+        chunk.data.ConsumeFront(samples);
+    }
+    float32Samples_ -= samples;
+}
+
+size_t AudioBuffer::Float32LimitSamples() const {
+    uint32_t limitMs = maxDurationMs_.load(std::memory_order_relaxed);
+    if (limitMs == 0) return 0;
+    
+    uint32_t sampleRate = float32SampleRate_.load(std::memory_order_relaxed);
+    uint16_t channels = std::max<uint16_t>(float32Channels_.load(std::memory_order_relaxed), 1);
+    return std::max<size_t>(static_cast<size_t>(sampleRate) * channels * limitMs / 1000, 1);
+}
+
 void AudioBuffer::TrimToSize() {
-    while (currentSizeBytes_ > maxSizeBytes_ && !chunks_.empty()) {
-        const auto& oldestChunk = chunks_.front();
-        currentSizeBytes_ -= GetChunkSize(oldestChunk);
-        chunks_.pop_front();
+    // Duration limit, per format; the oldest audio goes first
+    uint32_t limitMs = maxDurationMs_.load(std::memory_order_relaxed);
+    if (limitMs > 0) {
+        uint64_t limitMicros = static_cast<uint64_t>(limitMs) * 1000;
+        while (!chunks_.empty() && GetBufferedPcm16Micros() > limitMicros) {
+            RemovePcm16(chunks_.front());
+            chunks_.pop_front();
+            trimmedChunks_.fetch_add(1, std::memory_order_relaxed);
+        }
+        
+        size_t limitSamples = Float32LimitSamples();
+        while (!float32Chunks_.empty() && float32Samples_ > limitSamples) {
+            auto& front = float32Chunks_.front();
+            size_t excess = float32Samples_ - limitSamples;
+            size_t frontSamples = front.data.size() + front.silentSamples;
+            if (front.silentSamples > 0 && frontSamples > excess) {
+                // Only shorten a silence run; it costs nothing to keep the rest
+                ConsumeFloat32(front, excess);
+                trimmedFloat32Samples_.fetch_add(excess, std::memory_order_relaxed);
+                break;
+            }
+            RemoveFloat32(front);
+            float32Chunks_.pop_front();
+            trimmedChunks_.fetch_add(1, std::memory_order_relaxed);
+            trimmedFloat32Samples_.fetch_add(frontSamples, std::memory_order_relaxed);
+        }
+    }
+    
+    // Byte limit across both formats: drop whichever front chunk is older
+    while (currentSizeBytes_ > maxSizeBytes_ && (!chunks_.empty() || !float32Chunks_.empty())) {
+        bool dropPcm16 = float32Chunks_.empty() ||
+            (!chunks_.empty() && chunks_.front().timestamp <= float32Chunks_.front().timestamp);
+        if (dropPcm16) {
+            RemovePcm16(chunks_.front());
+            chunks_.pop_front();
+        } else {
+            auto& front = float32Chunks_.front();
+            size_t frontSamples = front.data.size() + front.silentSamples;
+            RemoveFloat32(front);
+            float32Chunks_.pop_front();
+            trimmedFloat32Samples_.fetch_add(frontSamples, std::memory_order_relaxed);
+        }
+        trimmedChunks_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AudioBuffer::TrimRing(BroadcastFloatRing::Cursor& cursor) {
+    // The ring is already bounded by its capacity; the duration limit drops
+    // the oldest samples here, before a read, so the reader sees the newest
+    size_t limit = Float32LimitSamples();
+    if (limit == 0) return;
+    
+    size_t available = cursor.Available();
+    if (available > limit) {
+        size_t skipped = cursor.Skip(available - limit);
+        trimmedFloat32Samples_.fetch_add(skipped, std::memory_order_relaxed);
     }
 }
 
 uint64_t AudioBuffer::GetCurrentTimestamp() const {
-    return std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::steady_clock::now().time_since_epoch()
-    ).count();
+    return MonotonicMicros();
 }
 
 } // namespace AudioCapture
\ No newline at end of file
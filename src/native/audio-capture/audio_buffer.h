@@ -4,28 +4,44 @@
 #include <mutex>
 #include <deque>
 #include <cstdint>
-#include <chrono>
+#include <atomic>
+#include <memory>
+#include "audio_block_pool.h"
+#include "broadcast_ring.h"
 
 namespace AudioCapture {
 
+// Chunk samples live in blocks of the buffer's pool, which stays alive while
+// popped chunks still hold them
 struct AudioChunk {
-    std::vector<int16_t> data;
+    PooledSamples<int16_t> data;
     uint64_t timestamp;
     uint32_t sampleRate;
     uint16_t channels;
 };
 
 struct Float32AudioChunk {
-    std::vector<float> data;
+    PooledSamples<float> data;
     uint64_t timestamp;
     uint32_t sampleRate;
     uint16_t channels;
+    size_t silentSamples = 0;  // Silence run: this many zero samples, data stays empty
 };
 
+// Buffered audio for pull consumers. Frame, sample and byte totals are kept
+// as running counters, so level, duration and size queries are O(1) and
+// lock-free. Both formats are bounded by the byte limit and an optional
+// duration limit; the oldest audio is trimmed first.
 class AudioBuffer {
 public:
-    explicit AudioBuffer(size_t maxSizeBytes = 5 * 1024 * 1024); // 5MB default
-    ~AudioBuffer() = default;
+    // float32RingSamples > 0 backs float32 audio with a lock-free ring of that
+    // capacity instead of the mutex-guarded chunk deque. With float32Stream the
+    // buffer starts out reading that shared ring through its own cursor, and
+    // its own ring is only allocated once UseFloat32Stream(false) needs it.
+    explicit AudioBuffer(size_t maxSizeBytes = 5 * 1024 * 1024, // 5MB default
+                         size_t float32RingSamples = 0,
+                         std::shared_ptr<BroadcastFloatRing> float32Stream = nullptr);
+    ~AudioBuffer();
     
     // Add audio data to buffer
     void Push(const std::vector<int16_t>& audioData, uint32_t sampleRate, uint16_t channels);
@@ -33,6 +49,21 @@ public:
     // Add float32 audio data to buffer
     void PushFloat32(const std::vector<float>& audioData, uint32_t sampleRate, uint16_t channels);
     
+    // Same, from a caller-owned buffer (allocation-free in ring mode)
+    void PushFloat32(const float* samples, size_t count, uint32_t sampleRate, uint16_t channels);
+    
+    // Add count zero samples; the chunk deque stores only the duration
+    void PushSilence(size_t count, uint32_t sampleRate, uint16_t channels);
+    
+    // Consumer thread: read float32 audio from the shared stream (its producer
+    // writes the samples; PushFloat32/PushSilence then only record the rate and
+    // arrival time) or from this buffer's own ring. Clears the float32 audio.
+    void UseFloat32Stream(bool useStream);
+    bool UsesFloat32Stream() const { return useStream_.load(std::memory_order_acquire); }
+    
+    // Drop the silence at the front of the float32 audio, returns samples skipped
+    size_t SkipFloat32Silence();
+    
     // Get latest audio chunk (non-blocking)
     bool Pop(AudioChunk& chunk);
     
@@ -40,15 +71,41 @@ public:
     std::vector<AudioChunk> PopMultiple(size_t maxChunks = 10);
     
     // Get multiple float32 chunks for batch processing
+    // (ring-backed buffers return everything available as one chunk; silence
+    // comes back as chunks with silentSamples set and no data)
     std::vector<Float32AudioChunk> PopMultipleFloat32(size_t maxChunks = 10);
     
+    // Copy up to maxSamples of buffered float32 audio into dest, returns samples copied
+    size_t PopFloat32(float* dest, size_t maxSamples);
+    
+    // Number of float32 samples currently buffered (within the duration limit)
+    size_t GetBufferedFloat32Samples() const;
+    
+    // Number of PCM16 frames currently buffered
+    size_t GetBufferedPcm16Frames() const { return pcm16Frames_.load(std::memory_order_relaxed); }
+    
+    // Whether float32 audio is backed by the lock-free ring
+    bool UsesFloat32Ring() const { return float32RingSamples_ > 0 || float32Stream_ != nullptr; }
+    
+    // Float32 samples lost because the consumer fell behind the ring
+    uint64_t GetFloat32OverrunCount() const;
+    
+    // Age in microseconds of the oldest buffered float32 sample (0 when empty)
+    uint64_t GetFloat32BufferedAgeMicros() const;
+    
+    // Chunks (either format) discarded by TrimToSize because a limit was reached
+    uint64_t GetTrimmedChunkCount() const { return trimmedChunks_.load(std::memory_order_relaxed); }
+    
+    // Float32 samples discarded to stay within the limits (deque and ring)
+    uint64_t GetTrimmedFloat32Samples() const { return trimmedFloat32Samples_.load(std::memory_order_relaxed); }
+    
     // Clear all buffered data
     void Clear();
     
     // Get current buffer size in bytes
     size_t GetSize() const;
     
-    // Check if buffer is empty
+    // Check if buffer is empty (both formats)
     bool IsEmpty() const;
     
     // Get buffer usage percentage (0.0 to 1.0)
@@ -57,23 +114,72 @@ public:
     // Set maximum buffer size
     void SetMaxSize(size_t maxSizeBytes);
     
-    // Get buffered duration in milliseconds
+    // Keep at most this much audio per format; 0 removes the limit. The ring
+    // is trimmed by its consumer, on the next read.
+    void SetMaxDuration(uint32_t milliseconds);
+    uint32_t GetMaxDuration() const { return maxDurationMs_.load(std::memory_order_relaxed); }
+    
+    // Get buffered duration in milliseconds (the longer of the two formats)
     uint64_t GetBufferedDurationMs() const;
+    
+    // Per-format buffered duration in microseconds
+    uint64_t GetBufferedPcm16Micros() const;
+    uint64_t GetBufferedFloat32Micros() const;
 
 private:
     mutable std::mutex mutex_;
     std::deque<AudioChunk> chunks_;
     std::deque<Float32AudioChunk> float32Chunks_;
+    AudioBlockPool* blockPool_;  // Chunk storage; retired with the buffer
     size_t maxSizeBytes_;
-    size_t currentSizeBytes_;
+    std::atomic<uint32_t> maxDurationMs_;
+    std::atomic<uint64_t> trimmedChunks_;
+    std::atomic<uint64_t> trimmedFloat32Samples_;
+    
+    // Running totals of the chunk deques: written under mutex_, read without it.
+    // Durations use the latest rate per format; callers clear the buffer when
+    // they change rates.
+    std::atomic<size_t> currentSizeBytes_;
+    std::atomic<size_t> pcm16Frames_;
+    std::atomic<uint32_t> pcm16SampleRate_;
+    std::atomic<size_t> float32Samples_;
+    std::atomic<uint32_t> float32SampleRate_;  // Deque and ring
+    std::atomic<uint16_t> float32Channels_;    // Deque and ring
+    
+    // Lock-free float32 backing (single producer: capture thread, single consumer: JS thread)
+    size_t float32RingSamples_;
+    std::unique_ptr<BroadcastFloatRing> float32Ring_;
+    std::unique_ptr<BroadcastFloatRing::Cursor> float32Cursor_;
+    std::atomic<uint64_t> float32RingTimestamp_;
+    
+    // Shared stream read through this buffer's cursor instead of float32Ring_
+    std::shared_ptr<BroadcastFloatRing> float32Stream_;
+    std::unique_ptr<BroadcastFloatRing::Cursor> streamCursor_;
+    std::atomic<bool> useStream_;
+    
+    // Cursor of the ring currently read from (nullptr: chunk deque)
+    BroadcastFloatRing::Cursor* Float32Cursor() const;
     
     // Helper to calculate chunk size in bytes
     size_t GetChunkSize(const AudioChunk& chunk) const;
     
-    // Remove oldest chunks if buffer is full
+    // Bookkeeping for a chunk entering or leaving the deques (mutex_ held)
+    void AddPcm16(const AudioChunk& chunk);
+    void RemovePcm16(const AudioChunk& chunk);
+    void RemoveFloat32(const Float32AudioChunk& chunk);
+    void ConsumeFloat32(Float32AudioChunk& chunk, size_t samples);  // Front of a chunk that stays
+    
+    // Remove oldest chunks if buffer is full or over the duration limit (mutex_ held)
     void TrimToSize();
     
-    // Get current timestamp
+    // Consumer side of the duration limit for the ring
+    void TrimRing(BroadcastFloatRing::Cursor& cursor);
+    
+    // Float32 samples allowed by the duration limit at the current rate (0: unlimited)
+    size_t Float32LimitSamples() const;
+
+    
+    // Get current timestamp (MonotonicMicros, same clock as AudioSample)
     uint64_t GetCurrentTimestamp() const;
 };
 
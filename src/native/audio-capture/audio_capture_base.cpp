@@ -1,4 +1,7 @@
 #include "audio_capture_base.h"
+#include "audio_simd_kernels.h"
+#include "file_replay_audio_capture.h"
+#include "multi_source_audio_capture.h"
 
 #ifdef WINDOWS_PLATFORM
 #include "windows_audio_capture.h"
@@ -10,6 +13,73 @@
 
 namespace AudioCapture {
 
+void AudioCaptureBase::DispatchAudio(const AudioSampleView& view) {
+    // Digital zeros become a silence run, whichever backend produced them
+    AudioSampleView packet = view;
+    if (!packet.silent && packet.data && packet.size > 0 && SimdKernels::IsZero(packet.data, packet.size)) {
+        packet.silent = true;
+    }
+    if (packet.silent) {
+        packet.data = nullptr;
+    }
+    
+    // Fit the device clock; once locked, its line replaces the raw timestamps
+    if (packet.captureTimestamp != 0) {
+        if (packet.format.sampleRate != clock_.NominalRate()) {
+            clock_.Reset(packet.format.sampleRate);
+        }
+        clock_.Update(clockFrames_, packet.captureTimestamp);
+        if (clock_.Locked()) {
+            packet.captureTimestamp = clock_.HostMicrosAt(clockFrames_);
+        }
+    }
+    clockFrames_ += packet.frameCount;
+    
+    if (audioViewCallback_) {
+        audioViewCallback_(packet);
+        return;
+    }
+    
+    if (!audioCallback_) return;
+    
+    // The vector keeps its capacity, so only growth allocates
+    if (packet.silent) {
+        ownedSample_.data.assign(packet.size, 0);
+    } else {
+        ownedSample_.data.assign(packet.data, packet.data + packet.size);
+    }
+    ownedSample_.format = packet.format;
+    ownedSample_.timestamp = packet.timestamp;
+    ownedSample_.captureTimestamp = packet.captureTimestamp;
+    ownedSample_.frameCount = packet.frameCount;
+    ownedSample_.silent = packet.silent;
+    audioCallback_(ownedSample_);
+}
+
+void AudioCaptureBase::SetDeviceChangeCallback(DeviceChangeCallback callback) {
+    std::lock_guard<std::mutex> lock(deviceChangeMutex_);
+    deviceChangeCallback_ = std::move(callback);
+}
+
+void AudioCaptureBase::NotifyDevicesChanged() {
+    std::lock_guard<std::mutex> lock(deviceChangeMutex_);
+    if (deviceChangeCallback_) {
+        deviceChangeCallback_();
+    }
+}
+
+void AudioCaptureBase::SetCaptureStoppedCallback(CaptureStoppedCallback callback) {
+    std::lock_guard<std::mutex> lock(captureStoppedMutex_);
+    captureStoppedCallback_ = std::move(callback);
+}
+
+void AudioCaptureBase::NotifyCaptureStopped() {
+    std::lock_guard<std::mutex> lock(captureStoppedMutex_);
+    if (captureStoppedCallback_) {
+        captureStoppedCallback_();
+    }
+}
+
 std::unique_ptr<AudioCaptureBase> CreateAudioCapture() {
 #ifdef WINDOWS_PLATFORM
     return std::make_unique<WindowsAudioCapture>();
@@ -22,4 +92,25 @@ std::unique_ptr<AudioCaptureBase> CreateAudioCapture() {
 #endif
 }
 
+CaptureBackend BackendForDevice(const std::string& deviceId) {
+    if (IsFileReplayDevice(deviceId)) {
+        return CaptureBackend::FileReplay;
+    }
+    if (IsMultiSourceDevice(deviceId)) {
+        return CaptureBackend::MultiSource;
+    }
+    return CaptureBackend::Platform;
+}
+
+std::unique_ptr<AudioCaptureBase> CreateAudioCapture(const std::string& deviceId) {
+    switch (BackendForDevice(deviceId)) {
+        case CaptureBackend::FileReplay:
+            return std::make_unique<FileReplayAudioCapture>();
+        case CaptureBackend::MultiSource:
+            return std::make_unique<MultiSourceAudioCapture>();
+        default:
+            return CreateAudioCapture();
+    }
+}
+
 } // namespace AudioCapture
\ No newline at end of file
@@ -1,13 +1,18 @@
 #pragma once
 
+#include "clock_drift_estimator.h"
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <cstdint>
 #include <string>
 
 namespace AudioCapture {
 
+struct ConversionKernels;
+
 struct AudioFormat {
     uint32_t sampleRate;
     uint16_t channels;
@@ -17,18 +22,83 @@ struct AudioFormat {
     bool isFloat = false;         // Whether samples are floating-point format
     bool isNonInterleaved = false; // Whether channels are in separate planes
     uint32_t formatFlags = 0;     // Raw format flags for debugging
+    const ConversionKernels* kernels = nullptr; // FormatKernels::Resolve(); null until resolved
 };
 
+// Capture clock shared by every backend and buffer: steady-clock microseconds
+inline uint64_t MonotonicMicros() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
 struct AudioSample {
     std::vector<uint8_t> data;
     AudioFormat format;
-    uint64_t timestamp;
+    uint64_t timestamp;           // MonotonicMicros() at delivery
+    uint64_t captureTimestamp = 0; // MonotonicMicros() the first sample was captured, by the device clock; 0 if unknown
     uint32_t frameCount;
+    bool silent = false;          // Digital silence; data is empty unless expanded
+};
+
+// Non-owning view of a captured packet, usually straight over the OS buffer.
+// Only valid for the duration of the callback; use ToSample() to keep it.
+struct AudioSampleView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;              // Bytes at data
+    AudioFormat format = {};
+    uint64_t timestamp = 0;       // MonotonicMicros() at delivery
+    uint64_t captureTimestamp = 0; // MonotonicMicros() the first sample was captured, by the device clock; 0 if unknown
+    uint32_t frameCount = 0;
+    bool silent = false;          // Digital silence: data may be null, size still gives the duration
+    
+    // Capture time of the first sample: the device's when the backend reports
+    // one, otherwise estimated as the packet's duration before delivery
+    uint64_t CaptureMicros() const {
+        if (captureTimestamp != 0) return captureTimestamp;
+        uint64_t duration = format.sampleRate > 0
+            ? static_cast<uint64_t>(frameCount) * 1000000 / format.sampleRate : 0;
+        return timestamp > duration ? timestamp - duration : 0;
+    }
+    
+    // Owning copy for consumers that retain the packet; silence is zero-filled
+    // unless expandSilence is false
+    AudioSample ToSample(bool expandSilence = true) const {
+        AudioSample sample;
+        if (silent) {
+            if (expandSilence) sample.data.assign(size, 0);
+        } else if (data && size > 0) {
+            sample.data.assign(data, data + size);
+        }
+        sample.format = format;
+        sample.timestamp = timestamp;
+        sample.captureTimestamp = captureTimestamp;
+        sample.frameCount = frameCount;
+        sample.silent = silent;
+        return sample;
+    }
+};
+
+// Stream format a backend should ask the OS for; 0 keeps the backend's default.
+// Letting the OS mixer resample and downmix is cheaper than converting every
+// packet ourselves.
+struct CaptureFormatRequest {
+    uint32_t sampleRate = 0;
+    uint16_t channels = 0;
 };
 
 // Callback for audio data
 using AudioCallback = std::function<void(const AudioSample& sample)>;
 
+// Callback for audio data without a per-packet copy
+using AudioViewCallback = std::function<void(const AudioSampleView& view)>;
+
+// Callback for device list or default device changes, on an OS notification thread
+using DeviceChangeCallback = std::function<void()>;
+
+// Callback for a backend stopping without Stop() (replay end, stream failure),
+// on the backend's own thread
+using CaptureStoppedCallback = std::function<void()>;
+
 // Base class for platform-specific audio capture implementations
 class AudioCaptureBase {
 public:
@@ -46,6 +116,9 @@ public:
     // Set the callback for audio data
     virtual void SetAudioCallback(AudioCallback callback) = 0;
     
+    // Set the zero-copy callback; takes precedence over the AudioCallback
+    virtual void SetAudioViewCallback(AudioViewCallback callback) = 0;
+    
     // Get current audio format
     virtual AudioFormat GetFormat() const = 0;
     
@@ -55,24 +128,79 @@ public:
     // Set the device to capture from (optional, default uses system default)
     virtual bool SetDevice(const std::string& deviceId) = 0;
     
-    // Get current volume level (0.0 to 1.0)
-    virtual float GetVolumeLevel() const = 0;
-    
     // Get last error message
     virtual std::string GetLastError() const = 0;
     
-    // Set noise gate threshold (0.0 = pass all audio, 0.02 = default gate)
-    virtual void SetNoiseGateThreshold(float threshold) = 0;
+    // Set the capture buffer duration in ms (lower = less latency, more wakeups).
+    // Only while stopped; false if unsupported, capturing or out of range
+    virtual bool SetBufferDuration(uint32_t /*milliseconds*/) { return false; }
+    
+    // Ask for a capture format. Only while stopped; the backend picks the
+    // closest format its OS API delivers and GetFormat() reports what was
+    // granted. False if unsupported, capturing or out of range.
+    virtual bool SetCaptureFormat(const CaptureFormatRequest& /*request*/) { return false; }
+    
+    // Device sample clock against MonotonicMicros(), fitted from the capture
+    // timestamps; never locks on backends that report none
+    ClockDriftReading ClockDrift() const { return clock_.Read(); }
+    
+    // Set the callback for device changes; backends without OS notifications
+    // never call it. Once this returns, the previous callback is not running.
+    void SetDeviceChangeCallback(DeviceChangeCallback callback);
+    
+    // Set the callback for capture stopping on its own. Stop() is still
+    // needed to release the backend. Once this returns, the previous
+    // callback is not running.
+    void SetCaptureStoppedCallback(CaptureStoppedCallback callback);
 
 protected:
+    // Hand a packet to the view callback, or copy it into the reused owning
+    // sample for an AudioCallback. Called from the backend's capture thread.
+    // Device capture timestamps are replaced by the fitted device clock, so
+    // consumers see sample-accurate times without the OS's jitter.
+    void DispatchAudio(const AudioSampleView& view);
+    
+    bool HasAudioCallback() const {
+        return audioViewCallback_ || audioCallback_;
+    }
+    
+    // Report that the device list or the default device changed
+    void NotifyDevicesChanged();
+    
+    // Report that capture ended without Stop()
+    void NotifyCaptureStopped();
+    
     AudioCallback audioCallback_;
+    AudioViewCallback audioViewCallback_;
     AudioFormat currentFormat_;
     bool isCapturing_ = false;
     std::string lastError_;
-    float currentVolumeLevel_ = 0.0f;
+    
+private:
+    AudioSample ownedSample_;  // Reused for AudioCallback consumers
+    ClockDriftEstimator clock_;  // Capture thread
+    uint64_t clockFrames_ = 0;   // Frames dispatched: the stream's sample clock
+    std::mutex deviceChangeMutex_;  // Held while the device change callback runs
+    DeviceChangeCallback deviceChangeCallback_;
+    std::mutex captureStoppedMutex_;  // Held while the stopped callback runs
+    CaptureStoppedCallback captureStoppedCallback_;
 };
 
 // Factory function to create platform-specific implementation
 std::unique_ptr<AudioCaptureBase> CreateAudioCapture();
 
+// Backend implementations a device id can select
+enum class CaptureBackend {
+    Platform,     // OS capture (WASAPI, ScreenCaptureKit, PulseAudio)
+    FileReplay,   // "file:" ids
+    MultiSource   // "mix:" / "tracks:" ids
+};
+
+CaptureBackend BackendForDevice(const std::string& deviceId);
+
+// Backend that serves deviceId: "file:" ids replay a recording, "mix:" and
+// "tracks:" ids combine several sources, anything else is a platform device.
+// The caller still selects it with SetDevice(deviceId).
+std::unique_ptr<AudioCaptureBase> CreateAudioCapture(const std::string& deviceId);
+
 } // namespace AudioCapture
\ No newline at end of file
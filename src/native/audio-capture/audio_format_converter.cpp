@@ -1,4 +1,6 @@
 #include "audio_format_converter.h"
+#include "audio_format_kernels.h"
+#include "audio_simd_kernels.h"
 #include <algorithm>
 #include <cmath>
 #include <numeric>
@@ -6,259 +8,202 @@
 
 namespace AudioCapture {
 
-std::vector<float> AudioFormatConverter::ConvertToMonoFloat32(const AudioSample& input) {
-    std::vector<float> result;
-    
-    if (input.data.empty()) {
-        return result;
+namespace {
+
+// Kernels the backend resolved for this format, or a lookup for formats built
+// without FormatKernels::Resolve()
+const ConversionKernels* KernelsFor(const AudioFormat& format) {
+    return format.kernels ? format.kernels : FormatKernels::Select(format);
+}
+
+} // namespace
+
+size_t AudioFormatConverter::GetMonoFrameCount(const AudioFormat& format, size_t byteLength) {
+    const ConversionKernels* kernels = KernelsFor(format);
+    if (!kernels) {
+        // Unsupported formats produce nothing
+        return 0;
     }
     
-    // Debug output disabled for production
-    // fprintf(stderr, "FMT  bps=%u  ch=%u  isFloat=%d  nonInter=%d  bytes=%zu\n",
-    //         input.format.bitsPerSample,
-    //         input.format.channels,
-    //         input.format.isFloat,
-    //         input.format.isNonInterleaved,
-    //         input.data.size());
-    
-    // Step 1: Convert raw bytes to float samples based on input format
-    std::vector<float> samples;
-    
-    if (input.format.bitsPerSample == 16) {
-        // 16-bit to float conversion
-        size_t sampleCount = input.data.size() / 2;
-        samples.reserve(sampleCount);
-        
-        const int16_t* int16Samples = reinterpret_cast<const int16_t*>(input.data.data());
-        for (size_t i = 0; i < sampleCount; ++i) {
-            samples.push_back(int16Samples[i] / 32768.0f);
-        }
-        
-    } else if (input.format.bitsPerSample == 32) {
-        // 32-bit samples - check if float or int using format flag
-        size_t frameCount = input.data.size() / (4 * input.format.channels);
-        size_t totalSamples = frameCount * input.format.channels;
-        
-        if (input.format.isFloat) {
-            const float* floatData = reinterpret_cast<const float*>(input.data.data());
-            
-            if (input.format.isNonInterleaved && input.format.channels == 2) {
-                // Non-interleaved stereo: L L L... R R R...
-                samples.reserve(totalSamples);
-                const float* leftChannel = floatData;
-                const float* rightChannel = floatData + frameCount;
-                
-                // Convert to interleaved format
-                for (size_t frame = 0; frame < frameCount; frame++) {
-                    samples.push_back(leftChannel[frame]);
-                    samples.push_back(rightChannel[frame]);
-                }
-            } else {
-                // Interleaved or mono - copy directly
-                samples.assign(floatData, floatData + totalSamples);
-            }
-        } else {
-            // 32-bit int to float conversion
-            const int32_t* int32Samples = reinterpret_cast<const int32_t*>(input.data.data());
-            samples.reserve(totalSamples);
-            
-            for (size_t i = 0; i < totalSamples; ++i) {
-                samples.push_back(int32Samples[i] / 2147483648.0f);
-            }
-        }
-    } else {
-        // Unsupported format
-        return result;
+    return byteLength / (kernels->bytesPerSample * format.channels);
+}
+
+size_t AudioFormatConverter::GetMonoFrameCount(const AudioSample& input) {
+    return GetMonoFrameCount(input.format, input.data.size());
+}
+
+size_t AudioFormatConverter::ConvertToMonoFloat32(
+    const uint8_t* data,
+    size_t byteLength,
+    const AudioFormat& format,
+    float* output,
+    size_t capacity) {
+    
+    const ConversionKernels* kernels = KernelsFor(format);
+    if (!data || !output || !kernels) {
+        return 0;
     }
     
-    // Step 2: Convert to mono if needed (no resampling - keep 48kHz!)
-    if (input.format.channels > 1) {
-        size_t frameCount = samples.size() / input.format.channels;
-        result.reserve(frameCount);
-        
-        for (size_t frame = 0; frame < frameCount; frame++) {
-            float sum = 0.0f;
-            for (uint16_t ch = 0; ch < input.format.channels; ch++) {
-                sum += samples[frame * input.format.channels + ch];
-            }
-            result.push_back(sum / input.format.channels);
-        }
-    } else {
-        result = std::move(samples);
+    // Planes are totalFrames apart when the format is non-interleaved
+    const size_t totalFrames = byteLength / (kernels->bytesPerSample * format.channels);
+    const size_t frameCount = std::min(totalFrames, capacity);
+    if (frameCount == 0) {
+        return 0;
     }
     
-    // Debug output disabled for production
-    // fprintf(stderr, "MONO frames produced: %zu\n", result.size());
+    // Single fused pass: sample conversion and downmix write straight into the
+    // output, no intermediate interleaved buffer (keep 48kHz, no resampling)
+    kernels->toMonoFloat32(data, frameCount, format.channels, totalFrames, output);
+    
+    return frameCount;
+}
+
+size_t AudioFormatConverter::ConvertToMonoFloat32(
+    const AudioSample& input,
+    float* output,
+    size_t capacity) {
     
+    return ConvertToMonoFloat32(input.data.data(), input.data.size(), input.format, output, capacity);
+}
+
+std::vector<float> AudioFormatConverter::ConvertToMonoFloat32(const AudioSample& input) {
+    std::vector<float> result(GetMonoFrameCount(input));
+    result.resize(ConvertToMonoFloat32(input, result.data(), result.size()));
     return result;
 }
 
-std::vector<int16_t> AudioFormatConverter::ConvertToPCM16(
+size_t AudioFormatConverter::GetPCM16SampleCount(const AudioFormat& format, size_t byteLength) {
+    // Whole frames only
+    return GetMonoFrameCount(format, byteLength) * format.channels;
+}
+
+size_t AudioFormatConverter::ConvertToPCM16(
     const AudioSample& input,
-    uint32_t targetSampleRate,
+    int16_t* output,
+    size_t capacity,
     uint16_t targetChannels) {
     
-    std::vector<int16_t> result;
-    
-    if (input.data.empty()) {
-        return result;
+    const AudioFormat& format = input.format;
+    const ConversionKernels* kernels = KernelsFor(format);
+    if (input.data.empty() || !output || !kernels) {
+        return 0;
     }
     
-    // Step 1: Convert raw bytes to int16 samples based on input format
-    std::vector<int16_t> samples;
+    const uint16_t channels = format.channels;
+    const size_t totalFrames = input.data.size() / (kernels->bytesPerSample * channels);
     
-    if (input.format.bitsPerSample == 16) {
-        // Already 16-bit, just copy
-        size_t sampleCount = input.data.size() / 2;
-        samples.resize(sampleCount);
-        std::memcpy(samples.data(), input.data.data(), input.data.size());
-        
-    } else if (input.format.bitsPerSample == 32) {
-        // Check if it's float or int32 using the format flag
-        size_t frameCount = input.data.size() / (4 * input.format.channels);
-        size_t totalSamples = frameCount * input.format.channels;
-        
-        if (input.format.isFloat) {
-            // Convert 32-bit float samples
-            
-            const float* floatData = reinterpret_cast<const float*>(input.data.data());
-            
-            if (input.format.isNonInterleaved && input.format.channels == 2) {
-                // Non-interleaved stereo: L L L... R R R...
-                samples.reserve(totalSamples);
-                const float* leftChannel = floatData;
-                const float* rightChannel = floatData + frameCount;
-                
-                // Convert to interleaved format
-                for (size_t frame = 0; frame < frameCount; frame++) {
-                    // Convert left sample
-                    float leftSample = std::fmax(-1.0f, std::fmin(1.0f, leftChannel[frame]));
-                    int16_t leftInt16 = static_cast<int16_t>(std::lrintf(leftSample * 32768.0f));
-                    samples.push_back(leftInt16);
-                    
-                    // Convert right sample
-                    float rightSample = std::fmax(-1.0f, std::fmin(1.0f, rightChannel[frame]));
-                    int16_t rightInt16 = static_cast<int16_t>(std::lrintf(rightSample * 32768.0f));
-                    samples.push_back(rightInt16);
-                }
-            } else {
-                // Interleaved or mono - use existing path
-                samples = FloatToInt16(floatData, totalSamples);
-            }
-        } else {
-            // Convert 32-bit int samples
-            const int32_t* int32Samples = reinterpret_cast<const int32_t*>(input.data.data());
-            samples = Int32ToInt16(int32Samples, totalSamples);
-        }
-        
-    } else if (input.format.bitsPerSample == 24) {
-        // 24-bit to 16-bit conversion
-        size_t sampleCount = input.data.size() / 3;
-        samples.reserve(sampleCount);
-        
-        for (size_t i = 0; i < sampleCount; ++i) {
-            int32_t sample24 = 0;
-            // Assuming little-endian 24-bit
-            sample24 = (input.data[i * 3]) |
-                      (input.data[i * 3 + 1] << 8) |
-                      (input.data[i * 3 + 2] << 16);
-            
-            // Sign extend if negative
-            if (sample24 & 0x800000) {
-                sample24 |= 0xFF000000;
-            }
-            
-            // Convert to 16-bit
-            int16_t sample16 = static_cast<int16_t>(sample24 >> 8);
-            samples.push_back(sample16);
-        }
-    } else {
-        // Unsupported format, return empty
-        return result;
+    // Downmix while converting; each sample becomes int16 before averaging
+    if (channels > 1 && targetChannels == 1) {
+        size_t frameCount = std::min(totalFrames, capacity);
+        kernels->toMonoPcm16(input.data.data(), frameCount, channels, totalFrames, output);
+        return frameCount;
     }
     
-    // Step 2: Convert to mono if needed
-    if (input.format.channels > 1 && targetChannels == 1) {
-        samples = StereoToMono(samples);
-    }
+    // Native channel count, interleaved (planar input is interleaved here)
+    size_t frameCount = std::min(totalFrames, capacity / channels);
+    kernels->toInterleavedPcm16(input.data.data(), frameCount, channels, totalFrames, output);
+    
+    // Resampling and the 8kHz low-pass are skipped: GPT-4o accepts the native
+    // rate, and the filter removed too much frequency content
+    return frameCount * channels;
+}
+
+std::vector<int16_t> AudioFormatConverter::ConvertToPCM16(
+    const AudioSample& input,
+    uint32_t targetSampleRate,
+    uint16_t targetChannels) {
     
-    // Step 3: Skip resampling to avoid distortion - keep native sample rate
-    // GPT-4o accepts various sample rates including 48kHz
+    (void)targetSampleRate;  // Native sample rate is kept
     
-    // Step 4: Skip low-pass filter to preserve audio quality
-    // The 8kHz filter was removing too much frequency content
+    std::vector<int16_t> result(GetPCM16SampleCount(input.format, input.data.size()));
+    result.resize(ConvertToPCM16(input, result.data(), result.size(), targetChannels));
+    return result;
+}
+
+size_t AudioFormatConverter::FloatToInt16(
+    const float* samples,
+    size_t count,
+    int16_t* output,
+    size_t capacity) {
+    
+    if (!samples || !output) {
+        return 0;
+    }
     
-    return samples;
+    // Clamp, scale, round to nearest and saturate in one vectorized pass
+    count = std::min(count, capacity);
+    SimdKernels::FloatToInt16(samples, output, count);
+    return count;
 }
 
 std::vector<int16_t> AudioFormatConverter::FloatToInt16(
     const float* samples, 
     size_t count) {
     
-    std::vector<int16_t> result;
-    result.reserve(count);
-    
-    for (size_t i = 0; i < count; ++i) {
-        float sample = samples[i];
-        
-        // Clamp to [-1.0, 1.0]
-        sample = std::max(-1.0f, std::min(1.0f, sample));
-        
-        // Convert to 16-bit with symmetric scaling and proper rounding
-        sample = std::fmax(-1.0f, std::fmin(1.0f, sample));
-        int16_t intSample = static_cast<int16_t>(std::lrintf(sample * 32768.0f));
-        result.push_back(intSample);
-    }
-    
+    std::vector<int16_t> result(count);
+    FloatToInt16(samples, count, result.data(), count);
     return result;
 }
 
-std::vector<int16_t> AudioFormatConverter::Int32ToInt16(
-    const int32_t* samples, 
-    size_t count) {
-    
-    std::vector<int16_t> result;
-    result.reserve(count);
+size_t AudioFormatConverter::Int32ToInt16(
+    const int32_t* samples,
+    size_t count,
+    int16_t* output,
+    size_t capacity) {
+    
+    if (!samples || !output) {
+        return 0;
+    }
     
+    count = std::min(count, capacity);
     for (size_t i = 0; i < count; ++i) {
         // Convert from 32-bit to 16-bit
         // Many systems use 24-bit data in 32-bit containers, so shift by 16 bits
         // But also handle full 32-bit range by scaling down
-        int32_t sample32 = samples[i];
-        
-        // Scale from 32-bit range to 16-bit range
-        int16_t sample16 = static_cast<int16_t>(sample32 >> 16);
-        result.push_back(sample16);
+        output[i] = static_cast<int16_t>(samples[i] >> 16);
     }
     
+    return count;
+}
+
+std::vector<int16_t> AudioFormatConverter::Int32ToInt16(
+    const int32_t* samples, 
+    size_t count) {
+    
+    std::vector<int16_t> result(count);
+    Int32ToInt16(samples, count, result.data(), count);
     return result;
 }
 
-std::vector<int16_t> AudioFormatConverter::Resample(
-    const std::vector<int16_t>& input,
+size_t AudioFormatConverter::Resample(
+    const int16_t* input,
+    size_t count,
     uint32_t inputSampleRate,
-    uint32_t outputSampleRate) {
+    uint32_t outputSampleRate,
+    int16_t* output,
+    size_t capacity) {
     
-    if (inputSampleRate == outputSampleRate) {
-        return input;
+    if (!input || !output || count == 0 || inputSampleRate == 0 || outputSampleRate == 0) {
+        return 0;
     }
     
-    if (input.empty()) {
-        return std::vector<int16_t>();
+    if (inputSampleRate == outputSampleRate) {
+        count = std::min(count, capacity);
+        if (output != input) {
+            std::memmove(output, input, count * sizeof(int16_t));
+        }
+        return count;
     }
     
     double ratio = static_cast<double>(inputSampleRate) / outputSampleRate;
-    size_t outputLength = static_cast<size_t>(input.size() / ratio);
-    
-    std::vector<int16_t> output;
-    output.reserve(outputLength);
+    size_t outputLength = std::min(static_cast<size_t>(count / ratio), capacity);
     
     for (size_t i = 0; i < outputLength; ++i) {
         double sourceIndex = i * ratio;
         size_t index = static_cast<size_t>(sourceIndex);
         
-        if (index >= input.size() - 1) {
-            output.push_back(input.back());
+        if (index >= count - 1) {
+            output[i] = input[count - 1];
         } else {
             double fraction = sourceIndex - index;
             float interpolated = LinearInterpolate(
@@ -266,32 +211,60 @@ std::vector<int16_t> AudioFormatConverter::Resample(
                 static_cast<float>(input[index + 1]),
                 static_cast<float>(fraction)
             );
-            output.push_back(static_cast<int16_t>(interpolated));
+            output[i] = static_cast<int16_t>(interpolated);
         }
     }
     
-    return output;
+    return outputLength;
 }
 
-std::vector<int16_t> AudioFormatConverter::StereoToMono(
-    const std::vector<int16_t>& stereoData) {
+std::vector<int16_t> AudioFormatConverter::Resample(
+    const std::vector<int16_t>& input,
+    uint32_t inputSampleRate,
+    uint32_t outputSampleRate) {
     
-    if (stereoData.size() % 2 != 0) {
-        // Invalid stereo data
+    if (inputSampleRate == outputSampleRate) {
+        return input;
+    }
+    
+    if (input.empty() || outputSampleRate == 0) {
         return std::vector<int16_t>();
     }
     
-    std::vector<int16_t> monoData;
-    monoData.reserve(stereoData.size() / 2);
+    double ratio = static_cast<double>(inputSampleRate) / outputSampleRate;
+    std::vector<int16_t> output(static_cast<size_t>(input.size() / ratio));
+    output.resize(Resample(input.data(), input.size(), inputSampleRate, outputSampleRate,
+                           output.data(), output.size()));
+    return output;
+}
+
+size_t AudioFormatConverter::StereoToMono(
+    const int16_t* stereoData,
+    size_t count,
+    int16_t* output,
+    size_t capacity) {
+    
+    if (!stereoData || !output || count % 2 != 0) {
+        // Invalid stereo data
+        return 0;
+    }
     
-    for (size_t i = 0; i < stereoData.size(); i += 2) {
+    size_t frames = std::min(count / 2, capacity);
+    for (size_t i = 0; i < frames; ++i) {
         // Average left and right channels without clipping
-        int32_t left = stereoData[i];
-        int32_t right = stereoData[i + 1];
-        int16_t mono = static_cast<int16_t>((left + right) >> 1);
-        monoData.push_back(mono);
+        int32_t left = stereoData[i * 2];
+        int32_t right = stereoData[i * 2 + 1];
+        output[i] = static_cast<int16_t>((left + right) >> 1);
     }
     
+    return frames;
+}
+
+std::vector<int16_t> AudioFormatConverter::StereoToMono(
+    const std::vector<int16_t>& stereoData) {
+    
+    std::vector<int16_t> monoData(stereoData.size() / 2);
+    monoData.resize(StereoToMono(stereoData.data(), stereoData.size(), monoData.data(), monoData.size()));
     return monoData;
 }
 
@@ -312,13 +285,17 @@ float AudioFormatConverter::CalculateRMSLevel(
     return static_cast<float>(std::sqrt(mean));
 }
 
-std::vector<int16_t> AudioFormatConverter::ApplyLowPassFilter(
-    const std::vector<int16_t>& input,
+size_t AudioFormatConverter::ApplyLowPassFilter(
+    const int16_t* input,
+    size_t count,
+    int16_t* output,
+    size_t capacity,
     float cutoffFreq,
     uint32_t sampleRate) {
     
-    if (input.empty()) {
-        return std::vector<int16_t>();
+    count = std::min(count, capacity);
+    if (!input || !output || count == 0) {
+        return 0;
     }
     
     // Simple single-pole IIR low-pass filter
@@ -326,19 +303,26 @@ std::vector<int16_t> AudioFormatConverter::ApplyLowPassFilter(
     float dt = 1.0f / sampleRate;
     float alpha = dt / (rc + dt);
     
-    std::vector<int16_t> output;
-    output.reserve(input.size());
-    
     float previous = static_cast<float>(input[0]);
-    output.push_back(input[0]);
+    output[0] = input[0];
     
-    for (size_t i = 1; i < input.size(); ++i) {
+    for (size_t i = 1; i < count; ++i) {
         float current = static_cast<float>(input[i]);
         float filtered = previous + alpha * (current - previous);
         previous = filtered;
-        output.push_back(static_cast<int16_t>(filtered));
+        output[i] = static_cast<int16_t>(filtered);
     }
     
+    return count;
+}
+
+std::vector<int16_t> AudioFormatConverter::ApplyLowPassFilter(
+    const std::vector<int16_t>& input,
+    float cutoffFreq,
+    uint32_t sampleRate) {
+    
+    std::vector<int16_t> output(input.size());
+    ApplyLowPassFilter(input.data(), input.size(), output.data(), output.size(), cutoffFreq, sampleRate);
     return output;
 }
 
@@ -20,6 +20,83 @@ public:
         uint16_t targetChannels = 1         // Mono
     );
     
+    // Allocation-free variants: write into caller-provided output and return the
+    // number of samples written (frames for mono output), truncated to capacity.
+    // Safe to call on the real-time capture path.
+    
+    // Mono frames ConvertToMonoFloat32 produces for this input (size for output)
+    static size_t GetMonoFrameCount(const AudioFormat& format, size_t byteLength);
+    static size_t GetMonoFrameCount(const AudioSample& input);
+    
+    // Convert raw interleaved/planar bytes to 48kHz mono float32 with the
+    // format's cached kernels (FormatKernels::Resolve)
+    static size_t ConvertToMonoFloat32(
+        const uint8_t* data,
+        size_t byteLength,
+        const AudioFormat& format,
+        float* output,
+        size_t capacity
+    );
+    static size_t ConvertToMonoFloat32(
+        const AudioSample& input,
+        float* output,
+        size_t capacity
+    );
+    
+    // Interleaved int16 samples ConvertToPCM16 needs room for (before downmix)
+    static size_t GetPCM16SampleCount(const AudioFormat& format, size_t byteLength);
+    
+    // Convert to PCM16, downmixed to mono when targetChannels is 1 and
+    // interleaved at the native channel count otherwise; capacity covering
+    // GetPCM16SampleCount() always holds the whole packet
+    static size_t ConvertToPCM16(
+        const AudioSample& input,
+        int16_t* output,
+        size_t capacity,
+        uint16_t targetChannels = 1
+    );
+    
+    static size_t FloatToInt16(
+        const float* samples,
+        size_t count,
+        int16_t* output,
+        size_t capacity
+    );
+    
+    static size_t Int32ToInt16(
+        const int32_t* samples,
+        size_t count,
+        int16_t* output,
+        size_t capacity
+    );
+    
+    // Output may alias input (in-place downmix)
+    static size_t StereoToMono(
+        const int16_t* stereoData,
+        size_t count,
+        int16_t* output,
+        size_t capacity
+    );
+    
+    static size_t Resample(
+        const int16_t* input,
+        size_t count,
+        uint32_t inputSampleRate,
+        uint32_t outputSampleRate,
+        int16_t* output,
+        size_t capacity
+    );
+    
+    // Output may alias input (in-place filtering)
+    static size_t ApplyLowPassFilter(
+        const int16_t* input,
+        size_t count,
+        int16_t* output,
+        size_t capacity,
+        float cutoffFreq = 8000.0f,
+        uint32_t sampleRate = 24000
+    );
+    
     // Convert float samples to int16
     static std::vector<int16_t> FloatToInt16(
         const float* samples, 
@@ -0,0 +1,283 @@
+#include "audio_format_kernels.h"
+#include "audio_simd_kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+namespace AudioCapture {
+namespace FormatKernels {
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Sample types: raw little-endian bytes -> float in [-1, 1) / int16
+// (unaligned loads through memcpy; they compile to plain moves)
+// ---------------------------------------------------------------------------
+
+struct Int16Sample {
+    using Raw = int16_t;
+    static constexpr uint16_t BYTES = 2;
+
+    static int16_t Load(const uint8_t* p) {
+        int16_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+    static float ToFloat(const uint8_t* p) { return Load(p) * (1.0f / 32768.0f); }
+    static int16_t ToInt16(const uint8_t* p) { return Load(p); }
+};
+
+// Packed 3-byte samples
+struct Int24Sample {
+    using Raw = void;
+    static constexpr uint16_t BYTES = 3;
+
+    static int32_t Load(const uint8_t* p) {
+        // Sign comes from the top byte
+        return static_cast<int32_t>(p[0]) |
+               (static_cast<int32_t>(p[1]) << 8) |
+               (static_cast<int32_t>(static_cast<int8_t>(p[2])) << 16);
+    }
+    static float ToFloat(const uint8_t* p) { return Load(p) * (1.0f / 8388608.0f); }
+    static int16_t ToInt16(const uint8_t* p) { return static_cast<int16_t>(Load(p) >> 8); }
+};
+
+struct Int32Sample {
+    using Raw = int32_t;
+    static constexpr uint16_t BYTES = 4;
+
+    static int32_t Load(const uint8_t* p) {
+        int32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+    static float ToFloat(const uint8_t* p) { return static_cast<float>(Load(p)) * (1.0f / 2147483648.0f); }
+    // 24-in-32 and full-range 32-bit both keep their top 16 bits
+    static int16_t ToInt16(const uint8_t* p) { return static_cast<int16_t>(Load(p) >> 16); }
+};
+
+struct Float32Sample {
+    using Raw = float;
+    static constexpr uint16_t BYTES = 4;
+
+    static float Load(const uint8_t* p) {
+        float value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+    static float ToFloat(const uint8_t* p) { return Load(p); }
+    // Same rounding and saturation as SimdKernels::FloatToInt16
+    static int16_t ToInt16(const uint8_t* p) {
+        float scaled = std::min(std::max(Load(p), -1.0f), 1.0f) * 32768.0f;
+        long value = std::lrintf(scaled);
+        return static_cast<int16_t>(value > 32767 ? 32767 : value);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Kernels: Channels == 0 takes the count at run time, anything else fixes it
+// so the per-frame channel loop unrolls
+// ---------------------------------------------------------------------------
+
+template <typename Sample, bool Planar, uint16_t Channels>
+struct Kernel {
+    static constexpr size_t BLOCK_SAMPLES = 1024;
+
+    static uint16_t Count(uint16_t channels) {
+        return Channels ? Channels : channels;
+    }
+
+    static const uint8_t* At(const uint8_t* data, size_t frame, uint16_t channel,
+                             uint16_t channels, size_t planeStride) {
+        size_t index = Planar ? channel * planeStride + frame : frame * channels + channel;
+        return data + index * Sample::BYTES;
+    }
+
+    // The SIMD kernels already cover these shapes: interleaved mono/stereo of
+    // every type except packed 24-bit, and planar float at any channel count
+    static constexpr bool SIMD_MONO =
+        (Planar && std::is_same<Sample, Float32Sample>::value) ||
+        (!Planar && (Channels == 1 || Channels == 2) && !std::is_same<Sample, Int24Sample>::value);
+
+    static void SimdMonoFloat32(const uint8_t* data, size_t frames, uint16_t channels,
+                                size_t planeStride, float* output) {
+        using Raw = typename Sample::Raw;
+        const Raw* samples = reinterpret_cast<const Raw*>(data);
+        if constexpr (Planar) {
+            SimdKernels::PlanarFloatToMono(samples, frames, channels, planeStride, output);
+        } else if constexpr (std::is_same<Sample, Int16Sample>::value) {
+            SimdKernels::InterleavedInt16ToMono(samples, frames, Channels, output);
+        } else if constexpr (std::is_same<Sample, Int32Sample>::value) {
+            SimdKernels::InterleavedInt32ToMono(samples, frames, Channels, output);
+        } else {
+            SimdKernels::InterleavedFloatToMono(samples, frames, Channels, output);
+        }
+    }
+
+    static void ToMonoFloat32(const uint8_t* data, size_t frames, uint16_t channels,
+                              size_t planeStride, float* output) {
+        if constexpr (SIMD_MONO) {
+            SimdMonoFloat32(data, frames, channels, planeStride, output);
+        } else {
+            const uint16_t count = Count(channels);
+            const float inverse = 1.0f / count;
+            for (size_t frame = 0; frame < frames; ++frame) {
+                float sum = 0.0f;
+                for (uint16_t ch = 0; ch < count; ++ch) {
+                    sum += Sample::ToFloat(At(data, frame, ch, count, planeStride));
+                }
+                output[frame] = sum * inverse;
+            }
+        }
+    }
+
+    // Average interleaved int16 frames; stereo keeps the exact (l + r) >> 1
+    // StereoToMono used
+    static void DownmixPcm16(const int16_t* input, size_t frames, uint16_t channels, int16_t* output) {
+        const uint16_t count = Count(channels);
+        for (size_t frame = 0; frame < frames; ++frame) {
+            int32_t sum = 0;
+            for (uint16_t ch = 0; ch < count; ++ch) {
+                sum += input[frame * count + ch];
+            }
+            output[frame] = static_cast<int16_t>(Channels == 2 ? sum >> 1 : sum / count);
+        }
+    }
+
+    static void ToMonoPcm16(const uint8_t* data, size_t frames, uint16_t channels,
+                            size_t planeStride, int16_t* output) {
+        const uint16_t count = Count(channels);
+        if constexpr (!Planar && std::is_same<Sample, Int16Sample>::value) {
+            DownmixPcm16(reinterpret_cast<const int16_t*>(data), frames, count, output);
+        } else if constexpr (Planar) {
+            // Accumulate a block of every plane, converted with the mono kernel
+            int16_t plane[BLOCK_SAMPLES];
+            int32_t sums[BLOCK_SAMPLES];
+            for (size_t frame = 0; frame < frames; frame += BLOCK_SAMPLES) {
+                size_t length = std::min(BLOCK_SAMPLES, frames - frame);
+                std::fill(sums, sums + length, 0);
+                for (uint16_t ch = 0; ch < count; ++ch) {
+                    Kernel<Sample, false, 1>::ToInterleavedPcm16(
+                        At(data, frame, ch, count, planeStride), length, 1, 0, plane);
+                    for (size_t i = 0; i < length; ++i) {
+                        sums[i] += plane[i];
+                    }
+                }
+                for (size_t i = 0; i < length; ++i) {
+                    output[frame + i] = static_cast<int16_t>(Channels == 2 ? sums[i] >> 1 : sums[i] / count);
+                }
+            }
+        } else {
+            // Convert a block of frames on the stack (vectorized where the
+            // interleaved kernel is), then average it
+            int16_t block[BLOCK_SAMPLES];
+            const size_t blockFrames = BLOCK_SAMPLES / count;
+            if (blockFrames == 0) {
+                for (size_t frame = 0; frame < frames; ++frame) {
+                    int32_t sum = 0;
+                    for (uint16_t ch = 0; ch < count; ++ch) {
+                        sum += Sample::ToInt16(At(data, frame, ch, count, 0));
+                    }
+                    output[frame] = static_cast<int16_t>(sum / count);
+                }
+                return;
+            }
+
+            for (size_t frame = 0; frame < frames; frame += blockFrames) {
+                size_t length = std::min(blockFrames, frames - frame);
+                ToInterleavedPcm16(At(data, frame, 0, count, 0), length, count, 0, block);
+                DownmixPcm16(block, length, count, output + frame);
+            }
+        }
+    }
+
+    static void ToInterleavedPcm16(const uint8_t* data, size_t frames, uint16_t channels,
+                                   size_t planeStride, int16_t* output) {
+        const uint16_t count = Count(channels);
+        const size_t total = frames * count;
+        if constexpr (!Planar && std::is_same<Sample, Int16Sample>::value) {
+            std::memcpy(output, data, total * sizeof(int16_t));
+        } else if constexpr (!Planar && std::is_same<Sample, Float32Sample>::value) {
+            SimdKernels::FloatToInt16(reinterpret_cast<const float*>(data), output, total);
+        } else if constexpr (!Planar) {
+            for (size_t i = 0; i < total; ++i) {
+                output[i] = Sample::ToInt16(data + i * Sample::BYTES);
+            }
+        } else {
+            // Convert a block of each plane with the mono kernel, then interleave
+            int16_t plane[BLOCK_SAMPLES];
+            for (size_t frame = 0; frame < frames; frame += BLOCK_SAMPLES) {
+                size_t length = std::min(BLOCK_SAMPLES, frames - frame);
+                for (uint16_t ch = 0; ch < count; ++ch) {
+                    Kernel<Sample, false, 1>::ToInterleavedPcm16(
+                        At(data, frame, ch, count, planeStride), length, 1, 0, plane);
+                    for (size_t i = 0; i < length; ++i) {
+                        output[(frame + i) * count + ch] = plane[i];
+                    }
+                }
+            }
+        }
+    }
+};
+
+template <typename Sample, bool Planar, uint16_t Channels>
+constexpr ConversionKernels MakeKernels() {
+    using K = Kernel<Sample, Planar, Channels>;
+    return { &K::ToMonoFloat32, &K::ToMonoPcm16, &K::ToInterleavedPcm16, Sample::BYTES };
+}
+
+// Specialized channel counts first, runtime count last
+template <typename Sample, bool Planar>
+const ConversionKernels* SelectLayout(uint16_t channels) {
+    static const ConversionKernels table[] = {
+        MakeKernels<Sample, Planar, 1>(),
+        MakeKernels<Sample, Planar, 2>(),
+        MakeKernels<Sample, Planar, 6>(),
+        MakeKernels<Sample, Planar, 8>(),
+        MakeKernels<Sample, Planar, 0>(),
+    };
+
+    switch (channels) {
+        case 1: return &table[0];
+        case 2: return &table[1];
+        case 6: return &table[2];
+        case 8: return &table[3];
+        default: return &table[4];
+    }
+}
+
+template <typename Sample>
+const ConversionKernels* SelectSample(bool planar, uint16_t channels) {
+    return planar ? SelectLayout<Sample, true>(channels) : SelectLayout<Sample, false>(channels);
+}
+
+} // namespace
+
+const ConversionKernels* Select(const AudioFormat& format) {
+    if (format.channels == 0) {
+        return nullptr;
+    }
+
+    // One plane is the same as interleaved mono
+    const bool planar = format.isNonInterleaved && format.channels > 1;
+
+    switch (format.bitsPerSample) {
+        case 16:
+            return SelectSample<Int16Sample>(planar, format.channels);
+        case 24:
+            return format.isFloat ? nullptr : SelectSample<Int24Sample>(planar, format.channels);
+        case 32:
+            return format.isFloat ? SelectSample<Float32Sample>(planar, format.channels)
+                                  : SelectSample<Int32Sample>(planar, format.channels);
+        default:
+            return nullptr;
+    }
+}
+
+void Resolve(AudioFormat& format) {
+    format.kernels = Select(format);
+}
+
+} // namespace FormatKernels
+} // namespace AudioCapture
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "audio_capture_base.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace AudioCapture {
+
+// Conversion entry points for one sample type, layout and channel count. Each
+// is a template instantiation with those fixed at compile time (1, 2, 6 and 8
+// channels; other counts use a runtime-count instantiation), and the common
+// shapes forward to the SIMD kernels. Chosen once per format, so converting a
+// packet does not branch on the format.
+struct ConversionKernels {
+    // Interleaved or planar frames -> mono float32 (channel average); planar
+    // planes start planeStride samples apart
+    void (*toMonoFloat32)(const uint8_t* data, size_t frames, uint16_t channels,
+                          size_t planeStride, float* output);
+
+    // Same, to PCM16: each sample is converted first, then averaged
+    void (*toMonoPcm16)(const uint8_t* data, size_t frames, uint16_t channels,
+                        size_t planeStride, int16_t* output);
+
+    // Frames -> interleaved PCM16, channels samples per frame
+    void (*toInterleavedPcm16)(const uint8_t* data, size_t frames, uint16_t channels,
+                               size_t planeStride, int16_t* output);
+
+    uint16_t bytesPerSample;
+};
+
+namespace FormatKernels {
+
+// Kernels for format, or nullptr if its sample format is unsupported (16, 24
+// or 32-bit integer, 32-bit float). Static storage, so formats can keep it.
+const ConversionKernels* Select(const AudioFormat& format);
+
+// Cache Select(format) in format.kernels; backends call this whenever they
+// detect or change a format
+void Resolve(AudioFormat& format);
+
+} // namespace FormatKernels
+} // namespace AudioCapture
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include "audio_metrics.h"
+
+namespace AudioCapture {
+
+namespace {
+
+// Index of the highest set bit (value > 0)
+inline size_t HighestBit(uint64_t value) {
+    size_t bit = 0;
+    while (value >>= 1) {
+        bit++;
+    }
+    return bit;
+}
+
+void AtomicMax(std::atomic<uint64_t>& target, uint64_t value) {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (value > current &&
+           !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+} // namespace
+
+size_t LatencyHistogram::BucketIndex(uint64_t micros) {
+    if (micros < kSubBuckets) {
+        return static_cast<size_t>(micros);
+    }
+
+    const uint64_t maxValue = (uint64_t(1) << (kMaxMagnitude + 1)) - 1;
+    if (micros > maxValue) {
+        micros = maxValue;
+    }
+
+    // Leading bit selects the magnitude, the next kSubBucketBits the sub-bucket
+    size_t magnitude = HighestBit(micros);
+    size_t shift = magnitude - kSubBucketBits;
+    size_t sub = static_cast<size_t>((micros >> shift) & (kSubBuckets - 1));
+    return kSubBuckets + shift * kSubBuckets + sub;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(size_t index) {
+    if (index < kSubBuckets) {
+        return index;
+    }
+
+    size_t shift = (index - kSubBuckets) / kSubBuckets;
+    uint64_t sub = (index - kSubBuckets) % kSubBuckets;
+    uint64_t lower = (kSubBuckets + sub) << shift;
+    return lower + (uint64_t(1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t micros) {
+    buckets_[BucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(micros, std::memory_order_relaxed);
+    AtomicMax(max_, micros);
+}
+
+double LatencyHistogram::Mean() const {
+    uint64_t count = Count();
+    if (count == 0) return 0.0;
+    return static_cast<double>(sum_.load(std::memory_order_relaxed)) / count;
+}
+
+uint64_t LatencyHistogram::Percentile(double quantile) const {
+    uint64_t count = Count();
+    if (count == 0) return 0;
+
+    if (quantile < 0.0) quantile = 0.0;
+    if (quantile > 1.0) quantile = 1.0;
+
+    // Rank of the quantile sample (1-based), then walk the buckets to it
+    uint64_t rank = static_cast<uint64_t>(quantile * count + 0.5);
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            // Never report more than what was actually observed
+            uint64_t bound = BucketUpperBound(i);
+            uint64_t max = Max();
+            return bound < max ? bound : max;
+        }
+    }
+    return Max();
+}
+
+void LatencyHistogram::Reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+AudioMetrics::AudioMetrics() {
+    for (auto& gauge : gauges_) {
+        gauge.store(0, std::memory_order_relaxed);
+    }
+    Reset();
+}
+
+void AudioMetrics::SetGauge(MetricGauge gauge, uint64_t value) {
+    gauges_[static_cast<size_t>(gauge)].store(value, std::memory_order_relaxed);
+    RaiseHighWater(gauge, value);
+}
+
+void AudioMetrics::AddGauge(MetricGauge gauge, int64_t delta) {
+    uint64_t value = gauges_[static_cast<size_t>(gauge)].fetch_add(
+        static_cast<uint64_t>(delta), std::memory_order_relaxed) + static_cast<uint64_t>(delta);
+    if (delta > 0) {
+        RaiseHighWater(gauge, value);
+    }
+}
+
+void AudioMetrics::RaiseHighWater(MetricGauge gauge, uint64_t value) {
+    AtomicMax(highWater_[static_cast<size_t>(gauge)], value);
+}
+
+void AudioMetrics::Reset() {
+    for (auto& stage : stages_) {
+        stage.Reset();
+    }
+    for (auto& counter : counters_) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < static_cast<size_t>(MetricGauge::Count); ++i) {
+        highWater_[i].store(gauges_[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+}
+
+const char* AudioMetrics::StageName(MetricStage stage) {
+    switch (stage) {
+        case MetricStage::CaptureToBuffer: return "captureToBuffer";
+        case MetricStage::BufferToJS:      return "bufferToJS";
+        case MetricStage::Conversion:      return "conversion";
+        case MetricStage::VAD:             return "vad";
+        case MetricStage::Features:        return "features";
+        case MetricStage::WorkerQueue:     return "workerQueue";
+        case MetricStage::CaptureLatency:  return "captureLatency";
+        default:                           return "unknown";
+    }
+}
+
+const char* AudioMetrics::CounterName(MetricCounter counter) {
+    switch (counter) {
+        case MetricCounter::Packets:            return "packets";
+        case MetricCounter::Frames:             return "frames";
+        case MetricCounter::RawCallbackDrops:   return "rawCallbackDrops";
+        case MetricCounter::PushSignalFailures: return "pushSignalFailures";
+        case MetricCounter::WorkerDrops:        return "workerDrops";
+        case MetricCounter::GatedPackets:       return "gatedPackets";
+        case MetricCounter::SilentPackets:      return "silentPackets";
+        default:                                return "unknown";
+    }
+}
+
+const char* AudioMetrics::GaugeName(MetricGauge gauge) {
+    switch (gauge) {
+        case MetricGauge::PullBufferedSamples: return "pullBufferedSamples";
+        case MetricGauge::PushBufferedSamples: return "pushBufferedSamples";
+        case MetricGauge::JSQueueDepth:        return "jsQueueDepth";
+        case MetricGauge::WorkerQueueDepth:    return "workerQueueDepth";
+        default:                               return "unknown";
+    }
+}
+
+} // namespace AudioCapture
\ No newline at end of file
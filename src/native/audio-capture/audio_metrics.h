@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace AudioCapture {
+
+// Log-linear latency histogram in microseconds (HDR-style: exact below 16us,
+// then 16 sub-buckets per power of two, so any percentile is within 6.25%).
+// Record() is wait-free and may run on any thread; readers see a snapshot
+// that is consistent enough for monitoring.
+class LatencyHistogram {
+public:
+    static constexpr size_t kSubBucketBits = 4;
+    static constexpr size_t kSubBuckets = size_t(1) << kSubBucketBits;
+    static constexpr size_t kMaxMagnitude = 31;  // values clamp to 2^32 - 1 us
+    static constexpr size_t kBucketCount = kSubBuckets + (kMaxMagnitude + 1 - kSubBucketBits) * kSubBuckets;
+
+    LatencyHistogram() { Reset(); }
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void Record(uint64_t micros);
+
+    uint64_t Count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t Max() const { return max_.load(std::memory_order_relaxed); }
+    double Mean() const;
+
+    // Upper bound of the bucket holding the given quantile (0.0 - 1.0)
+    uint64_t Percentile(double quantile) const;
+
+    void Reset();
+
+private:
+    static size_t BucketIndex(uint64_t micros);
+    static uint64_t BucketUpperBound(size_t index);
+
+    std::atomic<uint64_t> buckets_[kBucketCount];
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> max_;
+};
+
+// Timed pipeline stages
+enum class MetricStage : size_t {
+    CaptureToBuffer = 0,  // Backend delivery until the pull buffer holds the packet
+    BufferToJS,           // Queued audio until JS receives it
+    Conversion,           // Format conversion and consumer resampling
+    VAD,                  // Streaming VAD stage
+    Features,             // Spectral feature stage
+    WorkerQueue,          // Capture callback until the processing worker picks the packet up
+    CaptureLatency,       // Device capture of the first sample until backend delivery
+    Count
+};
+
+// Monotonic event counters
+enum class MetricCounter : size_t {
+    Packets = 0,          // Packets delivered by the backend
+    Frames,               // Frames delivered by the backend
+    RawCallbackDrops,     // Raw JS callbacks dropped on a full queue
+    PushSignalFailures,   // Push wakeups the JS queue refused
+    WorkerDrops,          // Packets dropped because the processing worker queue was full
+    GatedPackets,         // Packets the noise gate dropped
+    SilentPackets,        // Digital-silence packets carried as a duration only
+    Count
+};
+
+// Levels tracked with their high-water mark
+enum class MetricGauge : size_t {
+    PullBufferedSamples = 0,  // Float32 samples waiting for getBuffered*/read*
+    PushBufferedSamples,      // Samples waiting in the push ring
+    JSQueueDepth,             // Deliveries queued on the JS thread
+    WorkerQueueDepth,         // Packets waiting for the processing worker
+    Count
+};
+
+// Lock-free metrics of one capture pipeline, cheap enough to stay on:
+// updates are relaxed atomics, reads happen on demand from JS.
+class AudioMetrics {
+public:
+    AudioMetrics();
+
+    AudioMetrics(const AudioMetrics&) = delete;
+    AudioMetrics& operator=(const AudioMetrics&) = delete;
+
+    LatencyHistogram& Stage(MetricStage stage) { return stages_[static_cast<size_t>(stage)]; }
+    const LatencyHistogram& Stage(MetricStage stage) const { return stages_[static_cast<size_t>(stage)]; }
+
+    void Add(MetricCounter counter, uint64_t value = 1) {
+        counters_[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+    }
+    uint64_t Get(MetricCounter counter) const {
+        return counters_[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+    }
+
+    // Set a level (single writer per gauge) or move it by delta (any thread)
+    void SetGauge(MetricGauge gauge, uint64_t value);
+    void AddGauge(MetricGauge gauge, int64_t delta);
+    uint64_t GetGauge(MetricGauge gauge) const {
+        return gauges_[static_cast<size_t>(gauge)].load(std::memory_order_relaxed);
+    }
+    uint64_t GetHighWater(MetricGauge gauge) const {
+        return highWater_[static_cast<size_t>(gauge)].load(std::memory_order_relaxed);
+    }
+
+    // Clear histograms, counters and high-water marks (current levels stay)
+    void Reset();
+
+    static const char* StageName(MetricStage stage);
+    static const char* CounterName(MetricCounter counter);
+    static const char* GaugeName(MetricGauge gauge);
+
+private:
+    void RaiseHighWater(MetricGauge gauge, uint64_t value);
+
+    LatencyHistogram stages_[static_cast<size_t>(MetricStage::Count)];
+    std::atomic<uint64_t> counters_[static_cast<size_t>(MetricCounter::Count)];
+    std::atomic<uint64_t> gauges_[static_cast<size_t>(MetricGauge::Count)];
+    std::atomic<uint64_t> highWater_[static_cast<size_t>(MetricGauge::Count)];
+};
+
+} // namespace AudioCapture
\ No newline at end of file
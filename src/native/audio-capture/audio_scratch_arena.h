@@ -0,0 +1,94 @@
+#pragma once
+
+#include "spsc_ring_buffer.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace AudioCapture {
+
+// Named scratch buffers of one processing stream
+enum class ScratchSlot : size_t {
+    Convert = 0,    // Converted/downmixed capture samples
+    Resample,       // Resampler output
+    Decimate,       // Shared decimated stream (VAD rate), reused across stages
+    Analysis,       // VAD and metering frames
+    Features,       // Spectral feature frames
+    Encode,         // Encoder input/output
+    Adapt,          // Capture samples brought to the stream rate
+    Count
+};
+
+// Per-stream reusable scratch memory for the capture path. Each slot grows on
+// demand (while the stream warms up or when packets get larger) and is never
+// shrunk, so steady-state processing performs no heap allocations.
+//
+// Not thread-safe: one arena belongs to the single thread processing a stream.
+class ScratchArena {
+public:
+    ScratchArena() = default;
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    // Cache-line aligned room for at least count elements; valid until the next
+    // Get() on the same slot (previous contents are not preserved on growth)
+    template <typename T>
+    T* Get(ScratchSlot slot, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "ScratchArena holds trivially copyable samples only");
+
+        Slot& entry = slots_[static_cast<size_t>(slot)];
+        size_t bytes = count * sizeof(T);
+        if (bytes > entry.capacity) {
+            Grow(entry, bytes);
+        }
+        return reinterpret_cast<T*>(entry.aligned);
+    }
+
+    // Pre-size a slot so the first packets do not allocate either
+    template <typename T>
+    void Reserve(ScratchSlot slot, size_t count) {
+        Get<T>(slot, count);
+    }
+
+    // Number of times any slot had to allocate (stays flat in steady state)
+    uint64_t GrowthCount() const { return growthCount_; }
+
+    // Bytes currently held across all slots
+    size_t CapacityBytes() const {
+        size_t total = 0;
+        for (const Slot& entry : slots_) {
+            total += entry.capacity;
+        }
+        return total;
+    }
+
+private:
+    struct Slot {
+        std::unique_ptr<unsigned char[]> storage;
+        unsigned char* aligned = nullptr;
+        size_t capacity = 0;
+    };
+
+    void Grow(Slot& entry, size_t bytes) {
+        // Grow geometrically so slowly increasing packet sizes settle quickly
+        size_t capacity = entry.capacity > 0 ? entry.capacity : kCacheLineSize;
+        while (capacity < bytes) {
+            capacity *= 2;
+        }
+
+        entry.storage.reset(new unsigned char[capacity + kCacheLineSize - 1]);
+        uintptr_t address = reinterpret_cast<uintptr_t>(entry.storage.get());
+        address = (address + kCacheLineSize - 1) & ~static_cast<uintptr_t>(kCacheLineSize - 1);
+        entry.aligned = reinterpret_cast<unsigned char*>(address);
+        entry.capacity = capacity;
+        growthCount_++;
+    }
+
+    Slot slots_[static_cast<size_t>(ScratchSlot::Count)];
+    uint64_t growthCount_ = 0;
+};
+
+} // namespace AudioCapture
\ No newline at end of file
@@ -0,0 +1,847 @@
+#include "audio_simd_kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define AUDIO_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define AUDIO_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+// GCC/Clang need per-function target attributes to emit AVX2 without -mavx2;
+// MSVC accepts the intrinsics anywhere
+#if defined(__GNUC__) || defined(__clang__)
+#define AUDIO_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define AUDIO_TARGET_AVX2
+#endif
+
+namespace AudioCapture {
+namespace SimdKernels {
+
+namespace {
+
+constexpr float kInt16Scale = 1.0f / 32768.0f;
+constexpr float kInt32Scale = 1.0f / 2147483648.0f;
+
+constexpr char kBase64Alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Samples per FloatToPcm16Base64 block: 768 bytes, a multiple of 3 so only
+// the final block can need padding
+constexpr size_t kPcm16Base64BlockSamples = 384;
+
+// ---------------------------------------------------------------------------
+// Scalar reference implementations (also used for loop tails)
+// ---------------------------------------------------------------------------
+
+void ScalarInt16ToFloat(const int16_t* input, float* output, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        output[i] = input[i] * kInt16Scale;
+    }
+}
+
+void ScalarInt32ToFloat(const int32_t* input, float* output, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        output[i] = static_cast<float>(input[i]) * kInt32Scale;
+    }
+}
+
+void ScalarFloatToInt16(const float* input, int16_t* output, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        // One clamp before scaling; +1.0 scales to 32768 and saturates below
+        float scaled = std::min(std::max(input[i], -1.0f), 1.0f) * 32768.0f;
+        long value = std::lrintf(scaled);
+        output[i] = static_cast<int16_t>(value > 32767 ? 32767 : value);
+    }
+}
+
+template <typename T>
+void ScalarInterleavedToMono(const T* input, size_t frames, uint16_t channels, float scale, float* output) {
+    const float inverse = scale / channels;
+    for (size_t frame = 0; frame < frames; ++frame) {
+        const T* samples = input + frame * channels;
+        float sum = 0.0f;
+        for (uint16_t ch = 0; ch < channels; ++ch) {
+            sum += static_cast<float>(samples[ch]);
+        }
+        output[frame] = sum * inverse;
+    }
+}
+
+// Integer inputs are scaled per sample first so results match the per-sample path
+void ScalarInterleavedIntToMono(const int16_t* input, size_t frames, uint16_t channels, float* output) {
+    const float inverse = 1.0f / channels;
+    for (size_t frame = 0; frame < frames; ++frame) {
+        const int16_t* samples = input + frame * channels;
+        float sum = 0.0f;
+        for (uint16_t ch = 0; ch < channels; ++ch) {
+            sum += samples[ch] * kInt16Scale;
+        }
+        output[frame] = sum * inverse;
+    }
+}
+
+void ScalarInterleavedIntToMono(const int32_t* input, size_t frames, uint16_t channels, float* output) {
+    const float inverse = 1.0f / channels;
+    for (size_t frame = 0; frame < frames; ++frame) {
+        const int32_t* samples = input + frame * channels;
+        float sum = 0.0f;
+        for (uint16_t ch = 0; ch < channels; ++ch) {
+            sum += static_cast<float>(samples[ch]) * kInt32Scale;
+        }
+        output[frame] = sum * inverse;
+    }
+}
+
+void ScalarPlanarFloatToMono(const float* input, size_t frames, uint16_t channels,
+                             size_t planeStride, float* output) {
+    const float inverse = 1.0f / channels;
+    for (size_t frame = 0; frame < frames; ++frame) {
+        float sum = input[frame];
+        for (uint16_t ch = 1; ch < channels; ++ch) {
+            sum += input[ch * planeStride + frame];
+        }
+        output[frame] = sum * inverse;
+    }
+}
+
+void ScalarStereoFloatToMono(const float* input, size_t frames, float* output) {
+    ScalarInterleavedToMono(input, frames, 2, 1.0f, output);
+}
+
+void ScalarStereoInt16ToMono(const int16_t* input, size_t frames, float* output) {
+    ScalarInterleavedIntToMono(input, frames, 2, output);
+}
+
+void ScalarStereoInt32ToMono(const int32_t* input, size_t frames, float* output) {
+    ScalarInterleavedIntToMono(input, frames, 2, output);
+}
+
+void ScalarBase64Encode(const uint8_t* input, size_t length, char* output) {
+    size_t i = 0;
+    for (; i + 3 <= length; i += 3) {
+        uint32_t triple = (uint32_t(input[i]) << 16) | (uint32_t(input[i + 1]) << 8) | input[i + 2];
+        *output++ = kBase64Alphabet[(triple >> 18) & 0x3f];
+        *output++ = kBase64Alphabet[(triple >> 12) & 0x3f];
+        *output++ = kBase64Alphabet[(triple >> 6) & 0x3f];
+        *output++ = kBase64Alphabet[triple & 0x3f];
+    }
+
+    if (i < length) {
+        uint32_t triple = uint32_t(input[i]) << 16;
+        if (i + 1 < length) triple |= uint32_t(input[i + 1]) << 8;
+        *output++ = kBase64Alphabet[(triple >> 18) & 0x3f];
+        *output++ = kBase64Alphabet[(triple >> 12) & 0x3f];
+        *output++ = i + 1 < length ? kBase64Alphabet[(triple >> 6) & 0x3f] : '=';
+        *output++ = '=';
+    }
+}
+
+float ScalarDotProduct(const float* a, const float* b, size_t count) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+float ScalarSumSquaresAndPeak(const float* input, size_t count, float& peak) {
+    float sum = 0.0f;
+    float maximum = 0.0f;
+    for (size_t i = 0; i < count; ++i) {
+        sum += input[i] * input[i];
+        maximum = std::max(maximum, std::fabs(input[i]));
+    }
+    peak = maximum;
+    return sum;
+}
+
+bool ScalarIsZero(const uint8_t* data, size_t size) {
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        if (word != 0) return false;
+    }
+    for (; i < size; ++i) {
+        if (data[i] != 0) return false;
+    }
+    return true;
+}
+
+#ifdef AUDIO_SIMD_X86
+
+// ---------------------------------------------------------------------------
+// SSE2 (baseline on x86-64)
+// ---------------------------------------------------------------------------
+
+void Sse2Int16ToFloat(const int16_t* input, float* output, size_t count) {
+    const __m128 scale = _mm_set1_ps(kInt16Scale);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    ScalarInt16ToFloat(input + i, output + i, count - i);
+}
+
+void Sse2Int32ToFloat(const int32_t* input, float* output, size_t count) {
+    const __m128 scale = _mm_set1_ps(kInt32Scale);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+    }
+    ScalarInt32ToFloat(input + i, output + i, count - i);
+}
+
+void Sse2FloatToInt16(const float* input, int16_t* output, size_t count) {
+    const __m128 scale = _mm_set1_ps(32768.0f);
+    const __m128 lower = _mm_set1_ps(-1.0f);
+    const __m128 upper = _mm_set1_ps(1.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(input + i), lower), upper);
+        __m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(input + i + 4), lower), upper);
+        __m128i ia = _mm_cvtps_epi32(_mm_mul_ps(a, scale));
+        __m128i ib = _mm_cvtps_epi32(_mm_mul_ps(b, scale));
+        // packs saturates 32768 to 32767
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32(ia, ib));
+    }
+    ScalarFloatToInt16(input + i, output + i, count - i);
+}
+
+void Sse2StereoFloatToMono(const float* input, size_t frames, float* output) {
+    const __m128 half = _mm_set1_ps(0.5f);
+    size_t f = 0;
+    for (; f + 4 <= frames; f += 4) {
+        __m128 a = _mm_loadu_ps(input + 2 * f);
+        __m128 b = _mm_loadu_ps(input + 2 * f + 4);
+        __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(output + f, _mm_mul_ps(_mm_add_ps(left, right), half));
+    }
+    ScalarStereoFloatToMono(input + 2 * f, frames - f, output + f);
+}
+
+void Sse2StereoInt16ToMono(const int16_t* input, size_t frames, float* output) {
+    const __m128 scale = _mm_set1_ps(0.5f * kInt16Scale);
+    size_t f = 0;
+    for (; f + 4 <= frames; f += 4) {
+        // Each 32-bit lane holds one L/R pair
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 2 * f));
+        __m128i left = _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+        __m128i right = _mm_srai_epi32(v, 16);
+        __m128 sum = _mm_cvtepi32_ps(_mm_add_epi32(left, right));
+        _mm_storeu_ps(output + f, _mm_mul_ps(sum, scale));
+    }
+    ScalarStereoInt16ToMono(input + 2 * f, frames - f, output + f);
+}
+
+void Sse2StereoInt32ToMono(const int32_t* input, size_t frames, float* output) {
+    const __m128 scale = _mm_set1_ps(kInt32Scale);
+    const __m128 half = _mm_set1_ps(0.5f);
+    size_t f = 0;
+    for (; f + 4 <= frames; f += 4) {
+        __m128 a = _mm_mul_ps(_mm_cvtepi32_ps(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 2 * f))), scale);
+        __m128 b = _mm_mul_ps(_mm_cvtepi32_ps(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 2 * f + 4))), scale);
+        __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(output + f, _mm_mul_ps(_mm_add_ps(left, right), half));
+    }
+    ScalarStereoInt32ToMono(input + 2 * f, frames - f, output + f);
+}
+
+void Sse2PlanarFloatToMono(const float* input, size_t frames, uint16_t channels,
+                           size_t planeStride, float* output) {
+    const __m128 inverse = _mm_set1_ps(1.0f / channels);
+    size_t f = 0;
+    for (; f + 4 <= frames; f += 4) {
+        __m128 sum = _mm_loadu_ps(input + f);
+        for (uint16_t ch = 1; ch < channels; ++ch) {
+            sum = _mm_add_ps(sum, _mm_loadu_ps(input + ch * planeStride + f));
+        }
+        _mm_storeu_ps(output + f, _mm_mul_ps(sum, inverse));
+    }
+    ScalarPlanarFloatToMono(input + f, frames - f, channels, planeStride, output + f);
+}
+
+float Sse2HorizontalSum(__m128 value) {
+    __m128 high = _mm_movehl_ps(value, value);
+    __m128 pair = _mm_add_ps(value, high);
+    pair = _mm_add_ss(pair, _mm_shuffle_ps(pair, pair, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(pair);
+}
+
+float Sse2DotProduct(const float* a, const float* b, size_t count) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    return Sse2HorizontalSum(_mm_add_ps(acc0, acc1)) + ScalarDotProduct(a + i, b + i, count - i);
+}
+
+float Sse2HorizontalMax(__m128 value) {
+    __m128 pair = _mm_max_ps(value, _mm_movehl_ps(value, value));
+    pair = _mm_max_ss(pair, _mm_shuffle_ps(pair, pair, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(pair);
+}
+
+float Sse2SumSquaresAndPeak(const float* input, size_t count, float& peak) {
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 sum = _mm_setzero_ps();
+    __m128 maximum = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 value = _mm_loadu_ps(input + i);
+        sum = _mm_add_ps(sum, _mm_mul_ps(value, value));
+        maximum = _mm_max_ps(maximum, _mm_and_ps(value, absMask));
+    }
+    float tailPeak = 0.0f;
+    float total = Sse2HorizontalSum(sum) + ScalarSumSquaresAndPeak(input + i, count - i, tailPeak);
+    peak = std::max(Sse2HorizontalMax(maximum), tailPeak);
+    return total;
+}
+
+bool Sse2IsZero(const uint8_t* data, size_t size) {
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        const __m128i* block = reinterpret_cast<const __m128i*>(data + i);
+        __m128i bits = _mm_or_si128(_mm_or_si128(_mm_loadu_si128(block), _mm_loadu_si128(block + 1)),
+                                    _mm_or_si128(_mm_loadu_si128(block + 2), _mm_loadu_si128(block + 3)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(bits, zero)) != 0xffff) return false;
+    }
+    return ScalarIsZero(data + i, size - i);
+}
+
+// ---------------------------------------------------------------------------
+// AVX2 (runtime-detected)
+// ---------------------------------------------------------------------------
+
+AUDIO_TARGET_AVX2
+void Avx2Int16ToFloat(const int16_t* input, float* output, size_t count) {
+    const __m256 scale = _mm256_set1_ps(kInt16Scale);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i lo = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i)));
+        __m256i hi = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i + 8)));
+        _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+        _mm256_storeu_ps(output + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+    }
+    ScalarInt16ToFloat(input + i, output + i, count - i);
+}
+
+AUDIO_TARGET_AVX2
+void Avx2Int32ToFloat(const int32_t* input, float* output, size_t count) {
+    const __m256 scale = _mm256_set1_ps(kInt32Scale);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+        _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    ScalarInt32ToFloat(input + i, output + i, count - i);
+}
+
+AUDIO_TARGET_AVX2
+void Avx2FloatToInt16(const float* input, int16_t* output, size_t count) {
+    const __m256 scale = _mm256_set1_ps(32768.0f);
+    const __m256 lower = _mm256_set1_ps(-1.0f);
+    const __m256 upper = _mm256_set1_ps(1.0f);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256 a = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(input + i), lower), upper);
+        __m256 b = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(input + i + 8), lower), upper);
+        __m256i ia = _mm256_cvtps_epi32(_mm256_mul_ps(a, scale));
+        __m256i ib = _mm256_cvtps_epi32(_mm256_mul_ps(b, scale));
+        // packs works per 128-bit lane; restore sample order afterwards
+        __m256i packed = _mm256_packs_epi32(ia, ib);
+        packed = _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), packed);
+    }
+    ScalarFloatToInt16(input + i, output + i, count - i);
+}
+
+AUDIO_TARGET_AVX2
+void Avx2StereoFloatToMono(const float* input, size_t frames, float* output) {
+    const __m256 half = _mm256_set1_ps(0.5f);
+    size_t f = 0;
+    for (; f + 8 <= frames; f += 8) {
+        __m256 a = _mm256_loadu_ps(input + 2 * f);
+        __m256 b = _mm256_loadu_ps(input + 2 * f + 8);
+        // hadd yields pairs per lane as [0 1 4 5 | 2 3 6 7]; permute back to 0..7
+        __m256 sum = _mm256_hadd_ps(a, b);
+        sum = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(sum), _MM_SHUFFLE(3, 1, 2, 0)));
+        _mm256_storeu_ps(output + f, _mm256_mul_ps(sum, half));
+    }
+    Sse2StereoFloatToMono(input + 2 * f, frames - f, output + f);
+}
+
+AUDIO_TARGET_AVX2
+void Avx2StereoInt16ToMono(const int16_t* input, size_t frames, float* output) {
+    const __m256 scale = _mm256_set1_ps(0.5f * kInt16Scale);
+    size_t f = 0;
+    for (; f + 8 <= frames; f += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + 2 * f));
+        __m256i left = _mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16);
+        __m256i right = _mm256_srai_epi32(v, 16);
+        __m256 sum = _mm256_cvtepi32_ps(_mm256_add_epi32(left, right));
+        _mm256_storeu_ps(output + f, _mm256_mul_ps(sum, scale));
+    }
+    Sse2StereoInt16ToMono(input + 2 * f, frames - f, output + f);
+}
+
+AUDIO_TARGET_AVX2
+void Avx2StereoInt32ToMono(const int32_t* input, size_t frames, float* output) {
+    const __m256 scale = _mm256_set1_ps(kInt32Scale);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    size_t f = 0;
+    for (; f + 8 <= frames; f += 8) {
+        __m256 a = _mm256_mul_ps(_mm256_cvtepi32_ps(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + 2 * f))), scale);
+        __m256 b = _mm256_mul_ps(_mm256_cvtepi32_ps(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + 2 * f + 8))), scale);
+        __m256 sum = _mm256_hadd_ps(a, b);
+        sum = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(sum), _MM_SHUFFLE(3, 1, 2, 0)));
+        _mm256_storeu_ps(output + f, _mm256_mul_ps(sum, half));
+    }
+    Sse2StereoInt32ToMono(input + 2 * f, frames - f, output + f);
+}
+
+AUDIO_TARGET_AVX2
+void Avx2PlanarFloatToMono(const float* input, size_t frames, uint16_t channels,
+                           size_t planeStride, float* output) {
+    const __m256 inverse = _mm256_set1_ps(1.0f / channels);
+    size_t f = 0;
+    for (; f + 8 <= frames; f += 8) {
+        __m256 sum = _mm256_loadu_ps(input + f);
+        for (uint16_t ch = 1; ch < channels; ++ch) {
+            sum = _mm256_add_ps(sum, _mm256_loadu_ps(input + ch * planeStride + f));
+        }
+        _mm256_storeu_ps(output + f, _mm256_mul_ps(sum, inverse));
+    }
+    ScalarPlanarFloatToMono(input + f, frames - f, channels, planeStride, output + f);
+}
+
+AUDIO_TARGET_AVX2
+float Avx2DotProduct(const float* a, const float* b, size_t count) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8)));
+    }
+    __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    return Sse2HorizontalSum(sum) + Sse2DotProduct(a + i, b + i, count - i);
+}
+
+AUDIO_TARGET_AVX2
+float Avx2SumSquaresAndPeak(const float* input, size_t count, float& peak) {
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    __m256 maximum = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256 value0 = _mm256_loadu_ps(input + i);
+        __m256 value1 = _mm256_loadu_ps(input + i + 8);
+        sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(value0, value0));
+        sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(value1, value1));
+        maximum = _mm256_max_ps(maximum, _mm256_max_ps(_mm256_and_ps(value0, absMask),
+                                                       _mm256_and_ps(value1, absMask)));
+    }
+    __m256 sum = _mm256_add_ps(sum0, sum1);
+    __m128 sum128 = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+    __m128 max128 = _mm_max_ps(_mm256_castps256_ps128(maximum), _mm256_extractf128_ps(maximum, 1));
+    float tailPeak = 0.0f;
+    float total = Sse2HorizontalSum(sum128) + Sse2SumSquaresAndPeak(input + i, count - i, tailPeak);
+    peak = std::max(Sse2HorizontalMax(max128), tailPeak);
+    return total;
+}
+
+AUDIO_TARGET_AVX2
+bool Avx2IsZero(const uint8_t* data, size_t size) {
+    size_t i = 0;
+    for (; i + 128 <= size; i += 128) {
+        const __m256i* block = reinterpret_cast<const __m256i*>(data + i);
+        __m256i bits = _mm256_or_si256(_mm256_or_si256(_mm256_loadu_si256(block), _mm256_loadu_si256(block + 1)),
+                                       _mm256_or_si256(_mm256_loadu_si256(block + 2), _mm256_loadu_si256(block + 3)));
+        if (!_mm256_testz_si256(bits, bits)) return false;
+    }
+    return Sse2IsZero(data + i, size - i);
+}
+
+// Base64 via pshufb (Mula & Lemire): each 128-bit lane turns 12 input bytes
+// into 16 output characters
+AUDIO_TARGET_AVX2
+void Avx2Base64Encode(const uint8_t* input, size_t length, char* output) {
+    // Spread bytes so every 32-bit word holds one 3-byte group (b1 b0 b2 b1)
+    const __m256i spread = _mm256_setr_epi8(
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+        1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    // Per-range offsets from a 6-bit index to its ASCII character
+    const __m256i offsets = _mm256_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+    size_t i = 0;
+    // The upper lane loads 16 bytes at +12, so keep 28 bytes readable
+    for (; i + 28 <= length; i += 24) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i + 12));
+        __m256i in = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), spread);
+
+        // Extract the four 6-bit fields of each group into separate bytes
+        __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+        __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+        __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        __m256i indices = _mm256_or_si256(t1, t3);
+
+        // Map 0-25 -> 13, 26-51 -> 0, 52-61 -> 1..10, 62 -> 11, 63 -> 12
+        __m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        range = _mm256_or_si256(range, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+
+        __m256i ascii = _mm256_add_epi8(_mm256_shuffle_epi8(offsets, range), indices);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(output), ascii);
+        output += 32;
+    }
+    ScalarBase64Encode(input + i, length - i, output);
+}
+
+bool CpuSupportsAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+
+    // AVX needs OS support for saving YMM state (OSXSAVE + XCR0 bits 1-2)
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) return false;
+    if ((_xgetbv(0) & 0x6) != 0x6) return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // AUDIO_SIMD_X86
+
+#ifdef AUDIO_SIMD_NEON
+
+// ---------------------------------------------------------------------------
+// NEON (baseline on AArch64 / Apple silicon)
+// ---------------------------------------------------------------------------
+
+void NeonInt16ToFloat(const int16_t* input, float* output, size_t count) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t v = vld1q_s16(input + i);
+        float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(v)));
+        float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(v)));
+        vst1q_f32(output + i, vmulq_n_f32(lo, kInt16Scale));
+        vst1q_f32(output + i + 4, vmulq_n_f32(hi, kInt16Scale));
+    }
+    ScalarInt16ToFloat(input + i, output + i, count - i);
+}
+
+void NeonInt32ToFloat(const int32_t* input, float* output, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(output + i, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(input + i)), kInt32Scale));
+    }
+    ScalarInt32ToFloat(input + i, output + i, count - i);
+}
+
+void NeonFloatToInt16(const float* input, int16_t* output, size_t count) {
+    const float32x4_t lower = vdupq_n_f32(-1.0f);
+    const float32x4_t upper = vdupq_n_f32(1.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        float32x4_t a = vminq_f32(vmaxq_f32(vld1q_f32(input + i), lower), upper);
+        float32x4_t b = vminq_f32(vmaxq_f32(vld1q_f32(input + i + 4), lower), upper);
+        // Round to nearest even, then saturating narrow (32768 -> 32767)
+        int32x4_t ia = vcvtnq_s32_f32(vmulq_n_f32(a, 32768.0f));
+        int32x4_t ib = vcvtnq_s32_f32(vmulq_n_f32(b, 32768.0f));
+        vst1q_s16(output + i, vcombine_s16(vqmovn_s32(ia), vqmovn_s32(ib)));
+    }
+    ScalarFloatToInt16(input + i, output + i, count - i);
+}
+
+void NeonStereoFloatToMono(const float* input, size_t frames, float* output) {
+    size_t f = 0;
+    for (; f + 4 <= frames; f += 4) {
+        float32x4x2_t lr = vld2q_f32(input + 2 * f);
+        vst1q_f32(output + f, vmulq_n_f32(vaddq_f32(lr.val[0], lr.val[1]), 0.5f));
+    }
+    ScalarStereoFloatToMono(input + 2 * f, frames - f, output + f);
+}
+
+void NeonStereoInt16ToMono(const int16_t* input, size_t frames, float* output) {
+    const float scale = 0.5f * kInt16Scale;
+    size_t f = 0;
+    for (; f + 8 <= frames; f += 8) {
+        int16x8x2_t lr = vld2q_s16(input + 2 * f);
+        int32x4_t lo = vaddl_s16(vget_low_s16(lr.val[0]), vget_low_s16(lr.val[1]));
+        int32x4_t hi = vaddl_s16(vget_high_s16(lr.val[0]), vget_high_s16(lr.val[1]));
+        vst1q_f32(output + f, vmulq_n_f32(vcvtq_f32_s32(lo), scale));
+        vst1q_f32(output + f + 4, vmulq_n_f32(vcvtq_f32_s32(hi), scale));
+    }
+    ScalarStereoInt16ToMono(input + 2 * f, frames - f, output + f);
+}
+
+void NeonStereoInt32ToMono(const int32_t* input, size_t frames, float* output) {
+    size_t f = 0;
+    for (; f + 4 <= frames; f += 4) {
+        int32x4x2_t lr = vld2q_s32(input + 2 * f);
+        float32x4_t left = vmulq_n_f32(vcvtq_f32_s32(lr.val[0]), kInt32Scale);
+        float32x4_t right = vmulq_n_f32(vcvtq_f32_s32(lr.val[1]), kInt32Scale);
+        vst1q_f32(output + f, vmulq_n_f32(vaddq_f32(left, right), 0.5f));
+    }
+    ScalarStereoInt32ToMono(input + 2 * f, frames - f, output + f);
+}
+
+void NeonPlanarFloatToMono(const float* input, size_t frames, uint16_t channels,
+                           size_t planeStride, float* output) {
+    const float inverse = 1.0f / channels;
+    size_t f = 0;
+    for (; f + 4 <= frames; f += 4) {
+        float32x4_t sum = vld1q_f32(input + f);
+        for (uint16_t ch = 1; ch < channels; ++ch) {
+            sum = vaddq_f32(sum, vld1q_f32(input + ch * planeStride + f));
+        }
+        vst1q_f32(output + f, vmulq_n_f32(sum, inverse));
+    }
+    ScalarPlanarFloatToMono(input + f, frames - f, channels, planeStride, output + f);
+}
+
+float NeonDotProduct(const float* a, const float* b, size_t count) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    return vaddvq_f32(vaddq_f32(acc0, acc1)) + ScalarDotProduct(a + i, b + i, count - i);
+}
+
+float NeonSumSquaresAndPeak(const float* input, size_t count, float& peak) {
+    float32x4_t sum = vdupq_n_f32(0.0f);
+    float32x4_t maximum = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t value = vld1q_f32(input + i);
+        sum = vmlaq_f32(sum, value, value);
+        maximum = vmaxq_f32(maximum, vabsq_f32(value));
+    }
+    float tailPeak = 0.0f;
+    float total = vaddvq_f32(sum) + ScalarSumSquaresAndPeak(input + i, count - i, tailPeak);
+    peak = std::max(vmaxvq_f32(maximum), tailPeak);
+    return total;
+}
+
+bool NeonIsZero(const uint8_t* data, size_t size) {
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        uint8x16_t bits = vorrq_u8(vorrq_u8(vld1q_u8(data + i), vld1q_u8(data + i + 16)),
+                                   vorrq_u8(vld1q_u8(data + i + 32), vld1q_u8(data + i + 48)));
+        if (vmaxvq_u8(bits) != 0) return false;
+    }
+    return ScalarIsZero(data + i, size - i);
+}
+
+void NeonBase64Encode(const uint8_t* input, size_t length, char* output) {
+    uint8x16x4_t alphabet;
+    for (int t = 0; t < 4; ++t) {
+        alphabet.val[t] = vld1q_u8(reinterpret_cast<const uint8_t*>(kBase64Alphabet) + 16 * t);
+    }
+    const uint8x16_t mask = vdupq_n_u8(0x3f);
+
+    size_t i = 0;
+    for (; i + 48 <= length; i += 48) {
+        // De-interleave 16 groups of 3 bytes, emit 16 groups of 4 characters
+        uint8x16x3_t in = vld3q_u8(input + i);
+        uint8x16x4_t out;
+        out.val[0] = vshrq_n_u8(in.val[0], 2);
+        out.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask);
+        out.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask);
+        out.val[3] = vandq_u8(in.val[2], mask);
+        for (int t = 0; t < 4; ++t) {
+            out.val[t] = vqtbl4q_u8(alphabet, out.val[t]);
+        }
+        vst4q_u8(reinterpret_cast<uint8_t*>(output), out);
+        output += 64;
+    }
+    ScalarBase64Encode(input + i, length - i, output);
+}
+
+#endif // AUDIO_SIMD_NEON
+
+// ---------------------------------------------------------------------------
+// Runtime dispatch
+// ---------------------------------------------------------------------------
+
+struct KernelTable {
+    InstructionSet isa;
+    void (*int16ToFloat)(const int16_t*, float*, size_t);
+    void (*int32ToFloat)(const int32_t*, float*, size_t);
+    void (*floatToInt16)(const float*, int16_t*, size_t);
+    void (*stereoFloatToMono)(const float*, size_t, float*);
+    void (*stereoInt16ToMono)(const int16_t*, size_t, float*);
+    void (*stereoInt32ToMono)(const int32_t*, size_t, float*);
+    void (*planarFloatToMono)(const float*, size_t, uint16_t, size_t, float*);
+    float (*dotProduct)(const float*, const float*, size_t);
+    float (*sumSquaresAndPeak)(const float*, size_t, float&);
+    bool (*isZero)(const uint8_t*, size_t);
+    void (*base64Encode)(const uint8_t*, size_t, char*);
+};
+
+KernelTable ResolveKernels() {
+#if defined(AUDIO_SIMD_X86)
+    if (CpuSupportsAvx2()) {
+        return {InstructionSet::AVX2, Avx2Int16ToFloat, Avx2Int32ToFloat, Avx2FloatToInt16,
+                Avx2StereoFloatToMono, Avx2StereoInt16ToMono, Avx2StereoInt32ToMono,
+                Avx2PlanarFloatToMono, Avx2DotProduct, Avx2SumSquaresAndPeak, Avx2IsZero, Avx2Base64Encode};
+    }
+    return {InstructionSet::SSE2, Sse2Int16ToFloat, Sse2Int32ToFloat, Sse2FloatToInt16,
+            Sse2StereoFloatToMono, Sse2StereoInt16ToMono, Sse2StereoInt32ToMono,
+            Sse2PlanarFloatToMono, Sse2DotProduct, Sse2SumSquaresAndPeak, Sse2IsZero, ScalarBase64Encode};
+#elif defined(AUDIO_SIMD_NEON)
+    return {InstructionSet::NEON, NeonInt16ToFloat, NeonInt32ToFloat, NeonFloatToInt16,
+            NeonStereoFloatToMono, NeonStereoInt16ToMono, NeonStereoInt32ToMono,
+            NeonPlanarFloatToMono, NeonDotProduct, NeonSumSquaresAndPeak, NeonIsZero, NeonBase64Encode};
+#else
+    return {InstructionSet::Scalar, ScalarInt16ToFloat, ScalarInt32ToFloat, ScalarFloatToInt16,
+            ScalarStereoFloatToMono, ScalarStereoInt16ToMono, ScalarStereoInt32ToMono,
+            ScalarPlanarFloatToMono, ScalarDotProduct, ScalarSumSquaresAndPeak, ScalarIsZero, ScalarBase64Encode};
+#endif
+}
+
+const KernelTable& Kernels() {
+    static const KernelTable table = ResolveKernels();
+    return table;
+}
+
+} // namespace
+
+InstructionSet ActiveInstructionSet() {
+    return Kernels().isa;
+}
+
+const char* InstructionSetName(InstructionSet isa) {
+    switch (isa) {
+        case InstructionSet::SSE2: return "sse2";
+        case InstructionSet::AVX2: return "avx2";
+        case InstructionSet::NEON: return "neon";
+        default: return "scalar";
+    }
+}
+
+void Int16ToFloat(const int16_t* input, float* output, size_t count) {
+    Kernels().int16ToFloat(input, output, count);
+}
+
+void Int32ToFloat(const int32_t* input, float* output, size_t count) {
+    Kernels().int32ToFloat(input, output, count);
+}
+
+void FloatToInt16(const float* input, int16_t* output, size_t count) {
+    Kernels().floatToInt16(input, output, count);
+}
+
+void InterleavedFloatToMono(const float* input, size_t frames, uint16_t channels, float* output) {
+    if (channels <= 1) {
+        std::copy(input, input + frames, output);
+    } else if (channels == 2) {
+        Kernels().stereoFloatToMono(input, frames, output);
+    } else {
+        ScalarInterleavedToMono(input, frames, channels, 1.0f, output);
+    }
+}
+
+void InterleavedInt16ToMono(const int16_t* input, size_t frames, uint16_t channels, float* output) {
+    if (channels <= 1) {
+        Kernels().int16ToFloat(input, output, frames);
+    } else if (channels == 2) {
+        Kernels().stereoInt16ToMono(input, frames, output);
+    } else {
+        ScalarInterleavedIntToMono(input, frames, channels, output);
+    }
+}
+
+void InterleavedInt32ToMono(const int32_t* input, size_t frames, uint16_t channels, float* output) {
+    if (channels <= 1) {
+        Kernels().int32ToFloat(input, output, frames);
+    } else if (channels == 2) {
+        Kernels().stereoInt32ToMono(input, frames, output);
+    } else {
+        ScalarInterleavedIntToMono(input, frames, channels, output);
+    }
+}
+
+void PlanarFloatToMono(const float* input, size_t frames, uint16_t channels,
+                       size_t planeStride, float* output) {
+    if (channels <= 1) {
+        std::copy(input, input + frames, output);
+    } else {
+        Kernels().planarFloatToMono(input, frames, channels, planeStride, output);
+    }
+}
+
+float DotProduct(const float* a, const float* b, size_t count) {
+    return Kernels().dotProduct(a, b, count);
+}
+
+float SumSquaresAndPeak(const float* input, size_t count, float& peak) {
+    return Kernels().sumSquaresAndPeak(input, count, peak);
+}
+
+bool IsZero(const uint8_t* data, size_t size) {
+    return Kernels().isZero(data, size);
+}
+
+void Base64Encode(const uint8_t* input, size_t length, char* output) {
+    Kernels().base64Encode(input, length, output);
+}
+
+void FloatToPcm16Base64(const float* input, size_t count, char* output) {
+    // PCM16 is little-endian on every platform the kernels target
+    alignas(32) int16_t block[kPcm16Base64BlockSamples];
+    const KernelTable& kernels = Kernels();
+
+    for (size_t i = 0; i < count; i += kPcm16Base64BlockSamples) {
+        size_t samples = std::min(kPcm16Base64BlockSamples, count - i);
+        kernels.floatToInt16(input + i, block, samples);
+        kernels.base64Encode(reinterpret_cast<const uint8_t*>(block), samples * sizeof(int16_t), output);
+        output += Base64EncodedLength(samples * sizeof(int16_t));
+    }
+}
+
+} // namespace SimdKernels
+} // namespace AudioCapture
\ No newline at end of file
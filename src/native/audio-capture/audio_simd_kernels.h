@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace AudioCapture {
+namespace SimdKernels {
+
+// Instruction set chosen at runtime for the kernels below
+enum class InstructionSet {
+    Scalar,
+    SSE2,
+    AVX2,
+    NEON
+};
+
+// Instruction set the kernels dispatch to on this machine (detected once)
+InstructionSet ActiveInstructionSet();
+const char* InstructionSetName(InstructionSet isa);
+
+// int16 -> float in [-1, 1)
+void Int16ToFloat(const int16_t* input, float* output, size_t count);
+
+// int32 -> float in [-1, 1)
+void Int32ToFloat(const int32_t* input, float* output, size_t count);
+
+// float -> int16 with saturation (round to nearest even)
+void FloatToInt16(const float* input, int16_t* output, size_t count);
+
+// Interleaved N-channel -> mono float, averaging channels in a single pass
+void InterleavedFloatToMono(const float* input, size_t frames, uint16_t channels, float* output);
+void InterleavedInt16ToMono(const int16_t* input, size_t frames, uint16_t channels, float* output);
+void InterleavedInt32ToMono(const int32_t* input, size_t frames, uint16_t channels, float* output);
+
+// Planar N-channel float -> mono; plane c starts at input + c * planeStride
+void PlanarFloatToMono(const float* input, size_t frames, uint16_t channels,
+                       size_t planeStride, float* output);
+
+// Sum of a[i] * b[i] (FIR inner loop)
+float DotProduct(const float* a, const float* b, size_t count);
+
+// Sum of squares and largest |sample| in one pass (level metering)
+float SumSquaresAndPeak(const float* input, size_t count, float& peak);
+
+// Whether every byte is zero (digital silence); stops at the first non-zero block
+bool IsZero(const uint8_t* data, size_t size);
+
+// Characters of padded base64 text for length bytes
+constexpr size_t Base64EncodedLength(size_t length) {
+    return (length + 2) / 3 * 4;
+}
+
+// Standard padded base64 (RFC 4648); output receives Base64EncodedLength(length) chars
+void Base64Encode(const uint8_t* input, size_t length, char* output);
+
+// float -> little-endian PCM16 -> base64, converting in cache-sized blocks so
+// the PCM16 bytes never leave L1; output receives Base64EncodedLength(2 * count)
+void FloatToPcm16Base64(const float* input, size_t count, char* output);
+
+} // namespace SimdKernels
+} // namespace AudioCapture
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "spsc_ring_buffer.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace AudioCapture {
+
+// Preallocated single-producer ring read through any number of independent
+// cursors, so one converted stream can serve several consumers without a copy
+// per consumer. Writing is wait-free and never waits for readers: each cursor
+// is its own RingReader, detecting the samples the producer lapped and
+// counting them as its own overruns.
+//
+// A cursor has the consumer half of the SpscRingBuffer interface and belongs
+// to one consumer thread; cursors on different threads do not interact.
+template <typename T>
+class BroadcastRing {
+public:
+    class Cursor {
+    public:
+        // Starts at the newest sample: only audio written from now on is read
+        explicit Cursor(const BroadcastRing& ring)
+            : ring_(ring.ring_)
+            , reader_(ring.ring_.WritePosition()) {
+        }
+
+        Cursor(const Cursor&) = delete;
+        Cursor& operator=(const Cursor&) = delete;
+
+        // Move up to maxCount of the oldest unread samples into dest, returns samples copied
+        size_t Pop(T* dest, size_t maxCount) { return reader_.Pop(ring_, dest, maxCount); }
+
+        // Drop up to maxCount of the oldest unread samples without copying them
+        size_t Skip(size_t maxCount) { return reader_.Skip(ring_, maxCount); }
+
+        // How many unread samples at the front are PushZeros() silence
+        size_t SilentAvailable() const { return reader_.SilentAvailable(ring_); }
+
+        // Discard everything unread
+        void Clear() { reader_.Clear(ring_); }
+
+        // Number of unread samples (may be stale by the time it is used)
+        size_t Available() const { return reader_.Available(ring_); }
+
+        // Samples this cursor lost to overwrite-oldest
+        uint64_t OverrunCount() const { return reader_.OverrunCount(); }
+
+    private:
+        const RingStorage<T>& ring_;
+        RingReader<T> reader_;
+    };
+
+    // Capacity is rounded up to the next power of two
+    explicit BroadcastRing(size_t capacity) : ring_(capacity) {}
+
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    // Producer: append samples, overwriting the oldest ones if the ring is full
+    void Push(const T* data, size_t count) { ring_.Push(data, count); }
+
+    // Producer: append count zero samples, extending the current silence run
+    void PushZeros(size_t count) { ring_.PushZeros(count); }
+
+    size_t Capacity() const { return ring_.Capacity(); }
+
+    // Samples written since construction
+    uint64_t WritePosition() const { return ring_.WritePosition(); }
+
+private:
+    RingStorage<T> ring_;
+};
+
+using BroadcastFloatRing = BroadcastRing<float>;
+
+} // namespace AudioCapture
\ No newline at end of file
@@ -0,0 +1,451 @@
+#include "capture_engine.h"
+#include "audio_format_converter.h"
+#include <algorithm>
+
+namespace AudioCapture {
+
+std::shared_ptr<CaptureEngine> CaptureEngine::Acquire() {
+    static std::mutex mutex;
+    static std::weak_ptr<CaptureEngine> shared;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<CaptureEngine> engine = shared.lock();
+    if (engine) return engine;
+
+    std::unique_ptr<AudioCaptureBase> capture = CreateAudioCapture();
+    if (!capture) return nullptr;
+
+    engine.reset(new CaptureEngine(std::move(capture)));
+    shared = engine;
+    return engine;
+}
+
+CaptureEngine::CaptureEngine(std::unique_ptr<AudioCaptureBase> capture)
+    : audioCapture_(std::move(capture))
+    , backend_(CaptureBackend::Platform)
+    , streamRate_(DEFAULT_SAMPLE_RATE)
+    , capturing_(false)
+    , backendStopped_(false)
+    , devicesVersion_(UINT64_MAX)
+    , deviceChanges_(0)
+    , useWorker_(true)
+    , workerActive_(false)
+    , levelMeter_(DEFAULT_SAMPLE_RATE)
+    , stream_(std::make_shared<BroadcastFloatRing>(STREAM_RING_SAMPLES)) {
+
+    scratch_.Reserve<float>(ScratchSlot::Convert, SCRATCH_RESERVE_FRAMES);
+    workerOptions_.slotBytes = WORKER_SLOT_BYTES;
+
+    ConnectBackend(*audioCapture_);
+}
+
+CaptureEngine::~CaptureEngine() {
+    // Before any member the notification could touch goes away
+    audioCapture_->SetDeviceChangeCallback(nullptr);
+    audioCapture_->SetCaptureStoppedCallback(nullptr);
+
+    if (audioCapture_->IsCapturing()) {
+        audioCapture_->Stop();
+    }
+
+    // After the backend, so no capture thread is left enqueueing
+    workerActive_ = false;
+    worker_.Stop();
+}
+
+void CaptureEngine::ConnectBackend(AudioCaptureBase& capture) {
+    // Views avoid copying each packet out of the OS buffer
+    capture.SetAudioViewCallback([this](const AudioSampleView& view) {
+        OnAudioData(view);
+    });
+    capture.SetDeviceChangeCallback([this]() {
+        OnDevicesChanged();
+    });
+    capture.SetCaptureStoppedCallback([this]() {
+        OnCaptureStopped();
+    });
+}
+
+void CaptureEngine::OnDevicesChanged() {
+    // Only invalidates: the next GetAvailableDevices() lists again
+    deviceChanges_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CaptureEngine::OnCaptureStopped() {
+    // On the backend's thread, which a control call may be joining: flags only
+    backendStopped_ = true;
+    capturing_ = false;
+}
+
+void CaptureEngine::ReleaseStoppedBackend() {
+    // The backend still holds its thread and the worker is still draining;
+    // a stopped capture starts and reconfigures like one never started
+    if (!backendStopped_.exchange(false)) return;
+
+    audioCapture_->Stop();
+    workerActive_ = false;
+    worker_.Stop();
+}
+
+void CaptureEngine::Attach(CaptureEngineConsumer* consumer) {
+    std::lock_guard<std::mutex> lock(consumersMutex_);
+    consumers_.push_back({consumer, false});
+}
+
+void CaptureEngine::Detach(CaptureEngineConsumer* consumer) {
+    std::lock_guard<std::mutex> lock(consumersMutex_);
+    consumers_.erase(std::remove_if(consumers_.begin(), consumers_.end(),
+                                    [consumer](const Consumer& entry) { return entry.consumer == consumer; }),
+                     consumers_.end());
+}
+
+bool CaptureEngine::Start(CaptureEngineConsumer* consumer, std::string& error) {
+    std::lock_guard<std::mutex> control(controlMutex_);
+
+    auto setStarted = [this, consumer](bool started) {
+        std::lock_guard<std::mutex> lock(consumersMutex_);
+        for (Consumer& entry : consumers_) {
+            if (entry.consumer == consumer) entry.started = started;
+        }
+    };
+
+    ReleaseStoppedBackend();
+
+    // Joining a capture that is already running costs nothing more
+    if (capturing_) {
+        setStarted(true);
+        return true;
+    }
+
+    levelMeter_.Reset();
+
+    // The worker has to be draining before the first packet arrives
+    if (useWorker_ && !worker_.IsRunning()) {
+        std::string workerError;
+        bool started = worker_.Start(workerOptions_, [this](const AudioSampleView& view) {
+            uint64_t dequeued = MonotonicMicros();
+            metrics_.Stage(MetricStage::WorkerQueue).Record(dequeued - std::min(view.timestamp, dequeued));
+            metrics_.AddGauge(MetricGauge::WorkerQueueDepth, -1);
+            ProcessPacket(view);
+        }, workerError);
+        if (!started) {
+            error = "Failed to start processing worker: " + workerError;
+            return false;
+        }
+        workerActive_ = true;
+    }
+
+    setStarted(true);
+    bool success = audioCapture_->Start();
+    capturing_ = audioCapture_->IsCapturing() && !backendStopped_;
+    if (!success && !capturing_) {
+        setStarted(false);
+        workerActive_ = false;
+        worker_.Stop();
+    }
+    return success;
+}
+
+bool CaptureEngine::Stop(CaptureEngineConsumer* consumer) {
+    std::lock_guard<std::mutex> control(controlMutex_);
+
+    {
+        std::lock_guard<std::mutex> lock(consumersMutex_);
+        for (Consumer& entry : consumers_) {
+            if (entry.consumer == consumer) entry.started = false;
+        }
+        // Other consumers keep the capture running
+        if (AnyStarted()) return true;
+    }
+
+    backendStopped_ = false;
+    bool success = audioCapture_->Stop();
+    capturing_ = audioCapture_->IsCapturing();
+
+    // Packets already queued are still processed before the worker exits
+    if (!capturing_) {
+        workerActive_ = false;
+        worker_.Stop();
+    }
+    return success;
+}
+
+bool CaptureEngine::IsCapturing() const {
+    // Without controlMutex_, so polling never waits on a backend start-up
+    return capturing_.load();
+}
+
+bool CaptureEngine::IsStarted(const CaptureEngineConsumer* consumer) const {
+    std::lock_guard<std::mutex> lock(consumersMutex_);
+    for (const Consumer& entry : consumers_) {
+        if (entry.consumer == consumer) return entry.started;
+    }
+    return false;
+}
+
+size_t CaptureEngine::ConsumerCount() const {
+    std::lock_guard<std::mutex> lock(consumersMutex_);
+    return consumers_.size();
+}
+
+size_t CaptureEngine::StartedCount() const {
+    std::lock_guard<std::mutex> lock(consumersMutex_);
+    return static_cast<size_t>(std::count_if(consumers_.begin(), consumers_.end(),
+                                             [](const Consumer& entry) { return entry.started; }));
+}
+
+bool CaptureEngine::AnyStarted() const {
+    return std::any_of(consumers_.begin(), consumers_.end(),
+                       [](const Consumer& entry) { return entry.started; });
+}
+
+bool CaptureEngine::SetCaptureFormat(const CaptureFormatRequest& request, uint32_t frameDurationMs,
+                                     std::string& error) {
+    std::lock_guard<std::mutex> control(controlMutex_);
+
+    ReleaseStoppedBackend();
+    if (audioCapture_->IsCapturing()) {
+        error = "Stop capture before changing the capture format";
+        return false;
+    }
+
+    uint32_t streamRate = request.sampleRate ? request.sampleRate : DEFAULT_SAMPLE_RATE;
+    uint32_t previousRate = streamRate_.load();
+    if (streamRate < MIN_SAMPLE_RATE || !StreamingResampler::IsSupported(DEFAULT_SAMPLE_RATE, streamRate)) {
+        error = "Capture sampleRate must divide 48000 (48000, 24000, 16000, 12000 or 8000)";
+        return false;
+    }
+
+    // Every consumer reads the one stream, so each has to be able to follow it
+    std::lock_guard<std::mutex> lock(consumersMutex_);
+    if (streamRate != previousRate) {
+        for (const Consumer& entry : consumers_) {
+            if (!entry.consumer->AcceptsStreamRate(streamRate)) {
+                error = "Capture sampleRate is not reachable from every consumer's output, VAD, Opus or recording rate";
+                return false;
+            }
+        }
+    }
+
+    // A backend that cannot open the requested format keeps its own; the
+    // capture path decimates what it delivers, so this is not an error
+    if (request.sampleRate != captureFormat_.sampleRate || request.channels != captureFormat_.channels) {
+        audioCapture_->SetCaptureFormat(request);
+        captureFormat_ = request;
+    }
+    if (frameDurationMs > 0) {
+        audioCapture_->SetBufferDuration(frameDurationMs);
+    }
+
+    if (streamRate == previousRate) return true;
+
+    // Stopped, so nothing is dispatched while the consumers reconfigure
+    for (const Consumer& entry : consumers_) {
+        entry.consumer->OnStreamRateChanged(streamRate);
+    }
+    streamRate_ = streamRate;
+    levelMeter_.SetSampleRate(streamRate);
+    return true;
+}
+
+CaptureFormatRequest CaptureEngine::CaptureFormat() const {
+    std::lock_guard<std::mutex> control(controlMutex_);
+    return captureFormat_;
+}
+
+bool CaptureEngine::SetDevice(const std::string& deviceId, std::string& error) {
+    std::lock_guard<std::mutex> control(controlMutex_);
+
+    ReleaseStoppedBackend();
+
+    // "file:" ids are served by the replay backend and "mix:"/"tracks:" ids by
+    // the multi-source backend; swap implementations when the id changes kind
+    CaptureBackend backend = BackendForDevice(deviceId);
+    if (backend != backend_) {
+        if (audioCapture_->IsCapturing()) {
+            error = "Stop capture before switching between live, file replay and multi-source devices";
+            return false;
+        }
+
+        std::unique_ptr<AudioCaptureBase> capture = CreateAudioCapture(deviceId);
+        if (!capture) {
+            error = "Failed to create audio capture for this device";
+            return false;
+        }
+
+        ConnectBackend(*capture);
+        if (captureFormat_.sampleRate || captureFormat_.channels) {
+            capture->SetCaptureFormat(captureFormat_);
+        }
+        audioCapture_->SetDeviceChangeCallback(nullptr);
+        audioCapture_->SetCaptureStoppedCallback(nullptr);
+        audioCapture_ = std::move(capture);
+        backend_ = backend;
+        OnDevicesChanged();
+    }
+
+    return audioCapture_->SetDevice(deviceId);
+}
+
+bool CaptureEngine::SetBufferDuration(uint32_t milliseconds) {
+    std::lock_guard<std::mutex> control(controlMutex_);
+    return audioCapture_->SetBufferDuration(milliseconds);
+}
+
+AudioFormat CaptureEngine::GetFormat() const {
+    std::lock_guard<std::mutex> control(controlMutex_);
+    return audioCapture_->GetFormat();
+}
+
+std::vector<std::string> CaptureEngine::GetAvailableDevices() const {
+    {
+        std::lock_guard<std::mutex> lock(devicesMutex_);
+        if (devicesVersion_ == deviceChanges_.load(std::memory_order_relaxed)) {
+            return devices_;
+        }
+    }
+
+    // A change arriving mid-listing leaves the cache stale for the next call
+    std::lock_guard<std::mutex> control(controlMutex_);
+    uint64_t version = deviceChanges_.load(std::memory_order_relaxed);
+    std::vector<std::string> devices = audioCapture_->GetAvailableDevices();
+
+    std::lock_guard<std::mutex> lock(devicesMutex_);
+    devices_ = devices;
+    devicesVersion_ = version;
+    return devices;
+}
+
+std::string CaptureEngine::GetLastError() const {
+    std::lock_guard<std::mutex> control(controlMutex_);
+    return audioCapture_->GetLastError();
+}
+
+ClockDriftReading CaptureEngine::ClockDrift() const {
+    // Polled by getStats(): while a control call holds the backend, report
+    // the last reading instead of waiting for it
+    std::unique_lock<std::mutex> control(controlMutex_, std::try_to_lock);
+    std::lock_guard<std::mutex> lock(clockMutex_);
+    if (control.owns_lock()) {
+        lastClockDrift_ = audioCapture_->ClockDrift();
+    }
+    return lastClockDrift_;
+}
+
+bool CaptureEngine::ConfigureWorker(bool enabled, const ProcessingWorkerOptions& options, std::string& error) {
+    std::lock_guard<std::mutex> control(controlMutex_);
+
+    ReleaseStoppedBackend();
+    if (audioCapture_->IsCapturing() || worker_.IsRunning()) {
+        error = "Stop capture before reconfiguring the processing worker";
+        return false;
+    }
+
+    workerOptions_ = options;
+    useWorker_ = enabled;
+    return true;
+}
+
+void CaptureEngine::OnAudioData(const AudioSampleView& view) {
+    metrics_.Add(MetricCounter::Packets);
+    metrics_.Add(MetricCounter::Frames, view.frameCount);
+    if (view.captureTimestamp != 0) {
+        metrics_.Stage(MetricStage::CaptureLatency).Record(view.timestamp - std::min(view.captureTimestamp, view.timestamp));
+    }
+
+    // On the OS capture thread: only copy the packet into the worker queue
+    if (workerActive_) {
+        metrics_.AddGauge(MetricGauge::WorkerQueueDepth, 1);
+        if (!worker_.Enqueue(view)) {
+            metrics_.AddGauge(MetricGauge::WorkerQueueDepth, -1);
+            metrics_.Add(MetricCounter::WorkerDrops);
+        }
+        return;
+    }
+
+    ProcessPacket(view);
+}
+
+void CaptureEngine::ProcessPacket(const AudioSampleView& view) {
+    EnginePacket packet;
+    packet.view = &view;
+    packet.timestamp = view.timestamp;
+    packet.silent = view.silent;
+
+    // Convert to clean mono float32 at the stream rate (48kHz unless start()
+    // asked for less). Converts into the engine's scratch arena, so once it
+    // has grown to the packet size this path does not allocate.
+    size_t maxFrames = AudioFormatConverter::GetMonoFrameCount(view.format, view.size);
+    if (maxFrames == 0) {
+        // Nothing to convert, but raw packet consumers still get it
+        Dispatch(packet);
+        return;
+    }
+
+    uint64_t convertStart = MonotonicMicros();
+    if (packet.silent) {
+        // Silence is never converted or metered sample by sample; stages that
+        // need samples read one shared block of zeros
+        if (silence_.size() < maxFrames) {
+            silence_.assign(maxFrames, 0.0f);
+        }
+        packet.samples = silence_.data();
+        packet.frames = maxFrames;
+        metrics_.Add(MetricCounter::SilentPackets);
+    } else {
+        float* float32Data = scratch_.Get<float>(ScratchSlot::Convert, maxFrames);
+        packet.frames = AudioFormatConverter::ConvertToMonoFloat32(view.data, view.size, view.format,
+                                                                   float32Data, maxFrames);
+        packet.samples = float32Data;
+    }
+
+    // A backend that could not open the requested rate (file replay, the
+    // multi-source mixer, a refused conversion) is decimated here, once
+    uint32_t streamRate = streamRate_.load(std::memory_order_relaxed);
+    if (packet.frames > 0 && view.format.sampleRate != streamRate &&
+        StreamingResampler::IsSupported(view.format.sampleRate, streamRate)) {
+        if (captureResampler_.InputRate() != view.format.sampleRate || captureResampler_.OutputRate() != streamRate) {
+            captureResampler_.Configure(view.format.sampleRate, streamRate);
+        }
+        size_t capacity = captureResampler_.MaxOutputFrames(packet.frames);
+        float* adapted = scratch_.Get<float>(ScratchSlot::Adapt, capacity);
+        packet.frames = packet.silent
+            ? captureResampler_.ProcessSilence(packet.frames, adapted, capacity)
+            : captureResampler_.Process(packet.samples, packet.frames, adapted, capacity);
+        packet.samples = adapted;
+    }
+    packet.convertMicros = MonotonicMicros() - convertStart;
+
+    if (packet.frames == 0) {
+        Dispatch(packet);
+        return;
+    }
+
+    packet.gateOpen = packet.silent
+        ? levelMeter_.ProcessSilence(packet.frames)
+        : levelMeter_.Process(packet.samples, packet.frames);
+
+    // Consumers reading the stream as-is share this one copy
+    if (packet.gateOpen) {
+        if (packet.silent) {
+            stream_->PushZeros(packet.frames);
+        } else {
+            stream_->Push(packet.samples, packet.frames);
+        }
+    } else {
+        metrics_.Add(MetricCounter::GatedPackets);
+    }
+
+    Dispatch(packet);
+}
+
+void CaptureEngine::Dispatch(const EnginePacket& packet) {
+    std::lock_guard<std::mutex> lock(consumersMutex_);
+    for (const Consumer& entry : consumers_) {
+        if (entry.started) {
+            entry.consumer->OnEnginePacket(packet);
+        }
+    }
+}
+
+} // namespace AudioCapture
\ No newline at end of file
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "audio_capture_base.h"
+#include "audio_metrics.h"
+#include "audio_scratch_arena.h"
+#include "broadcast_ring.h"
+#include "level_meter.h"
+#include "processing_worker.h"
+#include "streaming_resampler.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace AudioCapture {
+
+// One capture packet after the shared front half: converted to mono float32
+// at the stream rate, rate-adapted and metered
+struct EnginePacket {
+    const AudioSampleView* view = nullptr;  // As delivered by the backend
+    uint64_t timestamp = 0;                 // MonotonicMicros of the capture packet
+    const float* samples = nullptr;         // Mono at the stream rate; zeros when silent
+    size_t frames = 0;                      // 0 when the packet had no convertible audio
+    bool silent = false;
+    bool gateOpen = false;                  // Noise gate verdict for this packet
+    uint64_t convertMicros = 0;             // Conversion and rate adaptation
+};
+
+// A pull, push, VAD or recording pipeline fed by the shared engine
+class CaptureEngineConsumer {
+public:
+    virtual ~CaptureEngineConsumer() = default;
+
+    // Processing thread, in capture order, while this consumer is started
+    virtual void OnEnginePacket(const EnginePacket& packet) = 0;
+
+    // JS thread, capture stopped: whether this consumer's stages can follow a
+    // new stream rate, and following it
+    virtual bool AcceptsStreamRate(uint32_t sampleRate) const = 0;
+    virtual void OnStreamRateChanged(uint32_t sampleRate) = 0;
+};
+
+// Process-wide capture front end shared by every AudioCapture instance. One
+// backend, one processing worker, one conversion and one noise gate serve all
+// consumers; the gated stream is published once into a broadcast ring that
+// each consumer reads through its own cursor, so N consumers cost one capture
+// and one conversion. Capture runs while at least one consumer is started.
+//
+// Control methods run on JS threads and are serialized internally; packets are
+// dispatched on the processing worker (or the OS capture thread without one).
+class CaptureEngine {
+public:
+    // The shared engine, created on first use; nullptr if this platform has no
+    // capture backend. Released with its last reference.
+    static std::shared_ptr<CaptureEngine> Acquire();
+
+    ~CaptureEngine();
+
+    CaptureEngine(const CaptureEngine&) = delete;
+    CaptureEngine& operator=(const CaptureEngine&) = delete;
+
+    // Dispatch starts with Start(consumer); Detach waits for a packet in flight
+    void Attach(CaptureEngineConsumer* consumer);
+    void Detach(CaptureEngineConsumer* consumer);
+
+    // Refcounted over started consumers: the first Start() opens the backend,
+    // the last Stop() closes it. error is set only when the worker cannot start.
+    bool Start(CaptureEngineConsumer* consumer, std::string& error);
+    bool Stop(CaptureEngineConsumer* consumer);
+    bool IsCapturing() const;  // Never waits on a control call in progress
+    bool IsStarted(const CaptureEngineConsumer* consumer) const;
+    size_t ConsumerCount() const;
+    size_t StartedCount() const;
+
+    // Capture stopped: ask the backend for a format and adopt its stream rate
+    // (0 keeps the 48kHz default). Every consumer must accept the rate.
+    bool SetCaptureFormat(const CaptureFormatRequest& request, uint32_t frameDurationMs, std::string& error);
+    uint32_t StreamRate() const { return streamRate_.load(std::memory_order_relaxed); }
+    CaptureFormatRequest CaptureFormat() const;
+
+    // Swap to the file replay or multi-source backend when the id calls for
+    // it (capture stopped), then select the device. error is set when the
+    // swap is impossible; a plain false is the backend refusing the device.
+    bool SetDevice(const std::string& deviceId, std::string& error);
+    bool SetBufferDuration(uint32_t milliseconds);
+    AudioFormat GetFormat() const;
+
+    // Cached until the backend reports a device change, so repeated calls do
+    // not re-enumerate; safe from any thread
+    std::vector<std::string> GetAvailableDevices() const;
+    uint64_t DeviceChangeCount() const { return deviceChanges_.load(std::memory_order_relaxed); }
+    std::string GetLastError() const;
+    ClockDriftReading ClockDrift() const;  // Of the current backend's device clock
+
+    // Capture stopped
+    bool ConfigureWorker(bool enabled, const ProcessingWorkerOptions& options, std::string& error);
+    bool WorkerEnabled() const { return useWorker_; }
+    const ProcessingWorkerOptions& WorkerOptions() const { return workerOptions_; }
+    const ProcessingWorker& Worker() const { return worker_; }
+
+    // Shared by every consumer
+    LevelMeter& Meter() { return levelMeter_; }
+    AudioMetrics& Metrics() { return metrics_; }
+    std::shared_ptr<BroadcastFloatRing> Stream() const { return stream_; }
+
+    // Default rate of the mono float32 stream
+    static constexpr uint32_t DEFAULT_SAMPLE_RATE = 48000;
+
+private:
+    struct Consumer {
+        CaptureEngineConsumer* consumer;
+        bool started;
+    };
+
+    explicit CaptureEngine(std::unique_ptr<AudioCaptureBase> capture);
+
+    void ConnectBackend(AudioCaptureBase& capture);
+    void OnDevicesChanged();
+    void OnCaptureStopped();
+    void ReleaseStoppedBackend();  // controlMutex_ held
+    void OnAudioData(const AudioSampleView& view);
+    void ProcessPacket(const AudioSampleView& view);
+    void Dispatch(const EnginePacket& packet);
+    bool AnyStarted() const;  // consumersMutex_ held
+
+    mutable std::mutex controlMutex_;  // JS threads: backend, worker and format changes
+    std::unique_ptr<AudioCaptureBase> audioCapture_;
+    CaptureBackend backend_;
+    CaptureFormatRequest captureFormat_;
+    std::atomic<uint32_t> streamRate_;
+    std::atomic<bool> capturing_;  // Mirrors the backend after each Start()/Stop() and when it stops on its own
+    std::atomic<bool> backendStopped_;  // Stopped on its own; Stop() not yet called
+    mutable std::mutex clockMutex_;
+    mutable ClockDriftReading lastClockDrift_;
+
+    // Device list cache; notifications arrive on OS threads
+    mutable std::mutex devicesMutex_;
+    mutable std::vector<std::string> devices_;
+    mutable uint64_t devicesVersion_;     // deviceChanges_ the cache was listed at
+    std::atomic<uint64_t> deviceChanges_;
+
+    // Processing thread only
+    StreamingResampler captureResampler_;
+    ScratchArena scratch_;
+    std::vector<float> silence_;  // Zeros standing in for silent packets
+
+    ProcessingWorker worker_;
+    ProcessingWorkerOptions workerOptions_;
+    bool useWorker_;
+    std::atomic<bool> workerActive_;  // Packets go through worker_
+
+    LevelMeter levelMeter_;
+    AudioMetrics metrics_;
+    std::shared_ptr<BroadcastFloatRing> stream_;  // Gated stream at the stream rate
+
+    mutable std::mutex consumersMutex_;  // Held by the processing thread while dispatching
+    std::vector<Consumer> consumers_;
+
+    // Constants
+    static constexpr uint32_t MIN_SAMPLE_RATE = 8000;
+    static constexpr size_t STREAM_RING_SAMPLES = 48000 * 10;      // 10 seconds at 48kHz
+    static constexpr size_t WORKER_SLOT_BYTES = 48000 / 10 * 2 * sizeof(float);  // 100ms of 48kHz stereo
+    static constexpr size_t SCRATCH_RESERVE_FRAMES = 48000 / 10;   // 100ms at 48kHz
+};
+
+} // namespace AudioCapture
\ No newline at end of file
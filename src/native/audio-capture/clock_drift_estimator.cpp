@@ -0,0 +1,114 @@
+#include "clock_drift_estimator.h"
+#include <algorithm>
+#include <cmath>
+
+namespace AudioCapture {
+
+ClockDriftEstimator::ClockDriftEstimator(uint32_t nominalRate)
+    : publishedLocked_(false)
+    , driftPpm_(0.0)
+    , measuredRate_(0.0)
+    , jitterMicros_(0.0) {
+    Reset(nominalRate);
+}
+
+void ClockDriftEstimator::Reset(uint32_t nominalRate) {
+    nominalRate_ = std::max<uint32_t>(nominalRate, 1);
+    Anchor(0, 0);
+    lastFrame_ = 0;
+    lastMicros_ = 0;
+    publishedLocked_.store(false, std::memory_order_relaxed);
+    driftPpm_.store(0.0, std::memory_order_relaxed);
+    measuredRate_.store(0.0, std::memory_order_relaxed);
+    jitterMicros_.store(0.0, std::memory_order_relaxed);
+}
+
+void ClockDriftEstimator::Anchor(uint64_t frame, uint64_t hostMicros) {
+    anchorFrame_ = frame;
+    anchorMicros_ = hostMicros;
+    updates_ = 0;
+    meanX_ = 0.0;
+    meanY_ = 0.0;
+    varX_ = 0.0;
+    covXY_ = 0.0;
+    residualSquares_ = 0.0;
+    locked_ = false;
+}
+
+void ClockDriftEstimator::Update(uint64_t frame, uint64_t hostMicros) {
+    if (hostMicros == 0) return;
+
+    // A timestamp the current fit cannot explain means the stream restarted or lost data
+    if (updates_ == 0 || frame < lastFrame_) {
+        Anchor(frame, hostMicros);
+    } else {
+        double expected = static_cast<double>(HostMicrosAt(frame));
+        if (std::fabs(static_cast<double>(hostMicros) - expected) > RESET_MICROS) {
+            Anchor(frame, hostMicros);
+        }
+    }
+
+    double x = static_cast<double>(frame - anchorFrame_);
+    double y = static_cast<double>(hostMicros) - static_cast<double>(anchorMicros_);
+    updates_++;
+
+    // Equal weights while the history is short, then a fixed time window
+    double packetSeconds = updates_ > 1 ? static_cast<double>(frame - lastFrame_) / nominalRate_ : 0.0;
+    double alpha = std::min(std::max(1.0 / static_cast<double>(updates_), packetSeconds / TIME_CONSTANT_SECONDS), 1.0);
+
+    double dx = x - meanX_;
+    double dy = y - meanY_;
+    if (updates_ > 2 && varX_ > 0.0) {
+        double residual = dy - (covXY_ / varX_) * dx;
+        residualSquares_ += alpha * (residual * residual - residualSquares_);
+    }
+    meanX_ += alpha * dx;
+    meanY_ += alpha * dy;
+    varX_ = (1.0 - alpha) * (varX_ + alpha * dx * dx);
+    covXY_ = (1.0 - alpha) * (covXY_ + alpha * dx * dy);
+
+    lastFrame_ = frame;
+    lastMicros_ = hostMicros;
+
+    locked_ = false;
+    if (updates_ >= LOCK_UPDATES && x >= LOCK_SECONDS * nominalRate_ && varX_ > 0.0 && covXY_ > 0.0) {
+        double rate = 1000000.0 * varX_ / covXY_;
+        locked_ = std::fabs((rate / nominalRate_ - 1.0) * 1000000.0) <= MAX_DRIFT_PPM;
+    }
+    Publish();
+}
+
+uint64_t ClockDriftEstimator::HostMicrosAt(uint64_t frame) const {
+    double micros;
+    if (locked_) {
+        double x = static_cast<double>(static_cast<int64_t>(frame - anchorFrame_));
+        micros = static_cast<double>(anchorMicros_) + meanY_ + (covXY_ / varX_) * (x - meanX_);
+    } else {
+        if (updates_ == 0) return 0;
+        double frames = static_cast<double>(static_cast<int64_t>(frame - lastFrame_));
+        micros = static_cast<double>(lastMicros_) + frames * 1000000.0 / nominalRate_;
+    }
+    return micros > 0.0 ? static_cast<uint64_t>(std::llround(micros)) : 0;
+}
+
+void ClockDriftEstimator::Publish() {
+    publishedLocked_.store(locked_, std::memory_order_relaxed);
+    if (!locked_) return;
+
+    // Keep the last locked estimate published while a new fit settles
+    double rate = 1000000.0 * varX_ / covXY_;
+    measuredRate_.store(rate, std::memory_order_relaxed);
+    driftPpm_.store((rate / nominalRate_ - 1.0) * 1000000.0, std::memory_order_relaxed);
+    jitterMicros_.store(std::sqrt(residualSquares_), std::memory_order_relaxed);
+}
+
+ClockDriftReading ClockDriftEstimator::Read() const {
+    ClockDriftReading reading;
+    reading.locked = publishedLocked_.load(std::memory_order_relaxed);
+    reading.driftPpm = driftPpm_.load(std::memory_order_relaxed);
+    reading.measuredRate = measuredRate_.load(std::memory_order_relaxed);
+    reading.jitterMicros = jitterMicros_.load(std::memory_order_relaxed);
+    return reading;
+}
+
+} // namespace AudioCapture
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace AudioCapture {
+
+// Latest estimate, published for any thread
+struct ClockDriftReading {
+    bool locked = false;        // Enough clean history for a stable estimate
+    double driftPpm = 0.0;      // Device sample clock against the host clock; positive: device runs fast
+    double measuredRate = 0.0;  // Sample rate measured on the host clock (0 until locked)
+    double jitterMicros = 0.0;  // RMS deviation of the timestamps from the fitted clock
+};
+
+// Relates a stream's sample clock to MonotonicMicros(). Each packet's first
+// frame index and capture time go into an exponentially weighted line fit,
+// whose slope is the real sample rate on the host clock. The fit turns noisy
+// per-packet timestamps into sample-accurate ones and tells consumers how
+// fast the device runs, so sources on different clocks can be kept aligned.
+//
+// A timestamp far off the fitted line (a device restart, dropped data, a
+// paused loopback) starts a new fit; until it locks again the raw timestamps
+// are used as they are.
+class ClockDriftEstimator {
+public:
+    explicit ClockDriftEstimator(uint32_t nominalRate = 48000);
+
+    // Owning thread: forget the fit, e.g. when the stream restarts or changes rate
+    void Reset(uint32_t nominalRate);
+
+    // Owning thread: the packet starting at stream frame `frame` was captured at hostMicros
+    void Update(uint64_t frame, uint64_t hostMicros);
+
+    // Owning thread: fitted capture time of a stream frame (the latest raw
+    // timestamp extrapolated at the nominal rate while not locked)
+    uint64_t HostMicrosAt(uint64_t frame) const;
+
+    bool Locked() const { return locked_; }
+    uint32_t NominalRate() const { return nominalRate_; }
+
+    // Any thread
+    ClockDriftReading Read() const;
+
+private:
+    void Anchor(uint64_t frame, uint64_t hostMicros);
+    void Publish();
+
+    uint32_t nominalRate_;
+
+    // Owning thread: fit relative to the anchor, in frames and microseconds
+    uint64_t anchorFrame_;
+    uint64_t anchorMicros_;
+    uint64_t lastFrame_;
+    uint64_t lastMicros_;
+    uint64_t updates_;
+    double meanX_;
+    double meanY_;
+    double varX_;
+    double covXY_;
+    double residualSquares_;
+    bool locked_;
+
+    // Published reading
+    std::atomic<bool> publishedLocked_;
+    std::atomic<double> driftPpm_;
+    std::atomic<double> measuredRate_;
+    std::atomic<double> jitterMicros_;
+
+    // Constants
+    static constexpr double TIME_CONSTANT_SECONDS = 30.0;  // Weighting window of the fit
+    static constexpr double LOCK_SECONDS = 2.0;            // History needed before the fit is trusted
+    static constexpr uint64_t LOCK_UPDATES = 16;
+    static constexpr double RESET_MICROS = 20000.0;        // Timestamps this far off the fit restart it
+    static constexpr double MAX_DRIFT_PPM = 2000.0;        // Beyond this the fit is not a clock
+};
+
+} // namespace AudioCapture
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "delivery_batch_controller.h"
+#include <algorithm>
+
+namespace AudioCapture {
+
+namespace {
+
+size_t MsToSamples(uint32_t sampleRate, uint32_t ms) {
+    return std::max<size_t>(static_cast<size_t>(sampleRate) * ms / 1000, 1);
+}
+
+double SamplesToMicros(uint32_t sampleRate, size_t samples) {
+    return sampleRate > 0 ? samples * 1e6 / sampleRate : 0.0;
+}
+
+} // namespace
+
+DeliveryBatchController::DeliveryBatchController()
+    : sampleRate_(48000)
+    , minSamples_(1)
+    , maxSamples_(1)
+    , adaptive_(false)
+    , smoothedMicros_(0.0)
+    , calmDeliveries_(0)
+    , targetSamples_(1)
+    , wakeupMicros_(0.0)
+    , maxWakeupMicros_(0.0)
+    , queuedSamples_(0)
+    , deliveries_(0)
+    , adjustments_(0) {
+}
+
+void DeliveryBatchController::Configure(uint32_t sampleRate, uint32_t batchMs, uint32_t minBatchMs,
+                                        uint32_t maxBatchMs, bool adaptive) {
+    sampleRate_ = std::max<uint32_t>(sampleRate, 1);
+    adaptive_ = adaptive;
+    minSamples_ = MsToSamples(sampleRate_, adaptive ? minBatchMs : batchMs);
+    maxSamples_ = std::max(MsToSamples(sampleRate_, adaptive ? maxBatchMs : batchMs), minSamples_);
+    smoothedMicros_ = 0.0;
+    calmDeliveries_ = 0;
+
+    targetSamples_.store(std::min(std::max(MsToSamples(sampleRate_, batchMs), minSamples_), maxSamples_),
+                         std::memory_order_relaxed);
+    wakeupMicros_.store(0.0, std::memory_order_relaxed);
+    maxWakeupMicros_.store(0.0, std::memory_order_relaxed);
+    queuedSamples_.store(0, std::memory_order_relaxed);
+    deliveries_.store(0, std::memory_order_relaxed);
+    adjustments_.store(0, std::memory_order_relaxed);
+}
+
+void DeliveryBatchController::Observe(uint64_t wakeupMicros, size_t queuedSamples) {
+    const double wakeup = static_cast<double>(wakeupMicros);
+    smoothedMicros_ = deliveries_.load(std::memory_order_relaxed) == 0
+        ? wakeup
+        : smoothedMicros_ + (wakeup - smoothedMicros_) * SMOOTHING;
+
+    wakeupMicros_.store(smoothedMicros_, std::memory_order_relaxed);
+    maxWakeupMicros_.store(std::max(maxWakeupMicros_.load(std::memory_order_relaxed), wakeup),
+                           std::memory_order_relaxed);
+    queuedSamples_.store(queuedSamples, std::memory_order_relaxed);
+    deliveries_.fetch_add(1, std::memory_order_relaxed);
+
+    if (!adaptive_) return;
+
+    const size_t target = TargetSamples();
+    const double targetMicros = SamplesToMicros(sampleRate_, target);
+
+    if (smoothedMicros_ * 2.0 > targetMicros || queuedSamples > target * BEHIND_BATCHES) {
+        // Behind: at least double, and cover twice the loop's current lag
+        size_t lagSamples = static_cast<size_t>(smoothedMicros_ * 2.0 * sampleRate_ / 1e6);
+        SetTarget(std::max(target * 2, lagSamples));
+        calmDeliveries_ = 0;
+    } else if (smoothedMicros_ * 4.0 < targetMicros) {
+        if (++calmDeliveries_ >= SHRINK_AFTER_DELIVERIES) {
+            SetTarget(target - target / 4);
+            calmDeliveries_ = 0;
+        }
+    } else {
+        calmDeliveries_ = 0;
+    }
+}
+
+void DeliveryBatchController::SetTarget(size_t samples) {
+    samples = std::min(std::max(samples, minSamples_), maxSamples_);
+    if (samples == TargetSamples()) return;
+
+    targetSamples_.store(samples, std::memory_order_relaxed);
+    adjustments_.fetch_add(1, std::memory_order_relaxed);
+}
+
+DeliveryBatchReading DeliveryBatchController::Read() const {
+    DeliveryBatchReading reading;
+    reading.adaptive = adaptive_;
+    reading.targetBatchMs = static_cast<uint32_t>(TargetSamples() * 1000 / sampleRate_);
+    reading.minBatchMs = static_cast<uint32_t>(minSamples_ * 1000 / sampleRate_);
+    reading.maxBatchMs = static_cast<uint32_t>(maxSamples_ * 1000 / sampleRate_);
+    reading.wakeupLatencyMs = wakeupMicros_.load(std::memory_order_relaxed) / 1000.0;
+    reading.maxWakeupLatencyMs = maxWakeupMicros_.load(std::memory_order_relaxed) / 1000.0;
+    reading.queuedMs = SamplesToMicros(sampleRate_, queuedSamples_.load(std::memory_order_relaxed)) / 1000.0;
+    reading.deliveries = deliveries_.load(std::memory_order_relaxed);
+    reading.adjustments = adjustments_.load(std::memory_order_relaxed);
+    return reading;
+}
+
+} // namespace AudioCapture
\ No newline at end of file
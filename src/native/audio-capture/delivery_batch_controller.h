@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace AudioCapture {
+
+// Latest controller state, published for any thread
+struct DeliveryBatchReading {
+    bool adaptive = false;
+    uint32_t targetBatchMs = 0;
+    uint32_t minBatchMs = 0;
+    uint32_t maxBatchMs = 0;
+    double wakeupLatencyMs = 0.0;  // Smoothed delay from the ready signal to the JS turn
+    double maxWakeupLatencyMs = 0.0;
+    double queuedMs = 0.0;         // Audio waiting when the last delivery started
+    uint64_t deliveries = 0;
+    uint64_t adjustments = 0;      // Target changes since Configure()
+};
+
+// Sizes push deliveries to JS from how late the event loop picks them up.
+// Each delivery reports its wakeup latency and the audio queued at that point:
+// when the loop falls behind (latency past half a batch, or more than two
+// batches waiting) the batch grows at once, halving the number of wakeups;
+// after a run of deliveries well inside the batch it shrinks back a quarter
+// at a time, so an idle loop gets small low-latency batches again.
+//
+// With min == max the target never moves and this is a fixed batch size.
+class DeliveryBatchController {
+public:
+    DeliveryBatchController();
+
+    // Owning (JS) thread, while no delivery is signalled
+    void Configure(uint32_t sampleRate, uint32_t batchMs, uint32_t minBatchMs, uint32_t maxBatchMs,
+                   bool adaptive);
+
+    // Owning thread: one delivery woke up wakeupMicros after its signal with
+    // queuedSamples waiting; may move the target
+    void Observe(uint64_t wakeupMicros, size_t queuedSamples);
+
+    // Any thread: samples the next delivery waits for
+    size_t TargetSamples() const { return targetSamples_.load(std::memory_order_relaxed); }
+
+    // Largest target, for sizing the queue behind it
+    size_t MaxSamples() const { return maxSamples_; }
+
+    // Any thread; the limits only change in Configure()
+    DeliveryBatchReading Read() const;
+
+private:
+    void SetTarget(size_t samples);
+
+    // Set by Configure()
+    uint32_t sampleRate_;
+    size_t minSamples_;
+    size_t maxSamples_;
+    bool adaptive_;
+
+    // Owning thread
+    double smoothedMicros_;
+    uint64_t calmDeliveries_;
+
+    // Published state
+    std::atomic<size_t> targetSamples_;
+    std::atomic<double> wakeupMicros_;
+    std::atomic<double> maxWakeupMicros_;
+    std::atomic<size_t> queuedSamples_;
+    std::atomic<uint64_t> deliveries_;
+    std::atomic<uint64_t> adjustments_;
+
+    // Constants
+    static constexpr double SMOOTHING = 1.0 / 8.0;          // EWMA weight of each wakeup
+    static constexpr uint64_t SHRINK_AFTER_DELIVERIES = 16; // Calm run before a step down
+    static constexpr size_t BEHIND_BATCHES = 2;             // Queue depth that counts as falling behind
+};
+
+} // namespace AudioCapture
\ No newline at end of file
@@ -0,0 +1,476 @@
+#include "file_replay_audio_capture.h"
+#include "audio_format_converter.h"
+#include "audio_format_kernels.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef WINDOWS_PLATFORM
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace AudioCapture {
+
+namespace {
+
+constexpr const char* FILE_DEVICE_PREFIX = "file:";
+
+uint32_t ReadLE(const uint8_t* bytes, size_t size) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < size; ++i) {
+        value |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+    }
+    return value;
+}
+
+// Only the shapes the capture path converts: 16, 24 and 32-bit int and float32
+bool IsReplayableFormat(const AudioFormat& format) {
+    return format.channels > 0 && format.sampleRate > 0 &&
+           AudioFormatConverter::GetMonoFrameCount(format, format.bytesPerFrame) == 1;
+}
+
+void FillFrameLayout(AudioFormat& format) {
+    format.bytesPerFrame = format.channels * (format.bitsPerSample / 8);
+    format.blockAlign = format.bytesPerFrame;
+}
+
+} // namespace
+
+MappedAudioFile::~MappedAudioFile() {
+    Close();
+}
+
+bool MappedAudioFile::Open(const std::string& path, const AudioFormat* rawFormat, std::string& error) {
+    Close();
+
+#ifdef WINDOWS_PLATFORM
+    // Paths arrive from JS as UTF-8
+    int wideLength = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    std::wstring widePath(wideLength > 0 ? wideLength - 1 : 0, L'\0');
+    if (wideLength > 0) {
+        MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &widePath[0], wideLength);
+    }
+
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "Cannot open " + path;
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        error = path + " is empty";
+        return false;
+    }
+
+    HANDLE mappingHandle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* view = mappingHandle ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mappingHandle) CloseHandle(mappingHandle);
+        CloseHandle(file);
+        error = "Cannot map " + path;
+        return false;
+    }
+
+    fileHandle_ = file;
+    mappingHandle_ = mappingHandle;
+    mapping_ = view;
+    mappedSize_ = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "Cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        error = path + " is empty";
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // The mapping keeps the file referenced
+    if (view == MAP_FAILED) {
+        error = "Cannot map " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+
+    mapping_ = view;
+    mappedSize_ = static_cast<size_t>(info.st_size);
+#endif
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(mapping_);
+    size_t dataOffset = 0;
+    size_t dataSize = mappedSize_;
+
+    if (rawFormat) {
+        format_ = *rawFormat;
+    } else if (!ParseWav(bytes, mappedSize_, format_, dataOffset, dataSize, error)) {
+        error = path + ": " + error + " (headerless PCM needs format, rate and channels)";
+        Close();
+        return false;
+    }
+
+    if (!IsReplayableFormat(format_)) {
+        Close();
+        error = path + ": replay needs 16, 24 or 32-bit PCM or float32 audio";
+        return false;
+    }
+
+    data_ = bytes + dataOffset;
+    size_ = dataSize - dataSize % format_.bytesPerFrame;
+    return true;
+}
+
+void MappedAudioFile::Close() {
+    if (mapping_) {
+#ifdef WINDOWS_PLATFORM
+        UnmapViewOfFile(mapping_);
+        CloseHandle(static_cast<HANDLE>(mappingHandle_));
+        CloseHandle(static_cast<HANDLE>(fileHandle_));
+        mappingHandle_ = nullptr;
+        fileHandle_ = nullptr;
+#else
+        munmap(mapping_, mappedSize_);
+#endif
+    }
+
+    mapping_ = nullptr;
+    mappedSize_ = 0;
+    data_ = nullptr;
+    size_ = 0;
+}
+
+bool MappedAudioFile::ParseWav(const uint8_t* bytes, size_t length, AudioFormat& format,
+                               size_t& dataOffset, size_t& dataSize, std::string& error) {
+    if (length < 12 || std::memcmp(bytes, "RIFF", 4) != 0 || std::memcmp(bytes + 8, "WAVE", 4) != 0) {
+        error = "Not a RIFF/WAVE file";
+        return false;
+    }
+
+    bool haveFormat = false;
+    bool haveData = false;
+    size_t offset = 12;
+
+    while (offset + 8 <= length) {
+        const uint8_t* chunk = bytes + offset;
+        size_t chunkSize = ReadLE(chunk + 4, 4);
+        size_t body = offset + 8;
+        size_t available = std::min(chunkSize, length - body);
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && available >= 16) {
+            uint16_t formatTag = static_cast<uint16_t>(ReadLE(chunk + 8, 2));
+            if (formatTag == 0xFFFE && available >= 26) {
+                // WAVE_FORMAT_EXTENSIBLE: the subformat GUID starts with the tag
+                formatTag = static_cast<uint16_t>(ReadLE(chunk + 32, 2));
+            }
+
+            format = AudioFormat();
+            format.channels = static_cast<uint16_t>(ReadLE(chunk + 10, 2));
+            format.sampleRate = ReadLE(chunk + 12, 4);
+            format.bitsPerSample = static_cast<uint16_t>(ReadLE(chunk + 22, 2));
+            format.isFloat = formatTag == 3;  // WAVE_FORMAT_IEEE_FLOAT
+            FillFrameLayout(format);
+            haveFormat = formatTag == 1 || formatTag == 3;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            // Streamed WAVs may leave the size unset; take what is there
+            dataOffset = body;
+            dataSize = (chunkSize == 0 || chunkSize == 0xFFFFFFFF) ? length - body : available;
+            haveData = true;
+            break;
+        }
+
+        offset = body + chunkSize + (chunkSize & 1);
+    }
+
+    if (!haveFormat || !haveData) {
+        error = "WAV file has no PCM/float format or no data chunk";
+        return false;
+    }
+    return true;
+}
+
+bool FileReplayOptions::Parse(const std::string& deviceId, FileReplayOptions& options, std::string& error) {
+    if (!IsFileReplayDevice(deviceId)) {
+        error = "Replay device ids start with \"file:\"";
+        return false;
+    }
+
+    options = FileReplayOptions();
+    std::string spec = deviceId.substr(std::strlen(FILE_DEVICE_PREFIX));
+    size_t query = spec.find('?');
+    options.path = spec.substr(0, query);
+    if (options.path.empty()) {
+        error = "Replay device id has no file path";
+        return false;
+    }
+
+    uint32_t rawRate = 0;
+    uint32_t rawChannels = 0;
+    std::string rawFormat;
+
+    while (query != std::string::npos) {
+        size_t next = spec.find('&', query + 1);
+        std::string item = spec.substr(query + 1, next == std::string::npos ? std::string::npos : next - query - 1);
+        query = next;
+
+        size_t equals = item.find('=');
+        std::string key = item.substr(0, equals);
+        std::string value = equals == std::string::npos ? std::string() : item.substr(equals + 1);
+
+        if (key == "speed") {
+            options.speed = value == "max" ? 0.0 : std::atof(value.c_str());
+            if (options.speed < 0.0 || (options.speed == 0.0 && value != "max" && value != "0")) {
+                error = "speed must be a positive multiple of real time or \"max\"";
+                return false;
+            }
+        } else if (key == "loop") {
+            options.loop = value != "0" && value != "false";
+        } else if (key == "packetMs") {
+            options.packetMs = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (key == "layout") {
+            if (value != "planar" && value != "interleaved") {
+                error = "layout must be \"planar\" or \"interleaved\"";
+                return false;
+            }
+            options.planar = value == "planar";
+        } else if (key == "format") {
+            rawFormat = value;
+        } else if (key == "rate") {
+            rawRate = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        } else if (key == "channels") {
+            rawChannels = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+        } else {
+            error = "Unknown replay option \"" + key + "\"";
+            return false;
+        }
+    }
+
+    if (!rawFormat.empty()) {
+        if (rawFormat != "s16" && rawFormat != "s32" && rawFormat != "f32") {
+            error = "format must be s16, s32 or f32";
+            return false;
+        }
+        if (rawRate == 0 || rawChannels == 0 || rawChannels > 32) {
+            error = "Headerless replay needs rate and channels (1-32)";
+            return false;
+        }
+
+        options.hasRawFormat = true;
+        options.rawFormat.sampleRate = rawRate;
+        options.rawFormat.channels = static_cast<uint16_t>(rawChannels);
+        options.rawFormat.bitsPerSample = rawFormat == "s16" ? 16 : 32;
+        options.rawFormat.isFloat = rawFormat == "f32";
+        FillFrameLayout(options.rawFormat);
+    }
+
+    return true;
+}
+
+bool IsFileReplayDevice(const std::string& deviceId) {
+    return deviceId.compare(0, std::strlen(FILE_DEVICE_PREFIX), FILE_DEVICE_PREFIX) == 0;
+}
+
+FileReplayAudioCapture::FileReplayAudioCapture()
+    : shouldStop_(false)
+    , finished_(false) {
+}
+
+FileReplayAudioCapture::~FileReplayAudioCapture() {
+    Stop();
+}
+
+bool FileReplayAudioCapture::Start() {
+    if (IsCapturing()) return true;
+
+    // A replay that ran to the end leaves its thread to be joined
+    Stop();
+
+    if (!file_.IsOpen()) {
+        lastError_ = "No replay file selected; use setDevice(\"file:<path>\")";
+        return false;
+    }
+
+    if (options_.packetMs < MIN_PACKET_MS || options_.packetMs > MAX_PACKET_MS) {
+        lastError_ = "packetMs must be between 1 and 1000";
+        return false;
+    }
+
+    shouldStop_ = false;
+    finished_ = false;
+    isCapturing_ = true;
+    replayThread_ = std::thread(&FileReplayAudioCapture::ReplayThreadFunction, this);
+    return true;
+}
+
+bool FileReplayAudioCapture::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(stopMutex_);
+        shouldStop_ = true;
+    }
+    stopCondition_.notify_all();
+
+    if (replayThread_.joinable()) {
+        replayThread_.join();
+    }
+
+    isCapturing_ = false;
+    return true;
+}
+
+bool FileReplayAudioCapture::IsCapturing() const {
+    return isCapturing_ && !finished_;
+}
+
+void FileReplayAudioCapture::SetAudioCallback(AudioCallback callback) {
+    std::lock_guard<std::mutex> lock(callbackMutex_);
+    audioCallback_ = callback;
+}
+
+void FileReplayAudioCapture::SetAudioViewCallback(AudioViewCallback callback) {
+    std::lock_guard<std::mutex> lock(callbackMutex_);
+    audioViewCallback_ = callback;
+}
+
+AudioFormat FileReplayAudioCapture::GetFormat() const {
+    return currentFormat_;
+}
+
+std::vector<std::string> FileReplayAudioCapture::GetAvailableDevices() {
+    std::vector<std::string> devices;
+    if (!deviceId_.empty()) {
+        devices.push_back(deviceId_);
+    }
+    return devices;
+}
+
+bool FileReplayAudioCapture::SetDevice(const std::string& deviceId) {
+    if (IsCapturing()) {
+        lastError_ = "Stop the replay before selecting another file";
+        return false;
+    }
+    Stop();
+
+    FileReplayOptions options;
+    if (!FileReplayOptions::Parse(deviceId, options, lastError_)) {
+        return false;
+    }
+
+    if (!file_.Open(options.path, options.hasRawFormat ? &options.rawFormat : nullptr, lastError_)) {
+        return false;
+    }
+
+    deviceId_ = deviceId;
+    options_ = options;
+
+    // Planar delivery mirrors ScreenCaptureKit: channel planes within each packet
+    currentFormat_ = file_.Format();
+    currentFormat_.isNonInterleaved = options_.planar && currentFormat_.channels > 1;
+    FormatKernels::Resolve(currentFormat_);
+    return true;
+}
+
+std::string FileReplayAudioCapture::GetLastError() const {
+    return lastError_;
+}
+
+bool FileReplayAudioCapture::SetBufferDuration(uint32_t milliseconds) {
+    if (isCapturing_ || milliseconds < MIN_PACKET_MS || milliseconds > MAX_PACKET_MS) {
+        return false;
+    }
+    options_.packetMs = milliseconds;
+    return true;
+}
+
+void FileReplayAudioCapture::ReplayThreadFunction() {
+    const AudioFormat& format = file_.Format();
+    const size_t totalFrames = file_.Size() / format.bytesPerFrame;
+    const size_t packetFrames = std::max<size_t>(1, static_cast<size_t>(format.sampleRate) * options_.packetMs / 1000);
+
+    // Pace against the start time so scheduling jitter does not accumulate
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t startMicros = MonotonicMicros();
+    uint64_t emittedFrames = 0;
+    size_t position = 0;
+
+    while (!shouldStop_) {
+        if (position >= totalFrames) {
+            if (!options_.loop) break;
+            position = 0;
+        }
+
+        size_t frames = std::min(packetFrames, totalFrames - position);
+
+        // At real time the schedule is the file's sample clock; faster
+        // replays have no meaningful capture time
+        uint64_t captureTimestamp = options_.speed == 1.0
+            ? startMicros + emittedFrames * 1000000 / format.sampleRate : 0;
+        DeliverPacket(file_.Data() + position * format.bytesPerFrame, frames, captureTimestamp);
+        position += frames;
+        emittedFrames += frames;
+
+        if (options_.speed > 0.0) {
+            auto due = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(emittedFrames / (format.sampleRate * options_.speed)));
+
+            std::unique_lock<std::mutex> lock(stopMutex_);
+            stopCondition_.wait_until(lock, due, [this]() { return shouldStop_.load(); });
+        }
+    }
+
+    finished_ = true;
+    if (!shouldStop_) {
+        NotifyCaptureStopped();
+    }
+}
+
+void FileReplayAudioCapture::DeliverPacket(const uint8_t* data, size_t frames, uint64_t captureTimestamp) {
+    const AudioFormat& format = file_.Format();
+    const size_t bytes = frames * format.bytesPerFrame;
+    const size_t sampleBytes = format.bitsPerSample / 8;
+    const uint8_t* packet = data;
+
+    if (currentFormat_.isNonInterleaved) {
+        // De-interleave this packet into channel planes
+        packetBuffer_.resize(bytes);
+        for (uint16_t ch = 0; ch < format.channels; ++ch) {
+            uint8_t* plane = packetBuffer_.data() + ch * frames * sampleBytes;
+            for (size_t frame = 0; frame < frames; ++frame) {
+                std::memcpy(plane + frame * sampleBytes,
+                            data + (frame * format.channels + ch) * sampleBytes, sampleBytes);
+            }
+        }
+        packet = packetBuffer_.data();
+    } else if (reinterpret_cast<uintptr_t>(data) % sampleBytes != 0) {
+        // Odd WAV headers can misalign the payload; the converters need aligned samples
+        packetBuffer_.assign(data, data + bytes);
+        packet = packetBuffer_.data();
+    }
+
+    std::lock_guard<std::mutex> lock(callbackMutex_);
+    if (!HasAudioCallback()) return;
+
+    AudioSampleView view;
+    view.data = packet;
+    view.size = bytes;
+    view.format = currentFormat_;
+    view.frameCount = static_cast<uint32_t>(frames);
+    view.timestamp = MonotonicMicros();
+    view.captureTimestamp = captureTimestamp;
+
+    DispatchAudio(view);
+}
+
+} // namespace AudioCapture
\ No newline at end of file
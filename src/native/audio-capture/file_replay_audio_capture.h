@@ -0,0 +1,111 @@
+#pragma once
+
+#include "audio_capture_base.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace AudioCapture {
+
+// Read-only memory mapping of a recorded audio file: a WAV file, or headerless
+// PCM described by the caller. The PCM payload is read in place.
+class MappedAudioFile {
+public:
+    MappedAudioFile() = default;
+    ~MappedAudioFile();
+
+    MappedAudioFile(const MappedAudioFile&) = delete;
+    MappedAudioFile& operator=(const MappedAudioFile&) = delete;
+
+    // rawFormat describes headerless files; pass nullptr for WAV
+    bool Open(const std::string& path, const AudioFormat* rawFormat, std::string& error);
+    void Close();
+
+    bool IsOpen() const { return mapping_ != nullptr; }
+    const uint8_t* Data() const { return data_; }
+    size_t Size() const { return size_; }  // Whole frames only
+    const AudioFormat& Format() const { return format_; }
+
+    // Locate the format and data chunks of a RIFF/WAVE image
+    static bool ParseWav(const uint8_t* bytes, size_t length, AudioFormat& format,
+                         size_t& dataOffset, size_t& dataSize, std::string& error);
+
+private:
+    void* mapping_ = nullptr;    // Start of the mapped file
+    size_t mappedSize_ = 0;
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    AudioFormat format_ = {};
+#ifdef WINDOWS_PLATFORM
+    void* fileHandle_ = nullptr;
+    void* mappingHandle_ = nullptr;
+#endif
+};
+
+// Replay settings parsed from a "file:" device id:
+//   file:<path>[?speed=<N|max>&loop=1&packetMs=<ms>&layout=planar
+//               &format=<s16|s32|f32>&rate=<hz>&channels=<n>]
+// format/rate/channels describe headerless PCM files.
+struct FileReplayOptions {
+    std::string path;
+    double speed = 1.0;       // Multiple of real time; 0 = as fast as possible
+    bool loop = false;        // Restart at the end instead of stopping
+    uint32_t packetMs = 10;   // Audio per delivered packet
+    bool planar = false;      // Deliver per-packet channel planes (ScreenCaptureKit shape)
+    bool hasRawFormat = false;
+    AudioFormat rawFormat = {};
+
+    static bool Parse(const std::string& deviceId, FileReplayOptions& options, std::string& error);
+};
+
+// Whether a device id selects the file replay backend
+bool IsFileReplayDevice(const std::string& deviceId);
+
+// Capture backend that replays a recorded file with the packet shapes the OS
+// backends produce, paced at real time, N x real time or as fast as possible,
+// so the whole capture -> JS pipeline can be loaded deterministically.
+class FileReplayAudioCapture : public AudioCaptureBase {
+public:
+    FileReplayAudioCapture();
+    ~FileReplayAudioCapture() override;
+
+    bool Start() override;
+    bool Stop() override;
+    bool IsCapturing() const override;
+    void SetAudioCallback(AudioCallback callback) override;
+    void SetAudioViewCallback(AudioViewCallback callback) override;
+    AudioFormat GetFormat() const override;
+    std::vector<std::string> GetAvailableDevices() override;
+    bool SetDevice(const std::string& deviceId) override;
+    std::string GetLastError() const override;
+    bool SetBufferDuration(uint32_t milliseconds) override;
+
+private:
+    std::string deviceId_;
+    FileReplayOptions options_;
+    MappedAudioFile file_;
+
+    // Replay thread
+    std::thread replayThread_;
+    std::atomic<bool> shouldStop_;
+    std::atomic<bool> finished_;  // End of file reached without looping
+    std::mutex stopMutex_;
+    std::condition_variable stopCondition_;  // Wakes a pacing wait on Stop()
+    std::mutex callbackMutex_;
+
+    std::vector<uint8_t> packetBuffer_;  // Replay thread only: planar/aligned copies
+
+    void ReplayThreadFunction();
+    void DeliverPacket(const uint8_t* data, size_t frames, uint64_t captureTimestamp);
+
+    // Constants
+    static constexpr uint32_t MIN_PACKET_MS = 1;
+    static constexpr uint32_t MAX_PACKET_MS = 1000;
+};
+
+} // namespace AudioCapture
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "level_meter.h"
+#include "audio_simd_kernels.h"
+#include <cmath>
+
+namespace AudioCapture {
+
+namespace {
+
+// One-pole smoothing factor for a packet of the given duration
+float SmoothingFactor(double seconds, uint32_t timeConstantMs) {
+    if (timeConstantMs == 0) return 0.0f;
+    return static_cast<float>(std::exp(-seconds * 1000.0 / timeConstantMs));
+}
+
+} // namespace
+
+LevelMeter::LevelMeter(uint32_t sampleRate)
+    : sampleRate_(sampleRate)
+    , envelope_(0.0f)
+    , holdRemaining_(0)
+    , gateOpen_(false)
+    , rms_(0.0f)
+    , peak_(0.0f)
+    , level_(0.0f)
+    , publishedGateOpen_(false) {
+    Configure(LevelMeterConfig());
+}
+
+void LevelMeter::Configure(const LevelMeterConfig& config) {
+    gateThreshold_.store(config.gateThreshold, std::memory_order_relaxed);
+    attackMs_.store(config.attackMs, std::memory_order_relaxed);
+    releaseMs_.store(config.releaseMs, std::memory_order_relaxed);
+    holdMs_.store(config.holdMs, std::memory_order_relaxed);
+}
+
+void LevelMeter::SetGateThreshold(float threshold) {
+    gateThreshold_.store(threshold, std::memory_order_relaxed);
+}
+
+LevelMeterConfig LevelMeter::Config() const {
+    LevelMeterConfig config;
+    config.gateThreshold = gateThreshold_.load(std::memory_order_relaxed);
+    config.attackMs = attackMs_.load(std::memory_order_relaxed);
+    config.releaseMs = releaseMs_.load(std::memory_order_relaxed);
+    config.holdMs = holdMs_.load(std::memory_order_relaxed);
+    return config;
+}
+
+bool LevelMeter::Process(const float* samples, size_t count) {
+    if (!samples || count == 0) return gateOpen_;
+
+    float peak = 0.0f;
+    float rms = std::sqrt(SimdKernels::SumSquaresAndPeak(samples, count, peak) / count);
+    return Update(rms, peak, count);
+}
+
+bool LevelMeter::ProcessSilence(size_t count) {
+    if (count == 0) return gateOpen_;
+    return Update(0.0f, 0.0f, count);
+}
+
+bool LevelMeter::Update(float rms, float peak, size_t count) {
+    // Attack/release envelope, advanced by the packet duration
+    double seconds = static_cast<double>(count) / sampleRate_;
+    uint32_t timeConstantMs = rms > envelope_
+        ? attackMs_.load(std::memory_order_relaxed)
+        : releaseMs_.load(std::memory_order_relaxed);
+    float factor = SmoothingFactor(seconds, timeConstantMs);
+    envelope_ = rms + (envelope_ - rms) * factor;
+
+    // Open on the smoothed level, close only after holdMs below the threshold
+    // so word endings and short pauses pass
+    float threshold = gateThreshold_.load(std::memory_order_relaxed);
+    if (threshold <= 0.0f || envelope_ > threshold) {
+        gateOpen_ = true;
+        holdRemaining_ = static_cast<uint64_t>(holdMs_.load(std::memory_order_relaxed)) * sampleRate_ / 1000;
+    } else if (holdRemaining_ > count) {
+        holdRemaining_ -= count;
+    } else {
+        holdRemaining_ = 0;
+        gateOpen_ = false;
+    }
+
+    rms_.store(rms, std::memory_order_relaxed);
+    peak_.store(peak, std::memory_order_relaxed);
+    level_.store(envelope_, std::memory_order_relaxed);
+    publishedGateOpen_.store(gateOpen_, std::memory_order_relaxed);
+    return gateOpen_;
+}
+
+void LevelMeter::SetSampleRate(uint32_t sampleRate) {
+    sampleRate_ = sampleRate;
+}
+
+LevelReading LevelMeter::Read() const {
+    LevelReading reading;
+    reading.rms = rms_.load(std::memory_order_relaxed);
+    reading.peak = peak_.load(std::memory_order_relaxed);
+    reading.level = level_.load(std::memory_order_relaxed);
+    reading.gateOpen = publishedGateOpen_.load(std::memory_order_relaxed);
+    return reading;
+}
+
+void LevelMeter::Reset() {
+    envelope_ = 0.0f;
+    holdRemaining_ = 0;
+    gateOpen_ = false;
+    rms_.store(0.0f, std::memory_order_relaxed);
+    peak_.store(0.0f, std::memory_order_relaxed);
+    level_.store(0.0f, std::memory_order_relaxed);
+    publishedGateOpen_.store(false, std::memory_order_relaxed);
+}
+
+} // namespace AudioCapture
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace AudioCapture {
+
+struct LevelMeterConfig {
+    float gateThreshold = 0.02f;  // Smoothed RMS the gate opens at; 0 disables gating
+    uint32_t attackMs = 10;       // Time constant of a rising level
+    uint32_t releaseMs = 150;     // Time constant of a falling level
+    uint32_t holdMs = 300;        // Gate stays open this long after the level falls below the threshold
+};
+
+// Latest measurement, published for any thread
+struct LevelReading {
+    float rms = 0.0f;    // Last packet
+    float peak = 0.0f;   // Last packet, largest |sample|
+    float level = 0.0f;  // RMS after attack/release smoothing
+    bool gateOpen = false;
+};
+
+// Level metering and noise gate over the converted mono stream, shared by
+// every backend. Process() runs on the processing thread; the configuration
+// and the published reading are atomics, so JS can adjust the gate and read
+// levels while audio flows without taking a lock.
+class LevelMeter {
+public:
+    explicit LevelMeter(uint32_t sampleRate);
+
+    LevelMeter(const LevelMeter&) = delete;
+    LevelMeter& operator=(const LevelMeter&) = delete;
+
+    // Any thread; takes effect from the next packet
+    void Configure(const LevelMeterConfig& config);
+    void SetGateThreshold(float threshold);
+    LevelMeterConfig Config() const;
+
+    // Measure one packet and publish the reading; false when the gate drops it
+    bool Process(const float* samples, size_t count);
+
+    // Same for count samples of digital silence, without reading any samples
+    bool ProcessSilence(size_t count);
+
+    // Any thread
+    LevelReading Read() const;
+
+    // Processing thread quiescent: forget the envelope and hold state
+    void Reset();
+
+    // Processing thread quiescent: rate of the samples passed to Process()
+    void SetSampleRate(uint32_t sampleRate);
+
+private:
+    bool Update(float rms, float peak, size_t count);
+
+    uint32_t sampleRate_;
+
+    std::atomic<float> gateThreshold_;
+    std::atomic<uint32_t> attackMs_;
+    std::atomic<uint32_t> releaseMs_;
+    std::atomic<uint32_t> holdMs_;
+
+    // Processing thread
+    float envelope_;
+    uint64_t holdRemaining_;  // Samples the gate stays open below the threshold
+    bool gateOpen_;
+
+    // Published reading
+    std::atomic<float> rms_;
+    std::atomic<float> peak_;
+    std::atomic<float> level_;
+    std::atomic<bool> publishedGateOpen_;
+};
+
+} // namespace AudioCapture
\ No newline at end of file
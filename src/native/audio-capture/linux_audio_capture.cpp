@@ -1,21 +1,41 @@
 #ifdef LINUX_PLATFORM
 
 #include "linux_audio_capture.h"
-#include <pulse/error.h>
-#include <cstring>
+#include "audio_format_kernels.h"
 
 namespace AudioCapture {
 
+namespace {
+
+// Source enumeration state shared with SourceInfoCallback
+struct DeviceQuery {
+    pa_threaded_mainloop* mainloop;
+    std::vector<std::string>* devices;
+};
+
+std::string PulseError(const char* what, pa_context* context) {
+    return std::string(what) + ": " + pa_strerror(pa_context_errno(context));
+}
+
+} // namespace
+
 LinuxAudioCapture::LinuxAudioCapture()
-    : stream_(nullptr)
-    , shouldStop_(false) {
-    
+    : mainloop_(nullptr)
+    , context_(nullptr)
+    , stream_(nullptr)
+    , streamRunning_(false)
+    , streamFailed_(false)
+    , followDefault_(true)
+    , fragmentMs_(FRAGMENT_SIZE_MS) {
+
     // Initialize default format
-    currentFormat_.sampleRate = 48000;
-    currentFormat_.channels = 2;
+    currentFormat_.sampleRate = CAPTURE_SAMPLE_RATE;
+    currentFormat_.channels = CAPTURE_CHANNELS;
     currentFormat_.bitsPerSample = 32;
-    currentFormat_.bytesPerFrame = 8;
-    currentFormat_.blockAlign = 8;
+    currentFormat_.bytesPerFrame = CAPTURE_CHANNELS * sizeof(float);
+    currentFormat_.blockAlign = CAPTURE_CHANNELS * sizeof(float);
+    currentFormat_.isFloat = true;
+    FormatKernels::Resolve(currentFormat_);
 }
 
 LinuxAudioCapture::~LinuxAudioCapture() {
@@ -24,147 +44,416 @@ LinuxAudioCapture::~LinuxAudioCapture() {
 }
 
 bool LinuxAudioCapture::Start() {
-    if (isCapturing_) return true;
-    
-    // TODO: Implement PulseAudio monitor capture
-    // For now, return a stub implementation
-    lastError_ = "Linux audio capture not yet implemented";
-    return false;
-    
-    /*
-    // Future implementation will use PulseAudio:
-    
+    if (IsCapturing()) return true;
+
+    // Release a stream that failed while capturing
+    Stop();
+
     if (!InitializePulseAudio()) {
         return false;
     }
-    
-    shouldStop_ = false;
-    captureThread_ = std::thread(&LinuxAudioCapture::CaptureThreadFunction, this);
+
+    pa_threaded_mainloop_lock(mainloop_);
+    bool connected = ConnectStream();
+    pa_threaded_mainloop_unlock(mainloop_);
+
+    if (!connected) {
+        return false;
+    }
+
     isCapturing_ = true;
     return true;
-    */
 }
 
 bool LinuxAudioCapture::Stop() {
     if (!isCapturing_) return true;
-    
-    shouldStop_ = true;
-    
-    if (captureThread_.joinable()) {
-        captureThread_.join();
-    }
-    
+
+    pa_threaded_mainloop_lock(mainloop_);
+    DisconnectStream();
+    pa_threaded_mainloop_unlock(mainloop_);
+
     isCapturing_ = false;
+    streamFailed_ = false;
     return true;
 }
 
 bool LinuxAudioCapture::IsCapturing() const {
-    return isCapturing_;
+    return isCapturing_ && !streamFailed_;
 }
 
 void LinuxAudioCapture::SetAudioCallback(AudioCallback callback) {
+    std::lock_guard<std::mutex> lock(callbackMutex_);
     audioCallback_ = callback;
 }
 
+void LinuxAudioCapture::SetAudioViewCallback(AudioViewCallback callback) {
+    std::lock_guard<std::mutex> lock(callbackMutex_);
+    audioViewCallback_ = callback;
+}
+
 AudioFormat LinuxAudioCapture::GetFormat() const {
     return currentFormat_;
 }
 
 std::vector<std::string> LinuxAudioCapture::GetAvailableDevices() {
-    // TODO: Implement device enumeration
-    return {"Default Monitor"};
+    std::vector<std::string> devices;
+
+    if (!InitializePulseAudio()) return devices;
+
+    DeviceQuery query = { mainloop_, &devices };
+
+    pa_threaded_mainloop_lock(mainloop_);
+    pa_operation* operation = pa_context_get_source_info_list(context_, SourceInfoCallback, &query);
+    if (operation) {
+        while (pa_operation_get_state(operation) == PA_OPERATION_RUNNING) {
+            pa_threaded_mainloop_wait(mainloop_);
+        }
+        pa_operation_unref(operation);
+    } else {
+        SetLastError(PulseError("Failed to list PulseAudio sources", context_));
+    }
+    pa_threaded_mainloop_unlock(mainloop_);
+
+    return devices;
 }
 
 bool LinuxAudioCapture::SetDevice(const std::string& deviceId) {
-    // TODO: Implement device selection
-    return true;
-}
+    // Empty or "@DEFAULT_MONITOR@" follows the default sink
+    std::string name = (deviceId == DEFAULT_MONITOR) ? std::string() : deviceId;
+    if (name == deviceName_) return true;
+
+    deviceName_ = name;
+    followDefault_ = name.empty();
+    if (!isCapturing_) return true;
 
-float LinuxAudioCapture::GetVolumeLevel() const {
-    return currentVolumeLevel_;
+    // Move the running capture over to the new source
+    pa_threaded_mainloop_lock(mainloop_);
+    DisconnectStream();
+    bool connected = ConnectStream();
+    pa_threaded_mainloop_unlock(mainloop_);
+
+    if (!connected) {
+        isCapturing_ = false;
+    }
+    return connected;
 }
 
 std::string LinuxAudioCapture::GetLastError() const {
+    std::lock_guard<std::mutex> lock(errorMutex_);
     return lastError_;
 }
 
-void LinuxAudioCapture::SetNoiseGateThreshold(float threshold) {
-    // Linux PulseAudio doesn't have a built-in noise gate like macOS ScreenCaptureKit
-    // This is a no-op for Linux - noise gating will be handled in JavaScript VAD
-    // Clear any previous errors
-    lastError_ = "";
-}
-
-void LinuxAudioCapture::CaptureThreadFunction() {
-    // TODO: Implement actual capture loop using PulseAudio
-    /*
-    // Future implementation:
-    static const size_t BUFFER_SIZE = 4096;
-    float buffer[BUFFER_SIZE];
-    
-    while (!shouldStop_) {
-        int error;
-        if (pa_simple_read(stream_, buffer, sizeof(buffer), &error) < 0) {
-            lastError_ = std::string("pa_simple_read() failed: ") + pa_strerror(error);
-            break;
+void LinuxAudioCapture::SetLastError(const std::string& error) {
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    lastError_ = error;
+}
+
+bool LinuxAudioCapture::SetBufferDuration(uint32_t milliseconds) {
+    if (milliseconds < MIN_FRAGMENT_SIZE_MS || milliseconds > MAX_FRAGMENT_SIZE_MS) {
+        SetLastError("Buffer duration must be between 1 and 2000 ms");
+        return false;
+    }
+
+    if (isCapturing_) {
+        SetLastError("Stop capture before changing the buffer duration");
+        return false;
+    }
+
+    fragmentMs_ = milliseconds;
+    return true;
+}
+
+bool LinuxAudioCapture::SetCaptureFormat(const CaptureFormatRequest& request) {
+    uint32_t sampleRate = request.sampleRate ? request.sampleRate : CAPTURE_SAMPLE_RATE;
+    uint16_t channels = request.channels ? request.channels : CAPTURE_CHANNELS;
+    if (sampleRate < MIN_SAMPLE_RATE || sampleRate > MAX_SAMPLE_RATE || channels > CAPTURE_CHANNELS) {
+        SetLastError("Capture format must be 8000-192000 Hz with 1 or 2 channels");
+        return false;
+    }
+
+    if (isCapturing_) {
+        SetLastError("Stop capture before changing the capture format");
+        return false;
+    }
+
+    // The server resamples and downmixes the monitor to this sample spec
+    currentFormat_.sampleRate = sampleRate;
+    currentFormat_.channels = channels;
+    currentFormat_.bytesPerFrame = channels * sizeof(float);
+    currentFormat_.blockAlign = channels * sizeof(float);
+    FormatKernels::Resolve(currentFormat_);
+    return true;
+}
+
+bool LinuxAudioCapture::InitializePulseAudio() {
+    if (context_ && pa_context_get_state(context_) == PA_CONTEXT_READY) {
+        return true;
+    }
+
+    // Drop a context that failed or was terminated by the server
+    CleanupPulseAudio();
+
+    mainloop_ = pa_threaded_mainloop_new();
+    if (!mainloop_) {
+        SetLastError("Failed to create PulseAudio mainloop");
+        return false;
+    }
+
+    context_ = pa_context_new(pa_threaded_mainloop_get_api(mainloop_), "AI Audio Assistant");
+    if (!context_) {
+        SetLastError("Failed to create PulseAudio context");
+        CleanupPulseAudio();
+        return false;
+    }
+    pa_context_set_state_callback(context_, ContextStateCallback, this);
+
+    if (pa_threaded_mainloop_start(mainloop_) < 0) {
+        SetLastError("Failed to start PulseAudio mainloop");
+        CleanupPulseAudio();
+        return false;
+    }
+
+    pa_threaded_mainloop_lock(mainloop_);
+    bool ready = false;
+    if (pa_context_connect(context_, nullptr, PA_CONTEXT_NOFLAGS, nullptr) < 0) {
+        SetLastError(PulseError("Failed to connect to PulseAudio", context_));
+    } else {
+        // Wait until the server accepted or rejected the connection
+        for (;;) {
+            pa_context_state_t state = pa_context_get_state(context_);
+            if (state == PA_CONTEXT_READY) {
+                ready = true;
+                break;
+            }
+            if (!PA_CONTEXT_IS_GOOD(state)) {
+                SetLastError(PulseError("PulseAudio connection failed", context_));
+                break;
+            }
+            pa_threaded_mainloop_wait(mainloop_);
         }
-        
-        if (audioCallback_) {
-            AudioSample sample;
-            sample.data.resize(sizeof(buffer));
-            std::memcpy(sample.data.data(), buffer, sizeof(buffer));
-            sample.format = currentFormat_;
-            sample.frameCount = BUFFER_SIZE / currentFormat_.channels;
-            sample.timestamp = GetCurrentTimestamp();
-            
-            audioCallback_(sample);
+    }
+    if (ready) {
+        // Source list and default device changes; without them the device
+        // list is never invalidated and the stream stays on its monitor
+        pa_context_set_subscribe_callback(context_, SubscribeCallback, this);
+        pa_operation* operation = pa_context_subscribe(
+            context_, static_cast<pa_subscription_mask_t>(PA_SUBSCRIPTION_MASK_SOURCE | PA_SUBSCRIPTION_MASK_SERVER),
+            nullptr, nullptr);
+        if (operation) {
+            pa_operation_unref(operation);
         }
     }
-    */
-    
-    while (!shouldStop_) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    pa_threaded_mainloop_unlock(mainloop_);
+
+    if (!ready) {
+        CleanupPulseAudio();
+        return false;
     }
+
+    return true;
 }
 
-bool LinuxAudioCapture::InitializePulseAudio() {
-    // TODO: Implement PulseAudio initialization
-    /*
-    // Future implementation:
-    pa_sample_spec spec = {
-        .format = PA_SAMPLE_FLOAT32LE,
-        .rate = 48000,
-        .channels = 2
-    };
-    
-    // Connect to monitor of default sink
-    stream_ = pa_simple_new(
-        nullptr,                // Server
-        "AI Audio Assistant",   // App name
-        PA_STREAM_RECORD,       // Direction
-        "@DEFAULT_MONITOR@",    // Device (monitor source)
-        "System Audio",         // Stream name
-        &spec,                  // Sample spec
-        nullptr,                // Channel map
-        nullptr,                // Buffer attr
-        nullptr                 // Error
-    );
-    
+bool LinuxAudioCapture::ConnectStream() {
+    pa_sample_spec spec;
+    spec.format = PA_SAMPLE_FLOAT32LE;
+    spec.rate = currentFormat_.sampleRate;
+    spec.channels = static_cast<uint8_t>(currentFormat_.channels);
+
+    stream_ = pa_stream_new(context_, "System Audio", &spec, nullptr);
     if (!stream_) {
-        lastError_ = "Failed to create PulseAudio stream";
+        SetLastError(PulseError("Failed to create PulseAudio stream", context_));
         return false;
     }
-    
+    pa_stream_set_state_callback(stream_, StreamStateCallback, this);
+    pa_stream_set_read_callback(stream_, StreamReadCallback, this);
+
+    // Ask for small fragments; with ADJUST_LATENCY the server sizes the
+    // source latency to match instead of its default (up to ~2s)
+    pa_buffer_attr attr;
+    attr.maxlength = static_cast<uint32_t>(-1);
+    attr.tlength = static_cast<uint32_t>(-1);
+    attr.prebuf = static_cast<uint32_t>(-1);
+    attr.minreq = static_cast<uint32_t>(-1);
+    attr.fragsize = static_cast<uint32_t>(pa_usec_to_bytes(fragmentMs_ * PA_USEC_PER_MSEC, &spec));
+
+    const char* device = deviceName_.empty() ? DEFAULT_MONITOR : deviceName_.c_str();
+    pa_stream_flags_t flags = static_cast<pa_stream_flags_t>(PA_STREAM_ADJUST_LATENCY | PA_STREAM_AUTO_TIMING_UPDATE | PA_STREAM_INTERPOLATE_TIMING);
+
+    if (pa_stream_connect_record(stream_, device, &attr, flags) < 0) {
+        SetLastError(PulseError("Failed to connect PulseAudio record stream", context_));
+        DisconnectStream();
+        return false;
+    }
+
+    for (;;) {
+        pa_stream_state_t state = pa_stream_get_state(stream_);
+        if (state == PA_STREAM_READY) break;
+        if (!PA_STREAM_IS_GOOD(state)) {
+            SetLastError(PulseError("PulseAudio record stream failed", context_));
+            DisconnectStream();
+            return false;
+        }
+        pa_threaded_mainloop_wait(mainloop_);
+    }
+
+    streamRunning_ = true;
     return true;
-    */
-    
-    return false;
+}
+
+void LinuxAudioCapture::DisconnectStream() {
+    streamRunning_ = false;
+    if (!stream_) return;
+
+    pa_stream_set_read_callback(stream_, nullptr, nullptr);
+    pa_stream_set_state_callback(stream_, nullptr, nullptr);
+    pa_stream_disconnect(stream_);
+    pa_stream_unref(stream_);
+    stream_ = nullptr;
 }
 
 void LinuxAudioCapture::CleanupPulseAudio() {
-    if (stream_) {
-        pa_simple_free(stream_);
-        stream_ = nullptr;
+    // Stop the mainloop thread first so no callback runs during teardown
+    if (mainloop_) {
+        pa_threaded_mainloop_stop(mainloop_);
+    }
+
+    DisconnectStream();
+
+    if (context_) {
+        pa_context_set_state_callback(context_, nullptr, nullptr);
+        pa_context_disconnect(context_);
+        pa_context_unref(context_);
+        context_ = nullptr;
+    }
+
+    if (mainloop_) {
+        pa_threaded_mainloop_free(mainloop_);
+        mainloop_ = nullptr;
+    }
+}
+
+void LinuxAudioCapture::DeliverAudio(const void* data, size_t length, uint64_t captureTimestamp) {
+    const uint32_t bytesPerFrame = currentFormat_.bytesPerFrame;
+    size_t frames = length / bytesPerFrame;
+    if (frames == 0) return;
+
+    std::lock_guard<std::mutex> lock(callbackMutex_);
+    if (!HasAudioCallback()) return;
+
+    // View straight over the server fragment (valid until pa_stream_drop)
+    AudioSampleView view;
+    view.data = static_cast<const uint8_t*>(data);
+    view.size = frames * bytesPerFrame;
+    view.format = currentFormat_;
+    view.frameCount = static_cast<uint32_t>(frames);
+    view.timestamp = MonotonicMicros();
+    view.captureTimestamp = captureTimestamp;
+
+    DispatchAudio(view);
+}
+
+void LinuxAudioCapture::ContextStateCallback(pa_context* /*context*/, void* userdata) {
+    auto* self = static_cast<LinuxAudioCapture*>(userdata);
+    pa_threaded_mainloop_signal(self->mainloop_, 0);
+}
+
+void LinuxAudioCapture::StreamStateCallback(pa_stream* stream, void* userdata) {
+    auto* self = static_cast<LinuxAudioCapture*>(userdata);
+
+    pa_stream_state_t state = pa_stream_get_state(stream);
+    if (state == PA_STREAM_FAILED) {
+        self->SetLastError(PulseError("PulseAudio record stream failed", self->context_));
+    }
+
+    // Lost after it was ready (server gone, source removed): capture ended
+    // without Stop(). Failures while connecting are ConnectStream()'s.
+    if (self->streamRunning_ && !PA_STREAM_IS_GOOD(state)) {
+        self->streamRunning_ = false;
+        self->streamFailed_ = true;
+        self->NotifyCaptureStopped();
+    }
+    pa_threaded_mainloop_signal(self->mainloop_, 0);
+}
+
+void LinuxAudioCapture::StreamReadCallback(pa_stream* stream, size_t length, void* userdata) {
+    auto* self = static_cast<LinuxAudioCapture*>(userdata);
+
+    // Drain every fragment the server has queued
+    while (pa_stream_readable_size(stream) > 0) {
+        const void* data = nullptr;
+        if (pa_stream_peek(stream, &data, &length) < 0) {
+            self->SetLastError(PulseError("pa_stream_peek() failed", self->context_));
+            return;
+        }
+
+        if (length == 0) break;
+
+        // For a record stream the latency is the age of the fragment at the
+        // read index, i.e. of the data just peeked
+        uint64_t captureTimestamp = 0;
+        pa_usec_t latency = 0;
+        int negative = 0;
+        if (pa_stream_get_latency(stream, &latency, &negative) == 0 && !negative) {
+            uint64_t now = MonotonicMicros();
+            captureTimestamp = latency < now ? now - latency : 0;
+        }
+
+        // A null pointer with a length marks a hole (dropped data)
+        if (data) {
+            self->DeliverAudio(data, length, captureTimestamp);
+        }
+        pa_stream_drop(stream);
+    }
+}
+
+void LinuxAudioCapture::SourceInfoCallback(pa_context* /*context*/, const pa_source_info* info, int eol, void* userdata) {
+    auto* query = static_cast<DeviceQuery*>(userdata);
+
+    if (eol) {
+        pa_threaded_mainloop_signal(query->mainloop, 0);
+        return;
+    }
+
+    // Only monitors of output sinks carry system audio
+    if (info && info->monitor_of_sink != PA_INVALID_INDEX) {
+        query->devices->push_back(info->name);
+    }
+}
+
+void LinuxAudioCapture::SubscribeCallback(pa_context* context, pa_subscription_event_type_t type, uint32_t /*index*/, void* userdata) {
+    auto* self = static_cast<LinuxAudioCapture*>(userdata);
+
+    unsigned facility = type & PA_SUBSCRIPTION_EVENT_FACILITY_MASK;
+    unsigned event = type & PA_SUBSCRIPTION_EVENT_TYPE_MASK;
+    if (facility == PA_SUBSCRIPTION_EVENT_SOURCE && event != PA_SUBSCRIPTION_EVENT_CHANGE) {
+        self->NotifyDevicesChanged();
+        return;
+    }
+    if (facility != PA_SUBSCRIPTION_EVENT_SERVER) return;
+
+    // The default sink may have moved; look it up without blocking the mainloop
+    self->NotifyDevicesChanged();
+    if (self->stream_ && self->followDefault_) {
+        pa_operation* operation = pa_context_get_server_info(context, ServerInfoCallback, self);
+        if (operation) {
+            pa_operation_unref(operation);
+        }
+    }
+}
+
+void LinuxAudioCapture::ServerInfoCallback(pa_context* context, const pa_server_info* info, void* userdata) {
+    auto* self = static_cast<LinuxAudioCapture*>(userdata);
+    if (!info || !info->default_sink_name || !self->stream_ || !self->followDefault_) return;
+
+    // Move the running stream itself, so the capture carries on without a gap
+    std::string monitor = std::string(info->default_sink_name) + ".monitor";
+    const char* current = pa_stream_get_device_name(self->stream_);
+    if (current && monitor == current) return;
+
+    pa_operation* operation = pa_context_move_source_output_by_name(
+        context, pa_stream_get_index(self->stream_), monitor.c_str(), nullptr, nullptr);
+    if (operation) {
+        pa_operation_unref(operation);
     }
 }
 
@@ -3,36 +3,80 @@
 #ifdef LINUX_PLATFORM
 
 #include "audio_capture_base.h"
-#include <pulse/simple.h>
-#include <thread>
+#include <pulse/pulseaudio.h>
 #include <atomic>
+#include <mutex>
 
 namespace AudioCapture {
 
+// System audio capture from a PulseAudio monitor source (also served by
+// PipeWire through pipewire-pulse). Runs on PulseAudio's threaded mainloop:
+// samples are delivered straight from the record stream's read callback.
+// Following the default sink, the stream is moved to the new default's
+// monitor in place when the default changes.
 class LinuxAudioCapture : public AudioCaptureBase {
 public:
     LinuxAudioCapture();
     ~LinuxAudioCapture() override;
-    
+
     bool Start() override;
     bool Stop() override;
     bool IsCapturing() const override;
     void SetAudioCallback(AudioCallback callback) override;
+    void SetAudioViewCallback(AudioViewCallback callback) override;
     AudioFormat GetFormat() const override;
     std::vector<std::string> GetAvailableDevices() override;
     bool SetDevice(const std::string& deviceId) override;
-    float GetVolumeLevel() const override;
     std::string GetLastError() const override;
-    void SetNoiseGateThreshold(float threshold) override;
+    bool SetBufferDuration(uint32_t milliseconds) override;
+    bool SetCaptureFormat(const CaptureFormatRequest& request) override;
 
 private:
-    pa_simple* stream_;
-    std::thread captureThread_;
-    std::atomic<bool> shouldStop_;
-    
-    void CaptureThreadFunction();
+    // PulseAudio objects; the context and streams are only touched with the
+    // mainloop lock held
+    pa_threaded_mainloop* mainloop_;
+    pa_context* context_;
+    pa_stream* stream_;
+    bool streamRunning_;               // stream_ reached READY; mainloop lock held
+    std::atomic<bool> streamFailed_;   // Stream lost while capturing; cleared by Stop()
+
+    // Monitor source name, empty for the default sink's monitor
+    std::string deviceName_;
+    std::atomic<bool> followDefault_;  // deviceName_ is empty; read on the mainloop thread
+
+    // Requested record fragment size
+    uint32_t fragmentMs_;
+
+    // Guards the callbacks against SetAudioCallback/SetAudioViewCallback
+    std::mutex callbackMutex_;
+
+    // lastError_ is also written from the mainloop thread
+    mutable std::mutex errorMutex_;
+    void SetLastError(const std::string& error);
+
     bool InitializePulseAudio();
+    bool ConnectStream();
+    void DisconnectStream();
     void CleanupPulseAudio();
+    void DeliverAudio(const void* data, size_t length, uint64_t captureTimestamp);
+
+    // PulseAudio callbacks (run on the mainloop thread)
+    static void ContextStateCallback(pa_context* context, void* userdata);
+    static void StreamStateCallback(pa_stream* stream, void* userdata);
+    static void StreamReadCallback(pa_stream* stream, size_t length, void* userdata);
+    static void SourceInfoCallback(pa_context* context, const pa_source_info* info, int eol, void* userdata);
+    static void SubscribeCallback(pa_context* context, pa_subscription_event_type_t type, uint32_t index, void* userdata);
+    static void ServerInfoCallback(pa_context* context, const pa_server_info* info, void* userdata);
+
+    // Constants
+    static constexpr uint32_t CAPTURE_SAMPLE_RATE = 48000;
+    static constexpr uint8_t CAPTURE_CHANNELS = 2;
+    static constexpr uint32_t MIN_SAMPLE_RATE = 8000;
+    static constexpr uint32_t MAX_SAMPLE_RATE = 192000;
+    static constexpr uint32_t FRAGMENT_SIZE_MS = 10;
+    static constexpr uint32_t MIN_FRAGMENT_SIZE_MS = 1;
+    static constexpr uint32_t MAX_FRAGMENT_SIZE_MS = 2000;
+    static constexpr const char* DEFAULT_MONITOR = "@DEFAULT_MONITOR@";
 };
 
 } // namespace AudioCapture
@@ -29,25 +29,26 @@ public:
     bool Stop() override;
     bool IsCapturing() const override;
     void SetAudioCallback(AudioCallback callback) override;
+    void SetAudioViewCallback(AudioViewCallback callback) override;
     AudioFormat GetFormat() const override;
     std::vector<std::string> GetAvailableDevices() override;
     bool SetDevice(const std::string& deviceId) override;
-    float GetVolumeLevel() const override;
     std::string GetLastError() const override;
+    bool SetCaptureFormat(const CaptureFormatRequest& request) override;
     
     // Helper methods for delegate callbacks
     void UpdateFormat(double sampleRate, uint32_t channels, uint32_t bitsPerSample, bool isFloat, bool isNonInterleaved, uint32_t formatFlags);
-    float CalculateRMSLevel(const uint8_t* data, size_t length, const AudioStreamBasicDescription* format);
-    void SetVolumeLevel(float level);
     void SetLastError(const std::string& error);
-    void OnAudioData(const uint8_t* data, size_t length);
-    void SetNoiseGateThreshold(float threshold) override;
+    void OnAudioData(const uint8_t* data, size_t length, uint64_t captureTimestamp);
+    void OnDevicesChanged();
+    void OnStreamStopped();
 
 private:
     SCStream* stream_;
     AudioStreamDelegate* streamDelegate_;
     std::atomic<bool> shouldStop_;
-    float noiseGateThreshold_;
+    uint32_t streamSampleRate_;  // Requested from ScreenCaptureKit at Start()
+    uint16_t streamChannels_;
     
     void CleanupResources();
 };
@@ -1,17 +1,21 @@
 #ifdef MACOS_PLATFORM
 
 #import "macos_audio_capture.h"
+#include "audio_format_kernels.h"
 #import <Foundation/Foundation.h>
 #import <AVFoundation/AVFoundation.h>
 #import <ScreenCaptureKit/ScreenCaptureKit.h>
 #import <CoreMedia/CoreMedia.h>
-#include <chrono>
+#import <CoreAudio/CoreAudio.h>
 
 @interface AudioStreamDelegate : NSObject <SCStreamDelegate, SCStreamOutput>
 @property (nonatomic, assign) AudioCapture::MacOSAudioCapture* captureInstance;
 @end
 
-@implementation AudioStreamDelegate
+@implementation AudioStreamDelegate {
+    // Only used when a block buffer is not contiguous (sample handler queue is serial)
+    std::vector<uint8_t> _gatherBuffer;
+}
 
 - (void)stream:(SCStream *)stream didOutputSampleBuffer:(CMSampleBufferRef)sampleBuffer ofType:(SCStreamOutputType)type {
     if (type != SCStreamOutputTypeAudio || !self.captureInstance) {
@@ -25,12 +29,22 @@
     size_t length = CMBlockBufferGetDataLength(blockBuffer);
     if (length == 0) return;
     
-    // Allocate buffer for audio data
-    std::vector<uint8_t> audioData(length);
-    
-    // Copy audio data
-    OSStatus status = CMBlockBufferCopyDataBytes(blockBuffer, 0, length, audioData.data());
-    if (status != noErr) return;
+    // Read the samples in place; ScreenCaptureKit delivers one contiguous block
+    // (planar channels back to back), so gathering is only a fallback
+    const uint8_t* audioData = nullptr;
+    if (CMBlockBufferIsRangeContiguous(blockBuffer, 0, length)) {
+        char* dataPointer = nullptr;
+        OSStatus status = CMBlockBufferGetDataPointer(blockBuffer, 0, nullptr, nullptr, &dataPointer);
+        if (status != kCMBlockBufferNoErr || !dataPointer) return;
+        audioData = reinterpret_cast<const uint8_t*>(dataPointer);
+    } else {
+        if (_gatherBuffer.size() < length) {
+            _gatherBuffer.resize(length);
+        }
+        OSStatus status = CMBlockBufferCopyDataBytes(blockBuffer, 0, length, _gatherBuffer.data());
+        if (status != kCMBlockBufferNoErr) return;
+        audioData = _gatherBuffer.data();
+    }
     
     // Get audio format description
     CMFormatDescriptionRef formatDesc = CMSampleBufferGetFormatDescription(sampleBuffer);
@@ -44,14 +58,22 @@
         // Audio format detected: 48kHz, 2ch, 32-bit float, non-interleaved
         
         self.captureInstance->UpdateFormat(asbd->mSampleRate, asbd->mChannelsPerFrame, asbd->mBitsPerChannel, isFloat, isNonInterleaved, asbd->mFormatFlags);
-        
-        // Calculate RMS level for volume indication
-        float rmsLevel = self.captureInstance->CalculateRMSLevel(audioData.data(), length, asbd);
-        self.captureInstance->SetVolumeLevel(rmsLevel);
     }
     
-    // Send audio data to callback
-    self.captureInstance->OnAudioData(audioData.data(), length);
+    // Presentation time is the first sample's capture on the host clock; carry
+    // its age over to MonotonicMicros() rather than mixing the two clocks
+    uint64_t captureTimestamp = 0;
+    CMTime presentation = CMSampleBufferGetPresentationTimeStamp(sampleBuffer);
+    if (CMTIME_IS_VALID(presentation)) {
+        CMTime now = CMClockGetTime(CMClockGetHostTimeClock());
+        Float64 ageSeconds = CMTimeGetSeconds(CMTimeSubtract(now, presentation));
+        if (ageSeconds >= 0.0 && ageSeconds < 1.0) {
+            captureTimestamp = AudioCapture::MonotonicMicros() - static_cast<uint64_t>(ageSeconds * 1000000.0);
+        }
+    }
+    
+    // Send audio data to callback; level metering and gating happen downstream
+    self.captureInstance->OnAudioData(audioData, length, captureTimestamp);
 }
 
 - (void)stream:(SCStream *)stream didStopWithError:(NSError *)error {
@@ -60,14 +82,37 @@
             self.captureInstance->SetLastError([error.localizedDescription UTF8String]);
         }
     }
+    // Only sent when the stream stops without stopCapture
+    if (self.captureInstance) {
+        self.captureInstance->OnStreamStopped();
+    }
 }
 
 @end
 
 namespace AudioCapture {
 
+namespace {
+
+// Hardware properties whose changes invalidate the device list
+const AudioObjectPropertyAddress kDeviceListProperties[] = {
+    { kAudioHardwarePropertyDevices, kAudioObjectPropertyScopeGlobal, kAudioObjectPropertyElementMain },
+    { kAudioHardwarePropertyDefaultOutputDevice, kAudioObjectPropertyScopeGlobal, kAudioObjectPropertyElementMain },
+};
+
+OSStatus HardwareListener(AudioObjectID /*object*/, UInt32 /*count*/,
+                          const AudioObjectPropertyAddress* /*addresses*/, void* clientData) {
+    // ScreenCaptureKit captures the system mix whichever output is the
+    // default, so only the device list is affected
+    static_cast<MacOSAudioCapture*>(clientData)->OnDevicesChanged();
+    return noErr;
+}
+
+} // namespace
+
 MacOSAudioCapture::MacOSAudioCapture()
-    : stream_(nil), streamDelegate_(nil), shouldStop_(false), noiseGateThreshold_(0.02f) {
+    : stream_(nil), streamDelegate_(nil), shouldStop_(false)
+    , streamSampleRate_(48000), streamChannels_(2) {
     
     // Initialize default format (will be updated when stream starts)
     currentFormat_.sampleRate = 48000;
@@ -75,10 +120,15 @@ MacOSAudioCapture::MacOSAudioCapture()
     currentFormat_.bitsPerSample = 32;
     currentFormat_.bytesPerFrame = 8;
     currentFormat_.blockAlign = 8;
+    FormatKernels::Resolve(currentFormat_);
     
     // Create stream delegate
     streamDelegate_ = [[AudioStreamDelegate alloc] init];
     [(AudioStreamDelegate*)streamDelegate_ setCaptureInstance:this];
+    
+    for (const AudioObjectPropertyAddress& address : kDeviceListProperties) {
+        AudioObjectAddPropertyListener(kAudioObjectSystemObject, &address, HardwareListener, this);
+    }
 }
 
 MacOSAudioCapture::~MacOSAudioCapture() {
@@ -124,8 +174,8 @@ bool MacOSAudioCapture::Start() {
                 SCStreamConfiguration* config = [[SCStreamConfiguration alloc] init];
                 config.capturesAudio = YES;
                 config.excludesCurrentProcessAudio = YES;  // Don't capture our own audio
-                config.sampleRate = 48000;
-                config.channelCount = 2;
+                config.sampleRate = streamSampleRate_;
+                config.channelCount = streamChannels_;
                 
                 // CRITICAL: Set minimal video config to avoid CoreGraphicsErrorDomain 1003
                 // The stream fails if video dimensions are too small (e.g., 1x1)
@@ -149,10 +199,16 @@ bool MacOSAudioCapture::Start() {
                     dispatch_semaphore_signal(semaphore);
                     return;
                 }
+                // Serial queue: packets arrive in order and the delegate's
+                // reused buffers are never touched concurrently
+                dispatch_queue_attr_t queueAttributes = dispatch_queue_attr_make_with_qos_class(
+                    DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INTERACTIVE, 0);
+                dispatch_queue_t sampleQueue = dispatch_queue_create("audiomid.capture.audio", queueAttributes);
+                
                 NSError* addOutputError = nil;
                 BOOL addSuccess = [stream_ addStreamOutput:(id<SCStreamOutput>)streamDelegate_ 
                                                       type:SCStreamOutputTypeAudio 
-                                          sampleHandlerQueue:dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0) 
+                                          sampleHandlerQueue:sampleQueue 
                                                        error:&addOutputError];
                 
                 if (!addSuccess || addOutputError) {
@@ -225,6 +281,10 @@ void MacOSAudioCapture::SetAudioCallback(AudioCallback callback) {
     audioCallback_ = callback;
 }
 
+void MacOSAudioCapture::SetAudioViewCallback(AudioViewCallback callback) {
+    audioViewCallback_ = callback;
+}
+
 AudioFormat MacOSAudioCapture::GetFormat() const {
     return currentFormat_;
 }
@@ -239,16 +299,49 @@ bool MacOSAudioCapture::SetDevice(const std::string& deviceId) {
     return true;
 }
 
-float MacOSAudioCapture::GetVolumeLevel() const {
-    return currentVolumeLevel_;
-}
-
 std::string MacOSAudioCapture::GetLastError() const {
     return lastError_;
 }
 
 // Helper methods for audio processing
+bool MacOSAudioCapture::SetCaptureFormat(const CaptureFormatRequest& request) {
+    // ScreenCaptureKit only renders these rates natively
+    uint32_t sampleRate = request.sampleRate ? request.sampleRate : 48000;
+    uint16_t channels = request.channels ? request.channels : 2;
+    if ((sampleRate != 8000 && sampleRate != 16000 && sampleRate != 24000 && sampleRate != 48000) ||
+        channels > 2) {
+        lastError_ = "ScreenCaptureKit supports 8000, 16000, 24000 or 48000 Hz with 1 or 2 channels";
+        return false;
+    }
+    
+    if (isCapturing_) {
+        lastError_ = "Stop capture before changing the capture format";
+        return false;
+    }
+    
+    streamSampleRate_ = sampleRate;
+    streamChannels_ = channels;
+    
+    // Reported until the first buffer updates it from the actual stream
+    currentFormat_.sampleRate = sampleRate;
+    currentFormat_.channels = channels;
+    currentFormat_.bytesPerFrame = (currentFormat_.bitsPerSample / 8) * channels;
+    currentFormat_.blockAlign = currentFormat_.bytesPerFrame;
+    FormatKernels::Resolve(currentFormat_);
+    return true;
+}
+
 void MacOSAudioCapture::UpdateFormat(double sampleRate, uint32_t channels, uint32_t bitsPerSample, bool isFloat, bool isNonInterleaved, uint32_t formatFlags) {
+    // Called for every buffer; kernels are only selected again when the stream format changes
+    if (currentFormat_.kernels &&
+        currentFormat_.sampleRate == static_cast<uint32_t>(sampleRate) &&
+        currentFormat_.channels == channels &&
+        currentFormat_.bitsPerSample == bitsPerSample &&
+        currentFormat_.isFloat == isFloat &&
+        currentFormat_.isNonInterleaved == isNonInterleaved) {
+        return;
+    }
+    
     currentFormat_.sampleRate = static_cast<int>(sampleRate);
     currentFormat_.channels = channels;
     currentFormat_.bitsPerSample = bitsPerSample;
@@ -257,90 +350,40 @@ void MacOSAudioCapture::UpdateFormat(double sampleRate, uint32_t channels, uint3
     currentFormat_.isFloat = isFloat;
     currentFormat_.isNonInterleaved = isNonInterleaved;
     currentFormat_.formatFlags = formatFlags;
-}
-
-float MacOSAudioCapture::CalculateRMSLevel(const uint8_t* data, size_t length, const AudioStreamBasicDescription* format) {
-    if (!data || length == 0 || !format) return 0.0f;
-    
-    float rms = 0.0f;
-    size_t sampleCount = length / (format->mBitsPerChannel / 8);
-    
-    if (format->mBitsPerChannel == 32 && (format->mFormatFlags & kAudioFormatFlagIsFloat)) {
-        // 32-bit float samples
-        const float* samples = reinterpret_cast<const float*>(data);
-        for (size_t i = 0; i < sampleCount; i++) {
-            rms += samples[i] * samples[i];
-        }
-    } else if (format->mBitsPerChannel == 16) {
-        // 16-bit integer samples
-        const int16_t* samples = reinterpret_cast<const int16_t*>(data);
-        for (size_t i = 0; i < sampleCount; i++) {
-            float normalizedSample = samples[i] / 32768.0f;
-            rms += normalizedSample * normalizedSample;
-        }
-    }
-    
-    if (sampleCount > 0) {
-        rms = sqrt(rms / sampleCount);
-    }
-    
-    return rms;
-}
-
-void MacOSAudioCapture::SetVolumeLevel(float level) {
-    currentVolumeLevel_ = level;
+    FormatKernels::Resolve(currentFormat_);
 }
 
 void MacOSAudioCapture::SetLastError(const std::string& error) {
     lastError_ = error;
 }
 
-void MacOSAudioCapture::SetNoiseGateThreshold(float threshold) {
-    noiseGateThreshold_ = threshold;
+void MacOSAudioCapture::OnAudioData(const uint8_t* data, size_t length, uint64_t captureTimestamp) {
+    if (HasAudioCallback() && data && length > 0) {
+        // View over the CoreMedia block buffer (valid while the handler runs)
+        AudioSampleView view;
+        view.data = data;
+        view.size = length;
+        view.format = currentFormat_;
+        view.timestamp = MonotonicMicros();
+        view.captureTimestamp = captureTimestamp;
+        view.frameCount = length / currentFormat_.bytesPerFrame;
+        DispatchAudio(view);
+    }
 }
 
-void MacOSAudioCapture::OnAudioData(const uint8_t* data, size_t length) {
-    if (audioCallback_ && data && length > 0) {
-        // Apply configurable noise gate - filter out background noise
-        
-        // Calculate current RMS level for gating
-        float rms = 0.0f;
-        size_t sampleCount = length / (currentFormat_.bitsPerSample / 8);
-        
-        if (currentFormat_.bitsPerSample == 32) {
-            // 32-bit float samples
-            const float* samples = reinterpret_cast<const float*>(data);
-            for (size_t i = 0; i < sampleCount; i++) {
-                rms += samples[i] * samples[i];
-            }
-        } else if (currentFormat_.bitsPerSample == 16) {
-            // 16-bit integer samples
-            const int16_t* samples = reinterpret_cast<const int16_t*>(data);
-            for (size_t i = 0; i < sampleCount; i++) {
-                float normalizedSample = samples[i] / 32768.0f;
-                rms += normalizedSample * normalizedSample;
-            }
-        }
-        
-        if (sampleCount > 0) {
-            rms = sqrt(rms / sampleCount);
-        }
-        
-        // Only send audio if it's above the configurable noise threshold
-        // Special case: threshold 0.0 means disable noise gate (allow all audio)
-        if (noiseGateThreshold_ <= 0.0f || rms > noiseGateThreshold_) {
-            AudioSample sample;
-            sample.data.assign(data, data + length);
-            sample.format = currentFormat_;
-            sample.timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
-                std::chrono::steady_clock::now().time_since_epoch()).count();
-            sample.frameCount = length / currentFormat_.bytesPerFrame;
-            audioCallback_(sample);
-        }
-    }
+void MacOSAudioCapture::OnDevicesChanged() {
+    NotifyDevicesChanged();
+}
+
+void MacOSAudioCapture::OnStreamStopped() {
+    NotifyCaptureStopped();
 }
 
 void MacOSAudioCapture::CleanupResources() {
+    for (const AudioObjectPropertyAddress& address : kDeviceListProperties) {
+        AudioObjectRemovePropertyListener(kAudioObjectSystemObject, &address, HardwareListener, this);
+    }
+    
     @autoreleasepool {
         if (streamDelegate_) {
             [(AudioStreamDelegate*)streamDelegate_ setCaptureInstance:nil];
@@ -0,0 +1,431 @@
+#include "multi_source_audio_capture.h"
+#include "audio_format_converter.h"
+#include "audio_format_kernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace AudioCapture {
+
+namespace {
+
+constexpr const char* MIX_DEVICE_PREFIX = "mix:";
+constexpr const char* TRACKS_DEVICE_PREFIX = "tracks:";
+
+bool HasPrefix(const std::string& value, const char* prefix) {
+    return value.compare(0, std::strlen(prefix), prefix) == 0;
+}
+
+} // namespace
+
+bool MultiSourceOptions::Parse(const std::string& deviceId, MultiSourceOptions& options, std::string& error) {
+    options = MultiSourceOptions();
+    options.tracks = HasPrefix(deviceId, TRACKS_DEVICE_PREFIX);
+    if (!options.tracks && !HasPrefix(deviceId, MIX_DEVICE_PREFIX)) {
+        error = "Multi-source device ids start with \"mix:\" or \"tracks:\"";
+        return false;
+    }
+
+    std::string spec = deviceId.substr(std::strlen(options.tracks ? TRACKS_DEVICE_PREFIX : MIX_DEVICE_PREFIX));
+    size_t begin = 0;
+    while (begin <= spec.size()) {
+        size_t end = spec.find('|', begin);
+        std::string source = spec.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+        if (source.empty()) {
+            error = "Multi-source device id has an empty source";
+            return false;
+        }
+        if (IsMultiSourceDevice(source)) {
+            error = "Multi-source devices cannot be nested";
+            return false;
+        }
+        options.sources.push_back(source);
+        if (end == std::string::npos) break;
+        begin = end + 1;
+    }
+
+    if (options.sources.size() < 2 || options.sources.size() > MAX_SOURCES) {
+        error = "Multi-source device needs 2-8 sources";
+        return false;
+    }
+    return true;
+}
+
+bool IsMultiSourceDevice(const std::string& deviceId) {
+    return HasPrefix(deviceId, MIX_DEVICE_PREFIX) || HasPrefix(deviceId, TRACKS_DEVICE_PREFIX);
+}
+
+MultiSourceAudioCapture::MultiSourceAudioCapture()
+    : epochMicros_(0)
+    , shouldStop_(false)
+    , finished_(false)
+    , stoppedSource_(NO_SOURCE)
+    , mixFrame_(0) {
+    currentFormat_ = {};
+}
+
+MultiSourceAudioCapture::~MultiSourceAudioCapture() {
+    Stop();
+}
+
+bool MultiSourceAudioCapture::Start() {
+    if (IsCapturing()) return true;
+
+    // Release the sources and mixer of a capture that ended on its own
+    if (isCapturing_) {
+        Stop();
+    }
+
+    if (sources_.empty()) {
+        lastError_ = "No sources selected; use setDevice(\"mix:<id>|<id>\")";
+        return false;
+    }
+
+    for (auto& source : sources_) {
+        source->ring.Clear();
+        source->started = false;
+        source->rejectedRate = 0;
+        source->seen = false;
+        source->overruns = source->ring.OverrunCount();
+    }
+
+    mixFrame_ = 0;
+    epochMicros_ = MonotonicMicros();
+    finished_ = false;
+    stoppedSource_ = NO_SOURCE;
+
+    for (size_t i = 0; i < sources_.size(); ++i) {
+        if (!sources_[i]->capture->Start()) {
+            lastError_ = "Source " + sources_[i]->deviceId + ": " + sources_[i]->capture->GetLastError();
+            for (size_t j = 0; j < i; ++j) {
+                sources_[j]->capture->Stop();
+            }
+            return false;
+        }
+    }
+
+    shouldStop_ = false;
+    isCapturing_ = true;
+    mixerThread_ = std::thread(&MultiSourceAudioCapture::MixerThreadFunction, this);
+    return true;
+}
+
+bool MultiSourceAudioCapture::Stop() {
+    // Sources first, so the mixer sees no more audio once it stops
+    for (auto& source : sources_) {
+        source->capture->Stop();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(stopMutex_);
+        shouldStop_ = true;
+    }
+    stopCondition_.notify_all();
+
+    if (mixerThread_.joinable()) {
+        mixerThread_.join();
+    }
+
+    isCapturing_ = false;
+    return true;
+}
+
+bool MultiSourceAudioCapture::IsCapturing() const {
+    return isCapturing_ && !finished_;
+}
+
+void MultiSourceAudioCapture::SetAudioCallback(AudioCallback callback) {
+    std::lock_guard<std::mutex> lock(callbackMutex_);
+    audioCallback_ = callback;
+}
+
+void MultiSourceAudioCapture::SetAudioViewCallback(AudioViewCallback callback) {
+    std::lock_guard<std::mutex> lock(callbackMutex_);
+    audioViewCallback_ = callback;
+}
+
+AudioFormat MultiSourceAudioCapture::GetFormat() const {
+    return currentFormat_;
+}
+
+std::vector<std::string> MultiSourceAudioCapture::GetAvailableDevices() {
+    return options_.sources;
+}
+
+bool MultiSourceAudioCapture::SetDevice(const std::string& deviceId) {
+    if (isCapturing_) {
+        lastError_ = "Stop capture before changing the sources";
+        return false;
+    }
+
+    MultiSourceOptions options;
+    if (!MultiSourceOptions::Parse(deviceId, options, lastError_)) {
+        return false;
+    }
+
+    std::vector<std::unique_ptr<Source>> sources;
+    for (const std::string& sourceId : options.sources) {
+        auto source = std::make_unique<Source>(SOURCE_RING_FRAMES);
+        source->deviceId = sourceId;
+        source->capture = CreateAudioCapture(sourceId);
+        if (!source->capture) {
+            lastError_ = "Failed to create audio capture for source " + sourceId;
+            return false;
+        }
+        if (!source->capture->SetDevice(sourceId)) {
+            lastError_ = "Source " + sourceId + ": " + source->capture->GetLastError();
+            return false;
+        }
+
+        Source* target = source.get();
+        size_t index = sources.size();
+        source->capture->SetAudioViewCallback([this, target](const AudioSampleView& view) {
+            OnSourceAudio(*target, view);
+        });
+        source->capture->SetDeviceChangeCallback([this]() {
+            NotifyDevicesChanged();
+        });
+        // On the source's thread: the mixer ends the capture
+        source->capture->SetCaptureStoppedCallback([this, index]() {
+            size_t none = NO_SOURCE;
+            stoppedSource_.compare_exchange_strong(none, index);
+            stopCondition_.notify_all();
+        });
+        sources.push_back(std::move(source));
+    }
+
+    sources_ = std::move(sources);
+    stoppedSource_ = NO_SOURCE;
+    options_ = options;
+    deviceId_ = deviceId;
+
+    // Mix: mono; tracks: one interleaved float32 channel per source
+    currentFormat_ = {};
+    currentFormat_.sampleRate = SAMPLE_RATE;
+    currentFormat_.channels = static_cast<uint16_t>(options_.tracks ? sources_.size() : 1);
+    currentFormat_.bitsPerSample = 32;
+    currentFormat_.isFloat = true;
+    currentFormat_.bytesPerFrame = currentFormat_.channels * sizeof(float);
+    currentFormat_.blockAlign = currentFormat_.bytesPerFrame;
+    FormatKernels::Resolve(currentFormat_);
+    return true;
+}
+
+std::string MultiSourceAudioCapture::GetLastError() const {
+    size_t stopped = stoppedSource_.load();
+    if (stopped != NO_SOURCE) {
+        const Source& source = *sources_[stopped];
+        std::string error = source.capture->GetLastError();
+        return "Source " + source.deviceId + " stopped" + (error.empty() ? std::string() : ": " + error);
+    }
+
+    for (const auto& source : sources_) {
+        uint32_t rate = source->rejectedRate.load(std::memory_order_relaxed);
+        if (rate != 0) {
+            return "Source " + source->deviceId + " delivers " + std::to_string(rate) +
+                   " Hz; mixing requires 48000 Hz";
+        }
+    }
+    return lastError_;
+}
+
+bool MultiSourceAudioCapture::SetBufferDuration(uint32_t milliseconds) {
+    if (isCapturing_) return false;
+
+    bool applied = false;
+    for (auto& source : sources_) {
+        applied = source->capture->SetBufferDuration(milliseconds) || applied;
+    }
+    return applied;
+}
+
+uint64_t MultiSourceAudioCapture::TimelineFrame(uint64_t micros) const {
+    uint64_t epoch = epochMicros_.load(std::memory_order_relaxed);
+    return micros > epoch ? (micros - epoch) * SAMPLE_RATE / 1000000 : 0;
+}
+
+void MultiSourceAudioCapture::OnSourceAudio(Source& source, const AudioSampleView& view) {
+    if (view.format.sampleRate != SAMPLE_RATE) {
+        source.rejectedRate.store(view.format.sampleRate, std::memory_order_relaxed);
+        return;
+    }
+
+    size_t maxFrames = AudioFormatConverter::GetMonoFrameCount(view.format, view.size);
+    if (maxFrames == 0) return;
+
+    // Silence runs skip conversion and are written as zeros below
+    size_t frames = maxFrames;
+    if (!view.silent) {
+        // Grows to the packet size once, then reused
+        if (source.converted.size() < maxFrames) {
+            source.converted.resize(maxFrames);
+        }
+        frames = AudioFormatConverter::ConvertToMonoFloat32(view.data, view.size, view.format,
+                                                            source.converted.data(), maxFrames);
+        if (frames == 0) return;
+    }
+
+    // Place the packet by its first sample's capture time: the source's fitted
+    // device clock when it has one, otherwise estimated from delivery
+    uint64_t packetStart = TimelineFrame(view.CaptureMicros());
+    const float* samples = source.converted.data();
+
+    if (!source.started.load(std::memory_order_relaxed)) {
+        source.nextFrame = packetStart;
+        source.startFrame.store(packetStart, std::memory_order_relaxed);
+        source.started.store(true, std::memory_order_release);
+    } else if (packetStart > source.nextFrame + SAMPLE_RATE * GAP_TOLERANCE_MS / 1000) {
+        // The source paused (loopback delivers nothing while idle): keep the
+        // timeline by writing the gap as silence. Every ring sample is one
+        // timeline frame, so the whole gap is pushed; beyond the ring's
+        // capacity this only moves its indices
+        source.ring.PushZeros(static_cast<size_t>(packetStart - source.nextFrame));
+        source.nextFrame = packetStart;
+    }
+
+    // A source on a locked device clock is steered onto the timeline one
+    // sample per packet, so clock drift never builds up between sources. The
+    // rest stay contiguous; their drift is absorbed by the mixer's latency bound.
+    const uint64_t deadband = SAMPLE_RATE * DRIFT_DEADBAND_MS / 1000;
+    if (source.capture->ClockDrift().locked) {
+        if (packetStart > source.nextFrame + deadband) {
+            // Device clock slow: repeat one sample
+            if (view.silent) {
+                source.ring.PushZeros(1);
+            } else {
+                source.ring.Push(samples, 1);
+            }
+            source.nextFrame += 1;
+        } else if (packetStart + deadband < source.nextFrame && frames > 1) {
+            // Device clock fast: drop one sample
+            ++samples;
+            --frames;
+        }
+    }
+
+    if (view.silent) {
+        source.ring.PushZeros(frames);
+    } else {
+        source.ring.Push(samples, frames);
+    }
+    source.nextFrame += frames;
+    source.endFrame.store(source.nextFrame, std::memory_order_release);
+}
+
+void MultiSourceAudioCapture::MixerThreadFunction() {
+    const uint64_t maxLatencyFrames = static_cast<uint64_t>(SAMPLE_RATE) * MAX_LATENCY_MS / 1000;
+
+    while (!shouldStop_) {
+        {
+            std::unique_lock<std::mutex> lock(stopMutex_);
+            stopCondition_.wait_for(lock, std::chrono::milliseconds(MIX_INTERVAL_MS),
+                                    [this]() { return shouldStop_.load(); });
+        }
+        if (shouldStop_) break;
+
+        // A source ended on its own; the others keep running until Stop()
+        if (stoppedSource_.load() != NO_SOURCE) {
+            finished_ = true;
+            NotifyCaptureStopped();
+            break;
+        }
+
+        // Mix up to where every source has audio, or where the slowest is too
+        // far behind to wait for
+        uint64_t ready = UINT64_MAX;
+        for (const auto& source : sources_) {
+            uint64_t end = source->started.load(std::memory_order_acquire)
+                ? source->endFrame.load(std::memory_order_acquire) : 0;
+            ready = std::min(ready, end);
+        }
+
+        uint64_t now = TimelineFrame(MonotonicMicros());
+        uint64_t deadline = now > maxLatencyFrames ? now - maxLatencyFrames : 0;
+        uint64_t target = std::max(ready, deadline);
+
+        while (mixFrame_ < target && !shouldStop_) {
+            MixRange(static_cast<size_t>(std::min<uint64_t>(target - mixFrame_, MAX_PACKET_FRAMES)));
+        }
+    }
+}
+
+size_t MultiSourceAudioCapture::PopSource(Source& source, size_t count, bool discard) {
+    size_t popped = discard ? source.ring.Skip(count) : source.ring.Pop(sourceScratch_.data(), count);
+
+    // Overwritten samples moved the read position forward as well
+    uint64_t overruns = source.ring.OverrunCount();
+    source.readFrame += popped + (overruns - source.overruns);
+    source.overruns = overruns;
+    return popped;
+}
+
+void MultiSourceAudioCapture::MixRange(size_t frames) {
+    const size_t channels = options_.tracks ? sources_.size() : 1;
+    output_.assign(frames * channels, 0.0f);
+    if (sourceScratch_.size() < frames) {
+        sourceScratch_.resize(frames);
+    }
+
+    for (size_t index = 0; index < sources_.size(); ++index) {
+        Source& source = *sources_[index];
+        if (!source.started.load(std::memory_order_acquire)) continue;
+
+        if (!source.seen) {
+            source.readFrame = source.startFrame.load(std::memory_order_relaxed);
+            source.seen = true;
+        }
+
+        // Audio before the mix position arrived too late: discard it. The
+        // read position only moves with the ring, so a stalled source's audio
+        // still lands at its own timeline frames once it resumes
+        while (source.readFrame < mixFrame_) {
+            size_t skip = static_cast<size_t>(
+                std::min<uint64_t>(mixFrame_ - source.readFrame, source.ring.Capacity()));
+            if (PopSource(source, skip, true) == 0) break;
+        }
+
+        // Nothing buffered up to the mix position: silent for this range
+        if (source.readFrame < mixFrame_) continue;
+
+        // A source that started later than the mix position leads with silence
+        size_t lead = static_cast<size_t>(std::min<uint64_t>(source.readFrame - mixFrame_, frames));
+        size_t popped = PopSource(source, frames - lead, false);
+
+        const float* samples = sourceScratch_.data();
+        if (options_.tracks) {
+            float* track = output_.data() + index;
+            for (size_t i = 0; i < popped; ++i) {
+                track[(lead + i) * channels] = samples[i];
+            }
+        } else {
+            float* mix = output_.data() + lead;
+            for (size_t i = 0; i < popped; ++i) {
+                mix[i] += samples[i];
+            }
+        }
+    }
+
+    if (!options_.tracks) {
+        // Summing can exceed full scale
+        for (float& sample : output_) {
+            sample = std::min(std::max(sample, -1.0f), 1.0f);
+        }
+    }
+
+    mixFrame_ += frames;
+
+    std::lock_guard<std::mutex> lock(callbackMutex_);
+    if (!HasAudioCallback()) return;
+
+    AudioSampleView view;
+    view.data = reinterpret_cast<const uint8_t*>(output_.data());
+    view.size = output_.size() * sizeof(float);
+    view.format = currentFormat_;
+    view.frameCount = static_cast<uint32_t>(frames);
+    view.timestamp = epochMicros_.load(std::memory_order_relaxed) + mixFrame_ * 1000000 / SAMPLE_RATE;
+    view.captureTimestamp = epochMicros_.load(std::memory_order_relaxed) + (mixFrame_ - frames) * 1000000 / SAMPLE_RATE;
+
+    DispatchAudio(view);
+}
+
+} // namespace AudioCapture
\ No newline at end of file
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "audio_capture_base.h"
+#include "spsc_ring_buffer.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace AudioCapture {
+
+// Sources of a multi-source device id, separated by '|':
+//   mix:<deviceId>|<deviceId>...     one mono stream, sources summed
+//   tracks:<deviceId>|<deviceId>...  interleaved float32, one channel per source
+// Each source id is what setDevice() would accept on its own (including "file:").
+struct MultiSourceOptions {
+    std::vector<std::string> sources;
+    bool tracks = false;  // Deliver aligned tracks instead of a mix
+
+    static constexpr size_t MAX_SOURCES = 8;
+
+    static bool Parse(const std::string& deviceId, MultiSourceOptions& options, std::string& error);
+};
+
+// Whether a device id selects the multi-source backend
+bool IsMultiSourceDevice(const std::string& deviceId);
+
+// Capture backend running several backends at once (e.g. system loopback and a
+// microphone source). Each source converts its packets to 48kHz mono on its
+// own capture thread and places them on a shared timeline derived from the
+// packets' capture timestamps; one mixer thread aligns the sources on that
+// timeline and delivers either the mix or sample-aligned tracks in a single
+// packet. Sources whose device clock is locked are steered against drift.
+//
+// A source that falls silent or stalls is filled with silence once it is
+// MAX_LATENCY_MS behind, so the combined stream keeps flowing. A source that
+// stops on its own (a file source at its end, a failed stream) ends the
+// whole capture.
+class MultiSourceAudioCapture : public AudioCaptureBase {
+public:
+    MultiSourceAudioCapture();
+    ~MultiSourceAudioCapture() override;
+
+    bool Start() override;
+    bool Stop() override;
+    bool IsCapturing() const override;
+    void SetAudioCallback(AudioCallback callback) override;
+    void SetAudioViewCallback(AudioViewCallback callback) override;
+    AudioFormat GetFormat() const override;
+    std::vector<std::string> GetAvailableDevices() override;
+    bool SetDevice(const std::string& deviceId) override;
+    std::string GetLastError() const override;
+    bool SetBufferDuration(uint32_t milliseconds) override;
+
+private:
+    struct Source {
+        std::string deviceId;
+        std::unique_ptr<AudioCaptureBase> capture;
+        SpscFloatRing ring;  // 48kHz mono, capture thread -> mixer thread
+
+        // Source capture thread
+        std::vector<float> converted;
+        uint64_t nextFrame = 0;      // Timeline frame of the next sample written
+
+        // Published to the mixer thread
+        std::atomic<bool> started{false};
+        std::atomic<uint64_t> startFrame{0};  // Timeline frame of the first sample
+        std::atomic<uint64_t> endFrame{0};    // Timeline frame after the last sample
+        std::atomic<uint32_t> rejectedRate{0};  // Non-48kHz rate that was dropped
+
+        // Mixer thread
+        bool seen = false;
+        uint64_t readFrame = 0;      // Timeline frame of the next sample popped
+        uint64_t overruns = 0;
+
+        explicit Source(size_t capacity) : ring(capacity) {}
+    };
+
+    MultiSourceOptions options_;
+    std::string deviceId_;
+    std::vector<std::unique_ptr<Source>> sources_;
+
+    // Timeline origin: MonotonicMicros() at Start()
+    std::atomic<uint64_t> epochMicros_;
+
+    // Mixer thread
+    std::thread mixerThread_;
+    std::atomic<bool> shouldStop_;
+    std::atomic<bool> finished_;          // Mixer ended because a source stopped
+    std::atomic<size_t> stoppedSource_;   // Index of that source, NO_SOURCE if none
+    std::mutex stopMutex_;
+    std::condition_variable stopCondition_;
+    std::mutex callbackMutex_;
+    uint64_t mixFrame_;                // Timeline frame of the next output sample
+    std::vector<float> output_;        // Mixer thread only
+    std::vector<float> sourceScratch_;  // Mixer thread only
+
+    void OnSourceAudio(Source& source, const AudioSampleView& view);
+    void MixerThreadFunction();
+    void MixRange(size_t frames);
+    size_t PopSource(Source& source, size_t count, bool discard);
+    uint64_t TimelineFrame(uint64_t micros) const;
+
+    // Constants
+    static constexpr uint32_t SAMPLE_RATE = 48000;
+    static constexpr uint32_t MIX_INTERVAL_MS = 5;
+    static constexpr uint32_t MAX_LATENCY_MS = 100;
+    static constexpr uint32_t GAP_TOLERANCE_MS = 40;
+    static constexpr uint32_t DRIFT_DEADBAND_MS = 2;
+    static constexpr size_t MAX_PACKET_FRAMES = 4800;
+    static constexpr size_t SOURCE_RING_FRAMES = 48000 * 2;
+    static constexpr size_t NO_SOURCE = SIZE_MAX;
+};
+
+} // namespace AudioCapture
\ No newline at end of file
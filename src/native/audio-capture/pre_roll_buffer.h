@@ -0,0 +1,77 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace AudioCapture {
+
+// Fixed-size history of the most recent samples, used to keep the audio just
+// before a speech onset while uploads are gated off. Unlike SpscRingBuffer the
+// capacity is exact (no power-of-two rounding), so it holds precisely the
+// requested pre-roll duration.
+//
+// Not thread-safe: owned by the thread that writes it.
+class PreRollBuffer {
+public:
+    PreRollBuffer() = default;
+
+    PreRollBuffer(const PreRollBuffer&) = delete;
+    PreRollBuffer& operator=(const PreRollBuffer&) = delete;
+
+    // Allocates; call while configuring, not on the audio path
+    void Resize(size_t capacity) {
+        storage_.assign(capacity, 0.0f);
+        Clear();
+    }
+
+    void Clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    // Append samples, keeping only the newest Capacity() of them
+    void Write(const float* data, size_t count) {
+        const size_t capacity = storage_.size();
+        if (!data || count == 0 || capacity == 0) return;
+
+        if (count >= capacity) {
+            std::copy(data + count - capacity, data + count, storage_.begin());
+            head_ = 0;
+            size_ = capacity;
+            return;
+        }
+
+        size_t first = std::min(count, capacity - head_);
+        std::copy(data, data + first, storage_.begin() + head_);
+        std::copy(data + first, data + count, storage_.begin());
+        head_ = (head_ + count) % capacity;
+        size_ = std::min(size_ + count, capacity);
+    }
+
+    // Hand the buffered samples, oldest first, to sink(const float*, size_t)
+    // in at most two spans, then empty the buffer
+    template <typename Sink>
+    void Drain(Sink&& sink) {
+        const size_t capacity = storage_.size();
+        if (size_ == 0) return;
+
+        size_t start = (head_ + capacity - size_) % capacity;
+        size_t first = std::min(size_, capacity - start);
+        sink(storage_.data() + start, first);
+        if (first < size_) {
+            sink(storage_.data(), size_ - first);
+        }
+        Clear();
+    }
+
+    size_t Size() const { return size_; }
+    size_t Capacity() const { return storage_.size(); }
+
+private:
+    std::vector<float> storage_;
+    size_t head_ = 0;  // Next write position
+    size_t size_ = 0;
+};
+
+} // namespace AudioCapture
\ No newline at end of file
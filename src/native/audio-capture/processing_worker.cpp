@@ -0,0 +1,220 @@
+#include "processing_worker.h"
+#include <algorithm>
+#include <future>
+
+#ifdef WINDOWS_PLATFORM
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#ifdef LINUX_PLATFORM
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace AudioCapture {
+
+ProcessingWorker::ProcessingWorker()
+    : running_(false)
+    , shouldStop_(false)
+    , sleeping_(false) {
+}
+
+ProcessingWorker::~ProcessingWorker() {
+    Stop();
+}
+
+bool ProcessingWorker::Start(const ProcessingWorkerOptions& options, Handler handler, std::string& error) {
+    if (running_) {
+        error = "Processing worker is already running";
+        return false;
+    }
+    if (options.queuePackets < MIN_QUEUE_PACKETS || options.queuePackets > MAX_QUEUE_PACKETS) {
+        error = "queuePackets must be between 2 and 4096";
+        return false;
+    }
+
+    // Every slot is allocated here so the capture thread only copies
+    if (slots_.size() != options.queuePackets || options.slotBytes != options_.slotBytes) {
+        slots_.clear();
+        slots_.resize(options.queuePackets);
+        for (Slot& slot : slots_) {
+            slot.data.resize(options.slotBytes);
+        }
+    }
+
+    options_ = options;
+    handler_ = std::move(handler);
+    writeIndex_ = 0;
+    readIndex_ = 0;
+    drops_ = 0;
+    shouldStop_ = false;
+    sleeping_ = false;
+
+    // Wait for the thread to apply its pinning/priority so the outcome is known
+    std::promise<std::string> configured;
+    std::future<std::string> configResult = configured.get_future();
+    thread_ = std::thread([this, configured = std::move(configured)]() mutable {
+        std::string configError;
+        ConfigureCurrentThread(options_, configError);
+        configured.set_value(configError);
+        ThreadFunction();
+    });
+    threadConfigError_ = configResult.get();
+
+    running_ = true;
+    return true;
+}
+
+void ProcessingWorker::Stop() {
+    if (!thread_.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        shouldStop_ = true;
+    }
+    wakeCondition_.notify_all();
+
+    thread_.join();
+    running_ = false;
+}
+
+bool ProcessingWorker::Enqueue(const AudioSampleView& view) {
+    if (slots_.empty()) return false;
+
+    uint64_t write = writeIndex_.load(std::memory_order_relaxed);
+    uint64_t read = readIndex_.load(std::memory_order_acquire);
+    if (write - read >= slots_.size()) {
+        drops_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Slot& slot = slots_[static_cast<size_t>(write % slots_.size())];
+    if (view.size > slot.data.size()) {
+        // Only packets larger than any before allocate, once per slot
+        slot.data.resize(view.size);
+    }
+    slot.view = view;
+    if (view.silent) {
+        // Silence runs carry only their duration
+        slot.view.data = nullptr;
+    } else {
+        if (view.data && view.size > 0) {
+            std::copy(view.data, view.data + view.size, slot.data.begin());
+        }
+        slot.view.data = slot.data.data();
+    }
+
+    writeIndex_.store(write + 1, std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_seq_cst)) {
+        {
+            // Uncontended unless the worker is between its check and its wait
+            std::lock_guard<std::mutex> lock(wakeMutex_);
+        }
+        wakeCondition_.notify_one();
+    }
+    return true;
+}
+
+size_t ProcessingWorker::QueueDepth() const {
+    uint64_t write = writeIndex_.load(std::memory_order_acquire);
+    uint64_t read = readIndex_.load(std::memory_order_acquire);
+    return static_cast<size_t>(write - read);
+}
+
+void ProcessingWorker::ThreadFunction() {
+    while (true) {
+        uint64_t read = readIndex_.load(std::memory_order_relaxed);
+        uint64_t write = writeIndex_.load(std::memory_order_acquire);
+
+        // Process everything queued, in order, releasing each slot afterwards
+        for (; read != write; ++read) {
+            handler_(slots_[static_cast<size_t>(read % slots_.size())].view);
+            readIndex_.store(read + 1, std::memory_order_release);
+        }
+
+        if (shouldStop_) {
+            // Packets queued before Stop() still get processed
+            if (writeIndex_.load(std::memory_order_acquire) == read) break;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        sleeping_.store(true, std::memory_order_seq_cst);
+        wakeCondition_.wait(lock, [this, read]() {
+            return shouldStop_.load() || writeIndex_.load(std::memory_order_seq_cst) != read;
+        });
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
+
+bool ProcessingWorker::ConfigureCurrentThread(const ProcessingWorkerOptions& options, std::string& error) {
+    bool applied = true;
+
+#ifdef WINDOWS_PLATFORM
+    if (options.cpu >= 0) {
+        if (options.cpu >= 64 || !SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << options.cpu)) {
+            error = "Failed to pin the processing worker to CPU " + std::to_string(options.cpu);
+            applied = false;
+        }
+    }
+    if (options.priority != WorkerPriority::Normal) {
+        int priority = options.priority == WorkerPriority::Realtime
+            ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_HIGHEST;
+        if (!SetThreadPriority(GetCurrentThread(), priority)) {
+            error = "Failed to raise the processing worker priority";
+            applied = false;
+        }
+    }
+#else
+    if (options.cpu >= 0) {
+#ifdef LINUX_PLATFORM
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        if (options.cpu >= CPU_SETSIZE) {
+            applied = false;
+        } else {
+            CPU_SET(options.cpu, &cpus);
+            applied = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+        }
+        if (!applied) {
+            error = "Failed to pin the processing worker to CPU " + std::to_string(options.cpu);
+        }
+#else
+        // macOS only offers affinity hints between threads, not CPU pinning
+        error = "CPU pinning is not supported on this platform";
+        applied = false;
+#endif
+    }
+
+    if (options.priority == WorkerPriority::Realtime) {
+        sched_param param = {};
+        param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 10;
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+            error = "Real-time scheduling was refused (needs CAP_SYS_NICE/rtkit or root)";
+            applied = false;
+        }
+    } else if (options.priority == WorkerPriority::High) {
+#if defined(MACOS_PLATFORM)
+        if (pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0) != 0) {
+            error = "Failed to raise the processing worker QoS class";
+            applied = false;
+        }
+#elif defined(LINUX_PLATFORM)
+        // Per-thread nice value; raising it needs CAP_SYS_NICE or a permissive RLIMIT_NICE
+        pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+        if (setpriority(PRIO_PROCESS, static_cast<id_t>(tid), -10) != 0) {
+            error = "Raising the processing worker priority was refused (RLIMIT_NICE)";
+            applied = false;
+        }
+#endif
+    }
+#endif
+
+    return applied;
+}
+
+} // namespace AudioCapture
\ No newline at end of file
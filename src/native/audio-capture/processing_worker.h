@@ -0,0 +1,98 @@
+#pragma once
+
+#include "audio_capture_base.h"
+#include "spsc_ring_buffer.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace AudioCapture {
+
+// Scheduling class requested for the worker thread
+enum class WorkerPriority {
+    Normal,
+    High,      // Above normal threads (QoS user-interactive / THREAD_PRIORITY_HIGHEST / nice -10)
+    Realtime   // Real-time scheduling where permitted (SCHED_FIFO / TIME_CRITICAL)
+};
+
+struct ProcessingWorkerOptions {
+    size_t queuePackets = 64;   // Packets buffered between capture and worker
+    size_t slotBytes = 16384;   // Preallocated bytes per packet; larger packets grow their slot once
+    int cpu = -1;               // Pin to this CPU; -1 leaves placement to the OS
+    WorkerPriority priority = WorkerPriority::High;
+};
+
+// Moves packet processing off the OS capture thread. The capture callback only
+// copies the raw packet into a preallocated slot of a wait-free SPSC queue;
+// one worker thread hands the packets, in order, to the processing handler.
+//
+// When the worker falls behind and every slot is taken, new packets are
+// dropped and counted rather than blocking the capture thread.
+class ProcessingWorker {
+public:
+    using Handler = std::function<void(const AudioSampleView& view)>;
+
+    static constexpr size_t MIN_QUEUE_PACKETS = 2;
+    static constexpr size_t MAX_QUEUE_PACKETS = 4096;
+
+    ProcessingWorker();
+    ~ProcessingWorker();
+
+    ProcessingWorker(const ProcessingWorker&) = delete;
+    ProcessingWorker& operator=(const ProcessingWorker&) = delete;
+
+    // Start the worker thread. Pinning or priority that the OS refuses does
+    // not fail the start; see ThreadConfigError().
+    bool Start(const ProcessingWorkerOptions& options, Handler handler, std::string& error);
+
+    // Process what is still queued, then join the thread
+    void Stop();
+
+    bool IsRunning() const { return running_; }
+
+    // Capture thread: queue a copy of the packet, false if it was dropped
+    bool Enqueue(const AudioSampleView& view);
+
+    size_t QueueDepth() const;
+    size_t QueueCapacity() const { return slots_.size(); }
+    uint64_t DropCount() const { return drops_.load(std::memory_order_relaxed); }
+
+    // Why the requested pinning/priority was not applied (empty when it was)
+    const std::string& ThreadConfigError() const { return threadConfigError_; }
+
+private:
+    struct Slot {
+        std::vector<uint8_t> data;
+        AudioSampleView view;
+    };
+
+    std::vector<Slot> slots_;
+    alignas(kCacheLineSize) std::atomic<uint64_t> writeIndex_{0};  // Capture thread
+    alignas(kCacheLineSize) std::atomic<uint64_t> readIndex_{0};   // Worker thread
+    std::atomic<uint64_t> drops_{0};
+
+    std::thread thread_;
+    Handler handler_;
+    ProcessingWorkerOptions options_;
+    std::atomic<bool> running_;  // Read by any thread through IsRunning()
+    std::string threadConfigError_;  // Written before Start() returns
+
+    // The capture thread only notifies while the worker sleeps, and then
+    // takes wakeMutex_ first: the worker holds it from its last queue check
+    // until it waits, so no wakeup is lost
+    std::atomic<bool> shouldStop_;
+    std::atomic<bool> sleeping_;
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCondition_;
+
+    void ThreadFunction();
+    static bool ConfigureCurrentThread(const ProcessingWorkerOptions& options, std::string& error);
+};
+
+} // namespace AudioCapture
\ No newline at end of file
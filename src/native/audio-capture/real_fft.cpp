@@ -0,0 +1,117 @@
+#include "real_fft.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace AudioCapture {
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+} // namespace
+
+RealFFT::RealFFT(size_t size)
+    : size_(size)
+    , half_(size / 2) {
+    if (!IsValidSize(size)) {
+        throw std::invalid_argument("FFT size must be a power of two, at least 4");
+    }
+
+    size_t bits = 0;
+    while ((static_cast<size_t>(1) << bits) < half_) {
+        bits++;
+    }
+
+    bitReverse_.resize(half_);
+    for (size_t i = 0; i < half_; ++i) {
+        size_t reversed = 0;
+        for (size_t b = 0; b < bits; ++b) {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        bitReverse_[i] = reversed;
+    }
+
+    // Stage with butterfly span `span` uses w^j = e^(-2*pi*i*j / (2 * span)), j < span
+    for (size_t span = 1; span < half_; span *= 2) {
+        for (size_t j = 0; j < span; ++j) {
+            double angle = -PI * static_cast<double>(j) / static_cast<double>(span);
+            stageCos_.push_back(static_cast<float>(std::cos(angle)));
+            stageSin_.push_back(static_cast<float>(std::sin(angle)));
+        }
+    }
+
+    splitCos_.resize(half_ + 1);
+    splitSin_.resize(half_ + 1);
+    for (size_t k = 0; k <= half_; ++k) {
+        double angle = -2.0 * PI * static_cast<double>(k) / static_cast<double>(size_);
+        splitCos_[k] = static_cast<float>(std::cos(angle));
+        splitSin_[k] = static_cast<float>(std::sin(angle));
+    }
+
+    re_.resize(half_);
+    im_.resize(half_);
+}
+
+bool RealFFT::IsValidSize(size_t size) {
+    return size >= 4 && (size & (size - 1)) == 0;
+}
+
+size_t RealFFT::SizeFor(size_t length) {
+    size_t size = 4;
+    while (size < length) {
+        size *= 2;
+    }
+    return size;
+}
+
+void RealFFT::Transform() {
+    float* re = re_.data();
+    float* im = im_.data();
+    const float* cosTable = stageCos_.data();
+    const float* sinTable = stageSin_.data();
+
+    for (size_t span = 1; span < half_; span *= 2) {
+        for (size_t block = 0; block < half_; block += 2 * span) {
+            float* aRe = re + block;
+            float* aIm = im + block;
+            float* bRe = aRe + span;
+            float* bIm = aIm + span;
+            for (size_t j = 0; j < span; ++j) {
+                float tRe = bRe[j] * cosTable[j] - bIm[j] * sinTable[j];
+                float tIm = bRe[j] * sinTable[j] + bIm[j] * cosTable[j];
+                bRe[j] = aRe[j] - tRe;
+                bIm[j] = aIm[j] - tIm;
+                aRe[j] += tRe;
+                aIm[j] += tIm;
+            }
+        }
+        cosTable += span;
+        sinTable += span;
+    }
+}
+
+void RealFFT::PowerSpectrum(const float* input, float* power) {
+    // Even samples as the real part, odd ones as the imaginary part
+    for (size_t i = 0; i < half_; ++i) {
+        size_t target = bitReverse_[i];
+        re_[target] = input[2 * i];
+        im_[target] = input[2 * i + 1];
+    }
+
+    Transform();
+
+    // X[k] = (Z[k] + conj(Z[M-k])) / 2 - i/2 * W^k * (Z[k] - conj(Z[M-k]))
+    for (size_t k = 0; k <= half_; ++k) {
+        size_t a = k % half_;
+        size_t b = (half_ - k) % half_;
+        float evenRe = 0.5f * (re_[a] + re_[b]);
+        float evenIm = 0.5f * (im_[a] - im_[b]);
+        float oddRe = 0.5f * (im_[a] + im_[b]);
+        float oddIm = -0.5f * (re_[a] - re_[b]);
+        float xRe = evenRe + oddRe * splitCos_[k] - oddIm * splitSin_[k];
+        float xIm = evenIm + oddRe * splitSin_[k] + oddIm * splitCos_[k];
+        power[k] = xRe * xRe + xIm * xIm;
+    }
+}
+
+} // namespace AudioCapture
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace AudioCapture {
+
+// Real-input FFT of a fixed power-of-two size. The N real samples are packed
+// into an N/2-point complex transform (radix-2, split real/imaginary arrays
+// with one contiguous twiddle run per stage, so every butterfly loop is a
+// straight vectorizable pass), then split into the N/2 + 1 bins of the real
+// spectrum. Tables and work buffers are allocated once in the constructor.
+class RealFFT {
+public:
+    // size: power of two, at least 4
+    explicit RealFFT(size_t size);
+
+    size_t Size() const { return size_; }
+    size_t Bins() const { return size_ / 2 + 1; }
+
+    static bool IsValidSize(size_t size);
+
+    // Smallest valid size holding length samples
+    static size_t SizeFor(size_t length);
+
+    // |X[k]|^2 for k = 0..Size()/2 of Size() real samples
+    void PowerSpectrum(const float* input, float* power);
+
+private:
+    void Transform();
+
+    size_t size_;
+    size_t half_;                      // Complex transform size
+
+    std::vector<size_t> bitReverse_;
+    std::vector<float> stageCos_;      // Per-stage twiddles, stage after stage
+    std::vector<float> stageSin_;
+    std::vector<float> splitCos_;      // Real-spectrum split twiddles
+    std::vector<float> splitSin_;
+
+    std::vector<float> re_;
+    std::vector<float> im_;
+};
+
+} // namespace AudioCapture
\ No newline at end of file
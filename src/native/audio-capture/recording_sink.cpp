@@ -0,0 +1,583 @@
+#include "recording_sink.h"
+#include "audio_capture_base.h"
+#include "audio_simd_kernels.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <random>
+#include <stdexcept>
+
+#ifdef WINDOWS_PLATFORM
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace AudioCapture {
+
+namespace {
+
+#ifdef WINDOWS_PLATFORM
+const HANDLE NO_FILE = INVALID_HANDLE_VALUE;
+#else
+constexpr int NO_FILE = -1;
+#endif
+
+void PutLE(uint8_t* bytes, uint64_t value, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+// Ogg page checksum: CRC-32, polynomial 0x04c11db7, unreflected, zero initial value
+const std::array<uint32_t, 256>& OggCrcTable() {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> entries = {};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i << 24;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x80000000u) ? (crc << 1) ^ 0x04c11db7u : crc << 1;
+            }
+            entries[i] = crc;
+        }
+        return entries;
+    }();
+    return table;
+}
+
+uint32_t OggCrc(const uint8_t* bytes, size_t size) {
+    const std::array<uint32_t, 256>& table = OggCrcTable();
+    uint32_t crc = 0;
+    for (size_t i = 0; i < size; ++i) {
+        crc = (crc << 8) ^ table[((crc >> 24) ^ bytes[i]) & 0xff];
+    }
+    return crc;
+}
+
+} // namespace
+
+void RecordingSink::AlignedDeleter::operator()(uint8_t* block) const {
+    ::operator delete(block, std::align_val_t(BLOCK_ALIGNMENT));
+}
+
+RecordingSink::RecordingSink()
+    : recording_(false)
+    , shouldStop_(false)
+    , blockSize_(0)
+    , blockFill_(0)
+    , file_(NO_FILE)
+    , fileIndex_(0)
+    , fileBytes_(0)
+    , fileWritten_(0)
+    , fileSamples_(0)
+    , lastSyncMicros_(0)
+    , dirty_(false)
+    , failed_(false)
+    , oggSerial_(0)
+    , oggSequence_(0)
+    , oggGranule_(0)
+    , samplesRecorded_(0)
+    , bytesWritten_(0)
+    , writes_(0)
+    , syncs_(0) {
+}
+
+RecordingSink::~RecordingSink() {
+    Stop();
+}
+
+bool RecordingSink::Start(const RecordingOptions& options, std::string& error) {
+    if (thread_.joinable()) {
+        error = "Recording is already running";
+        return false;
+    }
+    if (options.path.empty() || options.sampleRate == 0) {
+        error = "Recording needs a path and a sample rate";
+        return false;
+    }
+
+    if (options.format == RecordingFormat::OggOpus) {
+        try {
+            opusEncoder_.Configure(options.sampleRate, options.opus);
+        } catch (const std::exception& e) {
+            error = std::string("Failed to create Opus encoder: ") + e.what();
+            return false;
+        }
+        // Sized for a drain on top of the most samples a partial frame carries
+        opusPackets_.resize(opusEncoder_.MaxPacketsFor(DRAIN_CHUNK_SAMPLES + opusEncoder_.FrameSamples() - 1));
+    }
+
+    // Whole aligned blocks, so every write() but the last of a file is the same size
+    size_t blockSize = std::min(std::max(options.writeBytes, BLOCK_ALIGNMENT), MAX_WRITE_BYTES);
+    blockSize = (blockSize + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+    if (blockSize != blockSize_) {
+        block_.reset(static_cast<uint8_t*>(::operator new(blockSize, std::align_val_t(BLOCK_ALIGNMENT))));
+        blockSize_ = blockSize;
+    }
+
+    options_ = options;
+    size_t queueSamples = std::max<size_t>(static_cast<size_t>(options.sampleRate) * options.queueMs / 1000,
+                                           DRAIN_CHUNK_SAMPLES);
+    ring_ = std::make_unique<SpscFloatRing>(queueSamples);
+    samples_.resize(DRAIN_CHUNK_SAMPLES);
+    encoded_.resize(DRAIN_CHUNK_SAMPLES * sizeof(float));
+
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        files_.clear();
+        lastError_.clear();
+    }
+    samplesRecorded_ = 0;
+    bytesWritten_ = 0;
+    writes_ = 0;
+    syncs_ = 0;
+    fileIndex_ = 0;
+    failed_ = false;
+    oggSerial_ = std::random_device{}();
+
+    if (!OpenFile(error)) {
+        return false;
+    }
+
+    shouldStop_ = false;
+    recording_.store(true, std::memory_order_release);
+    thread_ = std::thread(&RecordingSink::ThreadFunction, this);
+    return true;
+}
+
+void RecordingSink::Stop() {
+    if (!thread_.joinable()) return;
+
+    recording_.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        shouldStop_ = true;
+    }
+    wakeCondition_.notify_all();
+    thread_.join();
+}
+
+void RecordingSink::Write(const float* samples, size_t count) {
+    if (!recording_.load(std::memory_order_acquire)) return;
+    ring_->Push(samples, count);
+}
+
+void RecordingSink::WriteSilence(size_t count) {
+    if (!recording_.load(std::memory_order_acquire)) return;
+    ring_->PushZeros(count);
+}
+
+RecordingStats RecordingSink::Stats() const {
+    RecordingStats stats;
+    stats.samples = samplesRecorded_.load(std::memory_order_relaxed);
+    stats.droppedSamples = ring_ ? ring_->OverrunCount() : 0;
+    stats.bytesWritten = bytesWritten_.load(std::memory_order_relaxed);
+    stats.writes = writes_.load(std::memory_order_relaxed);
+    stats.syncs = syncs_.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    stats.files = files_.size();
+    return stats;
+}
+
+std::vector<std::string> RecordingSink::Files() const {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    return files_;
+}
+
+std::string RecordingSink::LastError() const {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    return lastError_;
+}
+
+void RecordingSink::ThreadFunction() {
+    lastSyncMicros_ = MonotonicMicros();
+
+    while (true) {
+        {
+            // The producer never signals; draining on a timer keeps the worker syscall-free
+            std::unique_lock<std::mutex> lock(wakeMutex_);
+            wakeCondition_.wait_for(lock, std::chrono::milliseconds(WAKE_INTERVAL_MS),
+                                    [this]() { return shouldStop_.load(); });
+        }
+
+        Drain();
+        if (shouldStop_) break;
+
+        uint64_t now = MonotonicMicros();
+        if (options_.syncIntervalMs > 0 && dirty_ &&
+            now - lastSyncMicros_ >= static_cast<uint64_t>(options_.syncIntervalMs) * 1000) {
+            if (options_.format == RecordingFormat::Wav) {
+                PatchWavHeader();
+            }
+            Sync();
+            lastSyncMicros_ = now;
+        }
+    }
+
+    CloseFile();
+}
+
+void RecordingSink::Drain() {
+    // Silence runs come out of the ring as zeros, which is what the file needs
+    while (true) {
+        size_t count = ring_->Pop(samples_.data(), samples_.size());
+        if (count == 0) break;
+        Append(samples_.data(), count);
+    }
+}
+
+void RecordingSink::Append(const float* samples, size_t count) {
+    uint64_t rotateSamples = static_cast<uint64_t>(options_.rotateSeconds) * options_.sampleRate;
+
+    // After an I/O error (including a rotation that could not open its file)
+    // the rest of the stream is discarded
+    while (count > 0 && !failed_) {
+        // Split at the duration limit so every file holds exactly rotateSeconds
+        size_t take = count;
+        if (rotateSamples > 0) {
+            take = static_cast<size_t>(std::min<uint64_t>(take, rotateSamples - fileSamples_));
+        }
+
+        Encode(samples, take);
+        fileSamples_ += take;
+        samplesRecorded_.fetch_add(take, std::memory_order_relaxed);
+        samples += take;
+        count -= take;
+
+        if (ShouldRotate()) {
+            Rotate();
+        }
+    }
+}
+
+void RecordingSink::Encode(const float* samples, size_t count) {
+    if (options_.format == RecordingFormat::OggOpus) {
+        size_t packets = opusEncoder_.Process(samples, count, 0, opusPackets_.data(), opusPackets_.size());
+        uint64_t granuleStep = static_cast<uint64_t>(opusEncoder_.FrameSamples()) * 48000 / options_.sampleRate;
+        for (size_t i = 0; i < packets; ++i) {
+            // Granule positions count 48kHz samples whatever the input rate
+            oggGranule_ += granuleStep;
+            AddOggPacket(opusPackets_[i].data, opusPackets_[i].size);
+        }
+        return;
+    }
+
+    size_t bytes;
+    if (options_.float32) {
+        bytes = count * sizeof(float);
+        std::memcpy(encoded_.data(), samples, bytes);
+    } else {
+        bytes = count * sizeof(int16_t);
+        SimdKernels::FloatToInt16(samples, reinterpret_cast<int16_t*>(encoded_.data()), count);
+    }
+    Emit(encoded_.data(), bytes);
+}
+
+std::string RecordingSink::FilePath(size_t index) const {
+    if (options_.rotateBytes == 0 && options_.rotateSeconds == 0) {
+        return options_.path;
+    }
+
+    // session.wav -> session-0001.wav; the extension is whatever follows the last dot of the name
+    size_t slash = options_.path.find_last_of("/\\");
+    size_t dot = options_.path.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        dot = options_.path.size();
+    }
+
+    char suffix[16];
+    std::snprintf(suffix, sizeof(suffix), "-%04zu", index + 1);
+    return options_.path.substr(0, dot) + suffix + options_.path.substr(dot);
+}
+
+bool RecordingSink::OpenFile(std::string& error) {
+    std::string path = FilePath(fileIndex_);
+
+    // Reset first, so a failed open never leaves the previous file's counts
+    blockFill_ = 0;
+    fileBytes_ = 0;
+    fileWritten_ = 0;
+    fileSamples_ = 0;
+    dirty_ = false;
+
+#ifdef WINDOWS_PLATFORM
+    // Paths arrive from JS as UTF-8
+    int wideLength = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    std::wstring widePath(wideLength > 0 ? wideLength - 1 : 0, L'\0');
+    if (wideLength > 0) {
+        MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &widePath[0], wideLength);
+    }
+
+    file_ = CreateFileW(widePath.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                        CREATE_ALWAYS, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+        error = "Cannot create " + path;
+        return false;
+    }
+#else
+    file_ = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (file_ < 0) {
+        error = "Cannot create " + path + ": " + std::strerror(errno);
+        return false;
+    }
+#endif
+
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        files_.push_back(path);
+    }
+
+    if (options_.format == RecordingFormat::Wav) {
+        WriteWavHeader();
+    } else if (options_.format == RecordingFormat::OggOpus) {
+        WriteOggHeaders();
+    }
+    return true;
+}
+
+void RecordingSink::CloseFile() {
+    if (file_ == NO_FILE) return;
+
+    // A trailing partial Opus frame (under one frame of audio) is not encoded
+    if (options_.format == RecordingFormat::OggOpus) {
+        FlushOggPage(true);
+    }
+    FlushBlock();
+    if (options_.format == RecordingFormat::Wav) {
+        PatchWavHeader();
+    }
+    Sync();
+
+#ifdef WINDOWS_PLATFORM
+    CloseHandle(file_);
+#else
+    close(file_);
+#endif
+    file_ = NO_FILE;
+}
+
+void RecordingSink::Rotate() {
+    CloseFile();
+    ++fileIndex_;
+    ++oggSerial_;
+    if (options_.format == RecordingFormat::OggOpus) {
+        opusEncoder_.Reset();
+    }
+
+    std::string error;
+    if (!OpenFile(error)) {
+        SetError(error);
+    }
+}
+
+bool RecordingSink::ShouldRotate() const {
+    return (options_.rotateBytes > 0 && fileBytes_ >= options_.rotateBytes) ||
+           (options_.rotateSeconds > 0 &&
+            fileSamples_ >= static_cast<uint64_t>(options_.rotateSeconds) * options_.sampleRate);
+}
+
+void RecordingSink::Emit(const uint8_t* bytes, size_t size) {
+    fileBytes_ += size;
+    while (size > 0) {
+        size_t copied = std::min(size, blockSize_ - blockFill_);
+        std::memcpy(block_.get() + blockFill_, bytes, copied);
+        blockFill_ += copied;
+        bytes += copied;
+        size -= copied;
+
+        if (blockFill_ == blockSize_) {
+            FlushBlock();
+        }
+    }
+}
+
+void RecordingSink::FlushBlock() {
+    if (blockFill_ == 0) return;
+
+    if (!failed_ && file_ != NO_FILE && WriteOut(block_.get(), blockFill_)) {
+        fileWritten_ += blockFill_;
+        bytesWritten_.fetch_add(blockFill_, std::memory_order_relaxed);
+        writes_.fetch_add(1, std::memory_order_relaxed);
+        dirty_ = true;
+    }
+    blockFill_ = 0;
+}
+
+bool RecordingSink::WriteOut(const uint8_t* bytes, size_t size) {
+#ifdef WINDOWS_PLATFORM
+    while (size > 0) {
+        DWORD written = 0;
+        DWORD chunk = static_cast<DWORD>(std::min<size_t>(size, MAX_WRITE_BYTES));
+        if (!::WriteFile(file_, bytes, chunk, &written, nullptr) || written == 0) {
+            SetError("Recording write failed (error " + std::to_string(GetLastError()) + ")");
+            return false;
+        }
+        bytes += written;
+        size -= written;
+    }
+#else
+    while (size > 0) {
+        ssize_t written = write(file_, bytes, size);
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) {
+            SetError(std::string("Recording write failed: ") + std::strerror(errno));
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+#endif
+    return true;
+}
+
+bool RecordingSink::WriteOutAt(uint64_t offset, const uint8_t* bytes, size_t size) {
+    if (failed_ || file_ == NO_FILE) return false;
+
+#ifdef WINDOWS_PLATFORM
+    // Positioned writes move a synchronous handle's file pointer; put it back at the end
+    LARGE_INTEGER position;
+    position.QuadPart = static_cast<LONGLONG>(offset);
+    DWORD written = 0;
+    bool ok = SetFilePointerEx(file_, position, nullptr, FILE_BEGIN) &&
+              ::WriteFile(file_, bytes, static_cast<DWORD>(size), &written, nullptr) && written == size;
+    position.QuadPart = 0;
+    SetFilePointerEx(file_, position, nullptr, FILE_END);
+#else
+    bool ok = pwrite(file_, bytes, size, static_cast<off_t>(offset)) == static_cast<ssize_t>(size);
+#endif
+    if (!ok) {
+        SetError("Recording header update failed");
+    }
+    return ok;
+}
+
+void RecordingSink::Sync() {
+    if (failed_ || file_ == NO_FILE || !dirty_) return;
+
+#if defined(WINDOWS_PLATFORM)
+    FlushFileBuffers(file_);
+#elif defined(MACOS_PLATFORM)
+    fsync(file_);
+#else
+    fdatasync(file_);
+#endif
+    syncs_.fetch_add(1, std::memory_order_relaxed);
+    dirty_ = false;
+}
+
+void RecordingSink::SetError(const std::string& error) {
+    failed_ = true;
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    if (lastError_.empty()) {
+        lastError_ = error;
+    }
+}
+
+void RecordingSink::WriteWavHeader() {
+    uint16_t bytesPerSample = options_.float32 ? 4 : 2;
+    uint8_t header[WAV_HEADER_BYTES] = {};
+
+    // Sizes stay 0 until PatchWavHeader() fills in what reached the disk
+    std::memcpy(header, "RIFF", 4);
+    std::memcpy(header + 8, "WAVEfmt ", 8);
+    PutLE(header + 16, 16, 4);
+    PutLE(header + 20, options_.float32 ? 3 : 1, 2);  // WAVE_FORMAT_IEEE_FLOAT / PCM
+    PutLE(header + 22, 1, 2);
+    PutLE(header + 24, options_.sampleRate, 4);
+    PutLE(header + 28, static_cast<uint64_t>(options_.sampleRate) * bytesPerSample, 4);
+    PutLE(header + 32, bytesPerSample, 2);
+    PutLE(header + 34, bytesPerSample * 8, 2);
+    std::memcpy(header + 36, "data", 4);
+    Emit(header, sizeof(header));
+}
+
+void RecordingSink::PatchWavHeader() {
+    // The header is on disk with the first block; until then there is nothing to patch
+    if (fileWritten_ < WAV_HEADER_BYTES) return;
+
+    uint64_t dataBytes = std::min<uint64_t>(fileWritten_ - WAV_HEADER_BYTES, UINT32_MAX - 36);
+    uint8_t size[4];
+    PutLE(size, dataBytes + 36, 4);
+    WriteOutAt(4, size, 4);
+    PutLE(size, dataBytes, 4);
+    WriteOutAt(40, size, 4);
+}
+
+void RecordingSink::WriteOggHeaders() {
+    oggSequence_ = 0;
+    oggGranule_ = 0;
+    oggSegments_.clear();
+    oggBody_.clear();
+
+    // RFC 7845 identification header, mono, channel mapping family 0
+    uint8_t head[19] = {};
+    std::memcpy(head, "OpusHead", 8);
+    head[8] = 1;
+    head[9] = 1;
+    PutLE(head + 10, OPUS_PRE_SKIP, 2);
+    PutLE(head + 12, options_.sampleRate, 4);
+    AddOggPacket(head, sizeof(head));
+    FlushOggPage(false);
+
+    static const char vendor[] = "AudioMid";
+    uint8_t tags[8 + 4 + sizeof(vendor) - 1 + 4] = {};
+    std::memcpy(tags, "OpusTags", 8);
+    PutLE(tags + 8, sizeof(vendor) - 1, 4);
+    std::memcpy(tags + 12, vendor, sizeof(vendor) - 1);
+    AddOggPacket(tags, sizeof(tags));
+    FlushOggPage(false);
+}
+
+void RecordingSink::AddOggPacket(const uint8_t* data, size_t size) {
+    // Lacing: 255-byte segments, then one shorter (possibly empty) segment
+    if (oggSegments_.size() + size / 255 + 1 > OGG_MAX_SEGMENTS) {
+        FlushOggPage(false);
+    }
+    for (size_t remaining = size; ; remaining -= 255) {
+        if (remaining < 255) {
+            oggSegments_.push_back(static_cast<uint8_t>(remaining));
+            break;
+        }
+        oggSegments_.push_back(255);
+    }
+    oggBody_.insert(oggBody_.end(), data, data + size);
+
+    if (oggBody_.size() >= OGG_PAGE_BYTES) {
+        FlushOggPage(false);
+    }
+}
+
+void RecordingSink::FlushOggPage(bool endOfStream) {
+    if (oggSegments_.empty() && !endOfStream) return;
+
+    size_t headerSize = 27 + oggSegments_.size();
+    encoded_.resize(std::max(encoded_.size(), headerSize + oggBody_.size()));
+    uint8_t* page = encoded_.data();
+
+    std::memcpy(page, "OggS", 4);
+    page[4] = 0;
+    page[5] = static_cast<uint8_t>((oggSequence_ == 0 ? 0x02 : 0) | (endOfStream ? 0x04 : 0));
+    // Header pages carry granule 0; audio pages the position after their last packet
+    PutLE(page + 6, oggSequence_ < 2 ? 0 : oggGranule_, 8);
+    PutLE(page + 14, oggSerial_, 4);
+    PutLE(page + 18, oggSequence_, 4);
+    PutLE(page + 22, 0, 4);
+    page[26] = static_cast<uint8_t>(oggSegments_.size());
+    std::memcpy(page + 27, oggSegments_.data(), oggSegments_.size());
+    std::memcpy(page + headerSize, oggBody_.data(), oggBody_.size());
+
+    size_t pageSize = headerSize + oggBody_.size();
+    PutLE(page + 22, OggCrc(page, pageSize), 4);
+    Emit(page, pageSize);
+
+    ++oggSequence_;
+    oggSegments_.clear();
+    oggBody_.clear();
+}
+
+} // namespace AudioCapture
\ No newline at end of file
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "spsc_ring_buffer.h"
+#include "streaming_opus_encoder.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace AudioCapture {
+
+// Container written by the recording sink
+enum class RecordingFormat {
+    Wav,      // RIFF/WAVE, header patched at every sync so a crash leaves a playable file
+    Raw,      // Headerless little-endian samples
+    OggOpus   // Opus in Ogg (RFC 7845), encoded on the I/O thread
+};
+
+struct RecordingOptions {
+    std::string path;                     // First file; rotated files get "-0001", "-0002"... before the extension
+    RecordingFormat format = RecordingFormat::Wav;
+    bool float32 = false;                 // WAV/raw samples as float32 instead of PCM16
+    uint32_t sampleRate = 48000;          // Rate of the samples handed to Write()
+    uint64_t rotateBytes = 0;             // Start a new file past this size; 0 = never
+    uint32_t rotateSeconds = 0;           // Start a new file after this much audio; 0 = never
+    uint32_t syncIntervalMs = 1000;       // fdatasync cadence; 0 = only at rotation and stop
+    size_t writeBytes = 256 * 1024;       // Bytes per write(), rounded up to whole 4096-byte blocks
+    uint32_t queueMs = 2000;              // Audio queued between the worker and the I/O thread
+    OpusEncoderConfig opus;               // OggOpus only
+};
+
+struct RecordingStats {
+    uint64_t samples = 0;          // Samples taken from the queue
+    uint64_t droppedSamples = 0;   // Overwritten because the I/O thread fell behind
+    uint64_t bytesWritten = 0;
+    uint64_t writes = 0;           // write() calls
+    uint64_t syncs = 0;            // fdatasync() calls
+    uint64_t files = 0;
+};
+
+// Streams the processed capture stream to disk without touching the JS thread.
+// The processing worker only copies samples into a wait-free SPSC ring; an I/O
+// thread drains it on a timer, converts or encodes, and accumulates whole
+// aligned blocks so each write() moves writeBytes at once and data is synced
+// in batches instead of per chunk.
+//
+// Files rotate by size or by duration; every file is complete on its own (WAV
+// header, or Ogg headers with a fresh stream serial).
+class RecordingSink {
+public:
+    RecordingSink();
+    ~RecordingSink();
+
+    RecordingSink(const RecordingSink&) = delete;
+    RecordingSink& operator=(const RecordingSink&) = delete;
+
+    // Create the first file and start the I/O thread
+    bool Start(const RecordingOptions& options, std::string& error);
+
+    // Write out everything queued, finalize the file and join the I/O thread
+    void Stop();
+
+    bool IsRecording() const { return recording_.load(std::memory_order_acquire); }
+
+    // Processing thread: queue samples at options.sampleRate; never blocks.
+    // When the I/O thread falls behind the oldest queued audio is overwritten.
+    void Write(const float* samples, size_t count);
+    void WriteSilence(size_t count);
+
+    RecordingStats Stats() const;
+
+    // Files created so far and the first I/O error (empty when none)
+    std::vector<std::string> Files() const;
+    std::string LastError() const;
+
+private:
+    struct AlignedDeleter {
+        void operator()(uint8_t* block) const;
+    };
+
+    RecordingOptions options_;
+    std::atomic<bool> recording_;
+    std::unique_ptr<SpscFloatRing> ring_;
+
+    // I/O thread
+    std::thread thread_;
+    std::atomic<bool> shouldStop_;
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCondition_;
+
+    std::unique_ptr<uint8_t, AlignedDeleter> block_;  // Pending bytes, BLOCK_ALIGNMENT aligned
+    size_t blockSize_;
+    size_t blockFill_;
+    std::vector<float> samples_;
+    std::vector<uint8_t> encoded_;
+    StreamingOpusEncoder opusEncoder_;
+    std::vector<OpusPacket> opusPackets_;
+
+#ifdef WINDOWS_PLATFORM
+    void* file_;  // HANDLE
+#else
+    int file_;
+#endif
+    size_t fileIndex_;
+    uint64_t fileBytes_;        // Bytes in the current file, including the pending block
+    uint64_t fileWritten_;      // Bytes of the current file already handed to the OS
+    uint64_t fileSamples_;      // Samples in the current file
+    uint64_t lastSyncMicros_;
+    bool dirty_;                // Written since the last sync
+    bool failed_;               // I/O error; the rest of the stream is discarded
+
+    // Ogg stream state of the current file
+    uint32_t oggSerial_;
+    uint32_t oggSequence_;
+    uint64_t oggGranule_;
+    std::vector<uint8_t> oggSegments_;
+    std::vector<uint8_t> oggBody_;
+
+    std::atomic<uint64_t> samplesRecorded_;
+    std::atomic<uint64_t> bytesWritten_;
+    std::atomic<uint64_t> writes_;
+    std::atomic<uint64_t> syncs_;
+    mutable std::mutex stateMutex_;  // files_ and lastError_
+    std::vector<std::string> files_;
+    std::string lastError_;
+
+    void ThreadFunction();
+    void Drain();
+    void Append(const float* samples, size_t count);
+    void Encode(const float* samples, size_t count);
+    bool OpenFile(std::string& error);
+    void CloseFile();
+    void Rotate();
+    bool ShouldRotate() const;
+    std::string FilePath(size_t index) const;
+
+    // Block accumulation and raw file I/O
+    void Emit(const uint8_t* bytes, size_t size);
+    void FlushBlock();
+    bool WriteOut(const uint8_t* bytes, size_t size);
+    bool WriteOutAt(uint64_t offset, const uint8_t* bytes, size_t size);
+    void Sync();
+    void SetError(const std::string& error);
+
+    // Containers
+    void WriteWavHeader();
+    void PatchWavHeader();
+    void WriteOggHeaders();
+    void AddOggPacket(const uint8_t* data, size_t size);
+    void FlushOggPage(bool endOfStream);
+
+    // Constants
+    static constexpr size_t BLOCK_ALIGNMENT = 4096;
+    static constexpr size_t MAX_WRITE_BYTES = 16 * 1024 * 1024;
+    static constexpr uint32_t WAKE_INTERVAL_MS = 20;
+    static constexpr size_t DRAIN_CHUNK_SAMPLES = 4800;
+    static constexpr size_t WAV_HEADER_BYTES = 44;
+    static constexpr uint16_t OPUS_PRE_SKIP = 312;   // 48kHz samples of encoder lookahead
+    static constexpr size_t OGG_MAX_SEGMENTS = 255;
+    static constexpr size_t OGG_PAGE_BYTES = 4096;     // Flush a page once its body reaches this
+};
+
+} // namespace AudioCapture
\ No newline at end of file
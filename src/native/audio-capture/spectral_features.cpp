@@ -0,0 +1,178 @@
+#include "spectral_features.h"
+#include "audio_simd_kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace AudioCapture {
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+// Analysed spectrum starts above DC and mains hum; speech band as in telephony
+constexpr float MIN_ANALYSIS_HZ = 60.0f;
+constexpr float SPEECH_LOW_HZ = 300.0f;
+constexpr float SPEECH_HIGH_HZ = 3400.0f;
+
+// Floor for digital silence, and the power below which a frame has no spectrum
+constexpr float SILENCE_DB = -100.0f;
+constexpr float MIN_SPECTRUM_POWER = 1e-10f;
+
+bool IsValidSampleRate(uint32_t sampleRate) {
+    return sampleRate == 8000 || sampleRate == 16000 || sampleRate == 32000 || sampleRate == 48000;
+}
+
+} // namespace
+
+StreamingSpectralAnalyzer::StreamingSpectralAnalyzer()
+    : sampleRate_(0)
+    , filled_(0)
+    , speechBegin_(0)
+    , speechEnd_(0)
+    , firstBin_(0) {
+}
+
+void StreamingSpectralAnalyzer::Configure(uint32_t sampleRate, const SpectralFeaturesConfig& config) {
+    if (config.frameMs != 10 && config.frameMs != 20 && config.frameMs != 30) {
+        throw std::invalid_argument("Feature frame duration must be 10, 20 or 30 ms");
+    }
+    if (!IsValidSampleRate(sampleRate)) {
+        throw std::invalid_argument("Feature sample rate must be 8000, 16000, 32000 or 48000");
+    }
+
+    std::unique_ptr<Fvad, FvadDeleter> bands(fvad_new());
+    if (!bands || fvad_set_sample_rate(bands.get(), static_cast<int>(sampleRate)) != 0) {
+        throw std::runtime_error("Failed to create the filterbank");
+    }
+
+    const size_t frameSamples = static_cast<size_t>(sampleRate) * config.frameMs / 1000;
+    fft_ = std::make_unique<RealFFT>(RealFFT::SizeFor(frameSamples));
+    bands_ = std::move(bands);
+    config_ = config;
+    sampleRate_ = sampleRate;
+
+    frame_.assign(frameSamples, 0.0f);
+    pcm16_.assign(frameSamples, 0);
+    windowed_.assign(fft_->Size(), 0.0f);
+    power_.assign(fft_->Bins(), 0.0f);
+
+    window_.resize(frameSamples);
+    for (size_t i = 0; i < frameSamples; ++i) {
+        window_[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * PI * i / (frameSamples - 1)));
+    }
+
+    const float binHz = static_cast<float>(sampleRate) / fft_->Size();
+    const size_t lastBin = fft_->Bins() - 1;
+    firstBin_ = std::max<size_t>(static_cast<size_t>(std::ceil(MIN_ANALYSIS_HZ / binHz)), 1);
+    speechBegin_ = std::min(static_cast<size_t>(std::lround(SPEECH_LOW_HZ / binHz)), lastBin);
+    speechEnd_ = std::min(static_cast<size_t>(std::lround(SPEECH_HIGH_HZ / binHz)), lastBin) + 1;
+
+    filled_ = 0;
+}
+
+size_t StreamingSpectralAnalyzer::Process(const float* samples, size_t count, SpectralFrame* frames,
+                                          size_t capacity) {
+    if (!bands_ || !samples || frame_.empty()) {
+        return 0;
+    }
+
+    const size_t frameSamples = frame_.size();
+    size_t completed = 0;
+
+    while (count > 0) {
+        size_t take = std::min(count, frameSamples - filled_);
+        std::copy(samples, samples + take, frame_.begin() + filled_);
+        filled_ += take;
+        samples += take;
+        count -= take;
+
+        if (filled_ == frameSamples) {
+            SpectralFrame features;
+            AnalyseFrame(features);
+            if (frames && completed < capacity) {
+                frames[completed] = features;
+            }
+            completed++;
+            filled_ = 0;
+        }
+    }
+
+    return completed;
+}
+
+size_t StreamingSpectralAnalyzer::MaxFramesFor(size_t count) const {
+    if (frame_.empty()) return 0;
+    return (filled_ + count) / frame_.size();
+}
+
+void StreamingSpectralAnalyzer::Reset() {
+    filled_ = 0;
+    if (bands_) {
+        fvad_reset(bands_.get());
+        fvad_set_sample_rate(bands_.get(), static_cast<int>(sampleRate_));
+    }
+}
+
+void StreamingSpectralAnalyzer::AnalyseFrame(SpectralFrame& features) {
+    const size_t frameSamples = frame_.size();
+    const float* x = frame_.data();
+
+    // Time domain: power and sign changes
+    float sumSquares = 0.0f;
+    size_t crossings = 0;
+    for (size_t i = 0; i < frameSamples; ++i) {
+        sumSquares += x[i] * x[i];
+    }
+    for (size_t i = 1; i < frameSamples; ++i) {
+        crossings += (x[i - 1] < 0.0f) != (x[i] < 0.0f);
+    }
+    float meanSquare = sumSquares / frameSamples;
+    features.energyDb = meanSquare > 0.0f ? std::max(10.0f * std::log10(meanSquare), SILENCE_DB) : SILENCE_DB;
+    features.zeroCrossingRate = static_cast<float>(crossings) / (frameSamples - 1);
+
+    // Filterbank band energies straight from the VAD's feature extraction (Q4)
+    SimdKernels::FloatToInt16(x, pcm16_.data(), frameSamples);
+    int16_t bands[SpectralFrame::BANDS] = {};
+    fvad_band_energies(bands_.get(), pcm16_.data(), frameSamples, bands);
+    for (size_t b = 0; b < SpectralFrame::BANDS; ++b) {
+        features.bandDb[b] = bands[b] / 16.0f;
+    }
+
+    // Windowed power spectrum; the tail past the frame stays zero
+    for (size_t i = 0; i < frameSamples; ++i) {
+        windowed_[i] = x[i] * window_[i];
+    }
+    fft_->PowerSpectrum(windowed_.data(), power_.data());
+
+    const size_t bins = power_.size();
+    const float binHz = static_cast<float>(sampleRate_) / fft_->Size();
+    float total = 0.0f;
+    float weighted = 0.0f;
+    float speech = 0.0f;
+    float logSum = 0.0f;
+    for (size_t k = firstBin_; k < bins; ++k) {
+        float p = power_[k];
+        total += p;
+        weighted += p * (k * binHz);
+        logSum += std::log(p + MIN_SPECTRUM_POWER);
+    }
+    for (size_t k = speechBegin_; k < speechEnd_; ++k) {
+        speech += power_[k];
+    }
+
+    if (total < MIN_SPECTRUM_POWER) {
+        features.flatness = 0.0f;
+        features.centroidHz = 0.0f;
+        features.speechBandRatio = 0.0f;
+        return;
+    }
+
+    // Geometric over arithmetic mean of the power spectrum
+    const float count = static_cast<float>(bins - firstBin_);
+    features.flatness = std::min(std::exp(logSum / count) / (total / count), 1.0f);
+    features.centroidHz = weighted / total;
+    features.speechBandRatio = std::min(speech / total, 1.0f);
+}
+
+} // namespace AudioCapture
\ No newline at end of file
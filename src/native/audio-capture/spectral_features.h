@@ -0,0 +1,86 @@
+#pragma once
+
+#include "real_fft.h"
+#include "webrtc-vad/fvad.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace AudioCapture {
+
+// Features of one analysis frame; plain floats so a run of frames is one
+// Float32Array of SpectralFrame::COUNT values per frame for JS
+struct SpectralFrame {
+    static constexpr size_t BANDS = 6;
+    static constexpr size_t COUNT = 11;
+
+    float energyDb;          // Frame power in dBFS (-100 for digital silence)
+    float bandDb[BANDS];     // WebRTC VAD filterbank: 80-250, 250-500, 500-1k, 1-2k, 2-3k, 3-4k Hz
+    float flatness;          // Spectral flatness 0 (tonal, e.g. music notes) .. 1 (noise, e.g. keyboard)
+    float centroidHz;        // Spectral centre of mass
+    float zeroCrossingRate;  // Sign changes per sample
+    float speechBandRatio;   // Share of the power in 300-3400 Hz
+};
+
+static_assert(sizeof(SpectralFrame) == SpectralFrame::COUNT * sizeof(float), "SpectralFrame must stay packed");
+
+struct SpectralFeaturesConfig {
+    uint32_t frameMs = 20;  // 10, 20 or 30 (the filterbank's frame lengths)
+};
+
+// Per-frame spectral features over mono float32, next to the VAD's binary
+// decision, so consumers can tell speech from music or keyboard noise before
+// spending bandwidth on it. Buffers partial frames across chunks like
+// StreamingVAD; each completed frame gets the VAD's own filterbank band
+// energies (fvad_band_energies) plus flatness, centroid and speech-band share
+// from a Hann-windowed real FFT and the time-domain zero-crossing rate.
+class StreamingSpectralAnalyzer {
+public:
+    StreamingSpectralAnalyzer();
+
+    // Sample rate 8000, 16000, 32000 or 48000; throws std::invalid_argument
+    // on unsupported settings
+    void Configure(uint32_t sampleRate, const SpectralFeaturesConfig& config);
+
+    // Feed samples; writes one SpectralFrame per completed frame into frames
+    // (frames past capacity are still analysed) and returns frames done
+    size_t Process(const float* samples, size_t count, SpectralFrame* frames, size_t capacity);
+
+    // Upper bound of frames Process() completes for count more samples
+    size_t MaxFramesFor(size_t count) const;
+
+    // Clear the partial frame and the filterbank state
+    void Reset();
+
+    bool IsConfigured() const { return bands_ != nullptr; }
+    size_t FrameSamples() const { return frame_.size(); }
+    uint32_t SampleRate() const { return sampleRate_; }
+    const SpectralFeaturesConfig& Config() const { return config_; }
+
+private:
+    struct FvadDeleter {
+        void operator()(Fvad* instance) const { fvad_free(instance); }
+    };
+
+    void AnalyseFrame(SpectralFrame& features);
+
+    std::unique_ptr<Fvad, FvadDeleter> bands_;  // Filterbank state only, never classifies
+    std::unique_ptr<RealFFT> fft_;
+    SpectralFeaturesConfig config_;
+    uint32_t sampleRate_;
+
+    std::vector<float> frame_;     // Partial frame carried between chunks
+    std::vector<int16_t> pcm16_;   // Frame converted for the filterbank
+    std::vector<float> window_;    // Hann window over the frame
+    std::vector<float> windowed_;  // Zero-padded FFT input
+    std::vector<float> power_;
+    size_t filled_;
+
+    // Power spectrum bins of the speech band and of the analysed range
+    size_t speechBegin_;
+    size_t speechEnd_;
+    size_t firstBin_;
+};
+
+} // namespace AudioCapture
\ No newline at end of file
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <algorithm>
+#include <type_traits>
+
+namespace AudioCapture {
+
+// Assumed cache line size, used to keep producer and consumer state apart
+constexpr size_t kCacheLineSize = 64;
+
+template <typename T>
+class RingReader;
+
+// Storage and producer half shared by SpscRingBuffer and BroadcastRing.
+// Writes are wait-free and never lock or allocate, so the producer can be a
+// real-time OS audio thread; they never wait for readers either, and
+// overwrite the oldest samples when the ring is full.
+//
+// Overwrite detection works like a seqlock: the producer publishes how far it is
+// about to write before touching the storage, and a reader re-checks that
+// position after copying and discards anything that was overwritten underneath it.
+//
+// Runs written with PushZeros() are remembered, so a reader can tell that the
+// front of the ring is silence and skip it instead of copying zeros.
+template <typename T>
+class RingStorage {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "RingStorage requires trivially copyable samples");
+
+public:
+    // Capacity is rounded up to the next power of two
+    explicit RingStorage(size_t capacity)
+        : capacity_(RoundUpPowerOfTwo(capacity))
+        , mask_(capacity_ - 1)
+        , storage_(new T[capacity_]()) {
+    }
+
+    RingStorage(const RingStorage&) = delete;
+    RingStorage& operator=(const RingStorage&) = delete;
+
+    // Producer: append samples, overwriting the oldest ones if the ring is full
+    void Push(const T* data, size_t count) {
+        if (!data || count == 0) return;
+
+        silentFrom_.store(NO_SILENCE, std::memory_order_relaxed);
+        Write(data, count);
+    }
+
+    // Producer: append count zero samples, extending the current silence run
+    void PushZeros(size_t count) {
+        if (count == 0) return;
+
+        if (silentFrom_.load(std::memory_order_relaxed) == NO_SILENCE) {
+            silentFrom_.store(writeIndex_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        Write(nullptr, count);
+    }
+
+    size_t Capacity() const { return capacity_; }
+
+    // Samples written since construction
+    uint64_t WritePosition() const { return writeIndex_.load(std::memory_order_acquire); }
+
+private:
+    friend class RingReader<T>;
+
+    static size_t RoundUpPowerOfTwo(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    // Shared by Push() and PushZeros(); null data writes zeros
+    void Write(const T* data, size_t count) {
+        uint64_t write = writeIndex_.load(std::memory_order_relaxed);
+        uint64_t end = write + count;
+
+        // Anything beyond capacity would be overwritten immediately; only copy the tail
+        if (count > capacity_) {
+            if (data) data += count - capacity_;
+            write = end - capacity_;
+            count = capacity_;
+        }
+
+        claimIndex_.store(end, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        size_t start = static_cast<size_t>(write & mask_);
+        size_t first = std::min(count, capacity_ - start);
+        if (data) {
+            std::memcpy(storage_.get() + start, data, first * sizeof(T));
+            if (first < count) {
+                std::memcpy(storage_.get(), data + first, (count - first) * sizeof(T));
+            }
+        } else {
+            std::memset(storage_.get() + start, 0, first * sizeof(T));
+            if (first < count) {
+                std::memset(storage_.get(), 0, (count - first) * sizeof(T));
+            }
+        }
+
+        writeIndex_.store(end, std::memory_order_release);
+    }
+
+    static constexpr uint64_t NO_SILENCE = UINT64_MAX;
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<T[]> storage_;
+
+    // Producer-owned; readers keep their own positions
+    alignas(kCacheLineSize) std::atomic<uint64_t> writeIndex_{0};
+    std::atomic<uint64_t> claimIndex_{0};
+    std::atomic<uint64_t> silentFrom_{NO_SILENCE};  // Start of the trailing PushZeros() run
+};
+
+// Consumer half: one read position into a RingStorage, used from one thread.
+// Samples the producer lapped are skipped and counted as this reader's overruns.
+template <typename T>
+class RingReader {
+public:
+    explicit RingReader(uint64_t position) : readIndex_(position) {}
+
+    RingReader(const RingReader&) = delete;
+    RingReader& operator=(const RingReader&) = delete;
+
+    // Move up to maxCount of the oldest unread samples into dest, returns samples copied
+    size_t Pop(const RingStorage<T>& ring, T* dest, size_t maxCount) {
+        if (!dest || maxCount == 0) return 0;
+
+        uint64_t read = Front(ring);
+        uint64_t write = ring.writeIndex_.load(std::memory_order_acquire);
+        size_t count = static_cast<size_t>(std::min<uint64_t>(write - read, maxCount));
+        if (count == 0) return 0;
+
+        const size_t capacity = ring.capacity_;
+        size_t start = static_cast<size_t>(read & ring.mask_);
+        size_t first = std::min(count, capacity - start);
+        std::memcpy(dest, ring.storage_.get() + start, first * sizeof(T));
+        if (first < count) {
+            std::memcpy(dest + first, ring.storage_.get(), (count - first) * sizeof(T));
+        }
+
+        // Drop the front of the copy if the producer overwrote it while we were reading
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t claimed = ring.claimIndex_.load(std::memory_order_relaxed);
+        if (claimed > read + capacity) {
+            size_t overwritten = static_cast<size_t>(
+                std::min<uint64_t>(claimed - capacity - read, count));
+            overruns_.fetch_add(overwritten, std::memory_order_relaxed);
+            count -= overwritten;
+            if (count > 0) {
+                std::memmove(dest, dest + overwritten, count * sizeof(T));
+            }
+            read += overwritten;
+        }
+
+        readIndex_.store(read + count, std::memory_order_release);
+        return count;
+    }
+
+    // Drop up to maxCount of the oldest unread samples without copying them
+    size_t Skip(const RingStorage<T>& ring, size_t maxCount) {
+        uint64_t read = Front(ring);
+        uint64_t write = ring.writeIndex_.load(std::memory_order_acquire);
+        size_t count = static_cast<size_t>(std::min<uint64_t>(write - read, maxCount));
+        readIndex_.store(read + count, std::memory_order_release);
+        return count;
+    }
+
+    // How many unread samples at the front are PushZeros() silence (all of
+    // them up to the newest sample); 0 when the front is audio
+    size_t SilentAvailable(const RingStorage<T>& ring) const {
+        uint64_t write = ring.writeIndex_.load(std::memory_order_acquire);
+        uint64_t read = readIndex_.load(std::memory_order_relaxed);
+        uint64_t silentFrom = ring.silentFrom_.load(std::memory_order_relaxed);
+
+        // Samples the producer already lapped are gone either way
+        uint64_t front = write - read > ring.capacity_ ? write - ring.capacity_ : read;
+        if (silentFrom > front) return 0;
+        return static_cast<size_t>(write - front);
+    }
+
+    // Discard everything unread
+    void Clear(const RingStorage<T>& ring) {
+        readIndex_.store(ring.writeIndex_.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    // Number of unread samples (may be stale by the time it is used)
+    size_t Available(const RingStorage<T>& ring) const {
+        uint64_t write = ring.writeIndex_.load(std::memory_order_acquire);
+        uint64_t read = readIndex_.load(std::memory_order_acquire);
+        return static_cast<size_t>(std::min<uint64_t>(write - read, ring.capacity_));
+    }
+
+    // Samples this reader lost to overwrite-oldest
+    uint64_t OverrunCount() const {
+        return overruns_.load(std::memory_order_relaxed);
+    }
+
+private:
+    // Read position after skipping past samples the producer already lapped
+    uint64_t Front(const RingStorage<T>& ring) {
+        uint64_t read = readIndex_.load(std::memory_order_relaxed);
+        uint64_t write = ring.writeIndex_.load(std::memory_order_acquire);
+        if (write - read > ring.capacity_) {
+            overruns_.fetch_add(write - ring.capacity_ - read, std::memory_order_relaxed);
+            read = write - ring.capacity_;
+        }
+        return read;
+    }
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> readIndex_;
+    std::atomic<uint64_t> overruns_{0};
+};
+
+// Preallocated single-producer/single-consumer ring of trivially copyable samples.
+// Push() and Pop() are wait-free and never lock or allocate. When the consumer
+// falls behind, the oldest samples are overwritten and counted as overruns
+// instead of blocking the producer (see RingStorage).
+template <typename T>
+class SpscRingBuffer {
+public:
+    // Capacity is rounded up to the next power of two
+    explicit SpscRingBuffer(size_t capacity)
+        : ring_(capacity)
+        , reader_(0) {
+    }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // Producer: append samples, overwriting the oldest ones if the ring is full
+    void Push(const T* data, size_t count) { ring_.Push(data, count); }
+
+    // Producer: append count zero samples, extending the current silence run
+    void PushZeros(size_t count) { ring_.PushZeros(count); }
+
+    // Consumer: move up to maxCount of the oldest samples into dest, returns samples copied
+    size_t Pop(T* dest, size_t maxCount) { return reader_.Pop(ring_, dest, maxCount); }
+
+    // Consumer: drop up to maxCount of the oldest samples without copying them
+    size_t Skip(size_t maxCount) { return reader_.Skip(ring_, maxCount); }
+
+    // Consumer: how many samples at the front are PushZeros() silence (all of
+    // them up to the newest sample); 0 when the front is audio
+    size_t SilentAvailable() const { return reader_.SilentAvailable(ring_); }
+
+    // Consumer: discard everything currently buffered
+    void Clear() { reader_.Clear(ring_); }
+
+    // Number of samples currently readable (may be stale by the time it is used)
+    size_t Available() const { return reader_.Available(ring_); }
+
+    size_t Capacity() const { return ring_.Capacity(); }
+
+    // Total samples lost to overwrite-oldest since construction
+    uint64_t OverrunCount() const { return reader_.OverrunCount(); }
+
+private:
+    RingStorage<T> ring_;
+    RingReader<T> reader_;
+};
+
+using SpscFloatRing = SpscRingBuffer<float>;
+
+} // namespace AudioCapture
\ No newline at end of file
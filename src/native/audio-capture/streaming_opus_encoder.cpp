@@ -0,0 +1,144 @@
+#include "streaming_opus_encoder.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#ifdef AUDIOMID_HAVE_OPUS
+#include <opus.h>
+#endif
+
+namespace AudioCapture {
+
+StreamingOpusEncoder::StreamingOpusEncoder()
+    : sampleRate_(0)
+    , filled_(0)
+    , position_(0)
+    , errors_(0) {
+}
+
+StreamingOpusEncoder::~StreamingOpusEncoder() = default;
+
+void StreamingOpusEncoder::EncoderDeleter::operator()(void* encoder) const {
+#ifdef AUDIOMID_HAVE_OPUS
+    opus_encoder_destroy(static_cast<OpusEncoder*>(encoder));
+#else
+    (void)encoder;
+#endif
+}
+
+bool StreamingOpusEncoder::IsAvailable() {
+#ifdef AUDIOMID_HAVE_OPUS
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool StreamingOpusEncoder::IsSupportedRate(uint32_t sampleRate) {
+    return sampleRate == 8000 || sampleRate == 12000 || sampleRate == 16000 ||
+           sampleRate == 24000 || sampleRate == 48000;
+}
+
+void StreamingOpusEncoder::Configure(uint32_t sampleRate, const OpusEncoderConfig& config) {
+    if (!IsAvailable()) {
+        throw std::runtime_error("Built without Opus support (configure with AUDIOMID_WITH_OPUS=ON)");
+    }
+    if (!IsSupportedRate(sampleRate)) {
+        throw std::invalid_argument("Opus sample rate must be 8000, 12000, 16000, 24000 or 48000");
+    }
+    if (config.frameMs != 10 && config.frameMs != 20 && config.frameMs != 40 && config.frameMs != 60) {
+        throw std::invalid_argument("Opus frame duration must be 10, 20, 40 or 60 ms");
+    }
+    if (config.bitrate < 6000 || config.bitrate > 510000) {
+        throw std::invalid_argument("Opus bitrate must be 6000-510000 bits per second");
+    }
+    if (config.complexity < 0 || config.complexity > 10) {
+        throw std::invalid_argument("Opus complexity must be 0-10");
+    }
+
+#ifdef AUDIOMID_HAVE_OPUS
+    int error = OPUS_OK;
+    int application = config.voip ? OPUS_APPLICATION_VOIP : OPUS_APPLICATION_AUDIO;
+    OpusEncoder* encoder = opus_encoder_create(static_cast<opus_int32>(sampleRate), 1, application, &error);
+    if (!encoder || error != OPUS_OK) {
+        throw std::runtime_error(std::string("Failed to create Opus encoder: ") + opus_strerror(error));
+    }
+    encoder_.reset(encoder);
+
+    opus_encoder_ctl(encoder, OPUS_SET_BITRATE(static_cast<opus_int32>(config.bitrate)));
+    opus_encoder_ctl(encoder, OPUS_SET_COMPLEXITY(config.complexity));
+    opus_encoder_ctl(encoder, OPUS_SET_SIGNAL(config.voip ? OPUS_SIGNAL_VOICE : OPUS_AUTO));
+#endif
+
+    config_ = config;
+    sampleRate_ = sampleRate;
+    frame_.assign(static_cast<size_t>(sampleRate) * config.frameMs / 1000, 0.0f);
+    filled_ = 0;
+    position_ = 0;
+    errors_ = 0;
+}
+
+size_t StreamingOpusEncoder::Process(const float* samples, size_t count, uint64_t timestamp,
+                                     OpusPacket* packets, size_t capacity) {
+    if (!encoder_ || !samples || frame_.empty()) {
+        return 0;
+    }
+
+    const size_t frameSamples = frame_.size();
+    size_t written = 0;
+
+    while (count > 0) {
+        size_t take = std::min(count, frameSamples - filled_);
+        std::copy(samples, samples + take, frame_.begin() + filled_);
+        filled_ += take;
+        samples += take;
+        count -= take;
+
+        if (filled_ < frameSamples) break;
+
+#ifdef AUDIOMID_HAVE_OPUS
+        if (packets && written < capacity) {
+            OpusPacket& packet = packets[written];
+            opus_int32 bytes = opus_encode_float(static_cast<OpusEncoder*>(encoder_.get()),
+                                                 frame_.data(), static_cast<int>(frameSamples),
+                                                 packet.data, static_cast<opus_int32>(kOpusMaxPacketBytes));
+            if (bytes > 0) {
+                packet.timestamp = timestamp;
+                packet.position = position_;
+                packet.size = static_cast<uint16_t>(bytes);
+                written++;
+            } else {
+                errors_++;
+            }
+        }
+#else
+        (void)timestamp;
+        (void)packets;
+        (void)capacity;
+#endif
+
+        position_ += frameSamples;
+        filled_ = 0;
+    }
+
+    return written;
+}
+
+size_t StreamingOpusEncoder::MaxPacketsFor(size_t count) const {
+    if (frame_.empty()) {
+        return 0;
+    }
+    return (filled_ + count) / frame_.size();
+}
+
+void StreamingOpusEncoder::Reset() {
+#ifdef AUDIOMID_HAVE_OPUS
+    if (encoder_) {
+        opus_encoder_ctl(static_cast<OpusEncoder*>(encoder_.get()), OPUS_RESET_STATE);
+    }
+#endif
+    filled_ = 0;
+    position_ = 0;
+}
+
+} // namespace AudioCapture
\ No newline at end of file
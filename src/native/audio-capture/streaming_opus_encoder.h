@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace AudioCapture {
+
+// Largest Opus packet for one frame (RFC 6716, 3.4)
+constexpr size_t kOpusMaxPacketBytes = 1275;
+
+struct OpusEncoderConfig {
+    uint32_t bitrate = 24000;   // Bits per second (6000-510000)
+    uint32_t frameMs = 20;      // 10, 20, 40 or 60
+    int complexity = 5;         // 0-10, CPU vs. quality
+    bool voip = true;           // OPUS_APPLICATION_VOIP, else OPUS_APPLICATION_AUDIO
+};
+
+// One encoded frame, handed from the capture thread to JS
+struct OpusPacket {
+    uint64_t timestamp;   // MonotonicMicros of the capture packet that completed the frame
+    uint64_t position;    // Stream sample index of the frame's first sample
+    uint16_t size;
+    uint8_t data[kOpusMaxPacketBytes];
+};
+
+// Streaming Opus encoding of mono float32. Buffers partial frames across
+// chunks and encodes each complete frame into one packet.
+//
+// Only functional when built with libopus (AUDIOMID_HAVE_OPUS); otherwise
+// IsAvailable() is false and Configure() throws.
+class StreamingOpusEncoder {
+public:
+    StreamingOpusEncoder();
+    ~StreamingOpusEncoder();
+
+    StreamingOpusEncoder(const StreamingOpusEncoder&) = delete;
+    StreamingOpusEncoder& operator=(const StreamingOpusEncoder&) = delete;
+
+    static bool IsAvailable();
+
+    // Rates Opus encodes natively: 8, 12, 16, 24 or 48 kHz
+    static bool IsSupportedRate(uint32_t sampleRate);
+
+    // Create the encoder; throws std::invalid_argument / std::runtime_error
+    // on unsupported settings or without Opus support
+    void Configure(uint32_t sampleRate, const OpusEncoderConfig& config);
+
+    // Feed samples; encodes every completed frame into packets (frames past
+    // capacity are still consumed) and returns packets written
+    size_t Process(const float* samples, size_t count, uint64_t timestamp,
+                   OpusPacket* packets, size_t capacity);
+
+    // Upper bound of packets Process() produces for count more samples
+    size_t MaxPacketsFor(size_t count) const;
+
+    // Drop the partial frame and restart the encoder's stream
+    void Reset();
+
+    bool IsConfigured() const { return encoder_ != nullptr; }
+    size_t FrameSamples() const { return frame_.size(); }
+    uint32_t SampleRate() const { return sampleRate_; }
+    const OpusEncoderConfig& Config() const { return config_; }
+
+    // Frames the encoder rejected (should stay 0)
+    uint64_t ErrorCount() const { return errors_; }
+
+private:
+    struct EncoderDeleter {
+        void operator()(void* encoder) const;
+    };
+
+    std::unique_ptr<void, EncoderDeleter> encoder_;  // OpusEncoder
+    OpusEncoderConfig config_;
+    uint32_t sampleRate_;
+
+    std::vector<float> frame_;  // Partial frame carried between chunks
+    size_t filled_;
+    uint64_t position_;         // Samples consumed before frame_
+    uint64_t errors_;
+};
+
+} // namespace AudioCapture
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include "streaming_resampler.h"
+#include "audio_simd_kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace AudioCapture {
+
+namespace {
+
+// Filter length per unit of decimation; 48 taps/phase with beta 7.9 gives
+// roughly 80dB of stopband rejection
+constexpr size_t kTapsPerPhase = 48;
+constexpr double kKaiserBeta = 7.86;
+
+// Cutoff as a fraction of the output Nyquist (leaves room for the transition band)
+constexpr double kPassbandFraction = 0.9;
+
+constexpr double kPi = 3.14159265358979323846;
+
+// Zeroth-order modified Bessel function of the first kind (series expansion)
+double BesselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = x / 2.0;
+    for (int k = 1; k < 50; ++k) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+} // namespace
+
+StreamingResampler::StreamingResampler()
+    : inputRate_(48000)
+    , outputRate_(48000)
+    , factor_(1)
+    , historyFrames_(0)
+    , phase_(0)
+    , silentFrames_(0) {
+}
+
+bool StreamingResampler::IsSupported(uint32_t inputRate, uint32_t outputRate) {
+    return inputRate > 0 && outputRate > 0 &&
+           outputRate <= inputRate && inputRate % outputRate == 0;
+}
+
+bool StreamingResampler::Configure(uint32_t inputRate, uint32_t outputRate) {
+    if (!IsSupported(inputRate, outputRate)) {
+        return false;
+    }
+
+    inputRate_ = inputRate;
+    outputRate_ = outputRate;
+    factor_ = inputRate / outputRate;
+
+    DesignFilter();
+
+    // Room for 100ms chunks up front so steady-state Process() never grows
+    work_.reserve(historyFrames_ + inputRate_ / 10);
+    Reset();
+    return true;
+}
+
+void StreamingResampler::DesignFilter() {
+    if (factor_ == 1) {
+        taps_.clear();
+        historyFrames_ = 0;
+        return;
+    }
+
+    const size_t length = kTapsPerPhase * factor_ + 1;
+    const double cutoff = 0.5 * kPassbandFraction / factor_;  // cycles per input sample
+    const double middle = (length - 1) / 2.0;
+    const double windowNorm = BesselI0(kKaiserBeta);
+
+    taps_.resize(length);
+    double sum = 0.0;
+    for (size_t n = 0; n < length; ++n) {
+        double x = n - middle;
+        double sinc = (x == 0.0) ? 1.0 : std::sin(2.0 * kPi * cutoff * x) / (2.0 * kPi * cutoff * x);
+        double ratio = x / middle;
+        double window = BesselI0(kKaiserBeta * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) / windowNorm;
+        double tap = 2.0 * cutoff * sinc * window;
+        taps_[n] = static_cast<float>(tap);
+        sum += tap;
+    }
+
+    // Unity gain at DC
+    for (float& tap : taps_) {
+        tap = static_cast<float>(tap / sum);
+    }
+
+    historyFrames_ = length - 1;
+}
+
+size_t StreamingResampler::MaxOutputFrames(size_t inputFrames) const {
+    if (factor_ == 1) {
+        return inputFrames;
+    }
+    return (inputFrames + factor_ - 1) / factor_;
+}
+
+size_t StreamingResampler::Process(const float* input, size_t count, float* output, size_t capacity) {
+    if (!input || !output || count == 0) {
+        return 0;
+    }
+
+    if (factor_ == 1) {
+        size_t frames = std::min(count, capacity);
+        std::memcpy(output, input, frames * sizeof(float));
+        return frames;
+    }
+
+    // work_ = [history (taps - 1) | chunk]; output k's window ends at chunk[phase_ + k * factor_]
+    const size_t needed = historyFrames_ + count;
+    if (work_.size() < needed) {
+        work_.resize(needed);
+    }
+    std::memcpy(work_.data() + historyFrames_, input, count * sizeof(float));
+    silentFrames_ = 0;
+
+    return Filter(count, output, capacity);
+}
+
+size_t StreamingResampler::ProcessSilence(size_t count, float* output, size_t capacity) {
+    if (!output || count == 0) {
+        return 0;
+    }
+
+    if (factor_ == 1 || silentFrames_ >= historyFrames_) {
+        // Every window is all zeros: only the phase moves
+        size_t outputs = phase_ < count ? (count - phase_ + factor_ - 1) / factor_ : 0;
+        phase_ += outputs * factor_ - count;
+        size_t frames = std::min(outputs, capacity);
+        std::fill(output, output + frames, 0.0f);
+        return frames;
+    }
+
+    // Still ringing out the last audio
+    const size_t needed = historyFrames_ + count;
+    if (work_.size() < needed) {
+        work_.resize(needed);
+    }
+    std::fill(work_.begin() + historyFrames_, work_.begin() + needed, 0.0f);
+    silentFrames_ = std::min(silentFrames_ + count, historyFrames_);
+
+    return Filter(count, output, capacity);
+}
+
+size_t StreamingResampler::Filter(size_t count, float* output, size_t capacity) {
+    const size_t tapCount = taps_.size();
+    size_t written = 0;
+    size_t position = phase_;
+    for (; position < count; position += factor_) {
+        if (written < capacity) {
+            output[written++] = SimdKernels::DotProduct(work_.data() + position, taps_.data(), tapCount);
+        }
+    }
+
+    // Carry the decimation phase and the filter history into the next chunk
+    phase_ = position - count;
+    std::memmove(work_.data(), work_.data() + count, historyFrames_ * sizeof(float));
+
+    return written;
+}
+
+void StreamingResampler::Reset() {
+    phase_ = 0;
+    if (work_.size() < historyFrames_) {
+        work_.resize(historyFrames_);
+    }
+    std::fill(work_.begin(), work_.begin() + historyFrames_, 0.0f);
+    silentFrames_ = historyFrames_;
+}
+
+size_t StreamingResampler::LatencyFrames() const {
+    if (factor_ == 1) {
+        return 0;
+    }
+    return (historyFrames_ / 2) / factor_;
+}
+
+} // namespace AudioCapture
\ No newline at end of file
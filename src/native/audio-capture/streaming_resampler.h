@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace AudioCapture {
+
+// Streaming polyphase decimator for mono float32 (e.g. 48kHz -> 24/16/8kHz).
+// A Kaiser-windowed sinc low-pass removes everything above the new Nyquist
+// before decimating, and only the output phase is evaluated, so the cost is
+// one SIMD dot product per output sample. Filter history is carried across
+// Process() calls, so chunk boundaries are seamless.
+//
+// Supports integer ratios (input rate a multiple of the output rate) plus
+// passthrough when the rates are equal.
+class StreamingResampler {
+public:
+    StreamingResampler();
+
+    // Whether Configure() accepts this conversion
+    static bool IsSupported(uint32_t inputRate, uint32_t outputRate);
+
+    // Set up for a conversion and clear history; false if unsupported
+    bool Configure(uint32_t inputRate, uint32_t outputRate);
+
+    // Upper bound of Process() output for inputFrames of input
+    size_t MaxOutputFrames(size_t inputFrames) const;
+
+    // Resample a chunk; output needs MaxOutputFrames(count) room (anything past
+    // capacity is dropped). Returns frames written. Allocates only when count
+    // exceeds every previous chunk.
+    size_t Process(const float* input, size_t count, float* output, size_t capacity);
+
+    // Same as Process() for count zero frames. Once the history has settled to
+    // zeros, the output is known to be zeros and no filtering is done.
+    size_t ProcessSilence(size_t count, float* output, size_t capacity);
+
+    // Forget filter history (e.g. after a discontinuity)
+    void Reset();
+
+    uint32_t InputRate() const { return inputRate_; }
+    uint32_t OutputRate() const { return outputRate_; }
+    bool IsPassthrough() const { return factor_ == 1; }
+
+    // Filter group delay in output frames
+    size_t LatencyFrames() const;
+
+private:
+    void DesignFilter();
+    size_t Filter(size_t count, float* output, size_t capacity);
+
+    uint32_t inputRate_;
+    uint32_t outputRate_;
+    uint32_t factor_;
+
+    std::vector<float> taps_;
+    std::vector<float> work_;   // history followed by the current chunk
+    size_t historyFrames_;      // taps - 1
+    size_t phase_;              // input frames to skip before the next output
+    size_t silentFrames_;       // trailing zero input frames, up to historyFrames_
+};
+
+} // namespace AudioCapture
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "streaming_vad.h"
+#include "audio_simd_kernels.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace AudioCapture {
+
+StreamingVAD::StreamingVAD()
+    : sampleRate_(0)
+    , filled_(0)
+    , holdFrames_(0)
+    , releaseFrames_(0)
+    , voicedRun_(0)
+    , silentRun_(0)
+    , speaking_(false) {
+}
+
+void StreamingVAD::Configure(uint32_t sampleRate, const StreamingVADConfig& config) {
+    if (config.frameMs != 10 && config.frameMs != 20 && config.frameMs != 30) {
+        throw std::invalid_argument("VAD frame duration must be 10, 20 or 30 ms");
+    }
+
+    // Throws on unsupported sample rate or mode
+    auto vad = std::make_unique<WebRTCVAD::VADWrapper>(static_cast<int>(sampleRate), config.mode);
+
+    vad_ = std::move(vad);
+    config_ = config;
+    sampleRate_ = sampleRate;
+
+    size_t frameSamples = WebRTCVAD::VADWrapper::GetFrameLength(static_cast<int>(sampleRate), config.frameMs);
+    frame_.assign(frameSamples, 0.0f);
+    pcm16_.assign(frameSamples, 0);
+
+    // Round up so any non-zero hold/release lasts at least one frame
+    holdFrames_ = (config.holdMs + config.frameMs - 1) / config.frameMs;
+    releaseFrames_ = (config.releaseMs + config.frameMs - 1) / config.frameMs;
+
+    filled_ = 0;
+    voicedRun_ = 0;
+    silentRun_ = 0;
+    speaking_ = false;
+}
+
+size_t StreamingVAD::Process(const float* samples, size_t count, uint8_t* flags, size_t capacity) {
+    if (!vad_ || !samples || frame_.empty()) {
+        return 0;
+    }
+
+    const size_t frameSamples = frame_.size();
+    size_t frames = 0;
+
+    while (count > 0) {
+        size_t take = std::min(count, frameSamples - filled_);
+        std::copy(samples, samples + take, frame_.begin() + filled_);
+        filled_ += take;
+        samples += take;
+        count -= take;
+
+        if (filled_ == frameSamples) {
+            uint8_t frameFlags = RunFrame();
+            if (flags && frames < capacity) {
+                flags[frames] = frameFlags;
+            }
+            frames++;
+            filled_ = 0;
+        }
+    }
+
+    return frames;
+}
+
+uint8_t StreamingVAD::RunFrame() {
+    SimdKernels::FloatToInt16(frame_.data(), pcm16_.data(), frame_.size());
+
+    bool voiced = vad_->Process(pcm16_.data(), pcm16_.size()) == 1;
+    uint8_t flags = voiced ? kVADFrameVoiced : 0;
+
+    // Hysteresis: start after holdMs of continuous voice, stop after releaseMs of silence
+    if (voiced) {
+        voicedRun_++;
+        silentRun_ = 0;
+
+        if (!speaking_ && voicedRun_ >= holdFrames_) {
+            speaking_ = true;
+            flags |= kVADFrameSpeechStart;
+        }
+    } else {
+        silentRun_++;
+        voicedRun_ = 0;
+
+        if (speaking_ && silentRun_ >= releaseFrames_) {
+            speaking_ = false;
+            flags |= kVADFrameSpeechEnd;
+        }
+    }
+
+    if (speaking_) {
+        flags |= kVADFrameSpeaking;
+    }
+
+    return flags;
+}
+
+size_t StreamingVAD::MaxFramesFor(size_t count) const {
+    if (frame_.empty()) {
+        return 0;
+    }
+    return (filled_ + count) / frame_.size();
+}
+
+void StreamingVAD::Reset() {
+    if (vad_) {
+        vad_->Reset();
+    }
+    filled_ = 0;
+    voicedRun_ = 0;
+    silentRun_ = 0;
+    speaking_ = false;
+}
+
+} // namespace AudioCapture
\ No newline at end of file
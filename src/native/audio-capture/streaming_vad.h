@@ -0,0 +1,71 @@
+#pragma once
+
+#include "webrtc-vad/vad_wrapper.h"
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+namespace AudioCapture {
+
+// Per-frame decision flags produced by StreamingVAD
+enum VADFrameFlags : uint8_t {
+    kVADFrameVoiced      = 1 << 0,  // Raw WebRTC VAD decision for this frame
+    kVADFrameSpeaking    = 1 << 1,  // Speaking state after hold/release hysteresis
+    kVADFrameSpeechStart = 1 << 2,  // Speaking began with this frame
+    kVADFrameSpeechEnd   = 1 << 3   // Speaking ended with this frame
+};
+
+struct StreamingVADConfig {
+    int mode = 2;               // WebRTC VAD aggressiveness (0-3)
+    uint32_t frameMs = 20;      // 10, 20 or 30
+    uint32_t holdMs = 200;      // Continuous voice needed to start speaking
+    uint32_t releaseMs = 2000;  // Continuous silence needed to stop speaking
+};
+
+// Streaming voice activity detection over mono float32. Buffers partial frames
+// across chunks, runs WebRTC VAD on each complete frame and applies hold/release
+// hangover, emitting one flags byte per frame.
+class StreamingVAD {
+public:
+    StreamingVAD();
+
+    // Create the detector; throws std::invalid_argument / std::runtime_error
+    // on unsupported rates or settings
+    void Configure(uint32_t sampleRate, const StreamingVADConfig& config);
+
+    // Feed samples; writes one VADFrameFlags byte per completed frame into
+    // flags (frames past capacity are still processed) and returns frames done
+    size_t Process(const float* samples, size_t count, uint8_t* flags, size_t capacity);
+
+    // Upper bound of frames Process() completes for count more samples
+    size_t MaxFramesFor(size_t count) const;
+
+    // Clear partial frame, detector and hysteresis state
+    void Reset();
+
+    bool IsConfigured() const { return vad_ != nullptr; }
+    bool IsSpeaking() const { return speaking_; }
+    size_t FrameSamples() const { return frame_.size(); }
+    uint32_t SampleRate() const { return sampleRate_; }
+    const StreamingVADConfig& Config() const { return config_; }
+
+private:
+    uint8_t RunFrame();
+
+    std::unique_ptr<WebRTCVAD::VADWrapper> vad_;
+    StreamingVADConfig config_;
+    uint32_t sampleRate_;
+
+    std::vector<float> frame_;      // Partial frame carried between chunks
+    std::vector<int16_t> pcm16_;    // Frame converted for libfvad
+    size_t filled_;
+
+    uint32_t holdFrames_;
+    uint32_t releaseFrames_;
+    uint32_t voicedRun_;
+    uint32_t silentRun_;
+    bool speaking_;
+};
+
+} // namespace AudioCapture
\ No newline at end of file
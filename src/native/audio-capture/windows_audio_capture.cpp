@@ -1,20 +1,121 @@
 #ifdef WINDOWS_PLATFORM
 
 #include "windows_audio_capture.h"
+#include "audio_format_kernels.h"
+#include <ksmedia.h>
 #include <chrono>
 #include <sstream>
 #include <iomanip>
 
 namespace AudioCapture {
 
+namespace {
+
+// Map a WASAPI QPC position (100ns units) onto MonotonicMicros(); 0 if unusable
+uint64_t QpcPositionToMonotonicMicros(UINT64 qpcPosition) {
+    LARGE_INTEGER counter, frequency;
+    if (qpcPosition == 0 || !QueryPerformanceCounter(&counter) ||
+        !QueryPerformanceFrequency(&frequency) || frequency.QuadPart <= 0) {
+        return 0;
+    }
+    
+    // Split the conversion so the multiply cannot overflow
+    uint64_t ticks = static_cast<uint64_t>(counter.QuadPart);
+    uint64_t freq = static_cast<uint64_t>(frequency.QuadPart);
+    uint64_t now100ns = ticks / freq * 10000000 + ticks % freq * 10000000 / freq;
+    if (qpcPosition > now100ns) return 0;
+    
+    uint64_t ageMicros = (now100ns - qpcPosition) / 10;
+    uint64_t now = MonotonicMicros();
+    return ageMicros < now ? now - ageMicros : 0;
+}
+
+} // namespace
+
+// Endpoint notifications from the MMDevice API. They arrive on a system thread
+// that must not block, so the change is only flagged here.
+class WindowsAudioCapture::NotificationClient : public IMMNotificationClient {
+public:
+    explicit NotificationClient(WindowsAudioCapture* owner)
+        : refCount_(1)
+        , owner_(owner) {
+    }
+    
+    ULONG STDMETHODCALLTYPE AddRef() override {
+        return InterlockedIncrement(&refCount_);
+    }
+    
+    ULONG STDMETHODCALLTYPE Release() override {
+        ULONG count = InterlockedDecrement(&refCount_);
+        if (count == 0) {
+            delete this;
+        }
+        return count;
+    }
+    
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** object) override {
+        if (riid == __uuidof(IUnknown) || riid == __uuidof(IMMNotificationClient)) {
+            *object = static_cast<IMMNotificationClient*>(this);
+            AddRef();
+            return S_OK;
+        }
+        *object = nullptr;
+        return E_NOINTERFACE;
+    }
+    
+    HRESULT STDMETHODCALLTYPE OnDefaultDeviceChanged(EDataFlow flow, ERole role, LPCWSTR /*deviceId*/) override {
+        // Loopback captures the console render default
+        if (flow == eRender && role == eConsole) {
+            owner_->OnDefaultDeviceChanged();
+        }
+        owner_->NotifyDevicesChanged();
+        return S_OK;
+    }
+    
+    HRESULT STDMETHODCALLTYPE OnDeviceAdded(LPCWSTR /*deviceId*/) override {
+        owner_->NotifyDevicesChanged();
+        return S_OK;
+    }
+    
+    HRESULT STDMETHODCALLTYPE OnDeviceRemoved(LPCWSTR /*deviceId*/) override {
+        owner_->NotifyDevicesChanged();
+        return S_OK;
+    }
+    
+    HRESULT STDMETHODCALLTYPE OnDeviceStateChanged(LPCWSTR /*deviceId*/, DWORD /*newState*/) override {
+        owner_->NotifyDevicesChanged();
+        return S_OK;
+    }
+    
+    HRESULT STDMETHODCALLTYPE OnPropertyValueChanged(LPCWSTR /*deviceId*/, const PROPERTYKEY /*key*/) override {
+        return S_OK;
+    }
+    
+private:
+    LONG refCount_;
+    WindowsAudioCapture* owner_;
+};
+
 WindowsAudioCapture::WindowsAudioCapture()
     : deviceEnumerator_(nullptr)
     , device_(nullptr)
     , audioClient_(nullptr)
     , captureClient_(nullptr)
-    , endpointVolume_(nullptr)
     , shouldStop_(false)
-    , deviceFormat_(nullptr) {
+    , bufferEvent_(nullptr)
+    , stopEvent_(nullptr)
+    , eventDriven_(false)
+    , bufferDurationMs_(CAPTURE_BUFFER_SIZE_MS)
+    , notificationClient_(nullptr)
+    , deviceChangeEvent_(nullptr)
+    , defaultDeviceChanged_(false)
+    , deviceFormat_(nullptr)
+    , requestedFormat_{} {
+    
+    // Auto-reset event signaled by WASAPI per device period; manual-reset stop event
+    bufferEvent_ = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    stopEvent_ = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    deviceChangeEvent_ = CreateEvent(nullptr, FALSE, FALSE, nullptr);
     
     InitializeCOM();
 }
@@ -45,6 +146,13 @@ bool WindowsAudioCapture::InitializeCOM() {
         return false;
     }
     
+    // Without notifications the capture simply stays on the current endpoint
+    notificationClient_ = new NotificationClient(this);
+    if (FAILED(deviceEnumerator_->RegisterEndpointNotificationCallback(notificationClient_))) {
+        notificationClient_->Release();
+        notificationClient_ = nullptr;
+    }
+    
     return InitializeDevice();
 }
 
@@ -63,19 +171,6 @@ bool WindowsAudioCapture::InitializeDevice() {
         return false;
     }
     
-    // Get endpoint volume interface
-    hr = device_->Activate(
-        __uuidof(IAudioEndpointVolume),
-        CLSCTX_ALL,
-        nullptr,
-        reinterpret_cast<void**>(&endpointVolume_)
-    );
-    
-    if (FAILED(hr)) {
-        lastError_ = "Failed to get endpoint volume interface: " + GetCOMErrorString(hr);
-        return false;
-    }
-    
     return InitializeAudioClient();
 }
 
@@ -102,23 +197,86 @@ bool WindowsAudioCapture::InitializeAudioClient() {
         return false;
     }
     
+    // With a format request the shared-mode engine resamples and downmixes
+    // the mix to float32 at the requested rate/channels (AUTOCONVERTPCM)
+    const WAVEFORMATEX* streamFormat = deviceFormat_;
+    DWORD convertFlags = 0;
+    if (formatRequest_.sampleRate || formatRequest_.channels) {
+        WORD channels = formatRequest_.channels ? formatRequest_.channels : deviceFormat_->nChannels;
+        DWORD sampleRate = formatRequest_.sampleRate ? formatRequest_.sampleRate : deviceFormat_->nSamplesPerSec;
+        
+        requestedFormat_ = {};
+        requestedFormat_.Format.wFormatTag = WAVE_FORMAT_EXTENSIBLE;
+        requestedFormat_.Format.nChannels = channels;
+        requestedFormat_.Format.nSamplesPerSec = sampleRate;
+        requestedFormat_.Format.wBitsPerSample = 32;
+        requestedFormat_.Format.nBlockAlign = static_cast<WORD>(channels * sizeof(float));
+        requestedFormat_.Format.nAvgBytesPerSec = sampleRate * requestedFormat_.Format.nBlockAlign;
+        requestedFormat_.Format.cbSize = sizeof(WAVEFORMATEXTENSIBLE) - sizeof(WAVEFORMATEX);
+        requestedFormat_.Samples.wValidBitsPerSample = 32;
+        requestedFormat_.dwChannelMask = channels == 1 ? SPEAKER_FRONT_CENTER : (SPEAKER_FRONT_LEFT | SPEAKER_FRONT_RIGHT);
+        requestedFormat_.SubFormat = KSDATAFORMAT_SUBTYPE_IEEE_FLOAT;
+        
+        streamFormat = &requestedFormat_.Format;
+        convertFlags = AUDCLNT_STREAMFLAGS_AUTOCONVERTPCM | AUDCLNT_STREAMFLAGS_SRC_DEFAULT_QUALITY;
+    }
+    
     // Initialize audio client in loopback mode
-    REFERENCE_TIME bufferDuration = CAPTURE_BUFFER_SIZE_MS * 10000; // Convert to 100ns units
-    
-    hr = audioClient_->Initialize(
-        AUDCLNT_SHAREMODE_SHARED,
-        AUDCLNT_STREAMFLAGS_LOOPBACK,  // Loopback capture
-        bufferDuration,
-        0,
-        deviceFormat_,
-        nullptr
-    );
+    REFERENCE_TIME bufferDuration = bufferDurationMs_ * 10000; // Convert to 100ns units
+    
+    hr = E_FAIL;
+    if (bufferEvent_) {
+        hr = audioClient_->Initialize(
+            AUDCLNT_SHAREMODE_SHARED,
+            AUDCLNT_STREAMFLAGS_LOOPBACK | AUDCLNT_STREAMFLAGS_EVENTCALLBACK | convertFlags,
+            bufferDuration,
+            0,
+            streamFormat,
+            nullptr
+        );
+    }
+    eventDriven_ = SUCCEEDED(hr);
+    
+    if (!eventDriven_) {
+        // A client cannot be initialized twice; activate a fresh one for polling
+        audioClient_->Release();
+        audioClient_ = nullptr;
+        
+        hr = device_->Activate(
+            __uuidof(IAudioClient),
+            CLSCTX_ALL,
+            nullptr,
+            reinterpret_cast<void**>(&audioClient_)
+        );
+        
+        if (FAILED(hr)) {
+            lastError_ = "Failed to activate audio client: " + GetCOMErrorString(hr);
+            return false;
+        }
+        
+        hr = audioClient_->Initialize(
+            AUDCLNT_SHAREMODE_SHARED,
+            AUDCLNT_STREAMFLAGS_LOOPBACK | convertFlags,  // Loopback capture
+            bufferDuration,
+            0,
+            streamFormat,
+            nullptr
+        );
+    }
     
     if (FAILED(hr)) {
         lastError_ = "Failed to initialize audio client: " + GetCOMErrorString(hr);
         return false;
     }
     
+    if (eventDriven_) {
+        hr = audioClient_->SetEventHandle(bufferEvent_);
+        if (FAILED(hr)) {
+            lastError_ = "Failed to set audio event handle: " + GetCOMErrorString(hr);
+            return false;
+        }
+    }
+    
     // Get capture client
     hr = audioClient_->GetService(
         __uuidof(IAudioCaptureClient),
@@ -130,15 +288,42 @@ bool WindowsAudioCapture::InitializeAudioClient() {
         return false;
     }
     
-    // Store current format
-    currentFormat_ = WaveFormatToAudioFormat(deviceFormat_);
+    // Store current format (and the conversion kernels for it)
+    currentFormat_ = WaveFormatToAudioFormat(streamFormat);
     
     return true;
 }
 
+bool WindowsAudioCapture::ReopenDefaultDevice() {
+    if (audioClient_) {
+        audioClient_->Stop();
+    }
+    ReleaseAudioClient();
+    
+    if (device_) {
+        device_->Release();
+        device_ = nullptr;
+    }
+    
+    // Same buffer duration and format request, on the new endpoint
+    return InitializeDevice();
+}
+
+void WindowsAudioCapture::OnDefaultDeviceChanged() {
+    defaultDeviceChanged_ = true;
+    if (deviceChangeEvent_) {
+        SetEvent(deviceChangeEvent_);
+    }
+}
+
 bool WindowsAudioCapture::Start() {
     if (isCapturing_) return true;
     
+    // The default endpoint changed while stopped
+    if (defaultDeviceChanged_.exchange(false)) {
+        ReopenDefaultDevice();
+    }
+    
     if (!audioClient_ || !captureClient_) {
         lastError_ = "Audio client not initialized";
         return false;
@@ -153,6 +338,9 @@ bool WindowsAudioCapture::Start() {
     
     // Start capture thread
     shouldStop_ = false;
+    if (stopEvent_) {
+        ResetEvent(stopEvent_);
+    }
     captureThread_ = std::thread(&WindowsAudioCapture::CaptureThreadFunction, this);
     
     isCapturing_ = true;
@@ -164,6 +352,9 @@ bool WindowsAudioCapture::Stop() {
     
     // Signal thread to stop
     shouldStop_ = true;
+    if (stopEvent_) {
+        SetEvent(stopEvent_);
+    }
     
     // Wait for thread to finish
     if (captureThread_.joinable()) {
@@ -180,91 +371,149 @@ bool WindowsAudioCapture::Stop() {
 }
 
 void WindowsAudioCapture::CaptureThreadFunction() {
+    // Register with MMCSS so the scheduler keeps capture on time under load
+    DWORD taskIndex = 0;
+    HANDLE mmcssHandle = AvSetMmThreadCharacteristicsW(L"Audio", &taskIndex);
+    
+    // Switching endpoints activates COM objects on this thread
+    HRESULT comResult = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    
+    HANDLE waitHandles[3] = { stopEvent_, bufferEvent_, deviceChangeEvent_ };
+    const DWORD waitCount = deviceChangeEvent_ ? 3 : 2;
+    HANDLE idleHandles[2] = { stopEvent_, deviceChangeEvent_ };
+    bool streaming = true;  // False while no endpoint is usable
+    
     while (!shouldStop_) {
-        UINT32 packetLength = 0;
-        HRESULT hr = captureClient_->GetNextPacketSize(&packetLength);
-        
-        if (FAILED(hr)) {
-            lastError_ = "Failed to get packet size: " + GetCOMErrorString(hr);
-            break;
+        // Follow a new default endpoint in place: downstream buffers and VAD
+        // state carry on, and the format travels with each packet
+        if (defaultDeviceChanged_.exchange(false)) {
+            streaming = ReopenDefaultDevice();
+            if (streaming) {
+                HRESULT hr = audioClient_->Start();
+                if (FAILED(hr)) {
+                    lastError_ = "Failed to start audio client: " + GetCOMErrorString(hr);
+                    streaming = false;
+                }
+            }
         }
         
-        while (packetLength != 0) {
-            BYTE* data;
-            UINT32 framesAvailable;
-            DWORD flags;
-            
-            hr = captureClient_->GetBuffer(
-                &data,
-                &framesAvailable,
-                &flags,
-                nullptr,
-                nullptr
-            );
-            
-            if (FAILED(hr)) {
-                lastError_ = "Failed to get buffer: " + GetCOMErrorString(hr);
+        if (!streaming) {
+            // Wait for the next default endpoint, or for Stop()
+            if (!stopEvent_ || !deviceChangeEvent_ ||
+                WaitForMultipleObjects(2, idleHandles, FALSE, INFINITE) != WAIT_OBJECT_0 + 1) {
                 break;
             }
-            
-            // Calculate volume level
-            UpdateVolumeLevel();
-            
-            // Create audio sample
-            if (audioCallback_ && framesAvailable > 0) {
-                AudioSample sample;
-                sample.format = currentFormat_;
-                sample.frameCount = framesAvailable;
-                sample.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-                    std::chrono::steady_clock::now().time_since_epoch()
-                ).count();
-                
-                // Copy audio data
-                size_t dataSize = framesAvailable * currentFormat_.bytesPerFrame;
-                sample.data.resize(dataSize);
-                
-                if (!(flags & AUDCLNT_BUFFERFLAGS_SILENT)) {
-                    std::memcpy(sample.data.data(), data, dataSize);
-                } else {
-                    // Silent buffer, fill with zeros
-                    std::fill(sample.data.begin(), sample.data.end(), 0);
-                }
-                
-                // Call the callback
-                {
-                    std::lock_guard<std::mutex> lock(callbackMutex_);
-                    if (audioCallback_) {
-                        audioCallback_(sample);
-                    }
-                }
-            }
-            
-            hr = captureClient_->ReleaseBuffer(framesAvailable);
-            if (FAILED(hr)) {
-                lastError_ = "Failed to release buffer: " + GetCOMErrorString(hr);
+            continue;
+        }
+        
+        if (eventDriven_) {
+            // Loopback only signals while something is playing; the timeout
+            // bounds idle wakeups and covers systems that never signal
+            DWORD waitResult = WaitForMultipleObjects(waitCount, waitHandles, FALSE, bufferDurationMs_);
+            if (waitResult == WAIT_OBJECT_0 || waitResult == WAIT_FAILED) {
                 break;
             }
-            
-            hr = captureClient_->GetNextPacketSize(&packetLength);
-            if (FAILED(hr)) {
-                lastError_ = "Failed to get next packet size: " + GetCOMErrorString(hr);
+            if (waitResult == WAIT_OBJECT_0 + 2) {
+                continue;
+            }
+        } else if (stopEvent_) {
+            if (WaitForSingleObject(stopEvent_, POLL_INTERVAL_MS) == WAIT_OBJECT_0) {
                 break;
             }
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL_MS));
         }
         
-        // Short sleep to prevent excessive CPU usage
-        std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL_MS));
+        // Usually the endpoint was invalidated (unplugged) and a default
+        // device change is on its way
+        if (!DrainCaptureBuffer()) {
+            streaming = false;
+        }
+    }
+    
+    // A failed wait ends capture; Stop() still joins this thread
+    if (!shouldStop_) {
+        NotifyCaptureStopped();
+    }
+    
+    if (mmcssHandle) {
+        AvRevertMmThreadCharacteristics(mmcssHandle);
+    }
+    
+    if (SUCCEEDED(comResult)) {
+        CoUninitialize();
     }
 }
 
-void WindowsAudioCapture::UpdateVolumeLevel() {
-    if (!endpointVolume_) return;
+bool WindowsAudioCapture::DrainCaptureBuffer() {
+    UINT32 packetLength = 0;
+    HRESULT hr = captureClient_->GetNextPacketSize(&packetLength);
     
-    float peak = 0.0f;
-    HRESULT hr = endpointVolume_->GetMasterScalarVolume(&peak);
-    if (SUCCEEDED(hr)) {
-        currentVolumeLevel_ = peak;
+    if (FAILED(hr)) {
+        lastError_ = "Failed to get packet size: " + GetCOMErrorString(hr);
+        return false;
     }
+    
+    while (packetLength != 0) {
+        BYTE* data;
+        UINT32 framesAvailable;
+        DWORD flags;
+        UINT64 devicePosition = 0;
+        UINT64 qpcPosition = 0;  // When the first frame was captured, 100ns QPC units
+        
+        hr = captureClient_->GetBuffer(
+            &data,
+            &framesAvailable,
+            &flags,
+            &devicePosition,
+            &qpcPosition
+        );
+        
+        if (FAILED(hr)) {
+            lastError_ = "Failed to get buffer: " + GetCOMErrorString(hr);
+            return false;
+        }
+        
+        // Hand the WASAPI buffer straight to the callback (valid until ReleaseBuffer)
+        if (framesAvailable > 0) {
+            std::lock_guard<std::mutex> lock(callbackMutex_);
+            if (HasAudioCallback()) {
+                size_t dataSize = framesAvailable * currentFormat_.bytesPerFrame;
+                
+                AudioSampleView view;
+                view.data = data;
+                view.size = dataSize;
+                view.format = currentFormat_;
+                view.frameCount = framesAvailable;
+                view.timestamp = MonotonicMicros();
+                if (!(flags & AUDCLNT_BUFFERFLAGS_TIMESTAMP_ERROR)) {
+                    view.captureTimestamp = QpcPositionToMonotonicMicros(qpcPosition);
+                }
+                
+                if (flags & AUDCLNT_BUFFERFLAGS_SILENT) {
+                    // Silent buffer: contents are undefined, deliver only the duration
+                    view.data = nullptr;
+                    view.silent = true;
+                }
+                
+                DispatchAudio(view);
+            }
+        }
+        
+        hr = captureClient_->ReleaseBuffer(framesAvailable);
+        if (FAILED(hr)) {
+            lastError_ = "Failed to release buffer: " + GetCOMErrorString(hr);
+            return false;
+        }
+        
+        hr = captureClient_->GetNextPacketSize(&packetLength);
+        if (FAILED(hr)) {
+            lastError_ = "Failed to get next packet size: " + GetCOMErrorString(hr);
+            return false;
+        }
+    }
+    
+    return true;
 }
 
 bool WindowsAudioCapture::IsCapturing() const {
@@ -276,6 +525,11 @@ void WindowsAudioCapture::SetAudioCallback(AudioCallback callback) {
     audioCallback_ = callback;
 }
 
+void WindowsAudioCapture::SetAudioViewCallback(AudioViewCallback callback) {
+    std::lock_guard<std::mutex> lock(callbackMutex_);
+    audioViewCallback_ = callback;
+}
+
 AudioFormat WindowsAudioCapture::GetFormat() const {
     return currentFormat_;
 }
@@ -331,10 +585,6 @@ bool WindowsAudioCapture::SetDevice(const std::string& deviceId) {
     return true;
 }
 
-float WindowsAudioCapture::GetVolumeLevel() const {
-    return currentVolumeLevel_;
-}
-
 std::string WindowsAudioCapture::GetLastError() const {
     return lastError_;
 }
@@ -346,30 +596,71 @@ AudioFormat WindowsAudioCapture::WaveFormatToAudioFormat(const WAVEFORMATEX* wf)
     format.bitsPerSample = wf->wBitsPerSample;
     format.bytesPerFrame = wf->nBlockAlign;
     format.blockAlign = wf->nBlockAlign;
+    
+    // The shared-mode mix format is usually extensible float
+    if (wf->wFormatTag == WAVE_FORMAT_IEEE_FLOAT) {
+        format.isFloat = true;
+    } else if (wf->wFormatTag == WAVE_FORMAT_EXTENSIBLE && wf->cbSize >= 22) {
+        const WAVEFORMATEXTENSIBLE* extensible = reinterpret_cast<const WAVEFORMATEXTENSIBLE*>(wf);
+        format.isFloat = IsEqualGUID(extensible->SubFormat, KSDATAFORMAT_SUBTYPE_IEEE_FLOAT) != FALSE;
+    }
+    
+    FormatKernels::Resolve(format);
     return format;
 }
 
-void WindowsAudioCapture::SetNoiseGateThreshold(float threshold) {
-    // Windows WASAPI doesn't have a built-in noise gate like macOS ScreenCaptureKit
-    // This is a no-op for Windows - noise gating will be handled in JavaScript VAD
-    // Log the threshold for debugging purposes
-    lastError_ = "";  // Clear any previous errors
+bool WindowsAudioCapture::SetBufferDuration(uint32_t milliseconds) {
+    if (milliseconds < MIN_BUFFER_SIZE_MS || milliseconds > MAX_BUFFER_SIZE_MS) {
+        lastError_ = "Buffer duration must be between 10 and 2000 ms";
+        return false;
+    }
+    
+    if (isCapturing_) {
+        lastError_ = "Stop capture before changing the buffer duration";
+        return false;
+    }
+    
+    if (milliseconds == bufferDurationMs_ && audioClient_) {
+        return true;
+    }
+    
+    bufferDurationMs_ = milliseconds;
+    
+    // The buffer size is fixed by IAudioClient::Initialize, so rebuild the client
+    ReleaseAudioClient();
+    return InitializeAudioClient();
 }
 
-std::string WindowsAudioCapture::GetCOMErrorString(HRESULT hr) {
-    std::stringstream ss;
-    ss << "HRESULT 0x" << std::hex << std::uppercase << hr;
+bool WindowsAudioCapture::SetCaptureFormat(const CaptureFormatRequest& request) {
+    if ((request.sampleRate && (request.sampleRate < MIN_SAMPLE_RATE || request.sampleRate > MAX_SAMPLE_RATE)) ||
+        request.channels > MAX_CHANNELS) {
+        lastError_ = "Capture format must be 8000-192000 Hz with 1 or 2 channels";
+        return false;
+    }
     
-    _com_error err(hr);
-    LPCTSTR errMsg = err.ErrorMessage();
-    if (errMsg) {
-        ss << " (" << errMsg << ")";
+    if (isCapturing_) {
+        lastError_ = "Stop capture before changing the capture format";
+        return false;
     }
     
-    return ss.str();
+    // The stream format is fixed by IAudioClient::Initialize, so rebuild the client
+    CaptureFormatRequest previous = formatRequest_;
+    formatRequest_ = request;
+    ReleaseAudioClient();
+    if (InitializeAudioClient()) {
+        return true;
+    }
+    
+    // The engine refused the conversion; keep the previous format usable
+    std::string error = lastError_;
+    formatRequest_ = previous;
+    ReleaseAudioClient();
+    InitializeAudioClient();
+    lastError_ = error;
+    return false;
 }
 
-void WindowsAudioCapture::CleanupCOM() {
+void WindowsAudioCapture::ReleaseAudioClient() {
     if (captureClient_) {
         captureClient_->Release();
         captureClient_ = nullptr;
@@ -380,15 +671,27 @@ void WindowsAudioCapture::CleanupCOM() {
         audioClient_ = nullptr;
     }
     
-    if (endpointVolume_) {
-        endpointVolume_->Release();
-        endpointVolume_ = nullptr;
-    }
-    
     if (deviceFormat_) {
         CoTaskMemFree(deviceFormat_);
         deviceFormat_ = nullptr;
     }
+}
+
+std::string WindowsAudioCapture::GetCOMErrorString(HRESULT hr) {
+    std::stringstream ss;
+    ss << "HRESULT 0x" << std::hex << std::uppercase << hr;
+    
+    _com_error err(hr);
+    LPCTSTR errMsg = err.ErrorMessage();
+    if (errMsg) {
+        ss << " (" << errMsg << ")";
+    }
+    
+    return ss.str();
+}
+
+void WindowsAudioCapture::CleanupCOM() {
+    ReleaseAudioClient();
     
     if (device_) {
         device_->Release();
@@ -396,10 +699,30 @@ void WindowsAudioCapture::CleanupCOM() {
     }
     
     if (deviceEnumerator_) {
+        if (notificationClient_) {
+            deviceEnumerator_->UnregisterEndpointNotificationCallback(notificationClient_);
+            notificationClient_->Release();
+            notificationClient_ = nullptr;
+        }
         deviceEnumerator_->Release();
         deviceEnumerator_ = nullptr;
     }
     
+    if (bufferEvent_) {
+        CloseHandle(bufferEvent_);
+        bufferEvent_ = nullptr;
+    }
+    
+    if (stopEvent_) {
+        CloseHandle(stopEvent_);
+        stopEvent_ = nullptr;
+    }
+    
+    if (deviceChangeEvent_) {
+        CloseHandle(deviceChangeEvent_);
+        deviceChangeEvent_ = nullptr;
+    }
+    
     CoUninitialize();
 }
 
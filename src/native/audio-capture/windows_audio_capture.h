@@ -7,7 +7,7 @@
 #include <mmdeviceapi.h>
 #include <audioclient.h>
 #include <audiopolicy.h>
-#include <endpointvolume.h>
+#include <avrt.h>
 #include <thread>
 #include <atomic>
 #include <mutex>
@@ -24,42 +24,67 @@ public:
     bool Stop() override;
     bool IsCapturing() const override;
     void SetAudioCallback(AudioCallback callback) override;
+    void SetAudioViewCallback(AudioViewCallback callback) override;
     AudioFormat GetFormat() const override;
     std::vector<std::string> GetAvailableDevices() override;
     bool SetDevice(const std::string& deviceId) override;
-    float GetVolumeLevel() const override;
     std::string GetLastError() const override;
-    void SetNoiseGateThreshold(float threshold) override;
+    bool SetBufferDuration(uint32_t milliseconds) override;
+    bool SetCaptureFormat(const CaptureFormatRequest& request) override;
 
 private:
+    class NotificationClient;
+    
     // COM interfaces
     IMMDeviceEnumerator* deviceEnumerator_;
     IMMDevice* device_;
     IAudioClient* audioClient_;
     IAudioCaptureClient* captureClient_;
-    IAudioEndpointVolume* endpointVolume_;
     
     // Capture thread
     std::thread captureThread_;
     std::atomic<bool> shouldStop_;
     std::mutex callbackMutex_;
     
+    // Event-driven delivery (AUDCLNT_STREAMFLAGS_EVENTCALLBACK); falls back to
+    // polling when the audio client rejects event mode for loopback
+    HANDLE bufferEvent_;
+    HANDLE stopEvent_;
+    bool eventDriven_;
+    DWORD bufferDurationMs_;
+    
+    // Endpoint notifications: a new default render device is picked up by the
+    // capture thread (or the next Start()) without stopping the stream
+    NotificationClient* notificationClient_;
+    HANDLE deviceChangeEvent_;
+    std::atomic<bool> defaultDeviceChanged_;
+    
     // Audio format
     WAVEFORMATEX* deviceFormat_;
+    CaptureFormatRequest formatRequest_;     // Converted by the audio engine when set
+    WAVEFORMATEXTENSIBLE requestedFormat_;   // Float32 stream format built from formatRequest_
     
     // Helper methods
     bool InitializeCOM();
     bool InitializeDevice();
     bool InitializeAudioClient();
+    bool ReopenDefaultDevice();
+    void OnDefaultDeviceChanged();
     void CaptureThreadFunction();
+    bool DrainCaptureBuffer();
+    void ReleaseAudioClient();
     void CleanupCOM();
     AudioFormat WaveFormatToAudioFormat(const WAVEFORMATEX* wf);
     std::string GetCOMErrorString(HRESULT hr);
-    void UpdateVolumeLevel();
     
     // Constants
     static constexpr DWORD CAPTURE_BUFFER_SIZE_MS = 100;
+    static constexpr DWORD MIN_BUFFER_SIZE_MS = 10;
+    static constexpr DWORD MAX_BUFFER_SIZE_MS = 2000;
     static constexpr DWORD POLL_INTERVAL_MS = 10;
+    static constexpr uint32_t MIN_SAMPLE_RATE = 8000;
+    static constexpr uint32_t MAX_SAMPLE_RATE = 192000;
+    static constexpr uint16_t MAX_CHANNELS = 2;
 };
 
 } // namespace AudioCapture
@@ -2,14 +2,255 @@
 #include "audio-capture/audio_capture_base.h"
 #include "audio-capture/audio_format_converter.h"
 #include "audio-capture/audio_buffer.h"
+#include "audio-capture/audio_block_pool.h"
+#include "audio-capture/audio_metrics.h"
+#include "audio-capture/capture_engine.h"
+#include "audio-capture/delivery_batch_controller.h"
+#include "audio-capture/file_replay_audio_capture.h"
+#include "audio-capture/level_meter.h"
+#include "audio-capture/audio_scratch_arena.h"
+#include "audio-capture/audio_simd_kernels.h"
+#include "audio-capture/pre_roll_buffer.h"
+#include "audio-capture/processing_worker.h"
+#include "audio-capture/recording_sink.h"
+#include "audio-capture/spectral_features.h"
+#include "audio-capture/streaming_opus_encoder.h"
+#include "audio-capture/streaming_resampler.h"
+#include "audio-capture/streaming_vad.h"
+#include "webrtc-vad/vad_engine.h"
 #include "webrtc-vad/vad_wrapper.h"
+#include <functional>
 #include <memory>
 #include <thread>
 #include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <cstring>
+#include <new>
 
 using namespace AudioCapture;
 
-class AudioCaptureWrapper : public Napi::ObjectWrap<AudioCaptureWrapper> {
+// Default rate of the mono float32 stream produced from every capture packet;
+// start({ sampleRate }) lowers it to any divisor down to kMinCaptureSampleRate
+static constexpr uint32_t kCaptureSampleRate = CaptureEngine::DEFAULT_SAMPLE_RATE;
+static constexpr uint32_t kMinCaptureSampleRate = 8000;
+
+// Float32 ring capacity: 10 seconds of 48kHz mono
+static constexpr size_t kFloat32RingSamples = 48000 * 10;
+
+// Upper bound for setBufferLimits({ maxDurationMs })
+static constexpr uint32_t kMaxBufferDurationMs = 600000;
+
+// Zero-copy delivery: blocks sized to each poll's payload, up to the pool's
+// largest class (340 ms of 48kHz mono); a few of each class kept warm
+static constexpr size_t kPooledMaxSamples = AudioBlockPool::MAX_CLASS_BYTES / sizeof(float);
+static constexpr size_t kPooledInitialBlocks = 2;
+
+// Push-mode defaults: 20ms batches, at most 8 batches queued before dropping the oldest
+static constexpr uint32_t kDefaultPushBatchMs = 20;
+static constexpr uint32_t kDefaultPushMaxQueuedBatches = 8;
+
+// Adaptive push batching: batch duration bounds while the event loop's lag is followed
+static constexpr uint32_t kDefaultPushMinBatchMs = 10;
+static constexpr uint32_t kDefaultPushMaxBatchMs = 200;
+
+// Speech-gated push: audio kept from before the VAD's onset decision, which
+// itself lags the real onset by the VAD holdMs
+static constexpr uint32_t kDefaultPreRollMs = 500;
+static constexpr uint32_t kMaxPreRollMs = 5000;
+static constexpr size_t kPushSegmentEndsCapacity = 64;
+
+// Raw per-packet callback queue bound; packets beyond it are dropped, not waited on
+static constexpr size_t kRawCallbackQueueSize = 32;
+
+// Streaming VAD decisions kept for pull consumers: 10 seconds of 10ms frames
+static constexpr size_t kVADFlagsCapacity = 1024;
+
+// Spectral feature frames kept for pull consumers: 10 seconds of 10ms frames
+static constexpr size_t kFeatureFramesCapacity = 1024;
+
+// Opus stage defaults: 24kbit/s 20ms voice frames at the stream rate, one second queued
+static constexpr uint32_t kDefaultOpusMaxQueuedPackets = 50;
+
+// Raw callback packet as queued for JS: this header, then size bytes, in one
+// pooled block
+struct RawPacket {
+    AudioFormat format;
+    uint64_t timestamp;
+    uint32_t frameCount;
+    bool silent;
+    size_t size;                         // 0 for silence
+    
+    uint8_t* Bytes() { return reinterpret_cast<uint8_t*>(this + 1); }
+    const uint8_t* Bytes() const { return reinterpret_cast<const uint8_t*>(this + 1); }
+};
+
+// One capture packet after conversion and the analysis stages, shared by the
+// buffering and push stages so no conversion or decimation runs twice
+struct ProcessedPacket {
+    uint64_t timestamp = 0;              // MonotonicMicros of the capture packet
+    const float* samples = nullptr;      // Mono at the stream rate
+    size_t frames = 0;
+    const float* decimated = nullptr;    // VAD-rate stream when the VAD runs below the stream rate
+    size_t decimatedFrames = 0;
+    uint32_t decimatedRate = 0;
+    const uint8_t* vadFlags = nullptr;
+    size_t vadFrames = 0;
+    const SpectralFrame* features = nullptr;
+    size_t featureFrames = 0;
+    bool silent = false;                 // Digital silence: samples are zeros, never converted
+};
+
+// How audio is handed to JS: float32 samples, little-endian PCM16 bytes, or
+// PCM16 as base64 text ready for provider payloads
+enum class SampleEncoding {
+    Float32,
+    Pcm16,
+    Base64
+};
+
+// A silent packet's output is zeros once the consumer's filter has rung out
+static bool IsSilentOutput(const ProcessedPacket& packet, const float* data, size_t count) {
+    return packet.silent && SimdKernels::IsZero(reinterpret_cast<const uint8_t*>(data), count * sizeof(float));
+}
+
+// Runtimes with a V8 memory cage (Electron >= 21) refuse external buffers;
+// asked once with a tiny static block rather than found out on the first poll
+static bool ProbeExternalBuffers(napi_env env) {
+    static float probe[1];
+    napi_value arrayBuffer;
+    return napi_create_external_arraybuffer(env, probe, sizeof(probe), nullptr, nullptr, &arrayBuffer) == napi_ok;
+}
+
+// VAD audio: Float32Array and Int16Array by element type, other byte views
+// (Buffer, Uint8Array, DataView) as PCM16 bytes. Typed arrays go first since
+// napi_is_buffer is true for every ArrayBufferView.
+static bool GetVADAudio(const Napi::Value& value, const int16_t*& pcm16, const float*& float32, size_t& length) {
+    if (value.IsTypedArray()) {
+        Napi::TypedArray array = value.As<Napi::TypedArray>();
+        switch (array.TypedArrayType()) {
+            case napi_float32_array:
+                float32 = array.As<Napi::Float32Array>().Data();
+                length = array.ElementLength();
+                return true;
+            case napi_int16_array:
+                pcm16 = array.As<Napi::Int16Array>().Data();
+                length = array.ElementLength();
+                return true;
+            case napi_uint8_array:
+                pcm16 = reinterpret_cast<const int16_t*>(array.As<Napi::Uint8Array>().Data());
+                length = array.ByteLength() / sizeof(int16_t);
+                return true;
+            default:
+                return false;
+        }
+    }
+    
+    if (value.IsBuffer()) {
+        Napi::Buffer<uint8_t> buffer = value.As<Napi::Buffer<uint8_t>>();
+        pcm16 = reinterpret_cast<const int16_t*>(buffer.Data());
+        length = buffer.Length() / sizeof(int16_t);
+        return true;
+    }
+    return false;
+}
+
+static bool ParseWorkerPriority(const std::string& name, WorkerPriority& priority) {
+    if (name == "normal") {
+        priority = WorkerPriority::Normal;
+    } else if (name == "high") {
+        priority = WorkerPriority::High;
+    } else if (name == "realtime") {
+        priority = WorkerPriority::Realtime;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static const char* WorkerPriorityName(WorkerPriority priority) {
+    switch (priority) {
+        case WorkerPriority::Normal:   return "normal";
+        case WorkerPriority::High:     return "high";
+        case WorkerPriority::Realtime: return "realtime";
+        default:                       return "unknown";
+    }
+}
+
+static bool ParseSampleEncoding(const std::string& name, SampleEncoding& encoding) {
+    if (name == "float32") {
+        encoding = SampleEncoding::Float32;
+    } else if (name == "pcm16") {
+        encoding = SampleEncoding::Pcm16;
+    } else if (name == "base64") {
+        encoding = SampleEncoding::Base64;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Runs a blocking engine call on the libuv thread pool and settles a Promise
+// on the JS thread, so device enumeration, COM activation and backend start-up
+// (ScreenCaptureKit waits up to 10s on permissions) never stall the caller.
+// Holds the calling object so the instance outlives the call.
+class EngineTask : public Napi::AsyncWorker {
+public:
+    using Task = std::function<void(std::string& error)>;  // Pool thread; an error rejects
+    using Result = std::function<Napi::Value(Napi::Env env)>;
+    
+    static Napi::Promise Run(Napi::Env env, const Napi::Object& owner, Task task, Result result) {
+        auto* worker = new EngineTask(env, owner, std::move(task), std::move(result));
+        Napi::Promise promise = worker->deferred_.Promise();
+        worker->Queue();
+        return promise;
+    }
+    
+protected:
+    void Execute() override {
+        std::string error;
+        task_(error);
+        if (!error.empty()) {
+            SetError(error);
+        }
+    }
+    
+    void OnOK() override {
+        deferred_.Resolve(result_(Env()));
+    }
+    
+    void OnError(const Napi::Error& error) override {
+        deferred_.Reject(error.Value());
+    }
+    
+private:
+    EngineTask(Napi::Env env, const Napi::Object& owner, Task task, Result result)
+        : Napi::AsyncWorker(env)
+        , deferred_(Napi::Promise::Deferred::New(env))
+        , owner_(Napi::Persistent(owner))
+        , task_(std::move(task))
+        , result_(std::move(result)) {
+    }
+    
+    Napi::Promise::Deferred deferred_;
+    Napi::ObjectReference owner_;
+    Task task_;
+    Result result_;
+};
+
+// VAD decision tagged with the push stream position it was produced at
+struct PushVADRecord {
+    uint64_t endSample;  // pushRing_ write position after the frame's audio
+    uint8_t flags;
+};
+
+// Spectral features tagged the same way
+struct PushFeatureRecord {
+    uint64_t endSample;
+    SpectralFrame features;
+};
+
+class AudioCaptureWrapper : public Napi::ObjectWrap<AudioCaptureWrapper>, public CaptureEngineConsumer {
 public:
     static Napi::Object Init(Napi::Env env, Napi::Object exports);
     AudioCaptureWrapper(const Napi::CallbackInfo& info);
@@ -23,30 +264,201 @@ private:
     Napi::Value GetFormat(const Napi::CallbackInfo& info);
     Napi::Value GetAvailableDevices(const Napi::CallbackInfo& info);
     Napi::Value SetDevice(const Napi::CallbackInfo& info);
+    Napi::Value StartAsync(const Napi::CallbackInfo& info);
+    Napi::Value GetAvailableDevicesAsync(const Napi::CallbackInfo& info);
+    Napi::Value SetDeviceAsync(const Napi::CallbackInfo& info);
     Napi::Value GetVolumeLevel(const Napi::CallbackInfo& info);
+    Napi::Value GetLevel(const Napi::CallbackInfo& info);
     Napi::Value GetLastError(const Napi::CallbackInfo& info);
     Napi::Value SetNoiseGateThreshold(const Napi::CallbackInfo& info);
+    Napi::Value SetBufferDuration(const Napi::CallbackInfo& info);
+    Napi::Value SetProcessingWorker(const Napi::CallbackInfo& info);
     Napi::Value SetAudioCallback(const Napi::CallbackInfo& info);
+    Napi::Value SetFloat32Callback(const Napi::CallbackInfo& info);
+    Napi::Value ClearFloat32Callback(const Napi::CallbackInfo& info);
+    Napi::Value EncodePcm16(const Napi::CallbackInfo& info);
+    Napi::Value SetOpusCallback(const Napi::CallbackInfo& info);
+    Napi::Value ClearOpusCallback(const Napi::CallbackInfo& info);
+    Napi::Value IsOpusAvailable(const Napi::CallbackInfo& info);
+    Napi::Value StartRecording(const Napi::CallbackInfo& info);
+    Napi::Value StopRecording(const Napi::CallbackInfo& info);
+    Napi::Value GetRecordingStats(const Napi::CallbackInfo& info);
     Napi::Value GetBufferedAudio(const Napi::CallbackInfo& info);
     Napi::Value GetBufferedFloat32Audio(const Napi::CallbackInfo& info);
+    Napi::Value ReadFloat32Audio(const Napi::CallbackInfo& info);
+    Napi::Value SetZeroCopyDelivery(const Napi::CallbackInfo& info);
+    Napi::Value SetOutputSampleRate(const Napi::CallbackInfo& info);
     Napi::Value ClearBuffer(const Napi::CallbackInfo& info);
+    Napi::Value SkipBufferedSilence(const Napi::CallbackInfo& info);
+    Napi::Value SetBufferLimits(const Napi::CallbackInfo& info);
+    Napi::Value GetBufferLevel(const Napi::CallbackInfo& info);
+    Napi::Value GetStats(const Napi::CallbackInfo& info);
+    Napi::Value ResetStats(const Napi::CallbackInfo& info);
     
     // WebRTC VAD methods
     Napi::Value CreateVAD(const Napi::CallbackInfo& info);
     Napi::Value ProcessVAD(const Napi::CallbackInfo& info);
+    Napi::Value ProcessVADBatch(const Napi::CallbackInfo& info);
     Napi::Value SetVADMode(const Napi::CallbackInfo& info);
     Napi::Value ResetVAD(const Napi::CallbackInfo& info);
     
+    // Multi-stream VAD engine methods
+    Napi::Value CreateVADEngine(const Napi::CallbackInfo& info);
+    Napi::Value OpenVADStream(const Napi::CallbackInfo& info);
+    Napi::Value CloseVADStream(const Napi::CallbackInfo& info);
+    Napi::Value ResetVADStream(const Napi::CallbackInfo& info);
+    Napi::Value ProcessVADFrames(const Napi::CallbackInfo& info);
+    
+    // Streaming VAD stage methods
+    Napi::Value EnableStreamingVAD(const Napi::CallbackInfo& info);
+    Napi::Value DisableStreamingVAD(const Napi::CallbackInfo& info);
+    Napi::Value GetVADDecisions(const Napi::CallbackInfo& info);
+    Napi::Value EnableSpectralFeatures(const Napi::CallbackInfo& info);
+    Napi::Value DisableSpectralFeatures(const Napi::CallbackInfo& info);
+    Napi::Value GetSpectralFeatures(const Napi::CallbackInfo& info);
+    
     // Internal members
-    std::unique_ptr<AudioCaptureBase> audioCapture_;
+    // Process-wide engine: backend, processing worker, conversion to the mono
+    // stream and the noise gate are shared with every other AudioCapture
+    // instance; the stages below are this instance's own
+    std::shared_ptr<CaptureEngine> engine_;
+    std::atomic<uint32_t> streamRate_;  // Engine stream rate; changed only while stopped
     std::unique_ptr<AudioBuffer> audioBuffer_;
+    ScratchArena scratch_;  // capture thread only
+    
+    // Pull consumers (getBufferedFloat32Audio/readFloat32Audio) get audio at
+    // bufferSampleRate_; JS requests a rate, the capture thread reconfigures.
+    // At the stream rate the buffer reads the engine's stream through its own
+    // cursor instead of keeping a copy.
+    StreamingResampler bufferResampler_;  // capture thread only
+    bool bufferUsedShared_;               // capture thread only
+    std::atomic<uint32_t> bufferSampleRate_;
+    AudioBlockPool* float32Pool_;
+    bool zeroCopyDelivery_;
+    bool externalBuffersSupported_;
     std::unique_ptr<WebRTCVAD::VADWrapper> vad_;
-    Napi::ThreadSafeFunction jsCallback_;
+    std::unique_ptr<WebRTCVAD::VADEngine> vadEngine_;
+    std::vector<WebRTCVAD::VADFrame> vadEngineFrames_;  // JS thread scratch
+    // Raw per-packet callback: each packet travels as one pooled block, and the
+    // typed function queues it without a per-call closure
+    static void CallRawCallback(Napi::Env env, Napi::Function jsCallback, AudioCaptureWrapper* wrapper, void* block);
+    Napi::TypedThreadSafeFunction<AudioCaptureWrapper, void, &AudioCaptureWrapper::CallRawCallback> jsCallback_;
+    AudioBlockPool* rawPacketPool_;
     std::atomic<bool> hasJSCallback_;
+    AudioMetrics metrics_;  // This instance's stages; capture-side metrics live in the engine
+    
+    // Streaming VAD stage: runs on the capture thread as audio arrives
+    std::mutex vadStageMutex_;  // held by JS thread only while reconfiguring
+    StreamingVAD vadStage_;
+    StreamingResampler vadDecimator_;  // Stream rate -> VAD rate; output shared with other stages
+    std::atomic<bool> hasVADStage_;
+    SpscRingBuffer<uint8_t> vadFlags_;  // decisions for getVADDecisions()
+    std::vector<uint8_t> pullVADFlags_;  // JS thread scratch
+    bool pullVADSpeaking_;               // JS thread
+    
+    // Spectral feature stage: capture thread, after the VAD so its decimated
+    // stream can be reused
+    std::mutex featureStageMutex_;  // held by JS thread only while reconfiguring
+    StreamingSpectralAnalyzer featureStage_;
+    StreamingResampler featureResampler_;  // Stream rate -> feature rate; guarded by featureStageMutex_
+    bool featureUsedShared_;               // guarded by featureStageMutex_
+    std::atomic<bool> hasFeatureStage_;
+    SpscRingBuffer<SpectralFrame> featureFrames_;    // frames for getSpectralFeatures()
+    std::vector<SpectralFrame> pullFeatureFrames_;  // JS thread scratch
+    
+    // Push-mode float32 delivery: capture thread fills pushRing_, JS drains it in batches
+    std::mutex pushMutex_;  // held by JS thread only while reconfiguring
+    std::unique_ptr<SpscFloatRing> pushRing_;
+    Napi::ThreadSafeFunction pushCallback_;
+    std::atomic<bool> hasPushCallback_;
+    std::atomic<bool> pushPending_;
+    std::atomic<uint64_t> pushSignalledAt_;  // MonotonicMicros of the pending signal
+    DeliveryBatchController pushBatching_;  // Configured under pushMutex_; target read by the capture thread
+    StreamingResampler pushResampler_;  // guarded by pushMutex_
+    bool pushUsedShared_;               // guarded by pushMutex_
+    uint64_t pushReportedDrops_;
+    uint64_t pushWrittenSamples_;  // capture thread, under pushMutex_
+    uint64_t pushPoppedSamples_;   // JS thread
+    std::unique_ptr<SpscRingBuffer<PushVADRecord>> pushVADRecords_;
+    PushVADRecord pendingPushVADRecord_;  // JS thread; popped but belongs to a later batch
+    bool hasPendingPushVADRecord_;
+    std::vector<uint8_t> pushVADBatchFlags_;  // JS thread scratch
+    std::unique_ptr<SpscRingBuffer<PushFeatureRecord>> pushFeatureRecords_;
+    PushFeatureRecord pendingPushFeatureRecord_;  // JS thread; popped but belongs to a later batch
+    bool hasPendingPushFeatureRecord_;
+    std::vector<SpectralFrame> pushFeatureBatch_;  // JS thread scratch
+    bool pushVADSpeaking_;                    // JS thread
+    SampleEncoding pushEncoding_;             // JS thread
+    std::vector<float> pushDrained_;          // JS thread scratch for encoded batches
+    std::vector<char> base64Text_;            // JS thread scratch
+    
+    // Speech gating of push delivery: only VAD speech segments reach JS, each
+    // preceded by its pre-roll, so uploads can be gated without clipping onsets
+    bool pushGated_;                 // set while configuring, under pushMutex_
+    bool pushGateOpen_;              // capture thread, under pushMutex_
+    PreRollBuffer pushPreRoll_;      // capture thread, under pushMutex_
+    std::unique_ptr<SpscRingBuffer<uint64_t>> pushSegmentEnds_;  // push stream positions
+    uint64_t pendingSegmentEnd_;     // JS thread; popped but not reached yet
+    bool hasPendingSegmentEnd_;      // JS thread
+    bool pushSegmentStarting_;       // JS thread; next batch opens a segment
+    bool pushSilenceRuns_;           // JS thread; whole silent batches go out as a duration
+    
+    // Opus stage: capture thread encodes into opusPackets_, JS drains them per signal
+    std::mutex opusMutex_;  // held by JS thread only while reconfiguring
+    StreamingOpusEncoder opusEncoder_;  // guarded by opusMutex_
+    StreamingResampler opusResampler_;  // guarded by opusMutex_
+    bool opusUsedShared_;               // guarded by opusMutex_
+    std::unique_ptr<SpscRingBuffer<OpusPacket>> opusPackets_;
+    Napi::ThreadSafeFunction opusCallback_;
+    std::atomic<bool> hasOpusCallback_;
+    std::atomic<bool> opusPending_;
+    uint64_t opusReportedDrops_;          // JS thread
+    std::vector<OpusPacket> opusDrained_;  // JS thread scratch
+    
+    // Recording sink: the capture thread queues the stream, the sink's own I/O
+    // thread converts, encodes and writes it to disk
+    std::mutex recordMutex_;  // held by JS thread only while starting/stopping
+    RecordingSink recorder_;
+    std::atomic<bool> hasRecorder_;
+    
+    // JS-thread half of start()/startAsync(): options and the shared-stream
+    // reset; false with a JS exception pending
+    bool PrepareStart(const Napi::CallbackInfo& info);
+    
+    // Validate start() options and reconfigure every stage for the stream rate
+    bool ApplyCaptureOptions(Napi::Env env, const Napi::Object& options);
+    
+    // CaptureEngineConsumer
+    void OnEnginePacket(const EnginePacket& packet) override;
+    bool AcceptsStreamRate(uint32_t sampleRate) const override;
+    void OnStreamRateChanged(uint32_t sampleRate) override;
     
     // Audio processing
-    void OnAudioData(const AudioSample& sample);
-    void ProcessAndBufferAudio(const AudioSample& sample);
+    bool ProcessAndBufferAudio(const EnginePacket& input);
+    void RunVADStage(ProcessedPacket& packet);
+    void RunFeatureStage(ProcessedPacket& packet);
+    size_t ResampleForConsumer(StreamingResampler& resampler, bool& usedShared,
+                               const ProcessedPacket& packet, const float*& output);
+    void PushFloat32Batches(const ProcessedPacket& packet);
+    Napi::Value CollectPushVADFlags(Napi::Env env, uint64_t batchEnd);
+    Napi::Value CollectPushFeatures(Napi::Env env, uint64_t batchEnd);
+    Napi::Value EncodeSamples(Napi::Env env, const float* samples, size_t count, SampleEncoding encoding);
+    bool NextSegmentEnd(uint64_t readPosition, uint64_t& segmentEnd);
+    Napi::Value CreateVADResult(Napi::Env env, const uint8_t* flags, size_t count, bool& speaking);
+    Napi::Value CreateFeatureResult(Napi::Env env, const SpectralFrame* frames, size_t count);
+    void DeliverFloat32Batches(Napi::Env env, Napi::Function callback);
+    void ReleaseFloat32Callback(bool abort = false);
+    void EncodeOpusPackets(const ProcessedPacket& packet);
+    void DeliverOpusPackets(Napi::Env env, Napi::Function callback);
+    void ReleaseOpusCallback(bool abort = false);
+    Napi::Object CreateRecordingResult(Napi::Env env);
+    
+    // Sample the pull buffer's latency when JS reads from it
+    void RecordPullLatency();
+    
+    // Deliver buffered float32 audio as a view over a pooled native block
+    Napi::Value GetPooledFloat32Audio(Napi::Env env);
+    static void ReleasePooledBlock(napi_env env, void* data, void* hint);
 };
 
 Napi::Object AudioCaptureWrapper::Init(Napi::Env env, Napi::Object exports) {
@@ -57,17 +469,52 @@ Napi::Object AudioCaptureWrapper::Init(Napi::Env env, Napi::Object exports) {
         InstanceMethod("getFormat", &AudioCaptureWrapper::GetFormat),
         InstanceMethod("getAvailableDevices", &AudioCaptureWrapper::GetAvailableDevices),
         InstanceMethod("setDevice", &AudioCaptureWrapper::SetDevice),
+        InstanceMethod("startAsync", &AudioCaptureWrapper::StartAsync),
+        InstanceMethod("getAvailableDevicesAsync", &AudioCaptureWrapper::GetAvailableDevicesAsync),
+        InstanceMethod("setDeviceAsync", &AudioCaptureWrapper::SetDeviceAsync),
         InstanceMethod("getVolumeLevel", &AudioCaptureWrapper::GetVolumeLevel),
+        InstanceMethod("getLevel", &AudioCaptureWrapper::GetLevel),
         InstanceMethod("getLastError", &AudioCaptureWrapper::GetLastError),
         InstanceMethod("setNoiseGateThreshold", &AudioCaptureWrapper::SetNoiseGateThreshold),
+        InstanceMethod("setBufferDuration", &AudioCaptureWrapper::SetBufferDuration),
+        InstanceMethod("setProcessingWorker", &AudioCaptureWrapper::SetProcessingWorker),
         InstanceMethod("setAudioCallback", &AudioCaptureWrapper::SetAudioCallback),
+        InstanceMethod("setFloat32Callback", &AudioCaptureWrapper::SetFloat32Callback),
+        InstanceMethod("clearFloat32Callback", &AudioCaptureWrapper::ClearFloat32Callback),
+        InstanceMethod("encodePcm16", &AudioCaptureWrapper::EncodePcm16),
+        InstanceMethod("setOpusCallback", &AudioCaptureWrapper::SetOpusCallback),
+        InstanceMethod("clearOpusCallback", &AudioCaptureWrapper::ClearOpusCallback),
+        InstanceMethod("isOpusAvailable", &AudioCaptureWrapper::IsOpusAvailable),
+        InstanceMethod("startRecording", &AudioCaptureWrapper::StartRecording),
+        InstanceMethod("stopRecording", &AudioCaptureWrapper::StopRecording),
+        InstanceMethod("getRecordingStats", &AudioCaptureWrapper::GetRecordingStats),
         InstanceMethod("getBufferedAudio", &AudioCaptureWrapper::GetBufferedAudio),
         InstanceMethod("getBufferedFloat32Audio", &AudioCaptureWrapper::GetBufferedFloat32Audio),
+        InstanceMethod("readFloat32Audio", &AudioCaptureWrapper::ReadFloat32Audio),
+        InstanceMethod("setZeroCopyDelivery", &AudioCaptureWrapper::SetZeroCopyDelivery),
+        InstanceMethod("setOutputSampleRate", &AudioCaptureWrapper::SetOutputSampleRate),
         InstanceMethod("clearBuffer", &AudioCaptureWrapper::ClearBuffer),
+        InstanceMethod("skipBufferedSilence", &AudioCaptureWrapper::SkipBufferedSilence),
+        InstanceMethod("setBufferLimits", &AudioCaptureWrapper::SetBufferLimits),
+        InstanceMethod("getBufferLevel", &AudioCaptureWrapper::GetBufferLevel),
+        InstanceMethod("getStats", &AudioCaptureWrapper::GetStats),
+        InstanceMethod("resetStats", &AudioCaptureWrapper::ResetStats),
         InstanceMethod("createVAD", &AudioCaptureWrapper::CreateVAD),
         InstanceMethod("processVAD", &AudioCaptureWrapper::ProcessVAD),
+        InstanceMethod("processVADBatch", &AudioCaptureWrapper::ProcessVADBatch),
         InstanceMethod("setVADMode", &AudioCaptureWrapper::SetVADMode),
         InstanceMethod("resetVAD", &AudioCaptureWrapper::ResetVAD),
+        InstanceMethod("createVADEngine", &AudioCaptureWrapper::CreateVADEngine),
+        InstanceMethod("openVADStream", &AudioCaptureWrapper::OpenVADStream),
+        InstanceMethod("closeVADStream", &AudioCaptureWrapper::CloseVADStream),
+        InstanceMethod("resetVADStream", &AudioCaptureWrapper::ResetVADStream),
+        InstanceMethod("processVADFrames", &AudioCaptureWrapper::ProcessVADFrames),
+        InstanceMethod("enableStreamingVAD", &AudioCaptureWrapper::EnableStreamingVAD),
+        InstanceMethod("disableStreamingVAD", &AudioCaptureWrapper::DisableStreamingVAD),
+        InstanceMethod("getVADDecisions", &AudioCaptureWrapper::GetVADDecisions),
+        InstanceMethod("enableSpectralFeatures", &AudioCaptureWrapper::EnableSpectralFeatures),
+        InstanceMethod("disableSpectralFeatures", &AudioCaptureWrapper::DisableSpectralFeatures),
+        InstanceMethod("getSpectralFeatures", &AudioCaptureWrapper::GetSpectralFeatures),
     });
 
     Napi::FunctionReference* constructor = new Napi::FunctionReference();
@@ -80,85 +527,293 @@ Napi::Object AudioCaptureWrapper::Init(Napi::Env env, Napi::Object exports) {
 
 AudioCaptureWrapper::AudioCaptureWrapper(const Napi::CallbackInfo& info) 
     : Napi::ObjectWrap<AudioCaptureWrapper>(info)
-    , hasJSCallback_(false) {
+    , streamRate_(kCaptureSampleRate)
+    , bufferUsedShared_(false)
+    , bufferSampleRate_(kCaptureSampleRate)
+    , float32Pool_(nullptr)
+    , zeroCopyDelivery_(false)
+    , externalBuffersSupported_(true)
+    , rawPacketPool_(new AudioBlockPool())
+    , hasJSCallback_(false)
+    , hasVADStage_(false)
+    , vadFlags_(kVADFlagsCapacity)
+    , pullVADFlags_(kVADFlagsCapacity)
+    , pullVADSpeaking_(false)
+    , featureUsedShared_(false)
+    , hasFeatureStage_(false)
+    , featureFrames_(kFeatureFramesCapacity)
+    , pullFeatureFrames_(kFeatureFramesCapacity)
+    , hasPushCallback_(false)
+    , pushPending_(false)
+    , pushSignalledAt_(0)
+    , pushUsedShared_(false)
+    , pushReportedDrops_(0)
+    , pushWrittenSamples_(0)
+    , pushPoppedSamples_(0)
+    , pendingPushVADRecord_{0, 0}
+    , hasPendingPushVADRecord_(false)
+    , pendingPushFeatureRecord_{}
+    , hasPendingPushFeatureRecord_(false)
+    , pushVADSpeaking_(false)
+    , pushEncoding_(SampleEncoding::Float32)
+    , pushGated_(false)
+    , pushGateOpen_(false)
+    , pendingSegmentEnd_(0)
+    , hasPendingSegmentEnd_(false)
+    , pushSegmentStarting_(true)
+    , pushSilenceRuns_(false)
+    , opusUsedShared_(false)
+    , hasOpusCallback_(false)
+    , opusPending_(false)
+    , opusReportedDrops_(0)
+    , hasRecorder_(false) {
     
     Napi::Env env = info.Env();
     
-    // Create platform-specific audio capture instance
-    audioCapture_ = CreateAudioCapture();
-    if (!audioCapture_) {
+    // Share the process-wide engine, creating the platform backend on first use
+    engine_ = CaptureEngine::Acquire();
+    if (!engine_) {
         Napi::TypeError::New(env, "Failed to create audio capture for this platform")
             .ThrowAsJavaScriptException();
         return;
     }
     
-    // Create audio buffer
-    audioBuffer_ = std::make_unique<AudioBuffer>(5 * 1024 * 1024); // 5MB buffer
+    // Follow the rate another instance may already have set
+    streamRate_ = engine_->StreamRate();
     
-    // Set up audio callback
-    audioCapture_->SetAudioCallback([this](const AudioSample& sample) {
-        OnAudioData(sample);
-    });
+    // setZeroCopyDelivery() reports this, so it has to be known up front
+    externalBuffersSupported_ = ProbeExternalBuffers(env);
+    bufferSampleRate_ = streamRate_.load();
+    
+    // Create audio buffer; float32 is read from the engine's lock-free stream
+    // (its own ring only once a different rate is requested), so the capture
+    // thread never contends with JS polling
+    audioBuffer_ = std::make_unique<AudioBuffer>(5 * 1024 * 1024, kFloat32RingSamples, engine_->Stream()); // 5MB buffer
+    
+    engine_->Attach(this);
 }
 
 AudioCaptureWrapper::~AudioCaptureWrapper() {
-    if (audioCapture_ && audioCapture_->IsCapturing()) {
-        audioCapture_->Stop();
+    // Detach waits for a packet in flight, so nothing reaches this instance afterwards;
+    // the backend and worker keep running for the other instances
+    if (engine_) {
+        if (engine_->IsStarted(this)) {
+            engine_->Stop(this);
+        }
+        engine_->Detach(this);
     }
     
+    // Abort rather than release: calls still queued would otherwise run on
+    // the JS thread after this instance is gone. Aborted queues are drained
+    // without an environment, which every callback returns early on
     if (jsCallback_) {
-        jsCallback_.Release();
+        jsCallback_.Abort();
+    }
+    
+    ReleaseFloat32Callback(true);
+    ReleaseOpusCallback(true);
+    
+    // Finish the current file; detached, so nothing is queued after this
+    hasRecorder_ = false;
+    recorder_.Stop();
+    
+    // Blocks still referenced from JS are freed by their finalizers
+    if (float32Pool_) {
+        float32Pool_->Retire();
+        float32Pool_ = nullptr;
     }
+    
+    // Packets still queued for the raw callback return their blocks as they drain
+    rawPacketPool_->Retire();
 }
 
 Napi::Value AudioCaptureWrapper::Start(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (!audioCapture_) {
+    if (!engine_) {
         Napi::Error::New(env, "Audio capture not initialized").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    bool success = audioCapture_->Start();
+    if (!PrepareStart(info)) {
+        return env.Null();
+    }
+    
+    std::string error;
+    bool success = engine_->Start(this, error);
+    if (!error.empty()) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
     return Napi::Boolean::New(env, success);
 }
 
+bool AudioCaptureWrapper::PrepareStart(const Napi::CallbackInfo& info) {
+    // Options only apply to the first start; later instances join the running capture
+    if (!engine_->IsCapturing()) {
+        // Parse options: { sampleRate, channels, frameDurationMs }
+        if (info.Length() >= 1 && info[0].IsObject() && !ApplyCaptureOptions(info.Env(), info[0].As<Napi::Object>())) {
+            return false;
+        }
+    }
+    
+    // The shared stream carries other instances' audio from before this start
+    if (!engine_->IsStarted(this) && audioBuffer_->UsesFloat32Stream()) {
+        audioBuffer_->Clear();
+    }
+    return true;
+}
+
+Napi::Value AudioCaptureWrapper::StartAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!engine_) {
+        Napi::Error::New(env, "Audio capture not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Options are validated here, so bad ones throw instead of rejecting
+    if (!PrepareStart(info)) {
+        return env.Null();
+    }
+    
+    // Opening the backend is what blocks; the engine serializes it against
+    // every other control call
+    std::shared_ptr<CaptureEngine> engine = engine_;
+    auto success = std::make_shared<bool>(false);
+    return EngineTask::Run(env, info.This().As<Napi::Object>(),
+        [engine, success, this](std::string& error) {
+            *success = engine->Start(this, error);
+        },
+        [success](Napi::Env env) -> Napi::Value {
+            return Napi::Boolean::New(env, *success);
+        });
+}
+
+bool AudioCaptureWrapper::ApplyCaptureOptions(Napi::Env env, const Napi::Object& options) {
+    CaptureFormatRequest request = engine_->CaptureFormat();
+    uint32_t frameDurationMs = 0;
+    
+    if (options.Has("sampleRate") && options.Get("sampleRate").IsNumber()) {
+        request.sampleRate = options.Get("sampleRate").As<Napi::Number>().Uint32Value();
+    }
+    if (options.Has("channels") && options.Get("channels").IsNumber()) {
+        request.channels = static_cast<uint16_t>(options.Get("channels").As<Napi::Number>().Uint32Value());
+    }
+    if (options.Has("frameDurationMs") && options.Get("frameDurationMs").IsNumber()) {
+        frameDurationMs = options.Get("frameDurationMs").As<Napi::Number>().Uint32Value();
+    }
+    
+    if (request.sampleRate != 0 && (request.sampleRate < kMinCaptureSampleRate ||
+        !StreamingResampler::IsSupported(kCaptureSampleRate, request.sampleRate))) {
+        Napi::RangeError::New(env, "Capture sampleRate must divide 48000 (48000, 24000, 16000, 12000 or 8000)")
+            .ThrowAsJavaScriptException();
+        return false;
+    }
+    if (request.channels > 2 || frameDurationMs > 10000) {
+        Napi::RangeError::New(env, "Capture channels must be 1 or 2 and frameDurationMs at most 10000")
+            .ThrowAsJavaScriptException();
+        return false;
+    }
+    
+    // The engine checks every instance's stages against the new stream rate
+    std::string error;
+    if (!engine_->SetCaptureFormat(request, frameDurationMs, error)) {
+        Napi::RangeError::New(env, error).ThrowAsJavaScriptException();
+        return false;
+    }
+    return true;
+}
+
+bool AudioCaptureWrapper::AcceptsStreamRate(uint32_t sampleRate) const {
+    // Stages already configured must still be reachable by integer decimation
+    uint32_t bufferRate = bufferSampleRate_.load();
+    if (bufferRate == streamRate_.load()) {
+        bufferRate = sampleRate;
+    }
+    if (!StreamingResampler::IsSupported(sampleRate, bufferRate) ||
+        (hasPushCallback_ && !StreamingResampler::IsSupported(sampleRate, pushResampler_.OutputRate())) ||
+        (hasOpusCallback_ && !StreamingResampler::IsSupported(sampleRate, opusResampler_.OutputRate())) ||
+        (hasVADStage_ && !StreamingResampler::IsSupported(sampleRate, vadDecimator_.OutputRate())) ||
+        (hasFeatureStage_ && !StreamingResampler::IsSupported(sampleRate, featureResampler_.OutputRate()))) {
+        return false;
+    }
+    
+    // The archive's rate is fixed for the whole recording
+    return !hasRecorder_;
+}
+
+void AudioCaptureWrapper::OnStreamRateChanged(uint32_t sampleRate) {
+    // Stopped, so the capture thread is idle; the mutexes cover a worker
+    // still draining its last packets
+    uint32_t bufferRate = bufferSampleRate_.load();
+    if (bufferRate == streamRate_.load()) {
+        bufferRate = sampleRate;
+    }
+    bool rateChanged = bufferSampleRate_.exchange(bufferRate) != bufferRate;
+    if (audioBuffer_ && (rateChanged || audioBuffer_->UsesFloat32Stream() != (bufferRate == sampleRate))) {
+        audioBuffer_->UseFloat32Stream(bufferRate == sampleRate);
+    }
+    {
+        std::lock_guard<std::mutex> lock(pushMutex_);
+        pushResampler_.Configure(sampleRate, pushResampler_.OutputRate());
+        pushUsedShared_ = false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(opusMutex_);
+        opusResampler_.Configure(sampleRate, opusResampler_.OutputRate());
+        opusUsedShared_ = false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(vadStageMutex_);
+        vadDecimator_.Configure(sampleRate, hasVADStage_ ? vadDecimator_.OutputRate() : sampleRate);
+    }
+    {
+        std::lock_guard<std::mutex> lock(featureStageMutex_);
+        featureResampler_.Configure(sampleRate, hasFeatureStage_ ? featureResampler_.OutputRate() : sampleRate);
+        featureUsedShared_ = false;
+    }
+    streamRate_ = sampleRate;
+}
+
 Napi::Value AudioCaptureWrapper::Stop(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (!audioCapture_) {
+    if (!engine_) {
         Napi::Error::New(env, "Audio capture not initialized").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    bool success = audioCapture_->Stop();
+    // The backend stops with the last started instance
+    bool success = engine_->Stop(this);
     return Napi::Boolean::New(env, success);
 }
 
 Napi::Value AudioCaptureWrapper::IsCapturing(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (!audioCapture_) {
+    if (!engine_) {
         return Napi::Boolean::New(env, false);
     }
     
-    return Napi::Boolean::New(env, audioCapture_->IsCapturing());
+    return Napi::Boolean::New(env, engine_->IsStarted(this) && engine_->IsCapturing());
 }
 
 Napi::Value AudioCaptureWrapper::GetFormat(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (!audioCapture_) {
+    if (!engine_) {
         return env.Null();
     }
     
-    AudioFormat format = audioCapture_->GetFormat();
+    AudioFormat format = engine_->GetFormat();
     
     Napi::Object result = Napi::Object::New(env);
     result.Set("sampleRate", Napi::Number::New(env, format.sampleRate));
     result.Set("channels", Napi::Number::New(env, format.channels));
     result.Set("bitsPerSample", Napi::Number::New(env, format.bitsPerSample));
     result.Set("bytesPerFrame", Napi::Number::New(env, format.bytesPerFrame));
+    result.Set("streamSampleRate", Napi::Number::New(env, streamRate_.load()));
     
     return result;
 }
@@ -166,11 +821,11 @@ Napi::Value AudioCaptureWrapper::GetFormat(const Napi::CallbackInfo& info) {
 Napi::Value AudioCaptureWrapper::GetAvailableDevices(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (!audioCapture_) {
+    if (!engine_) {
         return Napi::Array::New(env, 0);
     }
     
-    auto devices = audioCapture_->GetAvailableDevices();
+    auto devices = engine_->GetAvailableDevices();
     
     Napi::Array result = Napi::Array::New(env, devices.size());
     for (size_t i = 0; i < devices.size(); ++i) {
@@ -188,36 +843,112 @@ Napi::Value AudioCaptureWrapper::SetDevice(const Napi::CallbackInfo& info) {
         return env.Null();
     }
     
-    if (!audioCapture_) {
+    if (!engine_) {
         Napi::Error::New(env, "Audio capture not initialized").ThrowAsJavaScriptException();
         return env.Null();
     }
     
+    // The device is the engine's, so this switches it for every instance
     std::string deviceId = info[0].As<Napi::String>().Utf8Value();
-    bool success = audioCapture_->SetDevice(deviceId);
+    std::string error;
+    bool success = engine_->SetDevice(deviceId, error);
+    if (!error.empty()) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
     
     return Napi::Boolean::New(env, success);
 }
 
+Napi::Value AudioCaptureWrapper::GetAvailableDevicesAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!engine_) {
+        Napi::Error::New(env, "Audio capture not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Resolves from the engine's cache unless a device change invalidated it
+    std::shared_ptr<CaptureEngine> engine = engine_;
+    auto devices = std::make_shared<std::vector<std::string>>();
+    return EngineTask::Run(env, info.This().As<Napi::Object>(),
+        [engine, devices](std::string& /*error*/) {
+            *devices = engine->GetAvailableDevices();
+        },
+        [devices](Napi::Env env) -> Napi::Value {
+            Napi::Array result = Napi::Array::New(env, devices->size());
+            for (size_t i = 0; i < devices->size(); ++i) {
+                result[i] = Napi::String::New(env, (*devices)[i]);
+            }
+            return result;
+        });
+}
+
+Napi::Value AudioCaptureWrapper::SetDeviceAsync(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "Expected device ID string").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (!engine_) {
+        Napi::Error::New(env, "Audio capture not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::shared_ptr<CaptureEngine> engine = engine_;
+    std::string deviceId = info[0].As<Napi::String>().Utf8Value();
+    auto success = std::make_shared<bool>(false);
+    return EngineTask::Run(env, info.This().As<Napi::Object>(),
+        [engine, deviceId, success](std::string& error) {
+            *success = engine->SetDevice(deviceId, error);
+        },
+        [success](Napi::Env env) -> Napi::Value {
+            return Napi::Boolean::New(env, *success);
+        });
+}
+
 Napi::Value AudioCaptureWrapper::GetVolumeLevel(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (!audioCapture_) {
-        return Napi::Number::New(env, 0.0);
+    if (!engine_) {
+        return Napi::Number::New(env, 0);
     }
     
-    float level = audioCapture_->GetVolumeLevel();
+    // Smoothed signal RMS of the captured stream, the same on every backend
+    float level = engine_->Meter().Read().level;
     return Napi::Number::New(env, level);
 }
 
+Napi::Value AudioCaptureWrapper::GetLevel(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!engine_) {
+        return env.Null();
+    }
+    
+    LevelReading reading = engine_->Meter().Read();
+    LevelMeterConfig config = engine_->Meter().Config();
+    
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("rms", Napi::Number::New(env, reading.rms));
+    result.Set("peak", Napi::Number::New(env, reading.peak));
+    result.Set("level", Napi::Number::New(env, reading.level));
+    result.Set("gateOpen", Napi::Boolean::New(env, reading.gateOpen));
+    result.Set("gateThreshold", Napi::Number::New(env, config.gateThreshold));
+    
+    return result;
+}
+
 Napi::Value AudioCaptureWrapper::GetLastError(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (!audioCapture_) {
+    if (!engine_) {
         return Napi::String::New(env, "Audio capture not initialized");
     }
     
-    std::string error = audioCapture_->GetLastError();
+    std::string error = engine_->GetLastError();
     return Napi::String::New(env, error);
 }
 
@@ -229,17 +960,127 @@ Napi::Value AudioCaptureWrapper::SetNoiseGateThreshold(const Napi::CallbackInfo&
         return env.Null();
     }
     
-    if (!audioCapture_) {
+    if (!engine_) {
         Napi::Error::New(env, "Audio capture not initialized").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    float threshold = info[0].As<Napi::Number>().FloatValue();
-    audioCapture_->SetNoiseGateThreshold(threshold);
+    // Parse options: { attackMs, releaseMs, holdMs }
+    LevelMeterConfig config = engine_->Meter().Config();
+    config.gateThreshold = info[0].As<Napi::Number>().FloatValue();
+    
+    if (info.Length() >= 2 && info[1].IsObject()) {
+        Napi::Object options = info[1].As<Napi::Object>();
+        if (options.Has("attackMs") && options.Get("attackMs").IsNumber()) {
+            config.attackMs = options.Get("attackMs").As<Napi::Number>().Uint32Value();
+        }
+        if (options.Has("releaseMs") && options.Get("releaseMs").IsNumber()) {
+            config.releaseMs = options.Get("releaseMs").As<Napi::Number>().Uint32Value();
+        }
+        if (options.Has("holdMs") && options.Get("holdMs").IsNumber()) {
+            config.holdMs = options.Get("holdMs").As<Napi::Number>().Uint32Value();
+        }
+    }
+    
+    if (!(config.gateThreshold >= 0.0f && config.gateThreshold <= 1.0f)) {
+        Napi::RangeError::New(env, "Noise gate threshold must be between 0 and 1").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    if (config.attackMs > 10000 || config.releaseMs > 10000 || config.holdMs > 10000) {
+        Napi::RangeError::New(env, "attackMs, releaseMs and holdMs must be at most 10000")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Picked up by the next packet; no lock against the processing thread.
+    // The gate is shared, so it applies to every instance.
+    engine_->Meter().Configure(config);
     
     return Napi::Boolean::New(env, true);
 }
 
+Napi::Value AudioCaptureWrapper::SetBufferDuration(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Expected buffer duration in milliseconds").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (!engine_) {
+        Napi::Error::New(env, "Audio capture not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    double milliseconds = info[0].As<Napi::Number>().DoubleValue();
+    if (!(milliseconds >= 1.0 && milliseconds <= 10000.0)) {
+        Napi::RangeError::New(env, "Buffer duration out of range").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Backend-specific limits; false (see getLastError) if rejected
+    bool applied = engine_->SetBufferDuration(static_cast<uint32_t>(milliseconds));
+    return Napi::Boolean::New(env, applied);
+}
+
+Napi::Value AudioCaptureWrapper::SetProcessingWorker(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        Napi::TypeError::New(env, "Expected processing worker options object").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (!engine_) {
+        Napi::Error::New(env, "Audio capture not initialized").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Parse options: { enabled, cpu, priority, queuePackets, slotBytes }
+    Napi::Object options = info[0].As<Napi::Object>();
+    ProcessingWorkerOptions workerOptions = engine_->WorkerOptions();
+    bool enabled = engine_->WorkerEnabled();
+    
+    if (options.Has("enabled") && options.Get("enabled").IsBoolean()) {
+        enabled = options.Get("enabled").As<Napi::Boolean>().Value();
+    }
+    if (options.Has("cpu") && options.Get("cpu").IsNumber()) {
+        workerOptions.cpu = options.Get("cpu").As<Napi::Number>().Int32Value();
+    }
+    if (options.Has("priority") && options.Get("priority").IsString()) {
+        std::string name = options.Get("priority").As<Napi::String>().Utf8Value();
+        if (!ParseWorkerPriority(name, workerOptions.priority)) {
+            Napi::RangeError::New(env, "priority must be 'normal', 'high' or 'realtime'")
+                .ThrowAsJavaScriptException();
+            return env.Null();
+        }
+    }
+    if (options.Has("queuePackets") && options.Get("queuePackets").IsNumber()) {
+        workerOptions.queuePackets = options.Get("queuePackets").As<Napi::Number>().Uint32Value();
+    }
+    if (options.Has("slotBytes") && options.Get("slotBytes").IsNumber()) {
+        workerOptions.slotBytes = options.Get("slotBytes").As<Napi::Number>().Uint32Value();
+    }
+    
+    if (workerOptions.queuePackets < ProcessingWorker::MIN_QUEUE_PACKETS ||
+        workerOptions.queuePackets > ProcessingWorker::MAX_QUEUE_PACKETS) {
+        Napi::RangeError::New(env, "queuePackets must be between 2 and 4096").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    if (workerOptions.slotBytes == 0 || workerOptions.slotBytes > 1024 * 1024) {
+        Napi::RangeError::New(env, "slotBytes must be between 1 and 1048576").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // One worker serves every instance; it can only change while none is capturing
+    std::string error;
+    if (!engine_->ConfigureWorker(enabled, workerOptions, error)) {
+        Napi::Error::New(env, error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    return env.Undefined();
+}
+
 Napi::Value AudioCaptureWrapper::SetAudioCallback(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
@@ -253,13 +1094,15 @@ Napi::Value AudioCaptureWrapper::SetAudioCallback(const Napi::CallbackInfo& info
         jsCallback_.Release();
     }
     
-    // Create new thread-safe function
-    jsCallback_ = Napi::ThreadSafeFunction::New(
+    // Create new thread-safe function; bounded so a stalled event loop drops
+    // packets instead of blocking the capture thread
+    jsCallback_ = decltype(jsCallback_)::New(
         env,
         info[0].As<Napi::Function>(),
         "AudioCaptureCallback",
-        0,      // Unlimited queue size
-        1       // Single thread
+        kRawCallbackQueueSize,
+        1,      // Single thread
+        this
     );
     
     hasJSCallback_ = true;
@@ -309,141 +1152,1349 @@ Napi::Value AudioCaptureWrapper::GetBufferedFloat32Audio(const Napi::CallbackInf
         return Napi::Array::New(env, 0);
     }
     
-    // Get all available float32 chunks for streaming to OpenAI
-    auto chunks = audioBuffer_->PopMultipleFloat32(1000);
+    if (zeroCopyDelivery_ && externalBuffersSupported_) {
+        return GetPooledFloat32Audio(env);
+    }
+    
+    // Pop everything available straight into a single Float32Array (40ms chunks ideal)
+    size_t available = audioBuffer_->GetBufferedFloat32Samples();
     
-    if (chunks.empty()) {
+    if (available == 0) {
         return Napi::Array::New(env, 0);
     }
     
-    // Combine all chunks into a single Float32Array (40ms chunks ideal)
-    size_t totalSamples = 0;
-    for (const auto& chunk : chunks) {
-        totalSamples += chunk.data.size();
-    }
+    RecordPullLatency();
     
-    // Create a single Float32Array with all the data
-    Napi::Float32Array result = Napi::Float32Array::New(env, totalSamples);
+    Napi::Float32Array result = Napi::Float32Array::New(env, available);
+    size_t copied = audioBuffer_->PopFloat32(result.Data(), available);
     
-    size_t offset = 0;
-    for (const auto& chunk : chunks) {
-        std::memcpy(
-            reinterpret_cast<uint8_t*>(result.Data()) + offset * sizeof(float),
-            chunk.data.data(),
-            chunk.data.size() * sizeof(float)
-        );
-        offset += chunk.data.size();
+    if (copied < available) {
+        // The producer overwrote part of what we sized for; return only valid samples
+        return Napi::Float32Array::New(env, copied, result.ArrayBuffer(), 0);
     }
     
     return result;
 }
 
-Napi::Value AudioCaptureWrapper::ClearBuffer(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
+Napi::Value AudioCaptureWrapper::GetPooledFloat32Audio(Napi::Env env) {
+    if (!float32Pool_) {
+        float32Pool_ = new AudioBlockPool(kPooledInitialBlocks);
+    }
     
-    if (audioBuffer_) {
-        audioBuffer_->Clear();
+    // The block is sized to this poll's audio; anything beyond the largest
+    // block stays buffered for the next poll
+    size_t available = std::min(audioBuffer_->GetBufferedFloat32Samples(), kPooledMaxSamples);
+    if (available == 0) {
+        return Napi::Array::New(env, 0);
     }
     
-    return env.Undefined();
-}
-
-void AudioCaptureWrapper::OnAudioData(const AudioSample& sample) {
-    // Process and buffer the audio
-    ProcessAndBufferAudio(sample);
+    RecordPullLatency();
     
-    // If JavaScript callback is set, call it
-    if (hasJSCallback_ && jsCallback_) {
-        auto callback = [](Napi::Env env, Napi::Function jsCallback, AudioSample* sample) {
-            if (sample) {
-                // Convert sample to JavaScript object
-                Napi::Object sampleObj = Napi::Object::New(env);
-                
-                // Create buffer from audio data
-                Napi::Buffer<uint8_t> buffer = Napi::Buffer<uint8_t>::Copy(
-                    env,
-                    sample->data.data(),
-                    sample->data.size()
-                );
-                
-                sampleObj.Set("data", buffer);
-                sampleObj.Set("timestamp", Napi::Number::New(env, sample->timestamp));
-                sampleObj.Set("frameCount", Napi::Number::New(env, sample->frameCount));
-                
-                Napi::Object formatObj = Napi::Object::New(env);
-                formatObj.Set("sampleRate", Napi::Number::New(env, sample->format.sampleRate));
-                formatObj.Set("channels", Napi::Number::New(env, sample->format.channels));
-                formatObj.Set("bitsPerSample", Napi::Number::New(env, sample->format.bitsPerSample));
-                
-                sampleObj.Set("format", formatObj);
-                
-                jsCallback.Call({sampleObj});
-                
-                delete sample;
-            }
-        };
+    AudioBlock block = float32Pool_->Acquire(available * sizeof(float));
+    float* samples = reinterpret_cast<float*>(block.Data());
+    size_t copied = audioBuffer_->PopFloat32(samples, available);
+    
+    // The finalizer owns the block once the buffer exists
+    void* handle = block.Release();
+    napi_value arrayBuffer;
+    napi_status status = napi_create_external_arraybuffer(
+        env,
+        samples,
+        available * sizeof(float),
+        &AudioCaptureWrapper::ReleasePooledBlock,
+        handle,
+        &arrayBuffer
+    );
+    
+    if (status != napi_ok) {
+        // Refused after all (the constructor's probe said otherwise): remember
+        // that and fall back to copying into a JS-owned array
+        externalBuffersSupported_ = false;
+        AudioBlock retained = AudioBlock::Adopt(handle);
         
-        AudioSample* sampleCopy = new AudioSample(sample);
-        jsCallback_.BlockingCall(sampleCopy, callback);
+        Napi::Float32Array result = Napi::Float32Array::New(env, copied);
+        std::memcpy(result.Data(), samples, copied * sizeof(float));
+        return result;
     }
+    
+    return Napi::Float32Array::New(env, copied, Napi::ArrayBuffer(env, arrayBuffer), 0);
 }
 
-void AudioCaptureWrapper::ProcessAndBufferAudio(const AudioSample& sample) {
-    if (!audioBuffer_) return;
-    
-    // Convert to clean 48kHz mono float32 for high-quality resampling in JS
-    std::vector<float> float32Data = AudioFormatConverter::ConvertToMonoFloat32(sample);
-    
-    // Debug output disabled for production
-    // fprintf(stderr, "PBA size=%zu\n", float32Data.size());
-    
-    if (!float32Data.empty()) {
-        audioBuffer_->PushFloat32(float32Data, 48000, 1);  // Always 48kHz mono
-    }
+void AudioCaptureWrapper::ReleasePooledBlock(napi_env /*env*/, void* /*data*/, void* hint) {
+    // hint is the block's handle; adopting it returns the block to its pool
+    AudioBlock::Adopt(hint).Reset();
 }
 
-// WebRTC VAD method implementations
-Napi::Value AudioCaptureWrapper::CreateVAD(const Napi::CallbackInfo& info) {
+Napi::Value AudioCaptureWrapper::ReadFloat32Audio(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    // Parse arguments: createVAD(sampleRate, mode)
-    int sampleRate = 48000;  // Default
-    int mode = 2;            // Default aggressive mode
-    
-    if (info.Length() >= 1 && info[0].IsNumber()) {
-        sampleRate = info[0].As<Napi::Number>().Int32Value();
+    if (info.Length() < 1 || !info[0].IsTypedArray() ||
+        info[0].As<Napi::TypedArray>().TypedArrayType() != napi_float32_array) {
+        Napi::TypeError::New(env, "Expected Float32Array as first argument")
+            .ThrowAsJavaScriptException();
+        return env.Null();
     }
     
-    if (info.Length() >= 2 && info[1].IsNumber()) {
-        mode = info[1].As<Napi::Number>().Int32Value();
+    if (!audioBuffer_) {
+        return Napi::Number::New(env, 0);
     }
     
-    try {
-        vad_ = std::make_unique<WebRTCVAD::VADWrapper>(sampleRate, mode);
-        return Napi::Boolean::New(env, true);
-    } catch (const std::exception& e) {
-        Napi::Error::New(env, std::string("Failed to create VAD: ") + e.what())
-            .ThrowAsJavaScriptException();
+    // Fill the caller's array in place: no allocation or extra copy on either side
+    Napi::Float32Array target = info[0].As<Napi::Float32Array>();
+    RecordPullLatency();
+    size_t copied = audioBuffer_->PopFloat32(target.Data(), target.ElementLength());
+    
+    return Napi::Number::New(env, static_cast<double>(copied));
+}
+
+Napi::Value AudioCaptureWrapper::SetZeroCopyDelivery(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsBoolean()) {
+        Napi::TypeError::New(env, "Expected boolean").ThrowAsJavaScriptException();
         return env.Null();
     }
+    
+    zeroCopyDelivery_ = info[0].As<Napi::Boolean>().Value();
+    
+    // Report whether pooled external buffers are actually in use
+    return Napi::Boolean::New(env, zeroCopyDelivery_ && externalBuffersSupported_);
 }
 
-Napi::Value AudioCaptureWrapper::ProcessVAD(const Napi::CallbackInfo& info) {
+Napi::Value AudioCaptureWrapper::SetOutputSampleRate(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
-    if (!vad_) {
-        Napi::Error::New(env, "VAD not initialized. Call createVAD() first.")
-            .ThrowAsJavaScriptException();
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(env, "Expected sample rate number").ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    if (info.Length() < 1 || !info[0].IsBuffer()) {
-        Napi::TypeError::New(env, "Expected audio buffer as first argument")
+    uint32_t sampleRate = info[0].As<Napi::Number>().Uint32Value();
+    if (!StreamingResampler::IsSupported(streamRate_, sampleRate)) {
+        Napi::RangeError::New(env, "Sample rate must divide the capture rate (e.g. 48000, 24000, 16000, 8000)")
             .ThrowAsJavaScriptException();
         return env.Null();
     }
     
-    // Get the audio buffer (expects Int16Array/Buffer)
+    // Drop audio buffered at the previous rate; the capture thread picks up the
+    // new rate with its next packet. The stream rate is read straight from the
+    // engine's stream, other rates from the buffer's own ring.
+    if (bufferSampleRate_.exchange(sampleRate) != sampleRate && audioBuffer_) {
+        audioBuffer_->UseFloat32Stream(sampleRate == streamRate_.load());
+    }
+    
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value AudioCaptureWrapper::ClearBuffer(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (audioBuffer_) {
+        audioBuffer_->Clear();
+    }
+    
+    return env.Undefined();
+}
+
+Napi::Value AudioCaptureWrapper::SkipBufferedSilence(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    // Digital silence at the front of the pull buffer is dropped without
+    // expanding it; the count keeps the caller's timeline
+    size_t skipped = audioBuffer_ ? audioBuffer_->SkipFloat32Silence() : 0;
+    return Napi::Number::New(env, static_cast<double>(skipped));
+}
+
+Napi::Value AudioCaptureWrapper::SetBufferLimits(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        Napi::TypeError::New(env, "Expected options object").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (!audioBuffer_) {
+        return Napi::Boolean::New(env, false);
+    }
+    
+    // Parse options: { maxDurationMs, maxBytes }; 0 ms keeps audio until the byte limit
+    Napi::Object options = info[0].As<Napi::Object>();
+    if (options.Has("maxDurationMs") && options.Get("maxDurationMs").IsNumber()) {
+        uint32_t maxDurationMs = options.Get("maxDurationMs").As<Napi::Number>().Uint32Value();
+        if (maxDurationMs > kMaxBufferDurationMs) {
+            Napi::RangeError::New(env, "maxDurationMs must be 0-600000").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        audioBuffer_->SetMaxDuration(maxDurationMs);
+    }
+    if (options.Has("maxBytes") && options.Get("maxBytes").IsNumber()) {
+        int64_t maxBytes = options.Get("maxBytes").As<Napi::Number>().Int64Value();
+        if (maxBytes <= 0) {
+            Napi::RangeError::New(env, "maxBytes must be positive").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        audioBuffer_->SetMaxSize(static_cast<size_t>(maxBytes));
+    }
+    
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value AudioCaptureWrapper::GetBufferLevel(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    // Running counters only, cheap enough to poll every frame
+    Napi::Object level = Napi::Object::New(env);
+    if (!audioBuffer_) {
+        return level;
+    }
+    
+    level.Set("float32Samples", Napi::Number::New(env, static_cast<double>(audioBuffer_->GetBufferedFloat32Samples())));
+    level.Set("float32DurationMs", Napi::Number::New(env, audioBuffer_->GetBufferedFloat32Micros() / 1000.0));
+    level.Set("pcm16Frames", Napi::Number::New(env, static_cast<double>(audioBuffer_->GetBufferedPcm16Frames())));
+    level.Set("pcm16DurationMs", Napi::Number::New(env, audioBuffer_->GetBufferedPcm16Micros() / 1000.0));
+    level.Set("bytes", Napi::Number::New(env, static_cast<double>(audioBuffer_->GetSize())));
+    level.Set("usage", Napi::Number::New(env, audioBuffer_->GetUsagePercentage()));
+    level.Set("ageMs", Napi::Number::New(env, audioBuffer_->GetFloat32BufferedAgeMicros() / 1000.0));
+    level.Set("maxDurationMs", Napi::Number::New(env, audioBuffer_->GetMaxDuration()));
+    return level;
+}
+
+Napi::Value AudioCaptureWrapper::GetStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!engine_) {
+        return env.Null();
+    }
+    
+    // Capture-side metrics come from the shared engine, the rest are this instance's
+    AudioMetrics& engineMetrics = engine_->Metrics();
+    
+    // Latency histograms, all in microseconds
+    Napi::Object stages = Napi::Object::New(env);
+    for (size_t i = 0; i < static_cast<size_t>(MetricStage::Count); ++i) {
+        MetricStage stage = static_cast<MetricStage>(i);
+        bool engineStage = stage == MetricStage::WorkerQueue || stage == MetricStage::CaptureLatency;
+        const LatencyHistogram& histogram = engineStage ? engineMetrics.Stage(stage) : metrics_.Stage(stage);
+        
+        Napi::Object stageObj = Napi::Object::New(env);
+        stageObj.Set("count", Napi::Number::New(env, static_cast<double>(histogram.Count())));
+        stageObj.Set("meanUs", Napi::Number::New(env, histogram.Mean()));
+        stageObj.Set("p50Us", Napi::Number::New(env, static_cast<double>(histogram.Percentile(0.50))));
+        stageObj.Set("p90Us", Napi::Number::New(env, static_cast<double>(histogram.Percentile(0.90))));
+        stageObj.Set("p99Us", Napi::Number::New(env, static_cast<double>(histogram.Percentile(0.99))));
+        stageObj.Set("maxUs", Napi::Number::New(env, static_cast<double>(histogram.Max())));
+        stages.Set(AudioMetrics::StageName(stage), stageObj);
+    }
+    
+    // Throughput and loss counters, including those kept by the buffers
+    // themselves; each counter is kept by either the engine or this instance
+    Napi::Object counters = Napi::Object::New(env);
+    for (size_t i = 0; i < static_cast<size_t>(MetricCounter::Count); ++i) {
+        MetricCounter counter = static_cast<MetricCounter>(i);
+        uint64_t value = metrics_.Get(counter) + engineMetrics.Get(counter);
+        counters.Set(AudioMetrics::CounterName(counter), Napi::Number::New(env, static_cast<double>(value)));
+    }
+    
+    uint64_t pullOverruns = audioBuffer_ ? audioBuffer_->GetFloat32OverrunCount() : 0;
+    uint64_t trimmedChunks = audioBuffer_ ? audioBuffer_->GetTrimmedChunkCount() : 0;
+    uint64_t pullTrimmed = audioBuffer_ ? audioBuffer_->GetTrimmedFloat32Samples() : 0;
+    // pushRing_ is only replaced on this thread, so no need to contend for pushMutex_
+    uint64_t pushDrops = pushRing_ ? pushRing_->OverrunCount() : 0;
+    counters.Set("pullOverrunSamples", Napi::Number::New(env, static_cast<double>(pullOverruns)));
+    counters.Set("trimmedChunks", Napi::Number::New(env, static_cast<double>(trimmedChunks)));
+    counters.Set("pullTrimmedSamples", Napi::Number::New(env, static_cast<double>(pullTrimmed)));
+    counters.Set("pushDroppedSamples", Napi::Number::New(env, static_cast<double>(pushDrops)));
+    
+    // Buffer levels with their high-water marks
+    Napi::Object buffers = Napi::Object::New(env);
+    for (size_t i = 0; i < static_cast<size_t>(MetricGauge::Count); ++i) {
+        MetricGauge gauge = static_cast<MetricGauge>(i);
+        const AudioMetrics& source = gauge == MetricGauge::WorkerQueueDepth ? engineMetrics : metrics_;
+        
+        Napi::Object gaugeObj = Napi::Object::New(env);
+        gaugeObj.Set("current", Napi::Number::New(env, static_cast<double>(source.GetGauge(gauge))));
+        gaugeObj.Set("highWater", Napi::Number::New(env, static_cast<double>(source.GetHighWater(gauge))));
+        buffers.Set(AudioMetrics::GaugeName(gauge), gaugeObj);
+    }
+    
+    // Processing worker configuration and backpressure
+    const ProcessingWorker& processingWorker = engine_->Worker();
+    const ProcessingWorkerOptions& workerOptions = engine_->WorkerOptions();
+    Napi::Object worker = Napi::Object::New(env);
+    worker.Set("enabled", Napi::Boolean::New(env, engine_->WorkerEnabled()));
+    worker.Set("running", Napi::Boolean::New(env, processingWorker.IsRunning()));
+    worker.Set("priority", Napi::String::New(env, WorkerPriorityName(workerOptions.priority)));
+    worker.Set("cpu", Napi::Number::New(env, workerOptions.cpu));
+    worker.Set("queueDepth", Napi::Number::New(env, static_cast<double>(processingWorker.QueueDepth())));
+    worker.Set("queueCapacity", Napi::Number::New(env, static_cast<double>(processingWorker.QueueCapacity())));
+    if (!processingWorker.ThreadConfigError().empty()) {
+        worker.Set("threadConfigError", Napi::String::New(env, processingWorker.ThreadConfigError()));
+    }
+    
+    // Instances sharing the engine, and whether the pull buffer reads its stream directly
+    Napi::Object engine = Napi::Object::New(env);
+    engine.Set("consumers", Napi::Number::New(env, static_cast<double>(engine_->ConsumerCount())));
+    engine.Set("started", Napi::Number::New(env, static_cast<double>(engine_->StartedCount())));
+    engine.Set("sharedPullStream", Napi::Boolean::New(env, audioBuffer_ && audioBuffer_->UsesFloat32Stream()));
+    engine.Set("deviceChanges", Napi::Number::New(env, static_cast<double>(engine_->DeviceChangeCount())));
+    
+    // Device clock against the host clock, from the backend's capture timestamps
+    ClockDriftReading drift = engine_->ClockDrift();
+    Napi::Object clock = Napi::Object::New(env);
+    clock.Set("locked", Napi::Boolean::New(env, drift.locked));
+    clock.Set("driftPpm", Napi::Number::New(env, drift.driftPpm));
+    clock.Set("measuredRate", Napi::Number::New(env, drift.measuredRate));
+    clock.Set("jitterUs", Napi::Number::New(env, drift.jitterMicros));
+    
+    // Push delivery batching, adapted to the event loop's lag when enabled
+    DeliveryBatchReading batching = pushBatching_.Read();
+    Napi::Object delivery = Napi::Object::New(env);
+    delivery.Set("active", Napi::Boolean::New(env, hasPushCallback_.load()));
+    delivery.Set("adaptive", Napi::Boolean::New(env, batching.adaptive));
+    delivery.Set("targetBatchMs", Napi::Number::New(env, batching.targetBatchMs));
+    delivery.Set("minBatchMs", Napi::Number::New(env, batching.minBatchMs));
+    delivery.Set("maxBatchMs", Napi::Number::New(env, batching.maxBatchMs));
+    delivery.Set("wakeupLatencyMs", Napi::Number::New(env, batching.wakeupLatencyMs));
+    delivery.Set("maxWakeupLatencyMs", Napi::Number::New(env, batching.maxWakeupLatencyMs));
+    delivery.Set("queuedMs", Napi::Number::New(env, batching.queuedMs));
+    delivery.Set("deliveries", Napi::Number::New(env, static_cast<double>(batching.deliveries)));
+    delivery.Set("adjustments", Napi::Number::New(env, static_cast<double>(batching.adjustments)));
+    
+    Napi::Object stats = Napi::Object::New(env);
+    stats.Set("stages", stages);
+    stats.Set("counters", counters);
+    stats.Set("buffers", buffers);
+    stats.Set("worker", worker);
+    stats.Set("engine", engine);
+    stats.Set("clock", clock);
+    stats.Set("delivery", delivery);
+    return stats;
+}
+
+Napi::Value AudioCaptureWrapper::ResetStats(const Napi::CallbackInfo& info) {
+    // The engine's counters are shared, so this resets them for every instance
+    metrics_.Reset();
+    if (engine_) {
+        engine_->Metrics().Reset();
+    }
+    return info.Env().Undefined();
+}
+
+void AudioCaptureWrapper::RecordPullLatency() {
+    uint64_t age = audioBuffer_->GetFloat32BufferedAgeMicros();
+    if (age > 0) {
+        metrics_.Stage(MetricStage::BufferToJS).Record(age);
+    }
+}
+
+void AudioCaptureWrapper::OnEnginePacket(const EnginePacket& packet) {
+    // Process and buffer the audio; gated packets go no further
+    if (!ProcessAndBufferAudio(packet)) return;
+    
+    const AudioSampleView& view = *packet.view;
+    
+    // If JavaScript callback is set, call it
+    if (hasJSCallback_ && jsCallback_) {
+        // The JS thread runs later, so this consumer needs its own copy:
+        // header and bytes in one pooled block, allocation-free once warm
+        size_t bytes = view.silent || !view.data ? 0 : view.size;
+        AudioBlock block = rawPacketPool_->Acquire(sizeof(RawPacket) + bytes);
+        RawPacket* raw = new (block.Data()) RawPacket{view.format, view.timestamp, view.frameCount, view.silent, bytes};
+        if (bytes > 0) {
+            std::memcpy(raw->Bytes(), view.data, bytes);
+        }
+        
+        metrics_.AddGauge(MetricGauge::JSQueueDepth, 1);
+        void* queued = block.Release();
+        if (jsCallback_.NonBlockingCall(queued) != napi_ok) {
+            AudioBlock::Adopt(queued).Reset();
+            metrics_.AddGauge(MetricGauge::JSQueueDepth, -1);
+            metrics_.Add(MetricCounter::RawCallbackDrops);
+        }
+    }
+}
+
+void AudioCaptureWrapper::CallRawCallback(Napi::Env env, Napi::Function jsCallback,
+                                          AudioCaptureWrapper* wrapper, void* queued) {
+    // Returned to the pool when this call ends
+    AudioBlock block = AudioBlock::Adopt(queued);
+    
+    // An aborted function drains its queue without an environment, possibly
+    // after the wrapper is gone; the block still has to go back
+    if (env == nullptr || !block) return;
+    
+    wrapper->metrics_.AddGauge(MetricGauge::JSQueueDepth, -1);
+    const RawPacket* sample = reinterpret_cast<const RawPacket*>(block.Data());
+    
+    // Convert sample to JavaScript object
+    Napi::Object sampleObj = Napi::Object::New(env);
+    
+    // Create buffer from audio data; silence is only expanded here,
+    // so dumps and recordings keep their timeline
+    Napi::Buffer<uint8_t> buffer;
+    if (sample->silent) {
+        size_t size = static_cast<size_t>(sample->frameCount) * sample->format.bytesPerFrame;
+        buffer = Napi::Buffer<uint8_t>::New(env, size);
+        std::memset(buffer.Data(), 0, size);
+    } else {
+        buffer = Napi::Buffer<uint8_t>::Copy(env, sample->Bytes(), sample->size);
+    }
+    
+    sampleObj.Set("data", buffer);
+    sampleObj.Set("silent", Napi::Boolean::New(env, sample->silent));
+    sampleObj.Set("timestamp", Napi::Number::New(env, sample->timestamp));
+    sampleObj.Set("frameCount", Napi::Number::New(env, sample->frameCount));
+    
+    Napi::Object formatObj = Napi::Object::New(env);
+    formatObj.Set("sampleRate", Napi::Number::New(env, sample->format.sampleRate));
+    formatObj.Set("channels", Napi::Number::New(env, sample->format.channels));
+    formatObj.Set("bitsPerSample", Napi::Number::New(env, sample->format.bitsPerSample));
+    
+    sampleObj.Set("format", formatObj);
+    
+    jsCallback.Call({sampleObj});
+}
+
+bool AudioCaptureWrapper::ProcessAndBufferAudio(const EnginePacket& input) {
+    if (!audioBuffer_) return true;
+    
+    // The engine already converted, rate-adapted and metered the packet once
+    // for every instance; a packet without audio still reaches raw consumers
+    if (input.frames == 0) return true;
+    
+    ProcessedPacket packet;
+    packet.timestamp = input.timestamp;
+    packet.samples = input.samples;
+    packet.frames = input.frames;
+    packet.silent = input.silent;
+    uint32_t streamRate = streamRate_.load(std::memory_order_relaxed);
+    uint64_t convertMicros = input.convertMicros;
+    
+    // The archive keeps the whole timeline, so it is fed before the gate
+    if (hasRecorder_) {
+        std::unique_lock<std::mutex> lock(recordMutex_, std::try_to_lock);
+        if (lock.owns_lock()) {
+            if (packet.silent) {
+                recorder_.WriteSilence(packet.frames);
+            } else {
+                recorder_.Write(packet.samples, packet.frames);
+            }
+        }
+    }
+    
+    // Every packet is metered, but only what passes the gate costs anything more
+    if (!input.gateOpen) return false;
+    
+    // VAD runs before buffering so decisions are ready no later than their audio
+    RunVADStage(packet);
+    RunFeatureStage(packet);
+    
+    // Pull consumers may have asked for 24/16kHz; downsample natively so JS
+    // neither resamples nor receives the extra bytes
+    uint32_t bufferRate = bufferSampleRate_.load(std::memory_order_relaxed);
+    if (bufferRate != bufferResampler_.OutputRate() || streamRate != bufferResampler_.InputRate()) {
+        bufferResampler_.Configure(streamRate, bufferRate);
+    }
+    
+    uint64_t resampleStart = MonotonicMicros();
+    const float* bufferData = nullptr;
+    size_t bufferFrames = ResampleForConsumer(bufferResampler_, bufferUsedShared_, packet, bufferData);
+    uint64_t buffered = MonotonicMicros();
+    metrics_.Stage(MetricStage::Conversion).Record(convertMicros + (buffered - resampleStart));
+    
+    // At the stream rate the samples are already in the engine's stream, which
+    // the buffer reads through its cursor; the calls below only stamp them
+    if (IsSilentOutput(packet, bufferData, bufferFrames)) {
+        audioBuffer_->PushSilence(bufferFrames, bufferResampler_.OutputRate(), 1);
+    } else {
+        audioBuffer_->PushFloat32(bufferData, bufferFrames, bufferResampler_.OutputRate(), 1);
+    }
+    metrics_.Stage(MetricStage::CaptureToBuffer).Record(buffered - std::min(packet.timestamp, buffered));
+    metrics_.SetGauge(MetricGauge::PullBufferedSamples, audioBuffer_->GetBufferedFloat32Samples());
+    
+    PushFloat32Batches(packet);
+    EncodeOpusPackets(packet);
+    return true;
+}
+
+void AudioCaptureWrapper::RunVADStage(ProcessedPacket& packet) {
+    if (!hasVADStage_) return;
+    
+    // Never wait on the JS thread; a packet during reconfiguration goes unclassified
+    std::unique_lock<std::mutex> lock(vadStageMutex_, std::try_to_lock);
+    if (!lock.owns_lock() || !vadStage_.IsConfigured()) return;
+    
+    uint64_t vadStart = MonotonicMicros();
+    
+    // Below the stream rate our own decimator feeds the VAD (instead of libfvad's internal
+    // 48->8kHz resampler) and its output is offered to the other stages
+    const float* vadInput = packet.samples;
+    size_t vadCount = packet.frames;
+    
+    if (!vadDecimator_.IsPassthrough()) {
+        size_t capacity = vadDecimator_.MaxOutputFrames(packet.frames);
+        float* decimated = scratch_.Get<float>(ScratchSlot::Decimate, capacity);
+        vadCount = packet.silent
+            ? vadDecimator_.ProcessSilence(packet.frames, decimated, capacity)
+            : vadDecimator_.Process(packet.samples, packet.frames, decimated, capacity);
+        vadInput = decimated;
+        
+        packet.decimated = decimated;
+        packet.decimatedFrames = vadCount;
+        packet.decimatedRate = vadDecimator_.OutputRate();
+    }
+    
+    size_t capacity = vadStage_.MaxFramesFor(vadCount);
+    uint8_t* flags = scratch_.Get<uint8_t>(ScratchSlot::Analysis, std::max<size_t>(capacity, 1));
+    size_t completed = vadStage_.Process(vadInput, vadCount, flags, capacity);
+    
+    // Decimation plus classification, per packet
+    metrics_.Stage(MetricStage::VAD).Record(MonotonicMicros() - vadStart);
+    
+    vadFlags_.Push(flags, completed);
+    packet.vadFlags = flags;
+    packet.vadFrames = completed;
+}
+
+void AudioCaptureWrapper::RunFeatureStage(ProcessedPacket& packet) {
+    if (!hasFeatureStage_) return;
+    
+    // Never wait on the JS thread; a packet during reconfiguration goes unanalysed
+    std::unique_lock<std::mutex> lock(featureStageMutex_, std::try_to_lock);
+    if (!lock.owns_lock() || !featureStage_.IsConfigured()) return;
+    
+    uint64_t featureStart = MonotonicMicros();
+    
+    // At the VAD's rate this is the decimated stream it already produced
+    const float* input = nullptr;
+    size_t count = ResampleForConsumer(featureResampler_, featureUsedShared_, packet, input);
+    
+    size_t capacity = featureStage_.MaxFramesFor(count);
+    SpectralFrame* frames = scratch_.Get<SpectralFrame>(ScratchSlot::Features, std::max<size_t>(capacity, 1));
+    size_t completed = featureStage_.Process(input, count, frames, capacity);
+    
+    metrics_.Stage(MetricStage::Features).Record(MonotonicMicros() - featureStart);
+    
+    featureFrames_.Push(frames, completed);
+    packet.features = frames;
+    packet.featureFrames = completed;
+}
+
+size_t AudioCaptureWrapper::ResampleForConsumer(StreamingResampler& resampler, bool& usedShared,
+                                                const ProcessedPacket& packet, const float*& output) {
+    if (resampler.IsPassthrough()) {
+        output = packet.samples;
+        return packet.frames;
+    }
+    
+    // Same filter, same input: the VAD's decimated stream is exactly what we need
+    if (packet.decimated && packet.decimatedRate == resampler.OutputRate()) {
+        usedShared = true;
+        output = packet.decimated;
+        return packet.decimatedFrames;
+    }
+    
+    // History is stale after running off the shared stream
+    if (usedShared) {
+        resampler.Reset();
+        usedShared = false;
+    }
+    
+    size_t capacity = resampler.MaxOutputFrames(packet.frames);
+    float* resampled = scratch_.Get<float>(ScratchSlot::Resample, capacity);
+    output = resampled;
+    if (packet.silent) {
+        return resampler.ProcessSilence(packet.frames, resampled, capacity);
+    }
+    return resampler.Process(packet.samples, packet.frames, resampled, capacity);
+}
+
+Napi::Value AudioCaptureWrapper::SetFloat32Callback(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsFunction()) {
+        Napi::TypeError::New(env, "Expected callback function").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Parse options: { batchMs, maxQueuedBatches, sampleRate, encoding, speechGated, preRollMs, silenceRuns,
+    //                 adaptiveBatching, minBatchMs, maxBatchMs }
+    uint32_t batchMs = kDefaultPushBatchMs;
+    uint32_t maxQueuedBatches = kDefaultPushMaxQueuedBatches;
+    uint32_t sampleRate = streamRate_;
+    SampleEncoding encoding = SampleEncoding::Float32;
+    bool speechGated = false;
+    uint32_t preRollMs = kDefaultPreRollMs;
+    bool silenceRuns = false;
+    bool adaptiveBatching = false;
+    uint32_t minBatchMs = kDefaultPushMinBatchMs;
+    uint32_t maxBatchMs = kDefaultPushMaxBatchMs;
+    
+    if (info.Length() >= 2 && info[1].IsObject()) {
+        Napi::Object options = info[1].As<Napi::Object>();
+        if (options.Has("batchMs") && options.Get("batchMs").IsNumber()) {
+            batchMs = options.Get("batchMs").As<Napi::Number>().Uint32Value();
+        }
+        if (options.Has("maxQueuedBatches") && options.Get("maxQueuedBatches").IsNumber()) {
+            maxQueuedBatches = options.Get("maxQueuedBatches").As<Napi::Number>().Uint32Value();
+        }
+        if (options.Has("sampleRate") && options.Get("sampleRate").IsNumber()) {
+            sampleRate = options.Get("sampleRate").As<Napi::Number>().Uint32Value();
+        }
+        if (options.Has("encoding") && options.Get("encoding").IsString() &&
+            !ParseSampleEncoding(options.Get("encoding").As<Napi::String>().Utf8Value(), encoding)) {
+            Napi::RangeError::New(env, "encoding must be 'float32', 'pcm16' or 'base64'")
+                .ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        if (options.Has("speechGated") && options.Get("speechGated").IsBoolean()) {
+            speechGated = options.Get("speechGated").As<Napi::Boolean>().Value();
+        }
+        if (options.Has("preRollMs") && options.Get("preRollMs").IsNumber()) {
+            preRollMs = options.Get("preRollMs").As<Napi::Number>().Uint32Value();
+        }
+        if (options.Has("silenceRuns") && options.Get("silenceRuns").IsBoolean()) {
+            silenceRuns = options.Get("silenceRuns").As<Napi::Boolean>().Value();
+        }
+        if (options.Has("adaptiveBatching") && options.Get("adaptiveBatching").IsBoolean()) {
+            adaptiveBatching = options.Get("adaptiveBatching").As<Napi::Boolean>().Value();
+        }
+        if (options.Has("minBatchMs") && options.Get("minBatchMs").IsNumber()) {
+            minBatchMs = options.Get("minBatchMs").As<Napi::Number>().Uint32Value();
+        }
+        if (options.Has("maxBatchMs") && options.Get("maxBatchMs").IsNumber()) {
+            maxBatchMs = options.Get("maxBatchMs").As<Napi::Number>().Uint32Value();
+        }
+    }
+    
+    if (speechGated && !hasVADStage_) {
+        Napi::Error::New(env, "speechGated requires the streaming VAD stage (enableStreamingVAD)")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (preRollMs > kMaxPreRollMs) {
+        Napi::RangeError::New(env, "preRollMs must be 0-5000").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (batchMs == 0 || batchMs > 1000 || maxQueuedBatches == 0) {
+        Napi::RangeError::New(env, "batchMs must be 1-1000 and maxQueuedBatches at least 1")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (adaptiveBatching && (minBatchMs == 0 || minBatchMs > maxBatchMs || maxBatchMs > 1000)) {
+        Napi::RangeError::New(env, "minBatchMs and maxBatchMs must satisfy 1 <= minBatchMs <= maxBatchMs <= 1000")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (!StreamingResampler::IsSupported(streamRate_, sampleRate)) {
+        Napi::RangeError::New(env, "sampleRate must divide the capture rate (e.g. 48000, 24000, 16000, 8000)")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    ReleaseFloat32Callback();
+    
+    std::lock_guard<std::mutex> lock(pushMutex_);
+    
+    pushResampler_.Configure(streamRate_, sampleRate);
+    // The queue holds maxQueuedBatches of the largest batch the controller may pick
+    pushBatching_.Configure(sampleRate, batchMs, minBatchMs, maxBatchMs, adaptiveBatching);
+    // Gated mode queues a whole pre-roll at once on top of the usual batches
+    size_t preRollSamples = speechGated ? static_cast<size_t>(sampleRate) * preRollMs / 1000 : 0;
+    pushRing_ = std::make_unique<SpscFloatRing>(pushBatching_.MaxSamples() * maxQueuedBatches + preRollSamples);
+    pushEncoding_ = encoding;
+    if (encoding != SampleEncoding::Float32) {
+        pushDrained_.resize(pushBatching_.MaxSamples());
+    }
+    pushReportedDrops_ = 0;
+    pushWrittenSamples_ = 0;
+    pushPoppedSamples_ = 0;
+    hasPendingPushVADRecord_ = false;
+    hasPendingPushFeatureRecord_ = false;
+    pushPending_ = false;
+    
+    pushGated_ = speechGated;
+    pushGateOpen_ = false;
+    pushPreRoll_.Resize(preRollSamples);
+    pushSegmentEnds_ = std::make_unique<SpscRingBuffer<uint64_t>>(kPushSegmentEndsCapacity);
+    hasPendingSegmentEnd_ = false;
+    pushSegmentStarting_ = true;
+    pushSilenceRuns_ = silenceRuns;
+    
+    // One record per 10ms VAD frame across the whole queue, plus slack
+    size_t queuedMs = static_cast<size_t>(adaptiveBatching ? maxBatchMs : batchMs) * maxQueuedBatches;
+    pushVADRecords_ = std::make_unique<SpscRingBuffer<PushVADRecord>>(queuedMs / 10 + 16);
+    pushVADBatchFlags_.reserve(queuedMs / 10 + 16);
+    pushFeatureRecords_ = std::make_unique<SpscRingBuffer<PushFeatureRecord>>(queuedMs / 10 + 16);
+    pushFeatureBatch_.reserve(queuedMs / 10 + 16);
+    
+    // One signal in flight at a time; the JS side drains every complete batch per call
+    pushCallback_ = Napi::ThreadSafeFunction::New(
+        env,
+        info[0].As<Napi::Function>(),
+        "AudioCaptureFloat32Callback",
+        1,
+        1
+    );
+    
+    hasPushCallback_ = true;
+    
+    return env.Undefined();
+}
+
+Napi::Value AudioCaptureWrapper::ClearFloat32Callback(const Napi::CallbackInfo& info) {
+    ReleaseFloat32Callback();
+    return info.Env().Undefined();
+}
+
+void AudioCaptureWrapper::ReleaseFloat32Callback(bool abort) {
+    std::lock_guard<std::mutex> lock(pushMutex_);
+    
+    hasPushCallback_ = false;
+    if (pushCallback_) {
+        if (abort) {
+            pushCallback_.Abort();
+        } else {
+            pushCallback_.Release();
+        }
+        pushCallback_ = Napi::ThreadSafeFunction();
+    }
+}
+
+void AudioCaptureWrapper::PushFloat32Batches(const ProcessedPacket& packet) {
+    if (!hasPushCallback_) return;
+    
+    // Never wait on the JS thread; skipping one packet during reconfiguration is fine
+    std::unique_lock<std::mutex> lock(pushMutex_, std::try_to_lock);
+    if (!lock.owns_lock() || !pushRing_ || !pushCallback_) return;
+    
+    // Downsample for this consumer if it asked for a lower rate
+    const float* data = nullptr;
+    size_t count = ResampleForConsumer(pushResampler_, pushUsedShared_, packet, data);
+    
+    // Speech gating follows the VAD's speaking state (after hold/release
+    // hysteresis) at the end of this packet; packets without frames keep it
+    bool segmentEnded = false;
+    if (pushGated_) {
+        bool speaking = packet.vadFrames > 0
+            ? (packet.vadFlags[packet.vadFrames - 1] & kVADFrameSpeaking) != 0
+            : pushGateOpen_;
+        
+        if (!pushGateOpen_ && !speaking) {
+            pushPreRoll_.Write(data, count);
+            return;
+        }
+        
+        if (!pushGateOpen_) {
+            // Onset: the pre-roll goes out ahead of the live audio
+            pushPreRoll_.Drain([this](const float* samples, size_t samplesCount) {
+                pushRing_->Push(samples, samplesCount);
+                pushWrittenSamples_ += samplesCount;
+            });
+            pushGateOpen_ = true;
+        }
+        
+        segmentEnded = !speaking;
+    }
+    
+    // A full ring overwrites the oldest batches and counts them as dropped
+    if (IsSilentOutput(packet, data, count)) {
+        pushRing_->PushZeros(count);
+    } else {
+        pushRing_->Push(data, count);
+    }
+    pushWrittenSamples_ += count;
+    metrics_.SetGauge(MetricGauge::PushBufferedSamples, pushRing_->Available());
+    
+    if (segmentEnded) {
+        // Deliver the segment's partial last batch without waiting for more audio
+        pushSegmentEnds_->Push(&pushWrittenSamples_, 1);
+        pushGateOpen_ = false;
+    }
+    
+    // Tag this packet's VAD frames with where its audio ends in the push stream
+    if (pushVADRecords_) {
+        for (size_t i = 0; i < packet.vadFrames; ++i) {
+            PushVADRecord record{pushWrittenSamples_, packet.vadFlags[i]};
+            pushVADRecords_->Push(&record, 1);
+        }
+    }
+    if (pushFeatureRecords_) {
+        for (size_t i = 0; i < packet.featureFrames; ++i) {
+            PushFeatureRecord record{pushWrittenSamples_, packet.features[i]};
+            pushFeatureRecords_->Push(&record, 1);
+        }
+    }
+    
+    if ((pushRing_->Available() < pushBatching_.TargetSamples() && !segmentEnded) || pushPending_.exchange(true)) {
+        return;
+    }
+    
+    auto callback = [this](Napi::Env env, Napi::Function jsCallback) {
+        if (env == nullptr) return;  // Aborted with the instance
+        DeliverFloat32Batches(env, jsCallback);
+    };
+    
+    pushSignalledAt_.store(MonotonicMicros(), std::memory_order_relaxed);
+    metrics_.AddGauge(MetricGauge::JSQueueDepth, 1);
+    if (pushCallback_.NonBlockingCall(callback) != napi_ok) {
+        // Queue full or closing: data stays in the ring for the next signal
+        pushPending_ = false;
+        metrics_.AddGauge(MetricGauge::JSQueueDepth, -1);
+        metrics_.Add(MetricCounter::PushSignalFailures);
+    }
+}
+
+void AudioCaptureWrapper::DeliverFloat32Batches(Napi::Env env, Napi::Function callback) {
+    // Wakeup latency: from the capture thread's signal to this JS turn
+    uint64_t signalledAt = pushSignalledAt_.load(std::memory_order_relaxed);
+    uint64_t now = MonotonicMicros();
+    uint64_t wakeup = now - std::min(signalledAt, now);
+    metrics_.Stage(MetricStage::BufferToJS).Record(wakeup);
+    metrics_.AddGauge(MetricGauge::JSQueueDepth, -1);
+    
+    // Allow the capture thread to signal again while we drain
+    pushPending_ = false;
+    
+    if (!pushRing_) return;
+    
+    // The event loop's lag sizes the following batches; this drain keeps one size
+    pushBatching_.Observe(wakeup, pushRing_->Available());
+    const size_t targetSamples = pushBatching_.TargetSamples();
+    
+    while (true) {
+        // Gated mode cuts the batch short where a speech segment ends
+        size_t batchSamples = targetSamples;
+        uint64_t readPosition = pushPoppedSamples_ + pushRing_->OverrunCount();
+        uint64_t segmentEnd = 0;
+        bool endsSegment = false;
+        if (pushGated_ && NextSegmentEnd(readPosition, segmentEnd) &&
+            segmentEnd - readPosition <= batchSamples) {
+            batchSamples = static_cast<size_t>(segmentEnd - readPosition);
+            endsSegment = true;
+        }
+        
+        if (pushRing_->Available() < batchSamples || batchSamples == 0) break;
+        
+        Napi::Value batch;
+        size_t copied = 0;
+        size_t silent = pushSilenceRuns_ ? pushRing_->SilentAvailable() : 0;
+        if (silent >= batchSamples) {
+            // Whole batches of digital silence go out as one duration, no samples
+            size_t run = endsSegment ? batchSamples : silent - silent % batchSamples;
+            copied = pushRing_->Skip(run);
+            batch = env.Null();
+        } else if (pushEncoding_ == SampleEncoding::Float32) {
+            Napi::Float32Array samples = Napi::Float32Array::New(env, batchSamples);
+            copied = pushRing_->Pop(samples.Data(), batchSamples);
+            if (copied < batchSamples) {
+                samples = Napi::Float32Array::New(env, copied, samples.ArrayBuffer(), 0);
+            }
+            batch = samples;
+        } else {
+            copied = pushRing_->Pop(pushDrained_.data(), batchSamples);
+            batch = EncodeSamples(env, pushDrained_.data(), copied, pushEncoding_);
+        }
+        if (copied == 0) break;
+        pushPoppedSamples_ += copied;
+        
+        uint64_t drops = pushRing_->OverrunCount();
+        
+        Napi::Object batchInfo = Napi::Object::New(env);
+        batchInfo.Set("sampleRate", Napi::Number::New(env, pushResampler_.OutputRate()));
+        batchInfo.Set("frames", Napi::Number::New(env, static_cast<double>(copied)));
+        batchInfo.Set("silent", Napi::Boolean::New(env, batch.IsNull()));
+        batchInfo.Set("droppedSamples", Napi::Number::New(env, static_cast<double>(drops - pushReportedDrops_)));
+        batchInfo.Set("totalDroppedSamples", Napi::Number::New(env, static_cast<double>(drops)));
+        pushReportedDrops_ = drops;
+        
+        if (hasVADStage_) {
+            // Ring read position: everything popped plus everything overwritten
+            batchInfo.Set("vad", CollectPushVADFlags(env, pushPoppedSamples_ + drops));
+        }
+        if (hasFeatureStage_) {
+            batchInfo.Set("features", CollectPushFeatures(env, pushPoppedSamples_ + drops));
+        }
+        
+        if (pushGated_) {
+            // Overwritten audio may have moved the read position past the end
+            endsSegment = endsSegment && pushPoppedSamples_ + drops >= segmentEnd;
+            if (endsSegment) {
+                hasPendingSegmentEnd_ = false;
+            }
+            batchInfo.Set("segmentStart", Napi::Boolean::New(env, pushSegmentStarting_));
+            batchInfo.Set("segmentEnd", Napi::Boolean::New(env, endsSegment));
+            pushSegmentStarting_ = endsSegment;
+        }
+        
+        callback.Call({batch, batchInfo});
+        if (env.IsExceptionPending()) break;
+    }
+}
+
+bool AudioCaptureWrapper::NextSegmentEnd(uint64_t readPosition, uint64_t& segmentEnd) {
+    // Ends the read position already reached (a batch boundary, or audio lost
+    // to overwrites) are skipped, but whatever is read next opens a segment
+    while (true) {
+        if (!hasPendingSegmentEnd_) {
+            if (!pushSegmentEnds_ || pushSegmentEnds_->Pop(&pendingSegmentEnd_, 1) == 0) {
+                return false;
+            }
+            hasPendingSegmentEnd_ = true;
+        }
+        
+        if (pendingSegmentEnd_ > readPosition) {
+            segmentEnd = pendingSegmentEnd_;
+            return true;
+        }
+        hasPendingSegmentEnd_ = false;
+        pushSegmentStarting_ = true;
+    }
+}
+
+Napi::Value AudioCaptureWrapper::EncodeSamples(Napi::Env env, const float* samples, size_t count,
+                                               SampleEncoding encoding) {
+    if (encoding == SampleEncoding::Pcm16) {
+        // Convert straight into the Buffer's storage
+        Napi::Buffer<uint8_t> bytes = Napi::Buffer<uint8_t>::New(env, count * sizeof(int16_t));
+        SimdKernels::FloatToInt16(samples, reinterpret_cast<int16_t*>(bytes.Data()), count);
+        return bytes;
+    }
+    
+    if (encoding == SampleEncoding::Base64) {
+        // One fused pass into reusable scratch; V8 copies the ASCII once
+        base64Text_.resize(SimdKernels::Base64EncodedLength(count * sizeof(int16_t)));
+        SimdKernels::FloatToPcm16Base64(samples, count, base64Text_.data());
+        return Napi::String::New(env, base64Text_.data(), base64Text_.size());
+    }
+    
+    Napi::Float32Array copy = Napi::Float32Array::New(env, count);
+    std::copy(samples, samples + count, copy.Data());
+    return copy;
+}
+
+Napi::Value AudioCaptureWrapper::EncodePcm16(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsTypedArray() ||
+        info[0].As<Napi::TypedArray>().TypedArrayType() != napi_float32_array) {
+        Napi::TypeError::New(env, "Expected Float32Array as first argument")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Second argument: 'base64' (default) or 'pcm16' for a Buffer of PCM16 bytes
+    SampleEncoding encoding = SampleEncoding::Base64;
+    if (info.Length() >= 2 && info[1].IsString() &&
+        (!ParseSampleEncoding(info[1].As<Napi::String>().Utf8Value(), encoding) ||
+         encoding == SampleEncoding::Float32)) {
+        Napi::RangeError::New(env, "encoding must be 'pcm16' or 'base64'").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    Napi::Float32Array samples = info[0].As<Napi::Float32Array>();
+    return EncodeSamples(env, samples.Data(), samples.ElementLength(), encoding);
+}
+
+Napi::Value AudioCaptureWrapper::CollectPushVADFlags(Napi::Env env, uint64_t batchEnd) {
+    pushVADBatchFlags_.clear();
+    
+    // Frames whose audio ends inside this batch (or in audio that was dropped)
+    PushVADRecord record;
+    while (pushVADRecords_) {
+        if (hasPendingPushVADRecord_) {
+            record = pendingPushVADRecord_;
+        } else if (pushVADRecords_->Pop(&record, 1) == 0) {
+            break;
+        }
+        
+        if (record.endSample > batchEnd) {
+            pendingPushVADRecord_ = record;
+            hasPendingPushVADRecord_ = true;
+            break;
+        }
+        
+        hasPendingPushVADRecord_ = false;
+        pushVADBatchFlags_.push_back(record.flags);
+    }
+    
+    return CreateVADResult(env, pushVADBatchFlags_.data(), pushVADBatchFlags_.size(), pushVADSpeaking_);
+}
+
+Napi::Value AudioCaptureWrapper::CollectPushFeatures(Napi::Env env, uint64_t batchEnd) {
+    pushFeatureBatch_.clear();
+    
+    // Frames whose audio ends inside this batch (or in audio that was dropped)
+    PushFeatureRecord record;
+    while (pushFeatureRecords_) {
+        if (hasPendingPushFeatureRecord_) {
+            record = pendingPushFeatureRecord_;
+        } else if (pushFeatureRecords_->Pop(&record, 1) == 0) {
+            break;
+        }
+        
+        if (record.endSample > batchEnd) {
+            pendingPushFeatureRecord_ = record;
+            hasPendingPushFeatureRecord_ = true;
+            break;
+        }
+        
+        hasPendingPushFeatureRecord_ = false;
+        pushFeatureBatch_.push_back(record.features);
+    }
+    
+    return CreateFeatureResult(env, pushFeatureBatch_.data(), pushFeatureBatch_.size());
+}
+
+Napi::Value AudioCaptureWrapper::SetOpusCallback(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsFunction()) {
+        Napi::TypeError::New(env, "Expected callback function").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (!StreamingOpusEncoder::IsAvailable()) {
+        Napi::Error::New(env, "This build has no Opus support").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Parse options: { bitrate, frameMs, sampleRate, complexity, application, maxQueuedPackets }
+    OpusEncoderConfig config;
+    uint32_t sampleRate = streamRate_;  // Every capture rate is an Opus rate
+    uint32_t maxQueuedPackets = kDefaultOpusMaxQueuedPackets;
+    
+    if (info.Length() >= 2 && info[1].IsObject()) {
+        Napi::Object options = info[1].As<Napi::Object>();
+        if (options.Has("bitrate") && options.Get("bitrate").IsNumber()) {
+            config.bitrate = options.Get("bitrate").As<Napi::Number>().Uint32Value();
+        }
+        if (options.Has("frameMs") && options.Get("frameMs").IsNumber()) {
+            config.frameMs = options.Get("frameMs").As<Napi::Number>().Uint32Value();
+        }
+        if (options.Has("sampleRate") && options.Get("sampleRate").IsNumber()) {
+            sampleRate = options.Get("sampleRate").As<Napi::Number>().Uint32Value();
+        }
+        if (options.Has("complexity") && options.Get("complexity").IsNumber()) {
+            config.complexity = options.Get("complexity").As<Napi::Number>().Int32Value();
+        }
+        if (options.Has("application") && options.Get("application").IsString()) {
+            config.voip = options.Get("application").As<Napi::String>().Utf8Value() != "audio";
+        }
+        if (options.Has("maxQueuedPackets") && options.Get("maxQueuedPackets").IsNumber()) {
+            maxQueuedPackets = options.Get("maxQueuedPackets").As<Napi::Number>().Uint32Value();
+        }
+    }
+    
+    if (!StreamingOpusEncoder::IsSupportedRate(sampleRate) ||
+        !StreamingResampler::IsSupported(streamRate_, sampleRate)) {
+        Napi::RangeError::New(env, "Opus sampleRate must be 8000, 12000, 16000, 24000 or 48000 and divide the capture rate")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (maxQueuedPackets == 0) {
+        Napi::RangeError::New(env, "maxQueuedPackets must be at least 1").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    ReleaseOpusCallback();
+    
+    std::lock_guard<std::mutex> lock(opusMutex_);
+    
+    try {
+        opusEncoder_.Configure(sampleRate, config);
+    } catch (const std::exception& e) {
+        Napi::Error::New(env, std::string("Failed to create Opus encoder: ") + e.what())
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    opusResampler_.Configure(streamRate_, sampleRate);
+    opusUsedShared_ = false;
+    opusPackets_ = std::make_unique<SpscRingBuffer<OpusPacket>>(maxQueuedPackets);
+    opusDrained_.resize(opusPackets_->Capacity());
+    opusReportedDrops_ = 0;
+    opusPending_ = false;
+    
+    // One signal in flight at a time; the JS side drains every queued packet per call
+    opusCallback_ = Napi::ThreadSafeFunction::New(
+        env,
+        info[0].As<Napi::Function>(),
+        "AudioCaptureOpusCallback",
+        1,
+        1
+    );
+    
+    hasOpusCallback_ = true;
+    
+    return env.Undefined();
+}
+
+Napi::Value AudioCaptureWrapper::ClearOpusCallback(const Napi::CallbackInfo& info) {
+    ReleaseOpusCallback();
+    return info.Env().Undefined();
+}
+
+Napi::Value AudioCaptureWrapper::IsOpusAvailable(const Napi::CallbackInfo& info) {
+    return Napi::Boolean::New(info.Env(), StreamingOpusEncoder::IsAvailable());
+}
+
+void AudioCaptureWrapper::ReleaseOpusCallback(bool abort) {
+    std::lock_guard<std::mutex> lock(opusMutex_);
+    
+    hasOpusCallback_ = false;
+    if (opusCallback_) {
+        if (abort) {
+            opusCallback_.Abort();
+        } else {
+            opusCallback_.Release();
+        }
+        opusCallback_ = Napi::ThreadSafeFunction();
+    }
+}
+
+void AudioCaptureWrapper::EncodeOpusPackets(const ProcessedPacket& packet) {
+    if (!hasOpusCallback_) return;
+    
+    // Never wait on the JS thread; skipping one packet during reconfiguration is fine
+    std::unique_lock<std::mutex> lock(opusMutex_, std::try_to_lock);
+    if (!lock.owns_lock() || !opusPackets_ || !opusCallback_ || !opusEncoder_.IsConfigured()) return;
+    
+    const float* data = nullptr;
+    size_t count = ResampleForConsumer(opusResampler_, opusUsedShared_, packet, data);
+    
+    size_t capacity = opusEncoder_.MaxPacketsFor(count);
+    if (capacity == 0) {
+        // Still buffering a partial frame
+        opusEncoder_.Process(data, count, packet.timestamp, nullptr, 0);
+        return;
+    }
+    
+    OpusPacket* encoded = scratch_.Get<OpusPacket>(ScratchSlot::Encode, capacity);
+    size_t packets = opusEncoder_.Process(data, count, packet.timestamp, encoded, capacity);
+    
+    // A full queue overwrites the oldest packets and counts them as dropped
+    opusPackets_->Push(encoded, packets);
+    
+    if (packets == 0 || opusPending_.exchange(true)) {
+        return;
+    }
+    
+    auto callback = [this](Napi::Env env, Napi::Function jsCallback) {
+        if (env == nullptr) return;  // Aborted with the instance
+        DeliverOpusPackets(env, jsCallback);
+    };
+    
+    if (opusCallback_.NonBlockingCall(callback) != napi_ok) {
+        // Queue full or closing: packets stay queued for the next signal
+        opusPending_ = false;
+    }
+}
+
+void AudioCaptureWrapper::DeliverOpusPackets(Napi::Env env, Napi::Function callback) {
+    // Allow the capture thread to signal again while we drain
+    opusPending_ = false;
+    
+    if (!opusPackets_) return;
+    
+    size_t count = opusPackets_->Pop(opusDrained_.data(), opusDrained_.size());
+    if (count == 0) return;
+    
+    Napi::Array packets = Napi::Array::New(env, count);
+    for (size_t i = 0; i < count; ++i) {
+        const OpusPacket& packet = opusDrained_[i];
+        
+        Napi::Object packetObj = Napi::Object::New(env);
+        packetObj.Set("data", Napi::Buffer<uint8_t>::Copy(env, packet.data, packet.size));
+        packetObj.Set("timestamp", Napi::Number::New(env, static_cast<double>(packet.timestamp)));
+        packetObj.Set("position", Napi::Number::New(env, static_cast<double>(packet.position)));
+        packets[i] = packetObj;
+    }
+    
+    uint64_t drops = opusPackets_->OverrunCount();
+    
+    Napi::Object packetInfo = Napi::Object::New(env);
+    packetInfo.Set("sampleRate", Napi::Number::New(env, opusEncoder_.SampleRate()));
+    packetInfo.Set("frameMs", Napi::Number::New(env, opusEncoder_.Config().frameMs));
+    packetInfo.Set("droppedPackets", Napi::Number::New(env, static_cast<double>(drops - opusReportedDrops_)));
+    packetInfo.Set("totalDroppedPackets", Napi::Number::New(env, static_cast<double>(drops)));
+    opusReportedDrops_ = drops;
+    
+    callback.Call({packets, packetInfo});
+}
+
+Napi::Value AudioCaptureWrapper::StartRecording(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (info.Length() < 1 || !info[0].IsObject()) {
+        Napi::TypeError::New(env, "Expected recording options object").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Parse options: { path, format, encoding, rotateBytes, rotateSeconds, syncIntervalMs,
+    //                  writeBytes, queueMs, bitrate, frameMs }
+    Napi::Object options = info[0].As<Napi::Object>();
+    RecordingOptions config;
+    config.sampleRate = streamRate_;
+    
+    if (!options.Has("path") || !options.Get("path").IsString()) {
+        Napi::TypeError::New(env, "Recording options need a path string").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    config.path = options.Get("path").As<Napi::String>().Utf8Value();
+    
+    if (options.Has("format") && options.Get("format").IsString()) {
+        std::string format = options.Get("format").As<Napi::String>().Utf8Value();
+        if (format == "wav") {
+            config.format = RecordingFormat::Wav;
+        } else if (format == "raw") {
+            config.format = RecordingFormat::Raw;
+        } else if (format == "opus") {
+            config.format = RecordingFormat::OggOpus;
+        } else {
+            Napi::TypeError::New(env, "Recording format must be 'wav', 'raw' or 'opus'").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+    }
+    if (options.Has("encoding") && options.Get("encoding").IsString()) {
+        std::string encoding = options.Get("encoding").As<Napi::String>().Utf8Value();
+        if (encoding != "pcm16" && encoding != "float32") {
+            Napi::TypeError::New(env, "Recording encoding must be 'pcm16' or 'float32'").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        config.float32 = encoding == "float32";
+    }
+    if (options.Has("rotateBytes") && options.Get("rotateBytes").IsNumber()) {
+        config.rotateBytes = static_cast<uint64_t>(options.Get("rotateBytes").As<Napi::Number>().Int64Value());
+    }
+    if (options.Has("rotateSeconds") && options.Get("rotateSeconds").IsNumber()) {
+        config.rotateSeconds = options.Get("rotateSeconds").As<Napi::Number>().Uint32Value();
+    }
+    if (options.Has("syncIntervalMs") && options.Get("syncIntervalMs").IsNumber()) {
+        config.syncIntervalMs = options.Get("syncIntervalMs").As<Napi::Number>().Uint32Value();
+    }
+    if (options.Has("writeBytes") && options.Get("writeBytes").IsNumber()) {
+        config.writeBytes = options.Get("writeBytes").As<Napi::Number>().Uint32Value();
+    }
+    if (options.Has("queueMs") && options.Get("queueMs").IsNumber()) {
+        config.queueMs = options.Get("queueMs").As<Napi::Number>().Uint32Value();
+    }
+    if (options.Has("bitrate") && options.Get("bitrate").IsNumber()) {
+        config.opus.bitrate = options.Get("bitrate").As<Napi::Number>().Uint32Value();
+    }
+    if (options.Has("frameMs") && options.Get("frameMs").IsNumber()) {
+        config.opus.frameMs = options.Get("frameMs").As<Napi::Number>().Uint32Value();
+    }
+    
+    if (config.queueMs < 100 || config.queueMs > 60000) {
+        Napi::RangeError::New(env, "queueMs must be 100-60000").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::lock_guard<std::mutex> lock(recordMutex_);
+    
+    hasRecorder_ = false;
+    recorder_.Stop();
+    
+    std::string error;
+    if (!recorder_.Start(config, error)) {
+        Napi::Error::New(env, "Failed to start recording: " + error).ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    hasRecorder_ = true;
+    
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value AudioCaptureWrapper::StopRecording(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    // Waits for the I/O thread to write out what is queued and close the file
+    {
+        std::lock_guard<std::mutex> lock(recordMutex_);
+        hasRecorder_ = false;
+        recorder_.Stop();
+    }
+    
+    return CreateRecordingResult(env);
+}
+
+Napi::Value AudioCaptureWrapper::GetRecordingStats(const Napi::CallbackInfo& info) {
+    return CreateRecordingResult(info.Env());
+}
+
+Napi::Object AudioCaptureWrapper::CreateRecordingResult(Napi::Env env) {
+    RecordingStats stats = recorder_.Stats();
+    std::vector<std::string> files = recorder_.Files();
+    
+    Napi::Array fileList = Napi::Array::New(env, files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        fileList[i] = Napi::String::New(env, files[i]);
+    }
+    
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("recording", Napi::Boolean::New(env, recorder_.IsRecording()));
+    result.Set("files", fileList);
+    result.Set("samples", Napi::Number::New(env, static_cast<double>(stats.samples)));
+    result.Set("droppedSamples", Napi::Number::New(env, static_cast<double>(stats.droppedSamples)));
+    result.Set("bytesWritten", Napi::Number::New(env, static_cast<double>(stats.bytesWritten)));
+    result.Set("writes", Napi::Number::New(env, static_cast<double>(stats.writes)));
+    result.Set("syncs", Napi::Number::New(env, static_cast<double>(stats.syncs)));
+    
+    std::string error = recorder_.LastError();
+    if (!error.empty()) {
+        result.Set("error", Napi::String::New(env, error));
+    }
+    return result;
+}
+
+// WebRTC VAD method implementations
+Napi::Value AudioCaptureWrapper::CreateVAD(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    // Parse arguments: createVAD(sampleRate, mode)
+    int sampleRate = 48000;  // Default
+    int mode = 2;            // Default aggressive mode
+    
+    if (info.Length() >= 1 && info[0].IsNumber()) {
+        sampleRate = info[0].As<Napi::Number>().Int32Value();
+    }
+    
+    if (info.Length() >= 2 && info[1].IsNumber()) {
+        mode = info[1].As<Napi::Number>().Int32Value();
+    }
+    
+    try {
+        vad_ = std::make_unique<WebRTCVAD::VADWrapper>(sampleRate, mode);
+        return Napi::Boolean::New(env, true);
+    } catch (const std::exception& e) {
+        Napi::Error::New(env, std::string("Failed to create VAD: ") + e.what())
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value AudioCaptureWrapper::ProcessVAD(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!vad_) {
+        Napi::Error::New(env, "VAD not initialized. Call createVAD() first.")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    if (info.Length() < 1 || !info[0].IsBuffer()) {
+        Napi::TypeError::New(env, "Expected audio buffer as first argument")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Get the audio buffer (expects Int16Array/Buffer)
     Napi::Buffer<int16_t> buffer = info[0].As<Napi::Buffer<int16_t>>();
     
     int result = vad_->Process(buffer.Data(), buffer.Length());
@@ -458,6 +2509,53 @@ Napi::Value AudioCaptureWrapper::ProcessVAD(const Napi::CallbackInfo& info) {
     return Napi::Boolean::New(env, result == 1);
 }
 
+Napi::Value AudioCaptureWrapper::ProcessVADBatch(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!vad_) {
+        Napi::Error::New(env, "VAD not initialized. Call createVAD() first.")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Parse arguments: processVADBatch(pcm16 Buffer | Int16Array | Float32Array, frameMs = 20)
+    int frameMs = 20;
+    if (info.Length() >= 2 && info[1].IsNumber()) {
+        frameMs = info[1].As<Napi::Number>().Int32Value();
+    }
+    
+    if (frameMs != 10 && frameMs != 20 && frameMs != 30) {
+        Napi::RangeError::New(env, "frameMs must be 10, 20 or 30")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Float input skips the JS floatToPcm16 pass entirely
+    const int16_t* pcm16 = nullptr;
+    const float* float32 = nullptr;
+    size_t length = 0;
+    
+    if (info.Length() < 1 || !GetVADAudio(info[0], pcm16, float32, length)) {
+        Napi::TypeError::New(env, "Expected PCM16 Buffer, Int16Array or Float32Array")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // One decision byte per completed frame; partial frames carry to the next call
+    Napi::Uint8Array decisions = Napi::Uint8Array::New(env, vad_->GetBatchFrameCount(length, frameMs));
+    int frames = float32
+        ? vad_->ProcessBatch(float32, length, frameMs, decisions.Data(), decisions.ElementLength())
+        : vad_->ProcessBatch(pcm16, length, frameMs, decisions.Data(), decisions.ElementLength());
+    
+    if (frames < 0) {
+        Napi::Error::New(env, "VAD batch processing failed")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return decisions;
+}
+
 Napi::Value AudioCaptureWrapper::SetVADMode(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
     
@@ -492,6 +2590,375 @@ Napi::Value AudioCaptureWrapper::ResetVAD(const Napi::CallbackInfo& info) {
     return env.Undefined();
 }
 
+Napi::Value AudioCaptureWrapper::CreateVADEngine(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    // Parse options: { streams = 64, threads = VADEngine::DefaultWorkerThreads() }
+    size_t streams = 64;
+    size_t threads = WebRTCVAD::VADEngine::DefaultWorkerThreads();
+    
+    if (info.Length() >= 1 && info[0].IsObject()) {
+        Napi::Object options = info[0].As<Napi::Object>();
+        if (options.Has("streams") && options.Get("streams").IsNumber()) {
+            int64_t value = options.Get("streams").As<Napi::Number>().Int64Value();
+            if (value < 1 || value > static_cast<int64_t>(WebRTCVAD::VADEngine::MAX_STREAMS)) {
+                Napi::RangeError::New(env, "streams must be 1-4096")
+                    .ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            streams = static_cast<size_t>(value);
+        }
+        if (options.Has("threads") && options.Get("threads").IsNumber()) {
+            int64_t value = options.Get("threads").As<Napi::Number>().Int64Value();
+            if (value < 0 || value > static_cast<int64_t>(WebRTCVAD::VADEngine::MAX_WORKER_THREADS)) {
+                Napi::RangeError::New(env, "threads must be 0-16")
+                    .ThrowAsJavaScriptException();
+                return env.Null();
+            }
+            threads = static_cast<size_t>(value);
+        }
+    }
+    
+    try {
+        // Replacing the engine closes every stream of the old one
+        vadEngine_.reset();
+        vadEngine_ = std::make_unique<WebRTCVAD::VADEngine>(streams, threads);
+        return Napi::Boolean::New(env, true);
+    } catch (const std::exception& e) {
+        Napi::Error::New(env, std::string("Failed to create VAD engine: ") + e.what())
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+}
+
+Napi::Value AudioCaptureWrapper::OpenVADStream(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!vadEngine_) {
+        Napi::Error::New(env, "VAD engine not initialized. Call createVADEngine() first.")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Parse arguments: openVADStream(sampleRate = 48000, mode = 2)
+    int sampleRate = 48000;
+    int mode = 2;
+    
+    if (info.Length() >= 1 && info[0].IsNumber()) {
+        sampleRate = info[0].As<Napi::Number>().Int32Value();
+    }
+    
+    if (info.Length() >= 2 && info[1].IsNumber()) {
+        mode = info[1].As<Napi::Number>().Int32Value();
+    }
+    
+    if ((sampleRate != 8000 && sampleRate != 16000 && sampleRate != 32000 && sampleRate != 48000) ||
+        mode < 0 || mode > 3) {
+        Napi::RangeError::New(env, "sampleRate must be 8000, 16000, 32000 or 48000 and mode 0-3")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    int stream = vadEngine_->OpenStream(sampleRate, mode);
+    if (stream < 0) {
+        Napi::Error::New(env, "Every VAD engine stream is in use")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return Napi::Number::New(env, stream);
+}
+
+Napi::Value AudioCaptureWrapper::CloseVADStream(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!vadEngine_ || info.Length() < 1 || !info[0].IsNumber()) {
+        return Napi::Boolean::New(env, false);
+    }
+    
+    return Napi::Boolean::New(env, vadEngine_->CloseStream(info[0].As<Napi::Number>().Uint32Value()));
+}
+
+Napi::Value AudioCaptureWrapper::ResetVADStream(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!vadEngine_ || info.Length() < 1 || !info[0].IsNumber()) {
+        return Napi::Boolean::New(env, false);
+    }
+    
+    return Napi::Boolean::New(env, vadEngine_->ResetStream(info[0].As<Napi::Number>().Uint32Value()));
+}
+
+Napi::Value AudioCaptureWrapper::ProcessVADFrames(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!vadEngine_) {
+        Napi::Error::New(env, "VAD engine not initialized. Call createVADEngine() first.")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Parse arguments: processVADFrames(streams Uint32Array,
+    //                                   audio Int16Array | Float32Array | pcm16 Buffer, frameMs = 20)
+    if (info.Length() < 2 || !info[0].IsTypedArray() ||
+        info[0].As<Napi::TypedArray>().TypedArrayType() != napi_uint32_array) {
+        Napi::TypeError::New(env, "Expected a Uint32Array of stream ids and the frames' audio")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    int frameMs = 20;
+    if (info.Length() >= 3 && info[2].IsNumber()) {
+        frameMs = info[2].As<Napi::Number>().Int32Value();
+    }
+    
+    if (frameMs != 10 && frameMs != 20 && frameMs != 30) {
+        Napi::RangeError::New(env, "frameMs must be 10, 20 or 30")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    const int16_t* pcm16 = nullptr;
+    const float* float32 = nullptr;
+    size_t length = 0;
+    
+    if (!GetVADAudio(info[1], pcm16, float32, length)) {
+        Napi::TypeError::New(env, "Expected PCM16 Buffer, Int16Array or Float32Array audio")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Frames are back to back in audio, each frameMs long at its stream's rate
+    Napi::Uint32Array streams = info[0].As<Napi::Uint32Array>();
+    const size_t count = streams.ElementLength();
+    vadEngineFrames_.resize(count);
+    
+    size_t offset = 0;
+    for (size_t i = 0; i < count; ++i) {
+        size_t frameLength = vadEngine_->FrameLength(streams[i], frameMs);
+        if (frameLength == 0) {
+            Napi::RangeError::New(env, "VAD stream " + std::to_string(streams[i]) + " is not open")
+                .ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        
+        WebRTCVAD::VADFrame& frame = vadEngineFrames_[i];
+        frame.stream = streams[i];
+        frame.pcm16 = pcm16 ? pcm16 + offset : nullptr;
+        frame.float32 = float32 ? float32 + offset : nullptr;
+        frame.length = frameLength;
+        offset += frameLength;
+    }
+    
+    if (offset != length) {
+        Napi::RangeError::New(env, "Audio length does not match one frameMs frame per stream id")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // One decision per frame: 1 = speech, 0 = no speech
+    Napi::Int8Array decisions = Napi::Int8Array::New(env, count);
+    size_t processed = vadEngine_->ProcessFrames(vadEngineFrames_.data(), count, decisions.Data());
+    if (processed != count) {
+        Napi::Error::New(env, "VAD engine processing failed")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    return decisions;
+}
+
+Napi::Value AudioCaptureWrapper::EnableStreamingVAD(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    // Parse options: { mode, frameMs, holdMs, releaseMs, sampleRate }
+    StreamingVADConfig config;
+    uint32_t streamRate = streamRate_;
+    uint32_t sampleRate = (streamRate == 16000 || streamRate == kCaptureSampleRate) ? streamRate : 8000;
+    
+    if (info.Length() >= 1 && info[0].IsObject()) {
+        Napi::Object options = info[0].As<Napi::Object>();
+        if (options.Has("mode") && options.Get("mode").IsNumber()) {
+            config.mode = options.Get("mode").As<Napi::Number>().Int32Value();
+        }
+        if (options.Has("frameMs") && options.Get("frameMs").IsNumber()) {
+            config.frameMs = options.Get("frameMs").As<Napi::Number>().Uint32Value();
+        }
+        if (options.Has("holdMs") && options.Get("holdMs").IsNumber()) {
+            config.holdMs = options.Get("holdMs").As<Napi::Number>().Uint32Value();
+        }
+        if (options.Has("releaseMs") && options.Get("releaseMs").IsNumber()) {
+            config.releaseMs = options.Get("releaseMs").As<Napi::Number>().Uint32Value();
+        }
+        if (options.Has("sampleRate") && options.Get("sampleRate").IsNumber()) {
+            sampleRate = options.Get("sampleRate").As<Napi::Number>().Uint32Value();
+        }
+    }
+    
+    if ((sampleRate != 8000 && sampleRate != 16000 && sampleRate != kCaptureSampleRate) ||
+        !StreamingResampler::IsSupported(streamRate, sampleRate)) {
+        Napi::RangeError::New(env, "VAD sampleRate must be 8000, 16000 or 48000 and divide the capture rate")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::lock_guard<std::mutex> lock(vadStageMutex_);
+    
+    try {
+        vadStage_.Configure(sampleRate, config);
+    } catch (const std::exception& e) {
+        Napi::Error::New(env, std::string("Failed to create VAD: ") + e.what())
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    vadDecimator_.Configure(streamRate, sampleRate);
+    
+    // Start from a clean slate for both consumers
+    vadFlags_.Clear();
+    pullVADSpeaking_ = false;
+    pushVADSpeaking_ = false;
+    hasVADStage_ = true;
+    
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value AudioCaptureWrapper::DisableStreamingVAD(const Napi::CallbackInfo& info) {
+    hasVADStage_ = false;
+    
+    std::lock_guard<std::mutex> lock(vadStageMutex_);
+    vadStage_ = StreamingVAD();
+    vadDecimator_.Configure(streamRate_, streamRate_);
+    
+    return info.Env().Undefined();
+}
+
+Napi::Value AudioCaptureWrapper::GetVADDecisions(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!hasVADStage_) {
+        Napi::Error::New(env, "Streaming VAD not enabled. Call enableStreamingVAD() first.")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Everything decided since the previous call, oldest first
+    size_t count = vadFlags_.Pop(pullVADFlags_.data(), pullVADFlags_.size());
+    return CreateVADResult(env, pullVADFlags_.data(), count, pullVADSpeaking_);
+}
+
+Napi::Value AudioCaptureWrapper::CreateVADResult(Napi::Env env, const uint8_t* flags, size_t count,
+                                                 bool& speaking) {
+    Napi::Uint8Array frames = Napi::Uint8Array::New(env, count);
+    bool speechStarted = false;
+    bool speechEnded = false;
+    
+    for (size_t i = 0; i < count; ++i) {
+        frames[i] = flags[i];
+        speechStarted = speechStarted || (flags[i] & kVADFrameSpeechStart);
+        speechEnded = speechEnded || (flags[i] & kVADFrameSpeechEnd);
+    }
+    
+    // Without new frames the consumer's last known state still holds
+    if (count > 0) {
+        speaking = (flags[count - 1] & kVADFrameSpeaking) != 0;
+    }
+    
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("frames", frames);
+    result.Set("frameMs", Napi::Number::New(env, vadStage_.Config().frameMs));
+    result.Set("sampleRate", Napi::Number::New(env, vadStage_.SampleRate()));
+    result.Set("speaking", Napi::Boolean::New(env, speaking));
+    result.Set("speechStarted", Napi::Boolean::New(env, speechStarted));
+    result.Set("speechEnded", Napi::Boolean::New(env, speechEnded));
+    return result;
+}
+
+Napi::Value AudioCaptureWrapper::EnableSpectralFeatures(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    // Parse options: { frameMs, sampleRate }
+    SpectralFeaturesConfig config;
+    uint32_t streamRate = streamRate_;
+    uint32_t sampleRate = StreamingResampler::IsSupported(streamRate, 16000) ? 16000 : 8000;
+    
+    if (info.Length() >= 1 && info[0].IsObject()) {
+        Napi::Object options = info[0].As<Napi::Object>();
+        if (options.Has("frameMs") && options.Get("frameMs").IsNumber()) {
+            config.frameMs = options.Get("frameMs").As<Napi::Number>().Uint32Value();
+        }
+        if (options.Has("sampleRate") && options.Get("sampleRate").IsNumber()) {
+            sampleRate = options.Get("sampleRate").As<Napi::Number>().Uint32Value();
+        }
+    }
+    
+    if ((sampleRate != 8000 && sampleRate != 16000 && sampleRate != kCaptureSampleRate) ||
+        !StreamingResampler::IsSupported(streamRate, sampleRate)) {
+        Napi::RangeError::New(env, "Feature sampleRate must be 8000, 16000 or 48000 and divide the capture rate")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    std::lock_guard<std::mutex> lock(featureStageMutex_);
+    
+    try {
+        featureStage_.Configure(sampleRate, config);
+    } catch (const std::exception& e) {
+        Napi::Error::New(env, std::string("Failed to create feature stage: ") + e.what())
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    featureResampler_.Configure(streamRate, sampleRate);
+    featureUsedShared_ = false;
+    
+    // Start from a clean slate for both consumers
+    featureFrames_.Clear();
+    hasFeatureStage_ = true;
+    
+    return Napi::Boolean::New(env, true);
+}
+
+Napi::Value AudioCaptureWrapper::DisableSpectralFeatures(const Napi::CallbackInfo& info) {
+    hasFeatureStage_ = false;
+    
+    std::lock_guard<std::mutex> lock(featureStageMutex_);
+    featureStage_ = StreamingSpectralAnalyzer();
+    featureResampler_.Configure(streamRate_, streamRate_);
+    
+    return info.Env().Undefined();
+}
+
+Napi::Value AudioCaptureWrapper::GetSpectralFeatures(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    
+    if (!hasFeatureStage_) {
+        Napi::Error::New(env, "Spectral features not enabled. Call enableSpectralFeatures() first.")
+            .ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    
+    // Everything analysed since the previous call, oldest first
+    size_t count = featureFrames_.Pop(pullFeatureFrames_.data(), pullFeatureFrames_.size());
+    return CreateFeatureResult(env, pullFeatureFrames_.data(), count);
+}
+
+Napi::Value AudioCaptureWrapper::CreateFeatureResult(Napi::Env env, const SpectralFrame* frames, size_t count) {
+    // SpectralFrame is packed floats, so the frames copy straight in
+    Napi::Float32Array values = Napi::Float32Array::New(env, count * SpectralFrame::COUNT);
+    if (count > 0) {
+        std::memcpy(values.Data(), frames, count * sizeof(SpectralFrame));
+    }
+    
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("frames", Napi::Number::New(env, static_cast<double>(count)));
+    result.Set("stride", Napi::Number::New(env, static_cast<double>(SpectralFrame::COUNT)));
+    result.Set("values", values);
+    result.Set("frameMs", Napi::Number::New(env, featureStage_.Config().frameMs));
+    result.Set("sampleRate", Napi::Number::New(env, featureStage_.SampleRate()));
+    return result;
+}
+
 // Initialize the addon
 Napi::Object Init(Napi::Env env, Napi::Object exports) {
     return AudioCaptureWrapper::Init(env, exports);
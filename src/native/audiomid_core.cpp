@@ -0,0 +1,368 @@
+#include "audiomid_core.h"
+#include "audio-capture/audio_format_converter.h"
+#include "audio-capture/audio_format_kernels.h"
+#include "audio-capture/capture_engine.h"
+#include "audio-capture/streaming_resampler.h"
+#include "webrtc-vad/vad_engine.h"
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+using AudioCapture::BroadcastFloatRing;
+using AudioCapture::CaptureEngine;
+using AudioCapture::EnginePacket;
+
+// Engine consumer behind the C handle: reads the gated stream through its own
+// cursor and optionally forwards every gated packet to a callback
+struct AudiomidCapture final : public AudioCapture::CaptureEngineConsumer {
+    std::shared_ptr<CaptureEngine> engine;
+    std::shared_ptr<BroadcastFloatRing> stream;  // Keeps the cursor's ring alive
+    std::unique_ptr<BroadcastFloatRing::Cursor> cursor;
+    AudiomidAudioCallback callback = nullptr;   // Changed only while stopped
+    void* userData = nullptr;
+    std::string lastError;
+
+    void OnEnginePacket(const EnginePacket& packet) override {
+        if (callback && packet.gateOpen && packet.frames > 0) {
+            callback(userData, packet.samples, packet.frames, packet.timestamp);
+        }
+    }
+
+    // Stream samples carry no per-consumer state tied to the rate
+    bool AcceptsStreamRate(uint32_t) const override { return true; }
+    void OnStreamRateChanged(uint32_t) override {}
+
+    int Fail(const std::string& error) {
+        lastError = error;
+        return -1;
+    }
+
+    // From a catch block: record what was thrown without throwing again
+    int FailCaught() noexcept {
+        try {
+            try {
+                throw;
+            } catch (const std::exception& e) {
+                lastError = e.what();
+            } catch (...) {
+                lastError = "Unknown error";
+            }
+        } catch (...) {
+            lastError.clear();
+        }
+        return -1;
+    }
+};
+
+struct AudiomidVad {
+    explicit AudiomidVad(size_t maxStreams, size_t workerThreads)
+        : engine(maxStreams, workerThreads) {
+    }
+
+    WebRTCVAD::VADEngine engine;
+    std::vector<WebRTCVAD::VADFrame> frames;  // Scratch for audiomid_vad_process()
+};
+
+extern "C" {
+
+// No exception may cross the C ABI: each function returns its failure value instead
+
+AudiomidCapture* audiomid_capture_create(void) {
+    try {
+        std::unique_ptr<AudiomidCapture> capture(new AudiomidCapture());
+        capture->engine = CaptureEngine::Acquire();
+        if (!capture->engine) {
+            return nullptr;
+        }
+
+        capture->stream = capture->engine->Stream();
+        capture->cursor.reset(new BroadcastFloatRing::Cursor(*capture->stream));
+        capture->engine->Attach(capture.get());
+        return capture.release();
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void audiomid_capture_destroy(AudiomidCapture* capture) {
+    if (!capture) return;
+
+    // Detach waits for a packet in flight, so no callback runs afterwards
+    try {
+        if (capture->engine->IsStarted(capture)) {
+            capture->engine->Stop(capture);
+        }
+    } catch (...) {
+    }
+    try {
+        capture->engine->Detach(capture);
+    } catch (...) {
+    }
+    delete capture;
+}
+
+int audiomid_capture_set_format(AudiomidCapture* capture, uint32_t sample_rate,
+                                uint16_t channels, uint32_t frame_ms) {
+    if (!capture) return -1;
+
+    try {
+        if (sample_rate != 0 && (sample_rate < 8000 ||
+            !AudioCapture::StreamingResampler::IsSupported(CaptureEngine::DEFAULT_SAMPLE_RATE, sample_rate))) {
+            return capture->Fail("Capture sample rate must divide 48000 (48000, 24000, 16000, 12000 or 8000)");
+        }
+        if (channels > 2 || frame_ms > 10000) {
+            return capture->Fail("Capture channels must be 1 or 2 and frame_ms at most 10000");
+        }
+
+        AudioCapture::CaptureFormatRequest request;
+        request.sampleRate = sample_rate;
+        request.channels = channels;
+
+        std::string error;
+        if (!capture->engine->SetCaptureFormat(request, frame_ms, error)) {
+            return capture->Fail(error);
+        }
+        return 0;
+    } catch (...) {
+        return capture->FailCaught();
+    }
+}
+
+int audiomid_capture_set_device(AudiomidCapture* capture, const char* device_id) {
+    if (!capture || !device_id) return -1;
+
+    try {
+        std::string error;
+        if (!capture->engine->SetDevice(device_id, error)) {
+            return capture->Fail(error.empty() ? capture->engine->GetLastError() : error);
+        }
+        return 0;
+    } catch (...) {
+        return capture->FailCaught();
+    }
+}
+
+size_t audiomid_capture_device_count(AudiomidCapture* capture) {
+    if (!capture) return 0;
+
+    try {
+        return capture->engine->GetAvailableDevices().size();
+    } catch (...) {
+        capture->FailCaught();
+        return 0;
+    }
+}
+
+int audiomid_capture_device_id(AudiomidCapture* capture, size_t index, char* buffer, size_t size) {
+    if (!capture) return -1;
+
+    try {
+        std::vector<std::string> devices = capture->engine->GetAvailableDevices();
+        if (index >= devices.size()) return -1;
+
+        const std::string& id = devices[index];
+        if (buffer && size > 0) {
+            size_t copied = std::min(id.size(), size - 1);
+            std::memcpy(buffer, id.data(), copied);
+            buffer[copied] = '\0';
+        }
+        return static_cast<int>(id.size());
+    } catch (...) {
+        return capture->FailCaught();
+    }
+}
+
+int audiomid_capture_set_callback(AudiomidCapture* capture, AudiomidAudioCallback callback, void* user_data) {
+    if (!capture) return -1;
+
+    try {
+        if (capture->engine->IsStarted(capture)) {
+            return capture->Fail("Stop capture before changing the callback");
+        }
+    } catch (...) {
+        return capture->FailCaught();
+    }
+
+    capture->callback = callback;
+    capture->userData = user_data;
+    return 0;
+}
+
+int audiomid_capture_start(AudiomidCapture* capture) {
+    if (!capture) return -1;
+
+    try {
+        // Other consumers' audio from before this start is not ours
+        if (!capture->engine->IsStarted(capture)) {
+            capture->cursor->Clear();
+        }
+
+        std::string error;
+        if (!capture->engine->Start(capture, error)) {
+            return capture->Fail(error.empty() ? capture->engine->GetLastError() : error);
+        }
+        return 0;
+    } catch (...) {
+        return capture->FailCaught();
+    }
+}
+
+int audiomid_capture_stop(AudiomidCapture* capture) {
+    if (!capture) return -1;
+
+    try {
+        if (!capture->engine->Stop(capture)) {
+            return capture->Fail(capture->engine->GetLastError());
+        }
+        return 0;
+    } catch (...) {
+        return capture->FailCaught();
+    }
+}
+
+int audiomid_capture_is_capturing(const AudiomidCapture* capture) {
+    try {
+        return capture && capture->engine->IsStarted(capture) && capture->engine->IsCapturing() ? 1 : 0;
+    } catch (...) {
+        return 0;
+    }
+}
+
+uint32_t audiomid_capture_sample_rate(const AudiomidCapture* capture) {
+    try {
+        return capture ? capture->engine->StreamRate() : 0;
+    } catch (...) {
+        return 0;
+    }
+}
+
+size_t audiomid_capture_read(AudiomidCapture* capture, float* output, size_t capacity) {
+    if (!capture || !output) return 0;
+
+    try {
+        return capture->cursor->Pop(output, capacity);
+    } catch (...) {
+        return 0;
+    }
+}
+
+size_t audiomid_capture_available(const AudiomidCapture* capture) {
+    try {
+        return capture ? capture->cursor->Available() : 0;
+    } catch (...) {
+        return 0;
+    }
+}
+
+const char* audiomid_capture_last_error(const AudiomidCapture* capture) {
+    return capture ? capture->lastError.c_str() : "";
+}
+
+AudiomidVad* audiomid_vad_create(size_t max_streams, size_t worker_threads) {
+    try {
+        return new AudiomidVad(max_streams, worker_threads);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void audiomid_vad_destroy(AudiomidVad* vad) {
+    delete vad;
+}
+
+int audiomid_vad_open_stream(AudiomidVad* vad, int sample_rate, int mode) {
+    try {
+        return vad ? vad->engine.OpenStream(sample_rate, mode) : -1;
+    } catch (...) {
+        return -1;
+    }
+}
+
+int audiomid_vad_close_stream(AudiomidVad* vad, uint32_t stream) {
+    try {
+        return vad && vad->engine.CloseStream(stream) ? 0 : -1;
+    } catch (...) {
+        return -1;
+    }
+}
+
+int audiomid_vad_reset_stream(AudiomidVad* vad, uint32_t stream) {
+    try {
+        return vad && vad->engine.ResetStream(stream) ? 0 : -1;
+    } catch (...) {
+        return -1;
+    }
+}
+
+int audiomid_vad_process(AudiomidVad* vad, const uint32_t* streams, size_t count,
+                         const int16_t* audio, size_t audio_length, int frame_ms,
+                         int8_t* decisions) {
+    if (!vad || !streams || !audio || !decisions) return -1;
+
+    try {
+        vad->frames.resize(count);
+
+        // Frames of streams that are not open have no length; ProcessFrames fails them
+        size_t offset = 0;
+        for (size_t i = 0; i < count; ++i) {
+            size_t length = vad->engine.FrameLength(streams[i], frame_ms);
+            vad->frames[i] = {streams[i], audio + offset, nullptr, length};
+            offset += length;
+        }
+
+        if (offset != audio_length) return -1;
+
+        return static_cast<int>(vad->engine.ProcessFrames(vad->frames.data(), count, decisions));
+    } catch (...) {
+        return -1;
+    }
+}
+
+} // extern "C"
+
+namespace {
+
+AudioCapture::AudioFormat ToAudioFormat(const AudiomidFormat& format) {
+    AudioCapture::AudioFormat result = {};
+    result.sampleRate = format.sample_rate;
+    result.channels = format.channels;
+    result.bitsPerSample = format.bits_per_sample;
+    result.bytesPerFrame = format.channels * (format.bits_per_sample / 8);
+    result.blockAlign = result.bytesPerFrame;
+    result.isFloat = format.is_float != 0;
+    result.isNonInterleaved = format.is_planar != 0;
+    AudioCapture::FormatKernels::Resolve(result);
+    return result;
+}
+
+} // namespace
+
+extern "C" {
+
+size_t audiomid_mono_frame_count(const AudiomidFormat* format, size_t length) {
+    if (!format) return 0;
+
+    try {
+        return AudioCapture::AudioFormatConverter::GetMonoFrameCount(ToAudioFormat(*format), length);
+    } catch (...) {
+        return 0;
+    }
+}
+
+size_t audiomid_convert_to_mono_float32(const uint8_t* data, size_t length, const AudiomidFormat* format,
+                                        float* output, size_t capacity) {
+    if (!format) return 0;
+
+    try {
+        return AudioCapture::AudioFormatConverter::ConvertToMonoFloat32(
+            data, length, ToAudioFormat(*format), output, capacity);
+    } catch (...) {
+        return 0;
+    }
+}
+
+} // extern "C"
\ No newline at end of file
@@ -0,0 +1,150 @@
+/*
+ * C ABI of the audiomid_core library: the capture pipeline, the multi-stream
+ * VAD engine and the format converter without Node. C++ callers can use the
+ * classes behind it directly (AudioCapture::CaptureEngine,
+ * WebRTCVAD::VADEngine, AudioCapture::AudioFormatConverter).
+ *
+ * Functions returning int return 0 on success and -1 on failure unless noted;
+ * audiomid_capture_last_error() describes the last capture failure.
+ */
+
+#ifndef AUDIOMID_CORE_H_
+#define AUDIOMID_CORE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(AUDIOMID_CORE_SHARED)
+#  if defined(AUDIOMID_CORE_BUILD)
+#    define AUDIOMID_API __declspec(dllexport)
+#  else
+#    define AUDIOMID_API __declspec(dllimport)
+#  endif
+#elif defined(AUDIOMID_CORE_SHARED) && (defined(__GNUC__) || defined(__clang__))
+#  define AUDIOMID_API __attribute__((visibility("default")))
+#else
+#  define AUDIOMID_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ------------------------------------------------------------------------ */
+/* Capture                                                                  */
+/* ------------------------------------------------------------------------ */
+
+/*
+ * One consumer of the process-wide capture engine: system audio as mono
+ * float32 at the stream rate, after the shared noise gate. Several handles
+ * (and a Node addon in the same process) share one backend and one
+ * conversion. Call the control functions from one thread at a time.
+ */
+typedef struct AudiomidCapture AudiomidCapture;
+
+/*
+ * Called on the processing thread for every packet that passes the noise
+ * gate; samples are valid only during the call. timestamp_us is the
+ * monotonic capture time of the packet.
+ */
+typedef void (*AudiomidAudioCallback)(void* user_data, const float* samples, size_t frames,
+                                      uint64_t timestamp_us);
+
+/* NULL if this platform has no capture backend */
+AUDIOMID_API AudiomidCapture* audiomid_capture_create(void);
+
+/* Stops this consumer first; the backend keeps running for other consumers */
+AUDIOMID_API void audiomid_capture_destroy(AudiomidCapture* capture);
+
+/*
+ * Capture stopped: stream sample_rate (0 keeps 48000; must divide 48000) and
+ * device channels (0 = device default, 1 or 2), frame_ms buffer (0 = keep)
+ */
+AUDIOMID_API int audiomid_capture_set_format(AudiomidCapture* capture, uint32_t sample_rate,
+                                             uint16_t channels, uint32_t frame_ms);
+
+/*
+ * Device ids as listed by the backend, plus "file:<path>?..." replay and
+ * "mix:<id>|<id>" sources (capture stopped)
+ */
+AUDIOMID_API int audiomid_capture_set_device(AudiomidCapture* capture, const char* device_id);
+AUDIOMID_API size_t audiomid_capture_device_count(AudiomidCapture* capture);
+
+/*
+ * Copies device id index, NUL terminated and truncated to size; returns the
+ * id's full length, or -1 if index is out of range
+ */
+AUDIOMID_API int audiomid_capture_device_id(AudiomidCapture* capture, size_t index,
+                                            char* buffer, size_t size);
+
+/* Set before starting; NULL removes the callback */
+AUDIOMID_API int audiomid_capture_set_callback(AudiomidCapture* capture, AudiomidAudioCallback callback,
+                                               void* user_data);
+
+AUDIOMID_API int audiomid_capture_start(AudiomidCapture* capture);
+AUDIOMID_API int audiomid_capture_stop(AudiomidCapture* capture);
+AUDIOMID_API int audiomid_capture_is_capturing(const AudiomidCapture* capture);
+
+/* Rate of the samples audiomid_capture_read() and callbacks produce */
+AUDIOMID_API uint32_t audiomid_capture_sample_rate(const AudiomidCapture* capture);
+
+/*
+ * Pull the oldest unread stream samples (single reader per handle); returns
+ * the number copied. Audio older than ten seconds is overwritten.
+ */
+AUDIOMID_API size_t audiomid_capture_read(AudiomidCapture* capture, float* output, size_t capacity);
+AUDIOMID_API size_t audiomid_capture_available(const AudiomidCapture* capture);
+
+/* Valid until the next call on this handle */
+AUDIOMID_API const char* audiomid_capture_last_error(const AudiomidCapture* capture);
+
+/* ------------------------------------------------------------------------ */
+/* Multi-stream VAD                                                         */
+/* ------------------------------------------------------------------------ */
+
+typedef struct AudiomidVad AudiomidVad;
+
+/* max_streams 1-4096; worker_threads helpers besides the caller (0 = none) */
+AUDIOMID_API AudiomidVad* audiomid_vad_create(size_t max_streams, size_t worker_threads);
+AUDIOMID_API void audiomid_vad_destroy(AudiomidVad* vad);
+
+/* Returns the new stream id, or -1 if the pool is full or the settings are invalid */
+AUDIOMID_API int audiomid_vad_open_stream(AudiomidVad* vad, int sample_rate, int mode);
+AUDIOMID_API int audiomid_vad_close_stream(AudiomidVad* vad, uint32_t stream);
+AUDIOMID_API int audiomid_vad_reset_stream(AudiomidVad* vad, uint32_t stream);
+
+/*
+ * One frame_ms frame (10, 20 or 30) per entry of streams, back to back in
+ * audio at each stream's rate. decisions[i] receives 1 (speech), 0 or -1 for
+ * frame i. Returns the number of frames processed without error, or -1 if
+ * audio_length does not match the streams' frames.
+ */
+AUDIOMID_API int audiomid_vad_process(AudiomidVad* vad, const uint32_t* streams, size_t count,
+                                      const int16_t* audio, size_t audio_length, int frame_ms,
+                                      int8_t* decisions);
+
+/* ------------------------------------------------------------------------ */
+/* Format conversion                                                        */
+/* ------------------------------------------------------------------------ */
+
+typedef struct AudiomidFormat {
+    uint32_t sample_rate;
+    uint16_t channels;
+    uint16_t bits_per_sample;  /* 16, 24 or 32 */
+    int is_float;              /* 32-bit IEEE float */
+    int is_planar;             /* One plane per channel */
+} AudiomidFormat;
+
+/* Mono frames audiomid_convert_to_mono_float32() produces for length bytes */
+AUDIOMID_API size_t audiomid_mono_frame_count(const AudiomidFormat* format, size_t length);
+
+/* Downmix raw capture bytes to mono float32; returns frames written */
+AUDIOMID_API size_t audiomid_convert_to_mono_float32(const uint8_t* data, size_t length,
+                                                     const AudiomidFormat* format,
+                                                     float* output, size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* AUDIOMID_CORE_H_ */
\ No newline at end of file
@@ -0,0 +1,482 @@
+// Microbenchmarks for the native capture hot path, built outside Electron.
+//
+//   cmake -S . -B build-bench -DAUDIOMID_BUILD_BENCHMARKS=ON
+//   cmake --build build-bench --target audio_bench
+//   ./build-bench/audio_bench [--replay=recording.wav] [--benchmark_filter=...]
+//
+// --replay runs a recorded 48kHz WAV file (PCM 16/24/32-bit or float32)
+// through the same per-packet stages the capture thread runs, so hot path
+// regressions show up on real audio and not only on synthetic packets.
+
+#include "audio-capture/audio_block_pool.h"
+#include "audio-capture/audio_buffer.h"
+#include "audio-capture/audio_capture_base.h"
+#include "audio-capture/audio_format_converter.h"
+#include "audio-capture/audio_format_kernels.h"
+#include "audio-capture/file_replay_audio_capture.h"
+#include "audio-capture/level_meter.h"
+#include "audio-capture/audio_scratch_arena.h"
+#include "audio-capture/audio_simd_kernels.h"
+#include "audio-capture/spectral_features.h"
+#include "audio-capture/streaming_resampler.h"
+#include "audio-capture/streaming_vad.h"
+#include "webrtc-vad/fvad.h"
+#include "webrtc-vad/vad_engine.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace AudioCapture;
+
+namespace {
+
+constexpr uint32_t kSampleRate = 48000;
+
+// 10ms at 48kHz: the packet size WASAPI and PulseAudio deliver by default
+constexpr size_t kPacketFrames = 480;
+
+enum SampleKind : int64_t {
+    kInt16 = 0,
+    kInt24,
+    kInt32,
+    kFloatInterleaved,
+    kFloatPlanar
+};
+
+const char* SampleKindName(int64_t kind) {
+    switch (kind) {
+        case kInt16:            return "int16";
+        case kInt24:            return "int24";
+        case kInt32:            return "int32";
+        case kFloatInterleaved: return "float";
+        case kFloatPlanar:      return "float-planar";
+        default:                return "unknown";
+    }
+}
+
+AudioFormat MakeFormat(int64_t kind, uint16_t channels) {
+    AudioFormat format = {};
+    format.sampleRate = kSampleRate;
+    format.channels = channels;
+    format.bitsPerSample = kind == kInt16 ? 16 : kind == kInt24 ? 24 : 32;
+    format.isFloat = kind == kFloatInterleaved || kind == kFloatPlanar;
+    format.isNonInterleaved = kind == kFloatPlanar;
+    format.bytesPerFrame = channels * (format.bitsPerSample / 8);
+    format.blockAlign = format.bytesPerFrame;
+    FormatKernels::Resolve(format);
+    return format;
+}
+
+// Deterministic test signal: a tone per channel plus a little noise
+std::vector<uint8_t> MakePacket(const AudioFormat& format, size_t frames) {
+    std::vector<uint8_t> packet(frames * format.bytesPerFrame);
+    uint32_t noise = 22222;
+
+    for (size_t frame = 0; frame < frames; ++frame) {
+        for (uint16_t ch = 0; ch < format.channels; ++ch) {
+            noise = noise * 1664525u + 1013904223u;
+            float value = 0.5f * std::sin(2.0f * 3.14159265f * (220.0f * (ch + 1)) * frame / kSampleRate)
+                        + (static_cast<int32_t>(noise >> 16) - 32768) / 327680.0f;
+
+            // Planar float keeps each channel in its own plane
+            size_t index = format.isNonInterleaved ? ch * frames + frame : frame * format.channels + ch;
+            uint8_t* out = packet.data() + index * (format.bitsPerSample / 8);
+
+            if (format.isFloat) {
+                std::memcpy(out, &value, sizeof(float));
+            } else if (format.bitsPerSample == 16) {
+                int16_t sample = static_cast<int16_t>(value * 32767.0f);
+                std::memcpy(out, &sample, sizeof(sample));
+            } else if (format.bitsPerSample == 24) {
+                int32_t sample = static_cast<int32_t>(value * 8388607.0f);
+                out[0] = static_cast<uint8_t>(sample);
+                out[1] = static_cast<uint8_t>(sample >> 8);
+                out[2] = static_cast<uint8_t>(sample >> 16);
+            } else {
+                int32_t sample = static_cast<int32_t>(value * 2147483647.0f);
+                std::memcpy(out, &sample, sizeof(sample));
+            }
+        }
+    }
+    return packet;
+}
+
+// Capture-path conversion: raw packet to 48kHz mono float32
+void BM_ConvertToMonoFloat32(benchmark::State& state) {
+    AudioFormat format = MakeFormat(state.range(0), static_cast<uint16_t>(state.range(1)));
+    std::vector<uint8_t> packet = MakePacket(format, kPacketFrames);
+    std::vector<float> output(kPacketFrames);
+
+    for (auto _ : state) {
+        size_t frames = AudioFormatConverter::ConvertToMonoFloat32(
+            packet.data(), packet.size(), format, output.data(), output.size());
+        benchmark::DoNotOptimize(frames);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(SampleKindName(state.range(0)));
+    state.SetItemsProcessed(state.iterations() * kPacketFrames);
+    state.SetBytesProcessed(state.iterations() * packet.size());
+}
+BENCHMARK(BM_ConvertToMonoFloat32)
+    ->ArgsProduct({{kInt16, kInt24, kInt32, kFloatInterleaved, kFloatPlanar}, {1, 2, 6, 8}})
+    ->ArgNames({"format", "channels"});
+
+// Legacy PCM16 conversion with mono downmix
+void BM_ConvertToPCM16(benchmark::State& state) {
+    AudioSample sample;
+    sample.format = MakeFormat(state.range(0), static_cast<uint16_t>(state.range(1)));
+    sample.data = MakePacket(sample.format, kPacketFrames);
+    sample.frameCount = kPacketFrames;
+    sample.timestamp = 0;
+
+    std::vector<int16_t> output(AudioFormatConverter::GetPCM16SampleCount(sample.format, sample.data.size()));
+
+    for (auto _ : state) {
+        size_t count = AudioFormatConverter::ConvertToPCM16(sample, output.data(), output.size());
+        benchmark::DoNotOptimize(count);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(SampleKindName(state.range(0)));
+    state.SetItemsProcessed(state.iterations() * kPacketFrames);
+    state.SetBytesProcessed(state.iterations() * sample.data.size());
+}
+BENCHMARK(BM_ConvertToPCM16)
+    ->ArgsProduct({{kInt16, kInt24, kInt32, kFloatInterleaved, kFloatPlanar}, {1, 2, 6, 8}})
+    ->ArgNames({"format", "channels"});
+
+void BM_FloatToInt16(benchmark::State& state) {
+    AudioFormat format = MakeFormat(kFloatInterleaved, 1);
+    std::vector<uint8_t> packet = MakePacket(format, kPacketFrames);
+    const float* samples = reinterpret_cast<const float*>(packet.data());
+    std::vector<int16_t> output(kPacketFrames);
+
+    for (auto _ : state) {
+        size_t count = AudioFormatConverter::FloatToInt16(samples, kPacketFrames, output.data(), output.size());
+        benchmark::DoNotOptimize(count);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * kPacketFrames);
+}
+BENCHMARK(BM_FloatToInt16);
+
+void BM_FloatToPcm16Base64(benchmark::State& state) {
+    AudioFormat format = MakeFormat(kFloatInterleaved, 1);
+    std::vector<uint8_t> packet = MakePacket(format, kPacketFrames);
+    const float* samples = reinterpret_cast<const float*>(packet.data());
+    std::vector<char> output(SimdKernels::Base64EncodedLength(kPacketFrames * sizeof(int16_t)));
+
+    for (auto _ : state) {
+        SimdKernels::FloatToPcm16Base64(samples, kPacketFrames, output.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * kPacketFrames);
+}
+BENCHMARK(BM_FloatToPcm16Base64);
+
+void BM_LevelMeter(benchmark::State& state) {
+    AudioFormat format = MakeFormat(kFloatInterleaved, 1);
+    std::vector<uint8_t> packet = MakePacket(format, kPacketFrames);
+    const float* samples = reinterpret_cast<const float*>(packet.data());
+    LevelMeter meter(kSampleRate);
+
+    for (auto _ : state) {
+        bool open = meter.Process(samples, kPacketFrames);
+        benchmark::DoNotOptimize(open);
+    }
+
+    state.SetItemsProcessed(state.iterations() * kPacketFrames);
+}
+BENCHMARK(BM_LevelMeter);
+
+// Digital-silence detection runs on every captured packet, so the all-zero
+// case (a full scan) is the one that matters
+void BM_SilenceDetection(benchmark::State& state) {
+    AudioFormat format = MakeFormat(kFloatInterleaved, 2);
+    std::vector<uint8_t> packet(kPacketFrames * format.bytesPerFrame, 0);
+
+    for (auto _ : state) {
+        bool silent = SimdKernels::IsZero(packet.data(), packet.size());
+        benchmark::DoNotOptimize(silent);
+    }
+
+    state.SetBytesProcessed(state.iterations() * packet.size());
+}
+BENCHMARK(BM_SilenceDetection);
+
+void BM_StreamingResampler(benchmark::State& state) {
+    StreamingResampler resampler;
+    resampler.Configure(kSampleRate, static_cast<uint32_t>(state.range(0)));
+
+    AudioFormat format = MakeFormat(kFloatInterleaved, 1);
+    std::vector<uint8_t> packet = MakePacket(format, kPacketFrames);
+    const float* samples = reinterpret_cast<const float*>(packet.data());
+    std::vector<float> output(resampler.MaxOutputFrames(kPacketFrames));
+
+    for (auto _ : state) {
+        size_t frames = resampler.Process(samples, kPacketFrames, output.data(), output.size());
+        benchmark::DoNotOptimize(frames);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * kPacketFrames);
+}
+BENCHMARK(BM_StreamingResampler)->Arg(24000)->Arg(16000)->Arg(8000)->ArgName("outputRate");
+
+// Capture thread pushing packets while a consumer thread drains continuously;
+// range(0) selects the lock-free ring (1) or the mutex-guarded deque (0)
+void BM_AudioBufferContention(benchmark::State& state) {
+    const bool useRing = state.range(0) != 0;
+    AudioBuffer buffer(5 * 1024 * 1024, useRing ? kSampleRate * 10 : 0);
+
+    std::vector<float> packet(kPacketFrames, 0.25f);
+    std::atomic<bool> running(true);
+    std::atomic<uint64_t> consumed(0);
+
+    std::thread consumer([&]() {
+        std::vector<float> scratch(kSampleRate);
+        while (running.load(std::memory_order_relaxed)) {
+            size_t count = 0;
+            if (useRing) {
+                count = buffer.PopFloat32(scratch.data(), scratch.size());
+            } else {
+                for (const auto& chunk : buffer.PopMultipleFloat32(1000)) {
+                    count += chunk.data.size();
+                }
+            }
+            consumed.fetch_add(count, std::memory_order_relaxed);
+            if (count == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (auto _ : state) {
+        buffer.PushFloat32(packet.data(), packet.size(), kSampleRate, 1);
+    }
+
+    running = false;
+    consumer.join();
+
+    state.SetLabel(useRing ? "ring" : "deque");
+    state.SetItemsProcessed(state.iterations() * kPacketFrames);
+    state.counters["consumed"] = static_cast<double>(consumed.load());
+    state.counters["overruns"] = static_cast<double>(buffer.GetFloat32OverrunCount());
+}
+BENCHMARK(BM_AudioBufferContention)->Arg(0)->Arg(1)->ArgName("ring")->UseRealTime();
+
+// Owning copy of a 10ms stereo float packet handed to another thread and freed
+// there, as the raw callback does; range(0) selects the block pool (1) or a
+// heap AudioSample per packet (0)
+void BM_PacketCopy(benchmark::State& state) {
+    const bool usePool = state.range(0) != 0;
+    AudioBlockPool* pool = new AudioBlockPool(4);
+
+    std::vector<float> interleaved(kPacketFrames * 2, 0.25f);
+    AudioSampleView view;
+    view.data = reinterpret_cast<const uint8_t*>(interleaved.data());
+    view.size = interleaved.size() * sizeof(float);
+    view.format.sampleRate = kSampleRate;
+    view.format.channels = 2;
+    view.format.bitsPerSample = 32;
+    view.format.bytesPerFrame = 8;
+    view.format.isFloat = true;
+    view.frameCount = kPacketFrames;
+
+    for (auto _ : state) {
+        if (usePool) {
+            AudioBlock block = pool->Acquire(view.size);
+            std::memcpy(block.Data(), view.data, view.size);
+            benchmark::DoNotOptimize(block.Data());
+        } else {
+            AudioSample* sample = new AudioSample(view.ToSample(false));
+            benchmark::DoNotOptimize(sample->data.data());
+            delete sample;
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(usePool ? "pool" : "heap");
+    state.SetBytesProcessed(state.iterations() * view.size);
+    state.counters["allocations"] = static_cast<double>(pool->Allocations());
+    pool->Retire();
+}
+BENCHMARK(BM_PacketCopy)->Arg(0)->Arg(1)->ArgName("pool");
+
+// One fvad_process call per frame at each supported rate and frame length
+void BM_FvadProcess(benchmark::State& state) {
+    const int sampleRate = static_cast<int>(state.range(0));
+    const size_t frameLength = static_cast<size_t>(sampleRate / 1000 * state.range(1));
+
+    Fvad* vad = fvad_new();
+    fvad_set_sample_rate(vad, sampleRate);
+    fvad_set_mode(vad, 2);
+
+    AudioFormat format = MakeFormat(kInt16, 1);
+    std::vector<uint8_t> packet = MakePacket(format, frameLength);
+    const int16_t* frame = reinterpret_cast<const int16_t*>(packet.data());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fvad_process(vad, frame, frameLength));
+    }
+
+    fvad_free(vad);
+    state.SetItemsProcessed(state.iterations() * frameLength);
+}
+BENCHMARK(BM_FvadProcess)
+    ->ArgsProduct({{8000, 16000, 32000, 48000}, {10, 20, 30}})
+    ->ArgNames({"rate", "frameMs"});
+
+// One ProcessFrames call carrying a 20ms 16kHz frame for every stream
+void BM_VADEngine(benchmark::State& state) {
+    const size_t streams = static_cast<size_t>(state.range(0));
+    const size_t frameLength = 320;
+
+    WebRTCVAD::VADEngine engine(streams, static_cast<size_t>(state.range(1)));
+    AudioFormat format = MakeFormat(kInt16, 1);
+    std::vector<uint8_t> packet = MakePacket(format, frameLength * streams);
+    const int16_t* samples = reinterpret_cast<const int16_t*>(packet.data());
+
+    std::vector<WebRTCVAD::VADFrame> frames(streams);
+    for (size_t i = 0; i < streams; ++i) {
+        frames[i] = {static_cast<uint32_t>(engine.OpenStream(16000, 2)), samples + i * frameLength,
+                     nullptr, frameLength};
+    }
+    std::vector<int8_t> decisions(streams);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine.ProcessFrames(frames.data(), frames.size(), decisions.data()));
+    }
+
+    state.SetItemsProcessed(state.iterations() * streams);
+}
+BENCHMARK(BM_VADEngine)
+    ->ArgsProduct({{1, 16, 64}, {0, 3}})
+    ->ArgNames({"streams", "threads"})
+    ->UseRealTime();
+
+// Spectral feature stage on 10ms mono packets at each analysis rate, 20ms frames
+void BM_SpectralFeatures(benchmark::State& state) {
+    const uint32_t sampleRate = static_cast<uint32_t>(state.range(0));
+    const size_t packetFrames = sampleRate / 100;
+
+    StreamingSpectralAnalyzer analyzer;
+    analyzer.Configure(sampleRate, SpectralFeaturesConfig());
+    std::vector<float> samples(packetFrames);
+    for (size_t i = 0; i < packetFrames; ++i) {
+        samples[i] = 0.25f * std::sin(2.0f * 3.14159265f * 440.0f * i / sampleRate);
+    }
+    std::vector<SpectralFrame> frames(analyzer.MaxFramesFor(packetFrames) + 1);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(analyzer.Process(samples.data(), samples.size(), frames.data(), frames.size()));
+    }
+
+    state.SetItemsProcessed(state.iterations() * packetFrames);
+}
+BENCHMARK(BM_SpectralFeatures)->Arg(8000)->Arg(16000)->Arg(48000)->ArgName("rate");
+
+// Capture-thread stages per packet: convert, decimate + VAD, pull-buffer
+// resampling and the lock-free buffer push
+void BM_Replay(benchmark::State& state, const MappedAudioFile* source, uint32_t outputRate) {
+    const AudioFormat& format = source->Format();
+    const size_t packetBytes = kPacketFrames * format.bytesPerFrame;
+    const size_t packets = source->Size() / packetBytes;
+    if (packets == 0) {
+        state.SkipWithError("recording shorter than one packet");
+        return;
+    }
+
+    ScratchArena scratch;
+    StreamingResampler vadDecimator;
+    StreamingResampler bufferResampler;
+    StreamingVAD vad;
+    vadDecimator.Configure(kSampleRate, 16000);
+    bufferResampler.Configure(kSampleRate, outputRate);
+    vad.Configure(16000, StreamingVADConfig());
+    AudioBuffer buffer(5 * 1024 * 1024, kSampleRate * 10);
+    std::vector<float> drain(kSampleRate);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < packets; ++i) {
+            const uint8_t* packet = source->Data() + i * packetBytes;
+
+            float* mono = scratch.Get<float>(ScratchSlot::Convert, kPacketFrames);
+            size_t frames = AudioFormatConverter::ConvertToMonoFloat32(packet, packetBytes, format,
+                                                                       mono, kPacketFrames);
+
+            size_t decimatedCapacity = vadDecimator.MaxOutputFrames(frames);
+            float* decimated = scratch.Get<float>(ScratchSlot::Decimate, decimatedCapacity);
+            size_t decimatedFrames = vadDecimator.Process(mono, frames, decimated, decimatedCapacity);
+
+            size_t flagCapacity = std::max<size_t>(vad.MaxFramesFor(decimatedFrames), 1);
+            uint8_t* flags = scratch.Get<uint8_t>(ScratchSlot::Analysis, flagCapacity);
+            benchmark::DoNotOptimize(vad.Process(decimated, decimatedFrames, flags, flagCapacity));
+
+            const float* bufferData = mono;
+            size_t bufferFrames = frames;
+            if (!bufferResampler.IsPassthrough()) {
+                size_t capacity = bufferResampler.MaxOutputFrames(frames);
+                float* resampled = scratch.Get<float>(ScratchSlot::Resample, capacity);
+                bufferFrames = bufferResampler.Process(mono, frames, resampled, capacity);
+                bufferData = resampled;
+            }
+            buffer.PushFloat32(bufferData, bufferFrames, outputRate, 1);
+        }
+
+        // Keep the ring from overrunning between iterations
+        buffer.PopFloat32(drain.data(), drain.size());
+    }
+
+    // Seconds of audio processed per second of wall time
+    double audioSeconds = static_cast<double>(packets * kPacketFrames) / kSampleRate;
+    state.counters["xRealtime"] = benchmark::Counter(
+        audioSeconds * state.iterations(), benchmark::Counter::kIsRate);
+    state.SetItemsProcessed(state.iterations() * packets);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+
+    // Whatever Google Benchmark did not consume is ours
+    MappedAudioFile replay;
+    for (int i = 1; i < argc; ++i) {
+        const char* prefix = "--replay=";
+        if (std::strncmp(argv[i], prefix, std::strlen(prefix)) != 0) {
+            std::fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            return 1;
+        }
+
+        std::string error;
+        if (!replay.Open(argv[i] + std::strlen(prefix), nullptr, error)) {
+            std::fprintf(stderr, "Replay: %s\n", error.c_str());
+            return 1;
+        }
+        if (replay.Format().sampleRate != kSampleRate) {
+            std::fprintf(stderr, "Replay: the capture path runs at 48kHz, recording is %uHz\n",
+                         replay.Format().sampleRate);
+            return 1;
+        }
+
+        for (uint32_t rate : {48000u, 24000u, 16000u}) {
+            benchmark::RegisterBenchmark(("BM_Replay/outputRate:" + std::to_string(rate)).c_str(),
+                                         BM_Replay, &replay, rate)
+                ->Unit(benchmark::kMillisecond);
+        }
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
\ No newline at end of file
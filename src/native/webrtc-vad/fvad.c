@@ -13,6 +13,9 @@
 
 #include <stdlib.h>
 #include "vad/vad_core.h"
+#include "vad/vad_filterbank.h"
+#include "vad/vad_sp.h"
+#include "signal_processing/spl_simd.h"
 
 // valid sample rates in kHz
 static const int valid_rates[] = { 8, 16, 32, 48 };
@@ -50,6 +53,12 @@ void fvad_free(Fvad *inst)
 }
 
 
+size_t fvad_instance_size(void)
+{
+    return sizeof(Fvad);
+}
+
+
 void fvad_reset(Fvad *inst)
 {
     assert(inst);
@@ -105,3 +114,50 @@ int fvad_process(Fvad* inst, const int16_t* frame, size_t length)
 
     return rv;
 }
+
+
+int fvad_band_energies(Fvad* inst, const int16_t* frame, size_t length, int16_t* bands)
+{
+    assert(inst);
+    if (!valid_length(inst->rate_idx, length))
+        return -1;
+
+    // Same 8 kHz signal the WebRtcVad_CalcVad*khz() functions classify
+    int16_t speech_nb[240];  // 30 ms at 8 kHz
+    int16_t speech_wb[480];  // 30 ms at 16 kHz
+    int32_t tmp_mem[480 + 256] = { 0 };
+    const int16_t *nb = frame;
+    size_t nb_length = length;
+
+    switch (valid_rates[inst->rate_idx]) {
+    case 16:
+        WebRtcVad_Downsampling(frame, speech_nb, inst->core.downsampling_filter_states, length);
+        nb = speech_nb;
+        nb_length = length / 2;
+        break;
+    case 32:
+        WebRtcVad_Downsampling(frame, speech_wb, &inst->core.downsampling_filter_states[2], length);
+        WebRtcVad_Downsampling(speech_wb, speech_nb, inst->core.downsampling_filter_states, length / 2);
+        nb = speech_nb;
+        nb_length = length / 4;
+        break;
+    case 48:
+        for (size_t i = 0; i < length / 480; i++) {
+            WebRtcSpl_Resample48khzTo8khz(frame + i * 480, &speech_nb[i * 80],
+                                          &inst->core.state_48_to_8, tmp_mem);
+        }
+        nb = speech_nb;
+        nb_length = length / 6;
+        break;
+    default:
+        break;
+    }
+
+    return WebRtcVad_CalculateFeatures(&inst->core, nb, nb_length, bands);
+}
+
+
+int fvad_set_simd_enabled(int enabled)
+{
+    return WebRtcSpl_SetSimdEnabled(enabled);
+}
@@ -40,6 +40,14 @@ Fvad *fvad_new(void);
  */
 void fvad_free(Fvad *inst);
 
+/*
+ * Size in bytes of one VAD instance. Callers that keep instances in their own
+ * storage (for example one contiguous pool) reserve this much per instance,
+ * aligned for any type, initialize each with fvad_reset() and never pass them
+ * to fvad_free().
+ */
+size_t fvad_instance_size(void);
+
 
 /*
  * Reinitializes a VAD instance, clearing all state and resetting mode and
@@ -89,6 +97,33 @@ int fvad_set_sample_rate(Fvad* inst, int sample_rate);
  */
 int fvad_process(Fvad* inst, const int16_t* frame, size_t length);
 
+
+/*
+ * Runs only the VAD's feature extraction on an audio frame: the log energies
+ * of its six filterbank bands (80-250, 250-500, 500-1000, 1000-2000,
+ * 2000-3000 and 3000-4000 Hz), after the same downsampling to 8 kHz that
+ * fvad_process() does. Frame lengths are as for fvad_process().
+ *
+ * `bands` receives 6 values of 10 * log10(band energy) in Q4. The filter
+ * state carries over between frames, so feed an instance either this or
+ * fvad_process(), not both.
+ *
+ * Returns the approximate total frame energy (>= 0), or -1 for an invalid
+ * frame length.
+ */
+int fvad_band_energies(Fvad* inst, const int16_t* frame, size_t length, int16_t* bands);
+
+
+/*
+ * Enables or disables the SIMD feature extraction kernels for all VAD
+ * instances of the process. Both paths produce bit-identical decisions; the
+ * switch exists for benchmarking and validation. SIMD is enabled by default
+ * whenever it was compiled in (SSE2 or NEON, unless FVAD_DISABLE_SIMD is set).
+ *
+ * Returns the previous setting, or 0 if no SIMD kernels are available.
+ */
+int fvad_set_simd_enabled(int enabled);
+
 #ifdef __cplusplus
 }
 #endif
@@ -16,22 +16,98 @@
  */
 
 #include "signal_processing_library.h"
+#include "spl_simd.h"
+
+// Scalar reference, also the tail loop of the vector versions.
+static int32_t EnergyScalar(const int16_t* vector,
+                            size_t vector_length,
+                            int scaling)
+{
+    int32_t en = 0;
+    size_t i;
+
+    for (i = 0; i < vector_length; i++)
+    {
+      en += (vector[i] * vector[i]) >> scaling;
+    }
+
+    return en;
+}
+
+#if defined(WEBRTC_SPL_SIMD_SSE2)
+// Each square is formed exactly in 32 bits (mullo/mulhi pair) and shifted
+// before it is accumulated; 32-bit wrapping addition is order independent, so
+// the lane sums equal the scalar running sum.
+static int32_t EnergySimd(const int16_t* vector,
+                          size_t vector_length,
+                          int scaling)
+{
+    const __m128i shift = _mm_cvtsi32_si128(scaling);
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    int32_t lanes[4];
+
+    for (; i + 8 <= vector_length; i += 8)
+    {
+      __m128i x = _mm_loadu_si128((const __m128i*)(vector + i));
+      __m128i lo = _mm_mullo_epi16(x, x);
+      __m128i hi = _mm_mulhi_epi16(x, x);
+      __m128i sq0 = _mm_unpacklo_epi16(lo, hi);
+      __m128i sq1 = _mm_unpackhi_epi16(lo, hi);
+      acc = _mm_add_epi32(acc, _mm_sra_epi32(sq0, shift));
+      acc = _mm_add_epi32(acc, _mm_sra_epi32(sq1, shift));
+    }
+
+    _mm_storeu_si128((__m128i*)lanes, acc);
+    return (int32_t)((uint32_t)lanes[0] + (uint32_t)lanes[1] +
+                     (uint32_t)lanes[2] + (uint32_t)lanes[3]) +
+           EnergyScalar(vector + i, vector_length - i, scaling);
+}
+#elif defined(WEBRTC_SPL_SIMD_NEON)
+static int32_t EnergySimd(const int16_t* vector,
+                          size_t vector_length,
+                          int scaling)
+{
+    const int32x4_t shift = vdupq_n_s32(-scaling);
+    int32x4_t acc = vdupq_n_s32(0);
+    size_t i = 0;
+
+    for (; i + 8 <= vector_length; i += 8)
+    {
+      int16x8_t x = vld1q_s16(vector + i);
+      int32x4_t sq0 = vmull_s16(vget_low_s16(x), vget_low_s16(x));
+      int32x4_t sq1 = vmull_s16(vget_high_s16(x), vget_high_s16(x));
+      acc = vaddq_s32(acc, vshlq_s32(sq0, shift));
+      acc = vaddq_s32(acc, vshlq_s32(sq1, shift));
+    }
+
+    return (int32_t)((uint32_t)vgetq_lane_s32(acc, 0) +
+                     (uint32_t)vgetq_lane_s32(acc, 1) +
+                     (uint32_t)vgetq_lane_s32(acc, 2) +
+                     (uint32_t)vgetq_lane_s32(acc, 3)) +
+           EnergyScalar(vector + i, vector_length - i, scaling);
+}
+#endif
 
 int32_t WebRtcSpl_Energy(int16_t* vector,
                          size_t vector_length,
                          int* scale_factor)
 {
-    int32_t en = 0;
-    size_t i;
+    int32_t en;
     int scaling =
         WebRtcSpl_GetScalingSquare(vector, vector_length, vector_length);
-    size_t looptimes = vector_length;
-    int16_t *vectorptr = vector;
 
-    for (i = 0; i < looptimes; i++)
+#if defined(WEBRTC_SPL_HAVE_SIMD)
+    if (WebRtcSpl_SimdEnabled())
+    {
+      en = EnergySimd(vector, vector_length, scaling);
+#if defined(FVAD_SIMD_VALIDATE)
+      RTC_DCHECK(en == EnergyScalar(vector, vector_length, scaling));
+#endif
+    } else
+#endif
     {
-      en += (*vectorptr * *vectorptr) >> scaling;
-      vectorptr++;
+      en = EnergyScalar(vector, vector_length, scaling);
     }
     *scale_factor = scaling;
 
@@ -16,24 +16,98 @@
  */
 
 #include "signal_processing_library.h"
+#include "spl_simd.h"
 
-int16_t WebRtcSpl_GetScalingSquare(int16_t* in_vector,
-                                   size_t in_vector_length,
-                                   size_t times)
+// Largest |sample|. Like the scalar reference, -32768 negates to itself and
+// therefore never raises the maximum.
+static int16_t MaxAbsScalar(const int16_t* sptr, size_t length)
 {
-    int16_t nbits = WebRtcSpl_GetSizeInBits((uint32_t)times);
     size_t i;
     int16_t smax = -1;
     int16_t sabs;
-    int16_t *sptr = in_vector;
-    int16_t t;
-    size_t looptimes = in_vector_length;
 
-    for (i = looptimes; i > 0; i--)
+    for (i = length; i > 0; i--)
     {
         sabs = (*sptr > 0 ? *sptr++ : -*sptr++);
         smax = (sabs > smax ? sabs : smax);
     }
+
+    return smax;
+}
+
+#if defined(WEBRTC_SPL_SIMD_SSE2)
+static int16_t MaxAbsSimd(const int16_t* sptr, size_t length)
+{
+    // Wrapping negate keeps -32768 at -32768, matching the scalar path.
+    const __m128i zero = _mm_setzero_si128();
+    __m128i vmax = _mm_set1_epi16(-1);
+    size_t i = 0;
+    int16_t lanes[8];
+    int16_t smax;
+    int k;
+
+    for (; i + 8 <= length; i += 8)
+    {
+        __m128i x = _mm_loadu_si128((const __m128i*)(sptr + i));
+        __m128i sabs = _mm_max_epi16(x, _mm_sub_epi16(zero, x));
+        vmax = _mm_max_epi16(vmax, sabs);
+    }
+
+    _mm_storeu_si128((__m128i*)lanes, vmax);
+    smax = MaxAbsScalar(sptr + i, length - i);
+    for (k = 0; k < 8; k++)
+    {
+        smax = (lanes[k] > smax ? lanes[k] : smax);
+    }
+
+    return smax;
+}
+#elif defined(WEBRTC_SPL_SIMD_NEON)
+static int16_t MaxAbsSimd(const int16_t* sptr, size_t length)
+{
+    // vabsq_s16 wraps -32768 to itself, matching the scalar path.
+    int16x8_t vmax = vdupq_n_s16(-1);
+    size_t i = 0;
+    int16_t lanes[8];
+    int16_t smax;
+    int k;
+
+    for (; i + 8 <= length; i += 8)
+    {
+        vmax = vmaxq_s16(vmax, vabsq_s16(vld1q_s16(sptr + i)));
+    }
+
+    vst1q_s16(lanes, vmax);
+    smax = MaxAbsScalar(sptr + i, length - i);
+    for (k = 0; k < 8; k++)
+    {
+        smax = (lanes[k] > smax ? lanes[k] : smax);
+    }
+
+    return smax;
+}
+#endif
+
+int16_t WebRtcSpl_GetScalingSquare(int16_t* in_vector,
+                                   size_t in_vector_length,
+                                   size_t times)
+{
+    int16_t nbits = WebRtcSpl_GetSizeInBits((uint32_t)times);
+    int16_t smax;
+    int16_t t;
+
+#if defined(WEBRTC_SPL_HAVE_SIMD)
+    if (WebRtcSpl_SimdEnabled())
+    {
+        smax = MaxAbsSimd(in_vector, in_vector_length);
+#if defined(FVAD_SIMD_VALIDATE)
+        RTC_DCHECK(smax == MaxAbsScalar(in_vector, in_vector_length));
+#endif
+    } else
+#endif
+    {
+        smax = MaxAbsScalar(in_vector, in_vector_length);
+    }
     t = WebRtcSpl_NormW32(WEBRTC_SPL_MUL(smax, smax));
 
     if (smax == 0)
@@ -22,6 +22,55 @@ static const int16_t kResampleAllpass[2][3] = {
         {3050, 9368, 15063}
 };
 
+// One sample through a three-section allpass chain. Every chain of the
+// half-band filters uses the same section arithmetic and differs only in its
+// coefficients and its 4-value state. The two chains of a filter are
+// independent, so the loops below run them side by side on local copies of
+// their state; the results are identical to running them one after another.
+static __inline int32_t RTC_NO_SANITIZE("signed-integer-overflow")
+AllpassChain(int32_t tmp0, const int16_t *coef, int32_t *state)
+{
+    int32_t tmp1, diff;
+
+    diff = tmp0 - state[1];
+    // scale down and round
+    diff = (diff + (1 << 13)) >> 14;
+    tmp1 = state[0] + diff * coef[0];
+    state[0] = tmp0;
+    diff = tmp1 - state[2];
+    // scale down and truncate
+    diff = diff >> 14;
+    if (diff < 0)
+        diff += 1;
+    tmp0 = state[1] + diff * coef[1];
+    state[1] = tmp1;
+    diff = tmp0 - state[3];
+    // scale down and truncate
+    diff = diff >> 14;
+    if (diff < 0)
+        diff += 1;
+    state[3] = state[2] + diff * coef[2];
+    state[2] = tmp0;
+
+    return state[3];
+}
+
+static __inline void LoadChainState(int32_t *chain, const int32_t *state)
+{
+    chain[0] = state[0];
+    chain[1] = state[1];
+    chain[2] = state[2];
+    chain[3] = state[3];
+}
+
+static __inline void StoreChainState(const int32_t *chain, int32_t *state)
+{
+    state[0] = chain[0];
+    state[1] = chain[1];
+    state[2] = chain[2];
+    state[3] = chain[3];
+}
+
 //
 //   decimator
 // input:  int32_t (shifted 15 positions to the left, + offset 16384) OVERWRITTEN!
@@ -32,72 +81,29 @@ void RTC_NO_SANITIZE("signed-integer-overflow")  // bugs.webrtc.org/5486
 WebRtcSpl_DownBy2IntToShort(int32_t *in, int32_t len, int16_t *out,
                             int32_t *state)
 {
-    int32_t tmp0, tmp1, diff;
+    int32_t tmp0, tmp1;
+    int32_t lower[4], upper[4];
     int32_t i;
 
     len >>= 1;
 
-    // lower allpass filter (operates on even input samples)
-    for (i = 0; i < len; i++)
-    {
-        tmp0 = in[i << 1];
-        diff = tmp0 - state[1];
-        // UBSan: -1771017321 - 999586185 cannot be represented in type 'int'
-
-        // scale down and round
-        diff = (diff + (1 << 13)) >> 14;
-        tmp1 = state[0] + diff * kResampleAllpass[1][0];
-        state[0] = tmp0;
-        diff = tmp1 - state[2];
-        // scale down and truncate
-        diff = diff >> 14;
-        if (diff < 0)
-            diff += 1;
-        tmp0 = state[1] + diff * kResampleAllpass[1][1];
-        state[1] = tmp1;
-        diff = tmp0 - state[3];
-        // scale down and truncate
-        diff = diff >> 14;
-        if (diff < 0)
-            diff += 1;
-        state[3] = state[2] + diff * kResampleAllpass[1][2];
-        state[2] = tmp0;
-
-        // divide by two and store temporarily
-        in[i << 1] = (state[3] >> 1);
-    }
-
-    in++;
+    LoadChainState(lower, state);
+    LoadChainState(upper, state + 4);
 
+    // lower allpass filter (operates on even input samples) and
     // upper allpass filter (operates on odd input samples)
     for (i = 0; i < len; i++)
     {
-        tmp0 = in[i << 1];
-        diff = tmp0 - state[5];
-        // scale down and round
-        diff = (diff + (1 << 13)) >> 14;
-        tmp1 = state[4] + diff * kResampleAllpass[0][0];
-        state[4] = tmp0;
-        diff = tmp1 - state[6];
-        // scale down and round
-        diff = diff >> 14;
-        if (diff < 0)
-            diff += 1;
-        tmp0 = state[5] + diff * kResampleAllpass[0][1];
-        state[5] = tmp1;
-        diff = tmp0 - state[7];
-        // scale down and truncate
-        diff = diff >> 14;
-        if (diff < 0)
-            diff += 1;
-        state[7] = state[6] + diff * kResampleAllpass[0][2];
-        state[6] = tmp0;
+        tmp0 = AllpassChain(in[i << 1], kResampleAllpass[1], lower);
+        tmp1 = AllpassChain(in[(i << 1) + 1], kResampleAllpass[0], upper);
 
         // divide by two and store temporarily
-        in[i << 1] = (state[7] >> 1);
+        in[i << 1] = (tmp0 >> 1);
+        in[(i << 1) + 1] = (tmp1 >> 1);
     }
 
-    in--;
+    StoreChainState(lower, state);
+    StoreChainState(upper, state + 4);
 
     // combine allpass outputs
     for (i = 0; i < len; i += 2)
@@ -130,72 +136,30 @@ WebRtcSpl_DownBy2ShortToInt(const int16_t *in,
                             int32_t *out,
                             int32_t *state)
 {
-    int32_t tmp0, tmp1, diff;
+    int32_t tmp0, tmp1;
+    int32_t lower[4], upper[4];
     int32_t i;
 
     len >>= 1;
 
-    // lower allpass filter (operates on even input samples)
-    for (i = 0; i < len; i++)
-    {
-        tmp0 = ((int32_t)in[i << 1] << 15) + (1 << 14);
-        diff = tmp0 - state[1];
-        // scale down and round
-        diff = (diff + (1 << 13)) >> 14;
-        tmp1 = state[0] + diff * kResampleAllpass[1][0];
-        state[0] = tmp0;
-        diff = tmp1 - state[2];
-        // UBSan: -1379909682 - 834099714 cannot be represented in type 'int'
-
-        // scale down and truncate
-        diff = diff >> 14;
-        if (diff < 0)
-            diff += 1;
-        tmp0 = state[1] + diff * kResampleAllpass[1][1];
-        state[1] = tmp1;
-        diff = tmp0 - state[3];
-        // scale down and truncate
-        diff = diff >> 14;
-        if (diff < 0)
-            diff += 1;
-        state[3] = state[2] + diff * kResampleAllpass[1][2];
-        state[2] = tmp0;
-
-        // divide by two and store temporarily
-        out[i] = (state[3] >> 1);
-    }
-
-    in++;
+    LoadChainState(lower, state);
+    LoadChainState(upper, state + 4);
 
+    // lower allpass filter (operates on even input samples) and
     // upper allpass filter (operates on odd input samples)
     for (i = 0; i < len; i++)
     {
         tmp0 = ((int32_t)in[i << 1] << 15) + (1 << 14);
-        diff = tmp0 - state[5];
-        // scale down and round
-        diff = (diff + (1 << 13)) >> 14;
-        tmp1 = state[4] + diff * kResampleAllpass[0][0];
-        state[4] = tmp0;
-        diff = tmp1 - state[6];
-        // scale down and round
-        diff = diff >> 14;
-        if (diff < 0)
-            diff += 1;
-        tmp0 = state[5] + diff * kResampleAllpass[0][1];
-        state[5] = tmp1;
-        diff = tmp0 - state[7];
-        // scale down and truncate
-        diff = diff >> 14;
-        if (diff < 0)
-            diff += 1;
-        state[7] = state[6] + diff * kResampleAllpass[0][2];
-        state[6] = tmp0;
+        tmp1 = ((int32_t)in[(i << 1) + 1] << 15) + (1 << 14);
+        tmp0 = AllpassChain(tmp0, kResampleAllpass[1], lower);
+        tmp1 = AllpassChain(tmp1, kResampleAllpass[0], upper);
 
-        // divide by two and store temporarily
-        out[i] += (state[7] >> 1);
+        // divide both outputs by two and add
+        out[i] = (tmp0 >> 1) + (tmp1 >> 1);
     }
 
-    in--;
+    StoreChainState(lower, state);
+    StoreChainState(upper, state + 4);
 }
 
 
@@ -207,130 +171,42 @@ void RTC_NO_SANITIZE("signed-integer-overflow")  // bugs.webrtc.org/5486
 WebRtcSpl_LPBy2IntToInt(const int32_t* in, int32_t len, int32_t* out,
                         int32_t* state)
 {
-    int32_t tmp0, tmp1, diff;
+    int32_t tmp0, tmp1, delayed;
+    int32_t lower[4], upper[4];
     int32_t i;
 
     len >>= 1;
 
-    // lower allpass filter: odd input -> even output samples
-    in++;
-    // initial state of polyphase delay element
-    tmp0 = state[12];
-    for (i = 0; i < len; i++)
-    {
-        diff = tmp0 - state[1];
-        // scale down and round
-        diff = (diff + (1 << 13)) >> 14;
-        tmp1 = state[0] + diff * kResampleAllpass[1][0];
-        state[0] = tmp0;
-        diff = tmp1 - state[2];
-        // scale down and truncate
-        diff = diff >> 14;
-        if (diff < 0)
-            diff += 1;
-        tmp0 = state[1] + diff * kResampleAllpass[1][1];
-        state[1] = tmp1;
-        diff = tmp0 - state[3];
-        // scale down and truncate
-        diff = diff >> 14;
-        if (diff < 0)
-            diff += 1;
-        state[3] = state[2] + diff * kResampleAllpass[1][2];
-        state[2] = tmp0;
-
-        // scale down, round and store
-        out[i << 1] = state[3] >> 1;
-        tmp0 = in[i << 1];
-    }
-    in--;
-
+    // lower allpass filter: odd input -> even output samples, and
     // upper allpass filter: even input -> even output samples
+    LoadChainState(lower, state);
+    LoadChainState(upper, state + 4);
+    // initial state of polyphase delay element
+    delayed = state[12];
     for (i = 0; i < len; i++)
     {
-        tmp0 = in[i << 1];
-        diff = tmp0 - state[5];
-        // UBSan: -794814117 - 1566149201 cannot be represented in type 'int'
-
-        // scale down and round
-        diff = (diff + (1 << 13)) >> 14;
-        tmp1 = state[4] + diff * kResampleAllpass[0][0];
-        state[4] = tmp0;
-        diff = tmp1 - state[6];
-        // scale down and round
-        diff = diff >> 14;
-        if (diff < 0)
-            diff += 1;
-        tmp0 = state[5] + diff * kResampleAllpass[0][1];
-        state[5] = tmp1;
-        diff = tmp0 - state[7];
-        // scale down and truncate
-        diff = diff >> 14;
-        if (diff < 0)
-            diff += 1;
-        state[7] = state[6] + diff * kResampleAllpass[0][2];
-        state[6] = tmp0;
+        tmp0 = AllpassChain(delayed, kResampleAllpass[1], lower);
+        tmp1 = AllpassChain(in[i << 1], kResampleAllpass[0], upper);
+        delayed = in[(i << 1) + 1];
 
         // average the two allpass outputs, scale down and store
-        out[i << 1] = (out[i << 1] + (state[7] >> 1)) >> 15;
-    }
-
-    // switch to odd output samples
-    out++;
-
-    // lower allpass filter: even input -> odd output samples
-    for (i = 0; i < len; i++)
-    {
-        tmp0 = in[i << 1];
-        diff = tmp0 - state[9];
-        // scale down and round
-        diff = (diff + (1 << 13)) >> 14;
-        tmp1 = state[8] + diff * kResampleAllpass[1][0];
-        state[8] = tmp0;
-        diff = tmp1 - state[10];
-        // scale down and truncate
-        diff = diff >> 14;
-        if (diff < 0)
-            diff += 1;
-        tmp0 = state[9] + diff * kResampleAllpass[1][1];
-        state[9] = tmp1;
-        diff = tmp0 - state[11];
-        // scale down and truncate
-        diff = diff >> 14;
-        if (diff < 0)
-            diff += 1;
-        state[11] = state[10] + diff * kResampleAllpass[1][2];
-        state[10] = tmp0;
-
-        // scale down, round and store
-        out[i << 1] = state[11] >> 1;
+        out[i << 1] = ((tmp0 >> 1) + (tmp1 >> 1)) >> 15;
     }
+    StoreChainState(lower, state);
+    StoreChainState(upper, state + 4);
 
+    // lower allpass filter: even input -> odd output samples, and
     // upper allpass filter: odd input -> odd output samples
-    in++;
+    LoadChainState(lower, state + 8);
+    LoadChainState(upper, state + 12);
     for (i = 0; i < len; i++)
     {
-        tmp0 = in[i << 1];
-        diff = tmp0 - state[13];
-        // scale down and round
-        diff = (diff + (1 << 13)) >> 14;
-        tmp1 = state[12] + diff * kResampleAllpass[0][0];
-        state[12] = tmp0;
-        diff = tmp1 - state[14];
-        // scale down and round
-        diff = diff >> 14;
-        if (diff < 0)
-            diff += 1;
-        tmp0 = state[13] + diff * kResampleAllpass[0][1];
-        state[13] = tmp1;
-        diff = tmp0 - state[15];
-        // scale down and truncate
-        diff = diff >> 14;
-        if (diff < 0)
-            diff += 1;
-        state[15] = state[14] + diff * kResampleAllpass[0][2];
-        state[14] = tmp0;
+        tmp0 = AllpassChain(in[i << 1], kResampleAllpass[1], lower);
+        tmp1 = AllpassChain(in[(i << 1) + 1], kResampleAllpass[0], upper);
 
         // average the two allpass outputs, scale down and store
-        out[i << 1] = (out[i << 1] + (state[15] >> 1)) >> 15;
+        out[(i << 1) + 1] = ((tmp0 >> 1) + (tmp1 >> 1)) >> 15;
     }
+    StoreChainState(lower, state + 8);
+    StoreChainState(upper, state + 12);
 }
@@ -0,0 +1,43 @@
+/*
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+
+/*
+ * This file contains the process-wide switch for the SPL vector kernels.
+ * The description header can be found in spl_simd.h
+ *
+ */
+
+#include "spl_simd.h"
+
+#if defined(WEBRTC_SPL_HAVE_SIMD)
+// Plain int: written rarely (configuration), read once per kernel call; both
+// paths produce identical results so a racy read is harmless.
+static volatile int simd_enabled = 1;
+#endif
+
+int WebRtcSpl_SimdEnabled(void)
+{
+#if defined(WEBRTC_SPL_HAVE_SIMD)
+    return simd_enabled;
+#else
+    return 0;
+#endif
+}
+
+int WebRtcSpl_SetSimdEnabled(int enabled)
+{
+#if defined(WEBRTC_SPL_HAVE_SIMD)
+    int previous = simd_enabled;
+    simd_enabled = enabled ? 1 : 0;
+    return previous;
+#else
+    (void)enabled;
+    return 0;
+#endif
+}
@@ -0,0 +1,58 @@
+/*
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+
+/*
+ * SIMD selection for the fixed-point hot loops (energy, scaling and the
+ * filterbank band split). Every vector path is bit-exact with the scalar
+ * reference it replaces.
+ *
+ * Compile-time switches:
+ *   FVAD_DISABLE_SIMD  - build the scalar reference only.
+ *   FVAD_SIMD_VALIDATE - also run the scalar reference next to every vector
+ *                        call and RTC_DCHECK that both agree (debug builds).
+ *
+ * SSE2 (baseline on x86-64) and NEON (baseline on AArch64) cover all 16-bit
+ * kernels, so no runtime CPU detection is needed; WebRtcSpl_SetSimdEnabled()
+ * is a process-wide override for A/B runs.
+ */
+
+#ifndef COMMON_AUDIO_SIGNAL_PROCESSING_SPL_SIMD_H_
+#define COMMON_AUDIO_SIGNAL_PROCESSING_SPL_SIMD_H_
+
+#if !defined(FVAD_DISABLE_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WEBRTC_SPL_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define WEBRTC_SPL_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
+
+#if defined(WEBRTC_SPL_SIMD_SSE2) || defined(WEBRTC_SPL_SIMD_NEON)
+#define WEBRTC_SPL_HAVE_SIMD 1
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Returns non-zero if the vector kernels are compiled in and enabled.
+int WebRtcSpl_SimdEnabled(void);
+
+// Enables (non-zero) or disables the vector kernels for the whole process.
+// Returns the previous setting; always 0 when no vector kernels are built.
+int WebRtcSpl_SetSimdEnabled(int enabled);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // COMMON_AUDIO_SIGNAL_PROCESSING_SPL_SIMD_H_
@@ -9,6 +9,7 @@
  */
 
 #include "vad_filterbank.h"
+#include "../signal_processing/spl_simd.h"
 
 // Constants used in LogOfEnergy().
 static const int16_t kLogConst = 24660;  // 160*log10(2) in Q9.
@@ -67,38 +68,85 @@ static void HighPassFilter(const int16_t* data_in, size_t data_length,
 }
 
 // All pass filtering of |data_in|, used before splitting the signal into two
-// frequency bands (low pass vs high pass).
-// Note that |data_in| and |data_out| can NOT correspond to the same address.
+// frequency bands (low pass vs high pass). The upper filter runs on the even
+// and the lower filter on the odd samples of |data_in|; the two recursions are
+// independent and are interleaved in one loop.
+// Note that |data_in| and the outputs can NOT correspond to the same address.
 //
 // - data_in            [i]   : Input audio signal given in Q0.
-// - data_length        [i]   : Length of input and output data.
-// - filter_coefficient [i]   : Given in Q15.
-// - filter_state       [i/o] : State of the filter given in Q(-1).
-// - data_out           [o]   : Output audio signal given in Q(-1).
-static void AllPassFilter(const int16_t* data_in, size_t data_length,
-                          int16_t filter_coefficient, int16_t* filter_state,
-                          int16_t* data_out) {
+// - data_length        [i]   : Length of each output.
+// - upper_state        [i/o] : State of the upper filter given in Q(-1).
+// - lower_state        [i/o] : State of the lower filter given in Q(-1).
+// - upper_out          [o]   : Upper filter output given in Q(-1).
+// - lower_out          [o]   : Lower filter output given in Q(-1).
+static void AllPassFilterPair(const int16_t* data_in, size_t data_length,
+                              int16_t* upper_state, int16_t* lower_state,
+                              int16_t* upper_out, int16_t* lower_out) {
   // The filter can only cause overflow (in the w16 output variable)
   // if more than 4 consecutive input numbers are of maximum value and
   // has the the same sign as the impulse responses first taps.
   // First 6 taps of the impulse response:
   // 0.6399 0.5905 -0.3779 0.2418 -0.1547 0.0990
 
+  const int16_t upper_coefficient = kAllPassCoefsQ15[0];
+  const int16_t lower_coefficient = kAllPassCoefsQ15[1];
   size_t i;
-  int16_t tmp16 = 0;
-  int32_t tmp32 = 0;
-  int32_t state32 = ((int32_t) (*filter_state) * (1 << 16));  // Q15
+  int16_t upper16 = 0;
+  int16_t lower16 = 0;
+  int32_t upper32 = ((int32_t) (*upper_state) * (1 << 16));  // Q15
+  int32_t lower32 = ((int32_t) (*lower_state) * (1 << 16));  // Q15
 
   for (i = 0; i < data_length; i++) {
-    tmp32 = state32 + filter_coefficient * *data_in;
-    tmp16 = (int16_t) (tmp32 >> 16);  // Q(-1)
-    *data_out++ = tmp16;
-    state32 = (*data_in * (1 << 14)) - filter_coefficient * tmp16;  // Q14
-    state32 *= 2;  // Q15.
+    const int16_t even = data_in[0];
+    const int16_t odd = data_in[1];
+
+    upper16 = (int16_t) ((upper32 + upper_coefficient * even) >> 16);  // Q(-1)
+    lower16 = (int16_t) ((lower32 + lower_coefficient * odd) >> 16);  // Q(-1)
+    *upper_out++ = upper16;
+    *lower_out++ = lower16;
+    upper32 = (even * (1 << 14)) - upper_coefficient * upper16;  // Q14
+    lower32 = (odd * (1 << 14)) - lower_coefficient * lower16;  // Q14
+    upper32 *= 2;  // Q15.
+    lower32 *= 2;  // Q15.
     data_in += 2;
   }
 
-  *filter_state = (int16_t) (state32 >> 16);  // Q(-1)
+  *upper_state = (int16_t) (upper32 >> 16);  // Q(-1)
+  *lower_state = (int16_t) (lower32 >> 16);  // Q(-1)
+}
+
+// Makes the HP and LP signals from the two all-pass outputs in place:
+// |hp| = |hp| - |lp| and |lp| = |lp| + |hp| with 16-bit wrap-around, which the
+// vector versions reproduce exactly.
+static void MakeBands(int16_t* hp_data, int16_t* lp_data, size_t length) {
+  size_t i = 0;
+  int16_t tmp_out;
+
+#if defined(WEBRTC_SPL_SIMD_SSE2)
+  if (WebRtcSpl_SimdEnabled()) {
+    for (; i + 8 <= length; i += 8) {
+      __m128i hp = _mm_loadu_si128((const __m128i*) (hp_data + i));
+      __m128i lp = _mm_loadu_si128((const __m128i*) (lp_data + i));
+      _mm_storeu_si128((__m128i*) (hp_data + i), _mm_sub_epi16(hp, lp));
+      _mm_storeu_si128((__m128i*) (lp_data + i), _mm_add_epi16(lp, hp));
+    }
+  }
+#elif defined(WEBRTC_SPL_SIMD_NEON)
+  if (WebRtcSpl_SimdEnabled()) {
+    for (; i + 8 <= length; i += 8) {
+      int16x8_t hp = vld1q_s16(hp_data + i);
+      int16x8_t lp = vld1q_s16(lp_data + i);
+      vst1q_s16(hp_data + i, vsubq_s16(hp, lp));
+      vst1q_s16(lp_data + i, vaddq_s16(lp, hp));
+    }
+  }
+#endif
+
+  for (; i < length; i++) {
+    tmp_out = hp_data[i];
+    hp_data[i] -= lp_data[i];
+    lp_data[i] += tmp_out;
+  }
 }
 
 // Splits |data_in| into |hp_data_out| and |lp_data_out| corresponding to
@@ -115,24 +163,14 @@ static void AllPassFilter(const int16_t* data_in, size_t data_length,
 static void SplitFilter(const int16_t* data_in, size_t data_length,
                         int16_t* upper_state, int16_t* lower_state,
                         int16_t* hp_data_out, int16_t* lp_data_out) {
-  size_t i;
   size_t half_length = data_length >> 1;  // Downsampling by 2.
-  int16_t tmp_out;
-
-  // All-pass filtering upper branch.
-  AllPassFilter(&data_in[0], half_length, kAllPassCoefsQ15[0], upper_state,
-                hp_data_out);
 
-  // All-pass filtering lower branch.
-  AllPassFilter(&data_in[1], half_length, kAllPassCoefsQ15[1], lower_state,
-                lp_data_out);
+  // All-pass filtering upper and lower branch.
+  AllPassFilterPair(data_in, half_length, upper_state, lower_state,
+                    hp_data_out, lp_data_out);
 
   // Make LP and HP signals.
-  for (i = 0; i < half_length; i++) {
-    tmp_out = *hp_data_out;
-    *hp_data_out++ -= *lp_data_out;
-    *lp_data_out++ += tmp_out;
-  }
+  MakeBands(hp_data_out, lp_data_out, half_length);
 }
 
 // Calculates the energy of |data_in| in dB, and also updates an overall
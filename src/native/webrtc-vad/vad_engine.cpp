@@ -0,0 +1,302 @@
+#include "vad_engine.h"
+#include <algorithm>
+#include <cmath>
+#include <new>
+#include <stdexcept>
+
+namespace WebRTCVAD {
+
+namespace {
+
+// Longest valid frame: 30 ms at 48 kHz
+constexpr size_t MAX_FRAME_SAMPLES = 48 * 30;
+
+// Same rounding and saturation as VADWrapper's float batches
+inline int16_t ToInt16(float sample) {
+    float scaled = std::min(std::max(sample, -1.0f), 1.0f) * 32768.0f;
+    long value = std::lrintf(scaled);
+    return static_cast<int16_t>(value > 32767 ? 32767 : value);
+}
+
+bool IsValidSampleRate(int sample_rate) {
+    return sample_rate == 8000 || sample_rate == 16000 || sample_rate == 32000 || sample_rate == 48000;
+}
+
+} // namespace
+
+VADEngine::VADEngine(size_t max_streams, size_t worker_threads)
+    : capacity_(max_streams)
+    , stride_(0)
+    , pool_(nullptr)
+    , streams_(max_streams)
+    , batch_frames_(nullptr)
+    , batch_decisions_(nullptr)
+    , stream_counts_(max_streams + 1, 0)
+    , next_run_(0)
+    , batch_errors_(0)
+    , generation_(0)
+    , busy_workers_(0)
+    , stopping_(false)
+    , frames_processed_(0) {
+    
+    if (max_streams == 0 || max_streams > MAX_STREAMS) {
+        throw std::invalid_argument("VAD engine needs 1-4096 streams");
+    }
+    
+    // Round each state up to whole cache lines so neighbouring streams on
+    // different workers never share one
+    stride_ = (fvad_instance_size() + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    pool_ = static_cast<uint8_t*>(::operator new(capacity_ * stride_, std::align_val_t(CACHE_LINE)));
+    
+    worker_threads = std::min(worker_threads, MAX_WORKER_THREADS);
+    try {
+        for (size_t i = 0; i < worker_threads; ++i) {
+            workers_.emplace_back(&VADEngine::WorkerLoop, this);
+        }
+    } catch (...) {
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+        ::operator delete(pool_, std::align_val_t(CACHE_LINE));
+        throw;
+    }
+}
+
+VADEngine::~VADEngine() {
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+    
+    ::operator delete(pool_, std::align_val_t(CACHE_LINE));
+}
+
+size_t VADEngine::DefaultWorkerThreads() {
+    unsigned hardware = std::thread::hardware_concurrency();
+    size_t helpers = hardware > 1 ? hardware - 1 : 0;
+    return std::min<size_t>(helpers, 3);
+}
+
+int VADEngine::OpenStream(int sample_rate, int mode) {
+    if (!IsValidSampleRate(sample_rate) || mode < 0 || mode > 3) {
+        return -1;
+    }
+    
+    std::lock_guard<std::mutex> lock(control_mutex_);
+    
+    for (size_t i = 0; i < capacity_; ++i) {
+        StreamInfo& info = streams_[i];
+        if (info.open) continue;
+    
+        Fvad* state = State(static_cast<uint32_t>(i));
+        fvad_reset(state);
+        if (fvad_set_sample_rate(state, sample_rate) != 0 || fvad_set_mode(state, mode) != 0) {
+            return -1;
+        }
+    
+        info.open = true;
+        info.sample_rate = sample_rate;
+        info.mode = mode;
+        return static_cast<int>(i);
+    }
+    
+    return -1;
+}
+
+bool VADEngine::CloseStream(uint32_t stream) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+    
+    if (!IsOpen(stream)) {
+        return false;
+    }
+    
+    streams_[stream].open = false;
+    return true;
+}
+
+bool VADEngine::ResetStream(uint32_t stream) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+    
+    if (!IsOpen(stream)) {
+        return false;
+    }
+    
+    // fvad_reset() also restores the default rate and mode
+    const StreamInfo& info = streams_[stream];
+    Fvad* state = State(stream);
+    fvad_reset(state);
+    fvad_set_sample_rate(state, info.sample_rate);
+    fvad_set_mode(state, info.mode);
+    return true;
+}
+
+bool VADEngine::SetStreamMode(uint32_t stream, int mode) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+    
+    if (!IsOpen(stream) || fvad_set_mode(State(stream), mode) != 0) {
+        return false;
+    }
+    
+    streams_[stream].mode = mode;
+    return true;
+}
+
+size_t VADEngine::FrameLength(uint32_t stream, int frame_ms) const {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+    
+    if (!IsOpen(stream)) {
+        return 0;
+    }
+    
+    return static_cast<size_t>(streams_[stream].sample_rate) * frame_ms / 1000;
+}
+
+size_t VADEngine::OpenStreamCount() const {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+    
+    return static_cast<size_t>(std::count_if(streams_.begin(), streams_.end(),
+                                             [](const StreamInfo& info) { return info.open; }));
+}
+
+size_t VADEngine::ProcessFrames(const VADFrame* frames, size_t count, int8_t* decisions) {
+    if (!frames || !decisions || count == 0) {
+        return 0;
+    }
+    
+    std::lock_guard<std::mutex> lock(control_mutex_);
+    
+    bool parallel = false;
+    size_t invalid = 0;
+    {
+        // The batch is only written while no worker is in DrainRuns(); a worker
+        // that wakes late joins under this lock and sees the whole batch
+        std::unique_lock<std::mutex> poolLock(pool_mutex_);
+        idle_.wait(poolLock, [this] { return busy_workers_ == 0; });
+    
+        // Group frame indices by stream (counting sort keeps each stream's
+        // order); frames for streams that are not open fail right away
+        std::fill(stream_counts_.begin(), stream_counts_.end(), 0);
+        for (size_t i = 0; i < count; ++i) {
+            if (IsOpen(frames[i].stream)) {
+                stream_counts_[frames[i].stream + 1]++;
+            } else {
+                decisions[i] = -1;
+                invalid++;
+            }
+        }
+    
+        runs_.clear();
+        for (size_t s = 0; s < capacity_; ++s) {
+            size_t frameCount = stream_counts_[s + 1];
+            stream_counts_[s + 1] += stream_counts_[s];
+            if (frameCount > 0) {
+                runs_.push_back({static_cast<uint32_t>(s), stream_counts_[s], stream_counts_[s + 1]});
+            }
+        }
+    
+        order_.resize(count - invalid);
+        for (size_t i = 0; i < count; ++i) {
+            if (IsOpen(frames[i].stream)) {
+                order_[stream_counts_[frames[i].stream]++] = i;
+            }
+        }
+    
+        batch_frames_ = frames;
+        batch_decisions_ = decisions;
+        batch_errors_.store(invalid, std::memory_order_relaxed);
+        next_run_.store(0, std::memory_order_relaxed);
+    
+        parallel = !workers_.empty() && runs_.size() >= PARALLEL_MIN_RUNS &&
+                   order_.size() >= PARALLEL_MIN_FRAMES;
+        if (parallel) {
+            generation_++;
+        }
+    }
+    
+    if (parallel) {
+        wake_.notify_all();
+    }
+    
+    DrainRuns();
+    
+    {
+        // Decisions are complete once every worker that joined has left
+        std::unique_lock<std::mutex> poolLock(pool_mutex_);
+        idle_.wait(poolLock, [this] { return busy_workers_ == 0; });
+    }
+    
+    frames_processed_.fetch_add(order_.size(), std::memory_order_relaxed);
+    return count - batch_errors_.load(std::memory_order_relaxed);
+}
+
+void VADEngine::WorkerLoop() {
+    uint64_t seen = 0;
+    
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(pool_mutex_);
+            wake_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+            if (stopping_) return;
+            seen = generation_;
+            busy_workers_++;
+        }
+    
+        DrainRuns();
+    
+        {
+            std::lock_guard<std::mutex> lock(pool_mutex_);
+            busy_workers_--;
+        }
+        idle_.notify_one();
+    }
+}
+
+void VADEngine::DrainRuns() {
+    const size_t runCount = runs_.size();
+    
+    while (true) {
+        size_t index = next_run_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= runCount) return;
+        ProcessRun(runs_[index]);
+    }
+}
+
+void VADEngine::ProcessRun(const Run& run) {
+    Fvad* state = State(run.stream);
+    int16_t converted[MAX_FRAME_SAMPLES];
+    size_t errors = 0;
+    
+    for (size_t i = run.begin; i < run.end; ++i) {
+        const size_t index = order_[i];
+        const VADFrame& frame = batch_frames_[index];
+        const int16_t* samples = frame.pcm16;
+    
+        if (!samples && frame.float32 && frame.length <= MAX_FRAME_SAMPLES) {
+            for (size_t s = 0; s < frame.length; ++s) {
+                converted[s] = ToInt16(frame.float32[s]);
+            }
+            samples = converted;
+        }
+    
+        // fvad_process() rejects lengths that are not 10/20/30 ms at the stream rate
+        int result = samples ? fvad_process(state, samples, frame.length) : -1;
+        batch_decisions_[index] = static_cast<int8_t>(result);
+        if (result < 0) errors++;
+    }
+    
+    if (errors > 0) {
+        batch_errors_.fetch_add(errors, std::memory_order_relaxed);
+    }
+}
+
+} // namespace WebRTCVAD
\ No newline at end of file
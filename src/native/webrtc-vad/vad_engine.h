@@ -0,0 +1,138 @@
+#pragma once
+
+#include "fvad.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace WebRTCVAD {
+
+// One 10, 20 or 30 ms frame for one stream, as PCM16 or as float in [-1, 1]
+struct VADFrame {
+    uint32_t stream;
+    const int16_t* pcm16;   // Set one of pcm16 / float32
+    const float* float32;
+    size_t length;          // Samples at the stream's sample rate
+};
+
+// WebRTC VAD for many concurrent streams. The per-stream VAD states live in
+// one contiguous pool (one cache line stride per state, so workers never
+// share a line), and ProcessFrames() takes frames for any mix of streams in a
+// single call. Streams are spread across a small worker pool plus the calling
+// thread; the frames of one stream stay in order on one thread.
+//
+// Opening, closing and processing are meant for one controlling thread at a
+// time; concurrent callers are serialized.
+class VADEngine {
+public:
+    static constexpr size_t MAX_STREAMS = 4096;
+    static constexpr size_t MAX_WORKER_THREADS = 16;
+
+    // Pool of max_streams states with worker_threads helpers besides the
+    // caller (0 processes every batch on the calling thread)
+    explicit VADEngine(size_t max_streams, size_t worker_threads = DefaultWorkerThreads());
+    ~VADEngine();
+
+    VADEngine(const VADEngine&) = delete;
+    VADEngine& operator=(const VADEngine&) = delete;
+
+    // Claim a free state for a new stream (sample rate 8000, 16000, 32000 or
+    // 48000, mode 0-3). Returns its id, or -1 if the pool is full or the
+    // settings are invalid
+    int OpenStream(int sample_rate = 48000, int mode = 2);
+
+    // Release the stream's state to the pool
+    bool CloseStream(uint32_t stream);
+
+    // Clear the stream's VAD history, keeping its settings
+    bool ResetStream(uint32_t stream);
+
+    // Change the stream's aggressiveness mode (0-3)
+    bool SetStreamMode(uint32_t stream, int mode);
+
+    // Samples in one frame_ms frame of the stream, 0 if it is not open
+    size_t FrameLength(uint32_t stream, int frame_ms) const;
+
+    // Run every frame; decisions[i] receives 1 (speech), 0 (no speech) or -1
+    // (stream not open, no samples or invalid frame length) for frames[i].
+    // Frames of the same stream are processed in array order. Returns the
+    // number of frames processed without error
+    size_t ProcessFrames(const VADFrame* frames, size_t count, int8_t* decisions);
+
+    size_t Capacity() const { return capacity_; }
+    size_t OpenStreamCount() const;
+    size_t WorkerThreads() const { return workers_.size(); }
+
+    // Frames processed since construction
+    uint64_t FramesProcessed() const { return frames_processed_.load(std::memory_order_relaxed); }
+
+    // Hardware threads minus the caller, capped for a "small" pool
+    static size_t DefaultWorkerThreads();
+
+private:
+    // Frames of one stream in the current batch: order_[begin, end)
+    struct Run {
+        uint32_t stream;
+        size_t begin;
+        size_t end;
+    };
+
+    struct StreamInfo {
+        bool open = false;
+        int sample_rate = 0;
+        int mode = 0;
+    };
+
+    Fvad* State(uint32_t stream) const {
+        return reinterpret_cast<Fvad*>(pool_ + stream * stride_);
+    }
+
+    bool IsOpen(uint32_t stream) const {
+        return stream < capacity_ && streams_[stream].open;
+    }
+
+    void WorkerLoop();
+
+    // Claim runs of the current batch until none are left
+    void DrainRuns();
+    void ProcessRun(const Run& run);
+
+    static constexpr size_t CACHE_LINE = 64;
+
+    // Below these a batch is not worth waking the workers for
+    static constexpr size_t PARALLEL_MIN_FRAMES = 8;
+    static constexpr size_t PARALLEL_MIN_RUNS = 2;
+
+    const size_t capacity_;
+    size_t stride_;
+    uint8_t* pool_;                      // capacity_ states, stride_ bytes apart
+    std::vector<StreamInfo> streams_;
+
+    mutable std::mutex control_mutex_;   // Serializes the public API
+
+    // Current batch; written only while no worker is busy
+    const VADFrame* batch_frames_;
+    int8_t* batch_decisions_;
+    std::vector<size_t> order_;          // Frame indices grouped by stream
+    std::vector<size_t> stream_counts_;  // Scratch for the grouping pass
+    std::vector<Run> runs_;
+    std::atomic<size_t> next_run_;
+    std::atomic<size_t> batch_errors_;
+
+    // Worker pool
+    std::vector<std::thread> workers_;
+    std::mutex pool_mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    uint64_t generation_;                // Bumped for every parallel batch
+    size_t busy_workers_;
+    bool stopping_;
+
+    std::atomic<uint64_t> frames_processed_;
+};
+
+} // namespace WebRTCVAD
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "vad_wrapper.h"
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 
 namespace WebRTCVAD {
@@ -6,7 +8,9 @@ namespace WebRTCVAD {
 VADWrapper::VADWrapper(int sample_rate, int mode) 
     : vad_(nullptr, fvad_free)
     , sample_rate_(sample_rate)
-    , mode_(mode) {
+    , mode_(mode)
+    , batch_filled_(0)
+    , batch_frame_ms_(0) {
     
     Fvad* raw_vad = fvad_new();
     if (!raw_vad) {
@@ -42,7 +46,93 @@ int VADWrapper::Process(const int16_t* frame, size_t length) {
     return fvad_process(vad_.get(), frame, length);
 }
 
+namespace {
+
+inline int16_t ToInt16(int16_t sample) {
+    return sample;
+}
+
+inline int16_t ToInt16(float sample) {
+    float scaled = std::min(std::max(sample, -1.0f), 1.0f) * 32768.0f;
+    long value = std::lrintf(scaled);
+    return static_cast<int16_t>(value > 32767 ? 32767 : value);
+}
+
+} // namespace
+
+bool VADWrapper::PrepareBatch(int frame_ms) {
+    if (frame_ms != 10 && frame_ms != 20 && frame_ms != 30) {
+        return false;
+    }
+    
+    if (frame_ms != batch_frame_ms_) {
+        batch_frame_.assign(GetFrameLength(sample_rate_, frame_ms), 0);
+        batch_filled_ = 0;
+        batch_frame_ms_ = frame_ms;
+    }
+    
+    return true;
+}
+
+template <typename T>
+int VADWrapper::ProcessBatchImpl(const T* samples, size_t length, int frame_ms,
+                                 uint8_t* decisions, size_t capacity) {
+    if (!vad_ || (!samples && length > 0) || !PrepareBatch(frame_ms)) {
+        return -1;
+    }
+    
+    const size_t frame_length = batch_frame_.size();
+    int frames = 0;
+    
+    while (length > 0) {
+        size_t take = std::min(length, frame_length - batch_filled_);
+        for (size_t i = 0; i < take; ++i) {
+            batch_frame_[batch_filled_ + i] = ToInt16(samples[i]);
+        }
+        batch_filled_ += take;
+        samples += take;
+        length -= take;
+        
+        if (batch_filled_ == frame_length) {
+            int result = fvad_process(vad_.get(), batch_frame_.data(), frame_length);
+            if (result < 0) {
+                return -1;
+            }
+            if (decisions && static_cast<size_t>(frames) < capacity) {
+                decisions[frames] = static_cast<uint8_t>(result);
+            }
+            frames++;
+            batch_filled_ = 0;
+        }
+    }
+    
+    return frames;
+}
+
+int VADWrapper::ProcessBatch(const int16_t* samples, size_t length, int frame_ms,
+                             uint8_t* decisions, size_t capacity) {
+    return ProcessBatchImpl(samples, length, frame_ms, decisions, capacity);
+}
+
+int VADWrapper::ProcessBatch(const float* samples, size_t length, int frame_ms,
+                             uint8_t* decisions, size_t capacity) {
+    return ProcessBatchImpl(samples, length, frame_ms, decisions, capacity);
+}
+
+size_t VADWrapper::GetBatchFrameCount(size_t length, int frame_ms) const {
+    size_t frame_length = GetFrameLength(sample_rate_, frame_ms);
+    if (frame_length == 0) {
+        return 0;
+    }
+    
+    // Carried samples only count toward the same frame duration
+    size_t carried = (frame_ms == batch_frame_ms_) ? batch_filled_ : 0;
+    return (carried + length) / frame_length;
+}
+
 void VADWrapper::Reset() {
+    batch_filled_ = 0;
+    
     if (vad_) {
         fvad_reset(vad_.get());
         // Restore settings after reset
@@ -71,6 +161,7 @@ bool VADWrapper::SetSampleRate(int sample_rate) {
     
     if (fvad_set_sample_rate(vad_.get(), sample_rate) == 0) {
         sample_rate_ = sample_rate;
+        batch_frame_ms_ = 0;  // Frame length changed; drop any partial frame
         return true;
     }
     
@@ -81,6 +172,10 @@ size_t VADWrapper::GetFrameLength(int sample_rate, int duration_ms) {
     return (sample_rate * duration_ms) / 1000;
 }
 
+bool VADWrapper::SetSimdEnabled(bool enabled) {
+    return fvad_set_simd_enabled(enabled ? 1 : 0) != 0;
+}
+
 bool VADWrapper::IsValidFrameLength(size_t length) const {
     // Valid frame lengths are 10ms, 20ms, or 30ms
     size_t frame_10ms = GetFrameLength(sample_rate_, 10);
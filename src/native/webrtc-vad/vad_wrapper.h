@@ -3,6 +3,7 @@
 #include "fvad.h"
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 namespace WebRTCVAD {
 
@@ -16,7 +17,21 @@ public:
     // Returns: 1 = speech, 0 = no speech, -1 = error
     int Process(const int16_t* frame, size_t length);
 
-    // Reset VAD state
+    // Process an arbitrary-length buffer as consecutive frame_ms frames (10, 20
+    // or 30). A trailing partial frame is kept and completed by the next call.
+    // Writes one decision (1 = speech, 0 = no speech) per completed frame into
+    // decisions, up to capacity. Returns frames completed, or -1 on error
+    int ProcessBatch(const int16_t* samples, size_t length, int frame_ms,
+                     uint8_t* decisions, size_t capacity);
+
+    // Same for float samples in [-1, 1], converted to int16 frame by frame
+    int ProcessBatch(const float* samples, size_t length, int frame_ms,
+                     uint8_t* decisions, size_t capacity);
+
+    // Frames the next ProcessBatch() call with this length will complete
+    size_t GetBatchFrameCount(size_t length, int frame_ms) const;
+
+    // Reset VAD state (also drops any carried partial frame)
     void Reset();
 
     // Change VAD aggressiveness mode (0-3)
@@ -28,13 +43,29 @@ public:
     // Get frame length in samples for given duration in ms
     static size_t GetFrameLength(int sample_rate, int duration_ms);
 
+    // Toggle the SIMD feature kernels for every instance (identical results);
+    // returns the previous setting
+    static bool SetSimdEnabled(bool enabled);
+
     // Check if frame length is valid for the sample rate
     bool IsValidFrameLength(size_t length) const;
 
 private:
+    template <typename T>
+    int ProcessBatchImpl(const T* samples, size_t length, int frame_ms,
+                         uint8_t* decisions, size_t capacity);
+
+    // Start a new batch stream if the frame duration changed
+    bool PrepareBatch(int frame_ms);
+
     std::unique_ptr<Fvad, void(*)(Fvad*)> vad_;
     int sample_rate_;
     int mode_;
+
+    // Partial frame carried between ProcessBatch() calls
+    std::vector<int16_t> batch_frame_;
+    size_t batch_filled_;
+    int batch_frame_ms_;
 };
 
 } // namespace WebRTCVAD
\ No newline at end of file
@@ -365,29 +365,50 @@ export default class RealtimeConversation extends EventEmitter {
         this.audioDumpStream.write(buffer);
       }
 
-      const base64Audio = buffer.toString('base64');
-
-      const audioMessage = {
-        type: 'input_audio_buffer.append',
-        audio: base64Audio,
-      };
-
-      const success = this.send(audioMessage);
+      return this.appendAudio(buffer.toString('base64'), int16Array.byteLength);
+    } catch (error) {
+      console.error('❌ Error sending audio:', error);
+      return false;
+    }
+  }
 
-      if (success) {
-        this.audioChunksSent += 1;
-        this.lastChunkBytes = int16Array.byteLength; // Track for error diagnostics
-        this.audioBufferHasData = true; // Mark that we have audio in the buffer
+  // Forward PCM16 that is already base64-encoded (e.g. natively via
+  // AudioCapture.encodePcm16 or a 'base64' push batch) without re-encoding
+  pushBase64PCM(base64Audio: string, byteLength: number): boolean {
+    if (!this.ws || !this.isConnected) {
+      console.warn('⚠️ Cannot send audio: not connected');
+      return false;
+    }
 
+    try {
+      if (this.audioDumpEnabled && this.audioDumpStream) {
+        this.audioDumpStream.write(Buffer.from(base64Audio, 'base64'));
       }
 
-      return success;
+      return this.appendAudio(base64Audio, byteLength);
     } catch (error) {
       console.error('❌ Error sending audio:', error);
       return false;
     }
   }
 
+  private appendAudio(base64Audio: string, byteLength: number): boolean {
+    const audioMessage = {
+      type: 'input_audio_buffer.append',
+      audio: base64Audio,
+    };
+
+    const success = this.send(audioMessage);
+
+    if (success) {
+      this.audioChunksSent += 1;
+      this.lastChunkBytes = byteLength; // Track for error diagnostics
+      this.audioBufferHasData = true; // Mark that we have audio in the buffer
+    }
+
+    return success;
+  }
+
   // Helper method to send any message with automatic event ID tracking
   send(message: any): boolean {
     if (!this.ws || !this.isConnected) {